@@ -17,6 +17,7 @@
 
 #include "CCDB/CcdbApi.h"
 #include "CCDB/CCDBTimeStampUtils.h"
+#include "CCDB/CCDBObjectCache.h"
 #include "CommonUtils/NameConf.h"
 #include <string>
 #include <map>
@@ -40,30 +41,10 @@ namespace o2::ccdb
 
 class CCDBManagerInstance
 {
-  struct CachedObject {
-    std::shared_ptr<void> objPtr;
-    void* noCleanupPtr = nullptr; // if assigned instead of objPtr, no cleanup will be done on exit (for global objects cleaned up by the root, e.g. gGeoManager)
-    std::string uuid;
-    long startvalidity = 0;
-    long endvalidity = -1;
-    bool isValid(long ts) { return ts < endvalidity && ts > startvalidity; }
-    void clear()
-    {
-      noCleanupPtr = nullptr;
-      objPtr.reset();
-      uuid = "";
-      startvalidity = 0;
-      endvalidity = -1;
-    }
-  };
-
  public:
   using MD = std::map<std::string, std::string>;
 
-  CCDBManagerInstance(std::string const& path) : mCCDBAccessor{}
-  {
-    mCCDBAccessor.init(path);
-  }
+  CCDBManagerInstance(std::string const& path);
   /// set a URL to query from
   void setURL(const std::string& url);
 
@@ -107,7 +88,7 @@ class CCDBManagerInstance
   void clearCache() { mCache.clear(); }
 
   /// clear particular entry in the cache
-  void clearCache(std::string const& path) { mCache.erase(path); }
+  void clearCache(std::string const& path) { mCache.clear(path); }
 
   /// check if caching is enabled
   bool isCachingEnabled() const { return mCachingEnabled; }
@@ -127,9 +108,26 @@ class CCDBManagerInstance
     if (!isCachingEnabled()) {
       return false;
     }
-    return mCache[path].isValid(timestamp);
+    return mCache.isValid(path, timestamp);
   }
 
+  /// set the memory budget (in bytes of the retrieved objects) for keeping several versions of the objects in the cache.
+  /// The least recently used versions are evicted first, the version returned last for each path is always kept. With 0, the default, only this
+  /// version is kept. The default can be set with the ALICEO2_CCDB_CACHE_BUDGET_MB environment variable
+  void setCacheMemoryBudget(size_t budget) { mCache.setMemoryBudget(budget); }
+
+  /// get the memory budget of the cache
+  size_t getCacheMemoryBudget() const { return mCache.getMemoryBudget(); }
+
+  /// get the size of the cached objects
+  size_t getCacheSize() const { return mCache.getSize(); }
+
+  /// get the hit/miss/byte statistics of the cache
+  const CCDBObjectCache::Stats& getCacheStats() const { return mCache.getStats(); }
+
+  /// reset the statistics of the cache
+  void resetCacheStats() { mCache.resetStats(); }
+
   /// check if checks of object validity before CCDB query is enabled
   bool isLocalObjectValidityCheckingEnabled() const { return mCheckObjValidityEnabled; }
 
@@ -166,18 +164,20 @@ class CCDBManagerInstance
  private:
   // method to print (fatal) error
   void reportFatal(std::string_view s);
+  // size of the retrieved object from the headers, 0 if not known
+  static size_t getObjectSize(MD const& headers);
   // we access the CCDB via the CURL based C++ API
   o2::ccdb::CcdbApi mCCDBAccessor;
-  std::unordered_map<std::string, CachedObject> mCache; //! map for {path, CachedObject} associations
-  MD mMetaData;                                         // some dummy object needed to talk to CCDB API
-  MD mHeaders;                                          // headers to retrieve tags
-  long mTimestamp{o2::ccdb::getCurrentTimestamp()};     // timestamp to be used for query (by default "now")
-  bool mCanDefault = false;                             // whether default is ok --> useful for testing purposes done standalone/isolation
-  bool mCachingEnabled = true;                          // whether caching is enabled
-  bool mCheckObjValidityEnabled = false;                // wether the validity of cached object is checked before proceeding to a CCDB API query
-  long mCreatedNotAfter = 0;                            // upper limit for object creation timestamp (TimeMachine mode) - If-Not-After HTTP header
-  long mCreatedNotBefore = 0;                           // lower limit for object creation timestamp (TimeMachine mode) - If-Not-Before HTTP header
-  bool mFatalWhenNull = true;                           // if nullptr blob replies should be treated as fatal (can be set by user)
+  CCDBObjectCache mCache;                           //! cached versions of the objects for each path
+  MD mMetaData;                                     // some dummy object needed to talk to CCDB API
+  MD mHeaders;                                      // headers to retrieve tags
+  long mTimestamp{o2::ccdb::getCurrentTimestamp()}; // timestamp to be used for query (by default "now")
+  bool mCanDefault = false;                         // whether default is ok --> useful for testing purposes done standalone/isolation
+  bool mCachingEnabled = true;                      // whether caching is enabled
+  bool mCheckObjValidityEnabled = false;            // wether the validity of cached object is checked before proceeding to a CCDB API query
+  long mCreatedNotAfter = 0;                        // upper limit for object creation timestamp (TimeMachine mode) - If-Not-After HTTP header
+  long mCreatedNotBefore = 0;                       // lower limit for object creation timestamp (TimeMachine mode) - If-Not-Before HTTP header
+  bool mFatalWhenNull = true;                       // if nullptr blob replies should be treated as fatal (can be set by user)
 
   ClassDefNV(CCDBManagerInstance, 1);
 };
@@ -195,27 +195,36 @@ T* CCDBManagerInstance::getForTimeStamp(std::string const& path, long timestamp)
     }
     return ptr;
   }
-  auto& cached = mCache[path];
-  if (mCheckObjValidityEnabled && cached.isValid(timestamp)) {
-    return reinterpret_cast<T*>(cached.noCleanupPtr ? cached.noCleanupPtr : cached.objPtr.get());
+  // the version valid for the timestamp is validated with its ETag, otherwise the one returned last (if any) is used as before
+  auto* cached = mCache.find(path, timestamp);
+  if (mCheckObjValidityEnabled && cached) {
+    mCache.use(path, *cached, false);
+    return reinterpret_cast<T*>(cached->get());
+  }
+  if (!cached) {
+    cached = mCache.getCurrent(path);
   }
-  ptr = mCCDBAccessor.retrieveFromTFileAny<T>(path, mMetaData, timestamp, &mHeaders, cached.uuid,
+  ptr = mCCDBAccessor.retrieveFromTFileAny<T>(path, mMetaData, timestamp, &mHeaders, cached ? cached->uuid : "",
                                               mCreatedNotAfter ? std::to_string(mCreatedNotAfter) : "",
                                               mCreatedNotBefore ? std::to_string(mCreatedNotBefore) : "");
-  if (ptr) { // new object was shipped, old one (if any) is not valid anymore
+  if (ptr) { // new object was shipped, old ones with overlapping validity (if any) are not valid anymore
+    CCDBObjectCache::CachedObject obj;
     if constexpr (std::is_same<TGeoManager, T>::value || std::is_base_of<o2::conf::ConfigurableParam, T>::value) {
       // some special objects cannot be cached to shared_ptr since root may delete their raw global pointer
-      cached.noCleanupPtr = ptr;
+      obj.noCleanupPtr = ptr;
     } else {
-      cached.objPtr.reset(ptr);
+      obj.objPtr.reset(ptr);
     }
-    cached.uuid = mHeaders["ETag"];
-    cached.startvalidity = std::stol(mHeaders["Valid-From"]);
-    cached.endvalidity = std::stol(mHeaders["Valid-Until"]);
+    obj.uuid = mHeaders["ETag"];
+    obj.startvalidity = std::stol(mHeaders["Valid-From"]);
+    obj.endvalidity = std::stol(mHeaders["Valid-Until"]);
+    obj.size = getObjectSize(mHeaders);
+    mCache.insert(path, std::move(obj));
   } else if (mHeaders.count("Error")) { // in case of errors the pointer is 0 and headers["Error"] should be set
     clearCache(path);                   // in case of any error clear cache for this object
-  } else {                              // the old object is valid
-    ptr = reinterpret_cast<T*>(cached.noCleanupPtr ? cached.noCleanupPtr : cached.objPtr.get());
+  } else if (cached) {                  // the cached object is valid
+    mCache.use(path, *cached, true);
+    ptr = reinterpret_cast<T*>(cached->get());
   }
   mHeaders.clear();
   mMetaData.clear();
@@ -0,0 +1,124 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#ifndef O2_CCDB_CCDBOBJECTCACHE_H_
+#define O2_CCDB_CCDBOBJECTCACHE_H_
+
+#include <cstddef>
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace o2::ccdb
+{
+
+/// Cache of the objects retrieved from the CCDB, used by the CCDBManagerInstance.
+///
+/// For each path several versions with disjoint validity intervals are kept, ordered by their start of validity,
+/// so that going back and forth in time (e.g. when processing several runs) does not download the same objects again.
+/// The size of the cached objects is bounded by a memory budget: the least recently used versions are evicted
+/// first. The version of each path which was returned last is never evicted, so that the pointer handed out for a
+/// path stays valid until the next query of the same path, as with a single cached object per path.
+/// A budget of 0, the default, keeps only this version. The budget is charged with the size of the objects as
+/// downloaded, which is compressed: the memory of the deserialised objects is larger.
+class CCDBObjectCache
+{
+ public:
+  struct CachedObject {
+    std::shared_ptr<void> objPtr;
+    void* noCleanupPtr = nullptr; // if assigned instead of objPtr, no cleanup will be done on exit (for global objects cleaned up by the root, e.g. gGeoManager)
+    std::string uuid;
+    long startvalidity = 0;
+    long endvalidity = -1;
+    size_t size = 0; // size of the object as downloaded, 0 if not known
+    bool isValid(long ts) const { return ts < endvalidity && ts > startvalidity; }
+    void* get() const { return noCleanupPtr ? noCleanupPtr : objPtr.get(); }
+  };
+
+  /// statistics of the cache usage
+  struct Stats {
+    size_t hits = 0;           // objects returned from the cache without query
+    size_t notModified = 0;    // objects returned from the cache after the query confirmed that they are still valid
+    size_t misses = 0;         // objects retrieved and added to the cache
+    size_t evictions = 0;      // objects removed to respect the memory budget
+    size_t bytesRetrieved = 0; // size of the retrieved objects
+    size_t bytesEvicted = 0;   // size of the evicted objects
+  };
+
+  static constexpr size_t DefaultMemoryBudget = 0;
+
+  /// object of path valid for timestamp ts, nullptr if there is none
+  CachedObject* find(std::string const& path, long ts);
+
+  /// object of path returned last, nullptr if there is none
+  CachedObject* getCurrent(std::string const& path);
+
+  /// mark a cached object of path as returned: it becomes the current object of the path and the most recently used one
+  /// \param queried the object was returned after a query confirmed its validity
+  void use(std::string const& path, CachedObject& obj, bool queried);
+
+  /// add a retrieved object to the cache, replacing the objects of the same path with overlapping validity.
+  /// It becomes the current object of the path and objects are evicted if the memory budget is exceeded
+  CachedObject& insert(std::string const& path, CachedObject&& obj);
+
+  /// check if an object of path valid for timestamp ts is cached
+  bool isValid(std::string const& path, long ts) const;
+
+  /// remove all objects
+  void clear();
+
+  /// remove all objects of path
+  void clear(std::string const& path);
+
+  /// set the memory budget in bytes, objects are evicted if it is exceeded
+  void setMemoryBudget(size_t budget);
+  size_t getMemoryBudget() const { return mMemoryBudget; }
+
+  /// size of all cached objects
+  size_t getSize() const { return mSize; }
+
+  /// number of cached objects
+  size_t getNObjects() const { return mLRU.size(); }
+
+  const Stats& getStats() const { return mStats; }
+  void resetStats() { mStats = Stats{}; }
+
+ private:
+  struct CachedPath;
+  using LRUList = std::list<std::pair<CachedPath*, long>>; // path and start of validity of the cached objects, most recently used first
+
+  struct Entry {
+    CachedObject obj;
+    LRUList::iterator lruPos;
+  };
+
+  struct CachedPath {
+    std::map<long, Entry> objects; // objects with disjoint validity, by start of validity
+    long current = 0;              // start of validity of the object returned last
+    bool hasCurrent = false;
+  };
+
+  void erase(CachedPath& cachedPath, std::map<long, Entry>::iterator it);
+  void evict();
+
+  std::unordered_map<std::string, CachedPath> mPaths;
+  LRUList mLRU;
+  size_t mMemoryBudget = DefaultMemoryBudget;
+  size_t mSize = 0;
+  Stats mStats;
+};
+
+} // namespace o2::ccdb
+
+#endif
@@ -81,6 +81,12 @@ class CcdbApi //: public DatabaseInterface
    */
   bool isSnapshotMode() const { return mInSnapshotMode; }
 
+  /**
+   * Check if the retrieved objects are stored in a local snapshot cache (ALICEO2_CCDB_LOCALCACHE)
+   *
+   */
+  bool hasSnapshotCache() const { return !mSnapshotCachePath.empty(); }
+
   /**
    * Create a binary image of the arbitrary type object, if CcdbObjectInfo pointer is provided, register there
    *
@@ -345,6 +351,21 @@ class CcdbApi //: public DatabaseInterface
                         const std::string& createdNotAfter, const std::string& createdNotBefore, bool considerSnapshot = true) const;
   void navigateURLsAndLoadFileToMemory(o2::pmr::vector<char>& dest, CURL* curl_handle, std::string const& url, std::map<string, string>* headers) const;
 
+  /// request of an object to be loaded to memory by loadFilesToMemory, with the arguments of loadFileToMemory
+  struct LoadRequest {
+    o2::pmr::vector<char>* dest = nullptr;
+    std::string path;
+    std::map<std::string, std::string> metadata;
+    long timestamp = -1;
+    std::map<std::string, std::string>* headers = nullptr;
+    std::string etag;
+  };
+
+  /// Load several objects to memory, with the same result as loadFileToMemory for each request. The requests to the
+  /// server, including the redirections, are done concurrently, on connections which are kept open between calls.
+  /// With a local snapshot the objects are loaded one after the other.
+  void loadFilesToMemory(std::vector<LoadRequest>& requests, const std::string& createdNotAfter, const std::string& createdNotBefore) const;
+
   // the failure to load the file to memory is signaled by 0 size and non-0 capacity
   static bool isMemoryFileInvalid(const o2::pmr::vector<char>& v) { return v.size() == 0 && v.capacity() > 0; }
   template <typename T>
@@ -15,6 +15,7 @@
 #include "CCDB/BasicCCDBManager.h"
 #include <boost/lexical_cast.hpp>
 #include "FairLogger.h"
+#include <cstdlib>
 #include <string>
 
 namespace o2
@@ -22,6 +23,15 @@ namespace o2
 namespace ccdb
 {
 
+CCDBManagerInstance::CCDBManagerInstance(std::string const& path) : mCCDBAccessor{}
+{
+  mCCDBAccessor.init(path);
+  if (const char* budget = std::getenv("ALICEO2_CCDB_CACHE_BUDGET_MB")) {
+    mCache.setMemoryBudget(std::stoul(budget) * 1024 * 1024);
+    LOG(info) << "Memory budget of the CCDB cache set to " << budget << " MB";
+  }
+}
+
 void CCDBManagerInstance::setURL(std::string const& url)
 {
   mCCDBAccessor.init(url);
@@ -32,6 +42,19 @@ void CCDBManagerInstance::reportFatal(std::string_view err)
   LOG(fatal) << err;
 }
 
+size_t CCDBManagerInstance::getObjectSize(MD const& headers)
+{
+  auto size = headers.find("Content-Length");
+  if (size == headers.end() && (size = headers.find("fileSize")) == headers.end()) {
+    return 0;
+  }
+  try {
+    return std::stoul(size->second);
+  } catch (std::exception const&) {
+    return 0;
+  }
+}
+
 std::pair<uint64_t, uint64_t> CCDBManagerInstance::getRunDuration(int runnumber) const
 {
   auto response = mCCDBAccessor.retrieveHeaders("RCT/Info/RunInformation", std::map<std::string, std::string>(), runnumber);
@@ -0,0 +1,149 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#include "CCDB/CCDBObjectCache.h"
+#include <algorithm>
+#include <iterator>
+
+namespace o2::ccdb
+{
+
+namespace
+{
+// the object valid for ts is the one with the largest start of validity below ts, since the validity intervals are disjoint
+template <typename Objects>
+auto findValid(Objects& objects, long ts)
+{
+  auto it = objects.lower_bound(ts);
+  if (it == objects.begin()) {
+    return objects.end();
+  }
+  --it;
+  return it->second.obj.isValid(ts) ? it : objects.end();
+}
+} // namespace
+
+CCDBObjectCache::CachedObject* CCDBObjectCache::find(std::string const& path, long ts)
+{
+  auto cachedPath = mPaths.find(path);
+  if (cachedPath == mPaths.end()) {
+    return nullptr;
+  }
+  auto it = findValid(cachedPath->second.objects, ts);
+  return it == cachedPath->second.objects.end() ? nullptr : &it->second.obj;
+}
+
+CCDBObjectCache::CachedObject* CCDBObjectCache::getCurrent(std::string const& path)
+{
+  auto cachedPath = mPaths.find(path);
+  if (cachedPath == mPaths.end() || !cachedPath->second.hasCurrent) {
+    return nullptr;
+  }
+  return &cachedPath->second.objects.at(cachedPath->second.current).obj;
+}
+
+bool CCDBObjectCache::isValid(std::string const& path, long ts) const
+{
+  auto cachedPath = mPaths.find(path);
+  return cachedPath != mPaths.end() && findValid(cachedPath->second.objects, ts) != cachedPath->second.objects.end();
+}
+
+void CCDBObjectCache::use(std::string const& path, CachedObject& obj, bool queried)
+{
+  auto& cachedPath = mPaths.at(path);
+  auto& entry = cachedPath.objects.at(obj.startvalidity);
+  mLRU.splice(mLRU.begin(), mLRU, entry.lruPos);
+  cachedPath.current = obj.startvalidity;
+  cachedPath.hasCurrent = true;
+  queried ? mStats.notModified++ : mStats.hits++;
+}
+
+CCDBObjectCache::CachedObject& CCDBObjectCache::insert(std::string const& path, CachedObject&& obj)
+{
+  auto& cachedPath = mPaths[path];
+  auto& objects = cachedPath.objects;
+  // remove the objects overlapping with [startvalidity, endvalidity), they are superseded by the new one
+  auto it = objects.lower_bound(std::max(obj.endvalidity, obj.startvalidity + 1));
+  while (it != objects.begin()) {
+    auto prev = std::prev(it);
+    if (prev->second.obj.endvalidity <= obj.startvalidity && prev->first != obj.startvalidity) {
+      break;
+    }
+    erase(cachedPath, prev);
+  }
+
+  mStats.misses++;
+  mStats.bytesRetrieved += obj.size;
+  mSize += obj.size;
+  const long key = obj.startvalidity;
+  mLRU.emplace_front(&cachedPath, key);
+  auto& entry = objects.emplace(key, Entry{std::move(obj), mLRU.begin()}).first->second;
+  cachedPath.current = key;
+  cachedPath.hasCurrent = true;
+  evict();
+  return entry.obj;
+}
+
+void CCDBObjectCache::erase(CachedPath& cachedPath, std::map<long, Entry>::iterator it)
+{
+  mSize -= it->second.obj.size;
+  mLRU.erase(it->second.lruPos);
+  if (cachedPath.hasCurrent && cachedPath.current == it->first) {
+    cachedPath.hasCurrent = false;
+  }
+  cachedPath.objects.erase(it);
+}
+
+void CCDBObjectCache::evict()
+{
+  // the least recently used objects are at the end of the list, the current object of each path is kept
+  auto it = mLRU.end();
+  while (mSize > mMemoryBudget && it != mLRU.begin()) {
+    --it;
+    auto [cachedPath, key] = *it;
+    if (cachedPath->hasCurrent && cachedPath->current == key) {
+      continue;
+    }
+    auto obj = cachedPath->objects.find(key);
+    mStats.evictions++;
+    mStats.bytesEvicted += obj->second.obj.size;
+    it = std::next(it);
+    erase(*cachedPath, obj);
+  }
+}
+
+void CCDBObjectCache::clear()
+{
+  mPaths.clear();
+  mLRU.clear();
+  mSize = 0;
+}
+
+void CCDBObjectCache::clear(std::string const& path)
+{
+  auto cachedPath = mPaths.find(path);
+  if (cachedPath == mPaths.end()) {
+    return;
+  }
+  for (auto& [key, entry] : cachedPath->second.objects) {
+    mSize -= entry.obj.size;
+    mLRU.erase(entry.lruPos);
+  }
+  mPaths.erase(cachedPath);
+}
+
+void CCDBObjectCache::setMemoryBudget(size_t budget)
+{
+  mMemoryBudget = budget;
+  evict();
+}
+
+} // namespace o2::ccdb
@@ -480,6 +480,21 @@ size_t header_map_callback(char* buffer, size_t size, size_t nitems, void* userd
   }
   return size * nitems;
 }
+
+size_t writeToMemoryCallback(void* contents, size_t size, size_t nmemb, void* chunkptr)
+{
+  o2::pmr::vector<char>& chunk = *static_cast<o2::pmr::vector<char>*>(chunkptr);
+  size_t realsize = size * nmemb;
+  try {
+    chunk.reserve(chunk.size() + realsize);
+    char* contC = (char*)contents;
+    chunk.insert(chunk.end(), contC, contC + realsize);
+  } catch (std::exception e) {
+    LOGP(info, "failed to expand by {} bytes chunk provided to CURL: {}", realsize, e.what());
+    realsize = 0;
+  }
+  return realsize;
+}
 } // namespace
 
 void CcdbApi::initHeadersForRetrieve(CURL* curlHandle, long timestamp, std::map<std::string, std::string>* headers, std::string const& etag,
@@ -1503,23 +1518,10 @@ void CcdbApi::navigateURLsAndLoadFileToMemory(o2::pmr::vector<char>& dest, CURL*
     chunk.reserve(1);
     errorflag = true;
   };
-  auto writeCallBack = [](void* contents, size_t size, size_t nmemb, void* chunkptr) {
-    o2::pmr::vector<char>& chunk = *static_cast<o2::pmr::vector<char>*>(chunkptr);
-    size_t realsize = size * nmemb;
-    try {
-      chunk.reserve(chunk.size() + realsize);
-      char* contC = (char*)contents;
-      chunk.insert(chunk.end(), contC, contC + realsize);
-    } catch (std::exception e) {
-      LOGP(info, "failed to expand by {} bytes chunk provided to CURL: {}", realsize, e.what());
-      realsize = 0;
-    }
-    return realsize;
-  };
 
   // specify URL to get
   curl_easy_setopt(curl_handle, CURLOPT_URL, url.c_str());
-  initCurlOptionsForRetrieve(curl_handle, (void*)&dest, writeCallBack, false);
+  initCurlOptionsForRetrieve(curl_handle, (void*)&dest, writeToMemoryCallback, false);
   curl_easy_setopt(curl_handle, CURLOPT_HEADERFUNCTION, header_map_callback<decltype(headerData)>);
   headerData.clear();
   curl_easy_setopt(curl_handle, CURLOPT_HEADERDATA, (void*)&headerData);
@@ -1594,6 +1596,167 @@ void CcdbApi::navigateURLsAndLoadFileToMemory(o2::pmr::vector<char>& dest, CURL*
   return;
 }
 
+void CcdbApi::loadFilesToMemory(std::vector<LoadRequest>& requests, const std::string& createdNotAfter, const std::string& createdNotBefore) const
+{
+  // the snapshots are read or created under a per-path semaphore, the objects are loaded one by one
+  if (mInSnapshotMode || hasSnapshotCache() || requests.size() < 2) {
+    for (auto& req : requests) {
+      loadFileToMemory(*req.dest, req.path, req.metadata, req.timestamp, req.headers, req.etag, createdNotAfter, createdNotBefore);
+    }
+    return;
+  }
+  // as the headerData of navigateURLsAndLoadFileToMemory, one multi handle per thread: it owns the connection cache,
+  // so that the connections to the servers are reused by the following calls
+  static thread_local std::unique_ptr<CURLM, decltype(&curl_multi_cleanup)> multiHandle{curl_multi_init(), &curl_multi_cleanup};
+  CURLM* multi = multiHandle.get();
+
+  struct Transfer {
+    LoadRequest* request = nullptr;
+    CURL* handle = nullptr;
+    std::string url;
+    std::multimap<std::string, std::string> headerData;
+    std::vector<std::pair<std::vector<std::string>, size_t>> redirections; // locations of nested redirections and the next one to try
+  };
+  std::vector<Transfer> transfers(requests.size());
+  size_t nActive = 0;
+
+  auto start = [multi, &nActive](Transfer& t, std::string const& url) {
+    t.url = url;
+    t.headerData.clear();
+    curl_easy_setopt(t.handle, CURLOPT_URL, t.url.c_str());
+    curl_multi_add_handle(multi, t.handle);
+    nActive++;
+  };
+  auto signalError = [](Transfer& t) {
+    t.request->dest->clear();
+    t.request->dest->reserve(1);
+    if (t.request->headers) {
+      (*t.request->headers)["Error"] = "An error occurred during retrieval";
+    }
+  };
+  // as navigateURLsAndLoadFileToMemory: unless the content was received, try the next location of the innermost
+  // redirection. Returns false if there is nothing left to try.
+  auto tryNextLocation = [this, &start](Transfer& t) {
+    auto& dest = *t.request->dest;
+    while (!t.redirections.empty() && dest.empty()) {
+      auto& [locs, next] = t.redirections.back();
+      if (next == locs.size()) {
+        t.redirections.pop_back();
+        continue;
+      }
+      const auto loc = locs[next++];
+      if (loc.empty()) {
+        continue;
+      }
+      LOG(debug) << "Trying content location " << loc;
+      if (loc.find("alien:/", 0) != std::string::npos) {
+        loadFileToMemory(dest, loc, nullptr);
+        continue;
+      }
+      start(t, loc);
+      return true;
+    }
+    return false;
+  };
+
+  for (size_t i = 0; i < requests.size(); i++) {
+    auto& req = requests[i];
+    auto& t = transfers[i];
+    LOGP(debug, "loadFilesToMemory {} ETag=[{}]", req.path, req.etag);
+    t.request = &req;
+    t.handle = curl_easy_init();
+    const auto fullUrl = getFullUrlForRetrieval(t.handle, req.path, req.metadata, req.timestamp);
+    initHeadersForRetrieve(t.handle, req.timestamp, req.headers, req.etag, createdNotAfter, createdNotBefore);
+    initCurlOptionsForRetrieve(t.handle, (void*)req.dest, writeToMemoryCallback, false);
+    curl_easy_setopt(t.handle, CURLOPT_HEADERFUNCTION, header_map_callback<decltype(t.headerData)>);
+    curl_easy_setopt(t.handle, CURLOPT_HEADERDATA, (void*)&t.headerData);
+    curl_easy_setopt(t.handle, CURLOPT_PRIVATE, (void*)&t);
+    curlSetSSLOptions(t.handle);
+    start(t, fullUrl);
+  }
+
+  while (nActive) {
+    int nRunning = 0;
+    curl_multi_perform(multi, &nRunning);
+    int nQueued = 0;
+    while (CURLMsg* msg = curl_multi_info_read(multi, &nQueued)) {
+      if (msg->msg != CURLMSG_DONE) {
+        continue;
+      }
+      CURL* handle = msg->easy_handle;
+      const CURLcode res = msg->data.result;
+      curl_multi_remove_handle(multi, handle);
+      nActive--;
+      char* priv = nullptr;
+      curl_easy_getinfo(handle, CURLINFO_PRIVATE, &priv);
+      auto& t = *reinterpret_cast<Transfer*>(priv);
+      auto* headers = t.request->headers;
+
+      long response_code = -1;
+      if (res == CURLE_OK && curl_easy_getinfo(handle, CURLINFO_RESPONSE_CODE, &response_code) == CURLE_OK) {
+        if (headers) {
+          for (auto& p : t.headerData) {
+            (*headers)[p.first] = p.second;
+          }
+        }
+        if (200 <= response_code && response_code < 300) {
+          // the content was written to the destination
+        } else if (response_code == 304) {
+          LOGP(debug, "Object exists but I am not serving it since it's already in your possession");
+        } else if (300 <= response_code && response_code < 400) {
+          // the "Location" first, then the alternative "Content-Location"s, as in navigateURLsAndLoadFileToMemory
+          auto complement_Location = [this](std::string const& loc) {
+            return loc[0] == '/' ? getURL() + loc : loc;
+          };
+          std::vector<std::string> locs;
+          auto iter = t.headerData.find("Location");
+          if (iter != t.headerData.end()) {
+            locs.push_back(complement_Location(iter->second));
+          }
+          auto range = t.headerData.equal_range("Content-Location");
+          for (auto it = range.first; it != range.second; ++it) {
+            if (std::find(locs.begin(), locs.end(), it->second) == locs.end()) {
+              locs.push_back(complement_Location(it->second));
+            }
+          }
+          t.redirections.emplace_back(std::move(locs), 0);
+        } else if (response_code == 404) {
+          LOG(error) << "Requested resource does not exist: " << t.url;
+          signalError(t);
+        } else {
+          LOG(error) << "Error in fetching object " << t.url << ", curl response code:" << response_code;
+          signalError(t);
+        }
+      } else {
+        LOGP(alarm, "Curl request to {} failed with result {}, response code: {}", t.url, int(res), response_code);
+        signalError(t);
+      }
+      if (!tryNextLocation(t)) {
+        curl_easy_cleanup(handle);
+        t.handle = nullptr;
+      }
+    }
+    if (nActive) {
+      curl_multi_poll(multi, nullptr, 0, 1000, nullptr);
+    }
+  }
+
+  for (auto& req : requests) {
+    auto& dest = *req.dest;
+    if (isMemoryFileInvalid(dest) && hostsPool.size() > 1) {
+      CURL* curl_handle = curl_easy_init();
+      for (size_t hostIndex = 1; hostIndex < hostsPool.size() && isMemoryFileInvalid(dest); hostIndex++) {
+        const auto fullUrl = getFullUrlForRetrieval(curl_handle, req.path, req.metadata, req.timestamp, hostIndex);
+        loadFileToMemory(dest, fullUrl, req.headers); // headers loaded from the file in case of the snapshot reading only
+      }
+      curl_easy_cleanup(curl_handle);
+    }
+    if (!dest.empty()) {
+      logReading(req.path, req.timestamp, req.headers, "load to memory");
+    }
+  }
+}
+
 void CcdbApi::loadFileToMemory(o2::pmr::vector<char>& dest, const std::string& path, std::map<std::string, std::string>* localHeaders) const
 {
   // Read file to memory as vector. For special case of the locally cached file retriev metadata stored directly in the file
@@ -0,0 +1,149 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+///
+/// \file bench_CCDBObjectCache.cxx
+/// \brief queries/s, hits, misses and retrieved bytes of the CCDB object cache for a replayed sequence of timestamps
+///
+
+#include <algorithm>
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <unistd.h>
+
+#include "CCDB/CCDBObjectCache.h"
+#include "TFile.h"
+#include "TH1F.h"
+
+namespace
+{
+using o2::ccdb::CCDBObjectCache;
+
+constexpr int NRuns = 40;
+constexpr long RunDuration = 3600 * 1000; // 1h runs, timestamps in ms
+constexpr int RunsPerFill = 4;
+
+// Stand-in for the CCDB server: one local ROOT file per version of each object. Objects are valid for a run, for a
+// fill or for all runs, with sizes of 0.1-2 MB. A retrieval opens the file and reads the object.
+class LocalServer
+{
+ public:
+  struct Path {
+    std::string name;
+    long granularity; // duration of the validity of each version
+    int nBins;
+  };
+
+  LocalServer()
+  {
+    mDir = std::filesystem::temp_directory_path() / ("ccdb-cache-bench-" + std::to_string(getpid()));
+    std::filesystem::create_directories(mDir);
+    const std::vector<Path> paths{{"TPC/Calib/Gain", RunDuration, 250000}, {"TPC/Calib/Pedestal", RunDuration, 500000},
+                                  {"ITS/Calib/NoiseMap", RunDuration, 100000}, {"GLO/Config/GRPECS", RunDuration, 25000},
+                                  {"GLO/Config/GRPLHCIF", RunsPerFill * RunDuration, 25000}, {"TOF/Calib/LHCphase", RunsPerFill * RunDuration, 50000},
+                                  {"TPC/Calib/VDrift", RunsPerFill * RunDuration, 50000}, {"GLO/Param/MatLUT", NRuns * RunDuration, 500000}};
+    std::mt19937 rng{0};
+    std::uniform_real_distribution<float> uni{0.f, 1.f};
+    for (const auto& path : paths) {
+      for (long start = 0; start < NRuns * RunDuration; start += path.granularity) {
+        TH1F h("h", path.name.c_str(), path.nBins, 0, 1);
+        for (int bin = 1; bin <= path.nBins; bin++) {
+          h.SetBinContent(bin, uni(rng)); // random content is not compressed, the file size is ~4 bytes per bin
+        }
+        TFile f(getFileName(path.name, start).c_str(), "RECREATE");
+        h.Write();
+      }
+    }
+    mPaths = paths;
+  }
+
+  ~LocalServer() { std::filesystem::remove_all(mDir); }
+
+  const std::vector<Path>& getPaths() const { return mPaths; }
+
+  CCDBObjectCache::CachedObject retrieve(Path const& path, long ts) const
+  {
+    CCDBObjectCache::CachedObject obj;
+    obj.startvalidity = ts / path.granularity * path.granularity;
+    obj.endvalidity = obj.startvalidity + path.granularity;
+    const auto fileName = getFileName(path.name, obj.startvalidity);
+    TFile f(fileName.c_str(), "READ");
+    auto* h = f.Get<TH1F>("h");
+    h->SetDirectory(nullptr);
+    obj.objPtr.reset(h);
+    obj.uuid = fileName;
+    obj.size = std::filesystem::file_size(fileName);
+    return obj;
+  }
+
+ private:
+  std::string getFileName(std::string name, long start) const
+  {
+    std::replace(name.begin(), name.end(), '/', '_');
+    return (mDir / (name + "_" + std::to_string(start) + ".root")).string();
+  }
+
+  std::filesystem::path mDir;
+  std::vector<Path> mPaths;
+};
+
+// Sequence of timestamps of an async reconstruction worker processing chunks of 5 min of data of randomly chosen runs,
+// which goes back and forth in time as the chunks of several runs are distributed to the workers.
+// For each chunk all objects are queried, as the CCDB fetchers do for each TF.
+std::vector<long> getTimestamps(int nChunks)
+{
+  std::mt19937 rng{0};
+  std::uniform_int_distribution<int> run{0, NRuns - 1};
+  std::uniform_int_distribution<long> offset{0, RunDuration - 1};
+  std::vector<long> ts(nChunks);
+  for (auto& t : ts) {
+    t = run(rng) * RunDuration + offset(rng);
+  }
+  return ts;
+}
+
+// The range argument is the memory budget of the cache in MB, 0 keeps one version per path as the previous cache.
+void BM_CCDBObjectCacheReplay(benchmark::State& state)
+{
+  static const LocalServer server;
+  const auto timestamps = getTimestamps(1000);
+  CCDBObjectCache::Stats stats;
+  for (auto _ : state) {
+    CCDBObjectCache cache;
+    cache.setMemoryBudget(state.range(0) * 1024 * 1024);
+    for (const auto ts : timestamps) {
+      for (const auto& path : server.getPaths()) {
+        auto* obj = cache.find(path.name, ts);
+        if (obj) {
+          cache.use(path.name, *obj, false);
+        } else {
+          obj = &cache.insert(path.name, server.retrieve(path, ts));
+        }
+        benchmark::DoNotOptimize(obj->get());
+      }
+    }
+    stats = cache.getStats();
+  }
+  state.SetItemsProcessed(state.iterations() * timestamps.size() * server.getPaths().size());
+  state.counters["hits"] = stats.hits;
+  state.counters["misses"] = stats.misses;
+  state.counters["evictions"] = stats.evictions;
+  state.counters["MBRetrieved"] = stats.bytesRetrieved / (1024. * 1024.);
+}
+} // namespace
+
+BENCHMARK(BM_CCDBObjectCacheReplay)->Arg(0)->Arg(16)->Arg(64)->Arg(256)->Unit(benchmark::kMillisecond)->ArgNames({"budgetMB"});
+
+BENCHMARK_MAIN();
@@ -0,0 +1,183 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+///
+/// \file bench_CcdbApiLoadFiles.cxx
+/// \brief time to load the conditions of a device one by one and with the concurrent requests of loadFilesToMemory
+///
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "CCDB/CcdbApi.h"
+
+namespace
+{
+using o2::ccdb::CcdbApi;
+
+// Stand-in for the CCDB server on localhost: every request is answered after a fixed latency, as for a remote
+// server, with an object of 64 kB. Half of the paths are redirected to another URL, as the CCDB does for objects
+// stored on a file server. Connections are kept alive and each one is served by its own thread.
+class LatencyServer
+{
+ public:
+  LatencyServer()
+  {
+    mSocket = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    socklen_t len = sizeof(addr);
+    if (bind(mSocket, (sockaddr*)&addr, sizeof(addr)) != 0 || listen(mSocket, 256) != 0 || getsockname(mSocket, (sockaddr*)&addr, &len) != 0) {
+      throw std::runtime_error("cannot start the server");
+    }
+    mURL = "http://127.0.0.1:" + std::to_string(ntohs(addr.sin_port));
+    std::thread([this]() {
+      int fd;
+      while ((fd = accept(mSocket, nullptr, nullptr)) >= 0) {
+        mConnections++;
+        std::thread(&LatencyServer::serve, this, fd).detach();
+      }
+    }).detach();
+  }
+
+  const std::string& getURL() const { return mURL; }
+  void setLatency(int ms) { mLatency = ms; }
+  size_t getConnections() const { return mConnections; }
+
+ private:
+  void serve(int fd)
+  {
+    const std::string body(64 * 1024, 'x');
+    std::string request;
+    char buf[4096];
+    while (true) {
+      auto end = request.find("\r\n\r\n");
+      if (end == std::string::npos) {
+        auto n = read(fd, buf, sizeof(buf));
+        if (n <= 0) {
+          break;
+        }
+        request.append(buf, n);
+        continue;
+      }
+      const auto url = request.substr(4, request.find(' ', 4) - 4); // GET <url> HTTP/1.1
+      request.erase(0, end + 4);
+      std::this_thread::sleep_for(std::chrono::milliseconds(mLatency.load()));
+      std::string response;
+      if (url.rfind("/files/", 0) != 0 && (std::hash<std::string>{}(url) & 0x1)) {
+        response = "HTTP/1.1 303 See Other\r\nLocation: /files" + url + "\r\nContent-Length: 0\r\n\r\n";
+      } else {
+        response = "HTTP/1.1 200 OK\r\nETag: \"" + url + "\"\r\nValid-From: 0\r\nValid-Until: 4000000000000\r\nContent-Length: " + std::to_string(body.size()) + "\r\n\r\n" + body;
+      }
+      if (write(fd, response.data(), response.size()) != (ssize_t)response.size()) {
+        break;
+      }
+    }
+    close(fd);
+  }
+
+  int mSocket = -1;
+  std::string mURL;
+  std::atomic<int> mLatency{0};
+  std::atomic<size_t> mConnections{0};
+};
+
+LatencyServer& getServer()
+{
+  static LatencyServer server;
+  return server;
+}
+
+// The range arguments are the number of objects, as the condition inputs of a reconstruction device, and the
+// latency of the server in ms. Every iteration loads all objects, as at the start of run.
+struct Conditions {
+  Conditions(int nObjects) : buffers(nObjects), headers(nObjects)
+  {
+    api.init(getServer().getURL());
+    for (int i = 0; i < nObjects; i++) {
+      paths.push_back("DET" + std::to_string(i % 10) + "/Calib/Object" + std::to_string(i));
+    }
+  }
+  void clear()
+  {
+    for (size_t i = 0; i < paths.size(); i++) {
+      buffers[i] = o2::pmr::vector<char>{};
+      headers[i].clear();
+    }
+  }
+  CcdbApi api;
+  std::vector<std::string> paths;
+  std::vector<o2::pmr::vector<char>> buffers;
+  std::vector<std::map<std::string, std::string>> headers;
+  const std::map<std::string, std::string> metadata;
+  const long timestamp = 1650000000000;
+};
+
+void BM_LoadFileToMemory(benchmark::State& state)
+{
+  getServer().setLatency(state.range(1));
+  Conditions cond(state.range(0));
+  const auto connections = getServer().getConnections();
+  for (auto _ : state) {
+    cond.clear();
+    for (size_t i = 0; i < cond.paths.size(); i++) {
+      cond.api.loadFileToMemory(cond.buffers[i], cond.paths[i], cond.metadata, cond.timestamp, &cond.headers[i], "", "", "");
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * cond.paths.size());
+  state.counters["connections"] = benchmark::Counter(getServer().getConnections() - connections, benchmark::Counter::kAvgIterations);
+}
+
+void BM_LoadFilesToMemory(benchmark::State& state)
+{
+  getServer().setLatency(state.range(1));
+  Conditions cond(state.range(0));
+  const auto connections = getServer().getConnections();
+  std::vector<CcdbApi::LoadRequest> requests;
+  for (size_t i = 0; i < cond.paths.size(); i++) {
+    requests.push_back({&cond.buffers[i], cond.paths[i], cond.metadata, cond.timestamp, &cond.headers[i], ""});
+  }
+  for (auto _ : state) {
+    cond.clear();
+    cond.api.loadFilesToMemory(requests, "", "");
+  }
+  state.SetItemsProcessed(state.iterations() * cond.paths.size());
+  state.counters["connections"] = benchmark::Counter(getServer().getConnections() - connections, benchmark::Counter::kAvgIterations);
+}
+
+void loadArgs(benchmark::internal::Benchmark* b)
+{
+  for (int latency : {1, 10, 50}) {
+    for (int nObjects : {8, 32}) {
+      b->Args({nObjects, latency});
+    }
+  }
+  b->ArgNames({"objects", "latencyMS"});
+}
+} // namespace
+
+BENCHMARK(BM_LoadFileToMemory)->Apply(loadArgs)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_LoadFilesToMemory)->Apply(loadArgs)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+BENCHMARK_MAIN();
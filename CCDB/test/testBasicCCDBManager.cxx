@@ -51,6 +51,7 @@ BOOST_AUTO_TEST_CASE(TestBasicCCDBManager)
   cdb.setURL(uri);
   cdb.setTimestamp((start + stop) / 2);
   cdb.setCaching(true);
+  cdb.setCacheMemoryBudget(1024 * 1024); // keep the versions of several time slots
 
   auto* objA = cdb.get<std::string>(pathA); // will be loaded from scratch and fill the cache
   LOG(info) << "1st reading of A: " << *objA;
@@ -82,6 +83,15 @@ BOOST_AUTO_TEST_CASE(TestBasicCCDBManager)
   LOG(info) << "Reading of A for different time slost, expect non-cached object: " << *objA;
   BOOST_CHECK(objA && (*objA) == ccdbObjN); // make sure correct object is loaded
 
+  // the version of the 1st time slot is still cached
+  const auto notModified = cdb.getCacheStats().notModified;
+  objA = cdb.getForTimeStamp<std::string>(pathA, (start + stop) / 2); // should get the cached and hacked object of the 1st slot
+  LOG(info) << "Reading of A for the 1st time slot, expect cached and modified value: " << *objA;
+  BOOST_CHECK(objA && (*objA) == hack);
+  BOOST_CHECK(cdb.getCacheStats().notModified == notModified + 1);
+  objA = cdb.getForTimeStamp<std::string>(pathA, stop + (stop - start) / 2); // should get the cached object of the 2nd slot
+  BOOST_CHECK(objA && (*objA) == ccdbObjN);
+
   // clear specific object cache
   cdb.clearCache(pathA);
   objA = cdb.get<std::string>(pathA); // will be loaded from scratch and fill the cache
@@ -0,0 +1,123 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   testCCDBObjectCache.cxx
+/// \brief  Test the versions, validity lookup and LRU eviction of the CCDBObjectCache
+///
+
+#define BOOST_TEST_MODULE CCDB
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include "CCDB/CCDBObjectCache.h"
+#include <boost/test/unit_test.hpp>
+#include <string>
+
+using namespace o2::ccdb;
+
+namespace
+{
+int gNAlive = 0; // number of cached objects which were not deleted
+
+struct Counted {
+  Counted(std::string v) : value(v) { gNAlive++; }
+  ~Counted() { gNAlive--; }
+  std::string value;
+};
+
+CCDBObjectCache::CachedObject makeObject(std::string const& value, long start, long end, size_t size = 100)
+{
+  CCDBObjectCache::CachedObject obj;
+  obj.objPtr = std::make_shared<Counted>(value);
+  obj.uuid = value;
+  obj.startvalidity = start;
+  obj.endvalidity = end;
+  obj.size = size;
+  return obj;
+}
+
+std::string getValue(CCDBObjectCache::CachedObject* obj)
+{
+  return obj ? static_cast<Counted*>(obj->get())->value : "";
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(TestCCDBObjectCacheVersions)
+{
+  CCDBObjectCache cache;
+  BOOST_CHECK(cache.getMemoryBudget() == 0); // keeping several versions is opt-in
+  cache.setMemoryBudget(1024 * 1024);
+  cache.insert("A", makeObject("A0", 1000, 2000));
+  cache.insert("A", makeObject("A1", 2000, 3000));
+  cache.insert("B", makeObject("B0", 1000, 3000));
+
+  BOOST_CHECK(getValue(cache.find("A", 1500)) == "A0");
+  BOOST_CHECK(getValue(cache.find("A", 2500)) == "A1");
+  BOOST_CHECK(cache.find("A", 3500) == nullptr);
+  BOOST_CHECK(cache.find("A", 500) == nullptr);
+  BOOST_CHECK(cache.find("C", 1500) == nullptr);
+  BOOST_CHECK(cache.isValid("B", 2500));
+  BOOST_CHECK(getValue(cache.getCurrent("A")) == "A1");
+  BOOST_CHECK(cache.getNObjects() == 3 && cache.getSize() == 300);
+
+  // returning a cached version makes it the current one
+  cache.use("A", *cache.find("A", 1500), true);
+  BOOST_CHECK(getValue(cache.getCurrent("A")) == "A0");
+  BOOST_CHECK(cache.getStats().notModified == 1 && cache.getStats().misses == 3);
+
+  // a new version replaces the overlapping ones
+  cache.insert("A", makeObject("A2", 1500, 2500));
+  BOOST_CHECK(getValue(cache.find("A", 1700)) == "A2");
+  BOOST_CHECK(cache.find("A", 2700) == nullptr);
+  BOOST_CHECK(cache.find("A", 1200) == nullptr);
+  BOOST_CHECK(cache.getNObjects() == 2 && gNAlive == 2);
+
+  // same start of validity
+  cache.insert("A", makeObject("A3", 1500, 1600));
+  BOOST_CHECK(getValue(cache.find("A", 1550)) == "A3");
+  BOOST_CHECK(cache.getNObjects() == 2 && gNAlive == 2);
+
+  cache.clear("A");
+  BOOST_CHECK(cache.getCurrent("A") == nullptr);
+  BOOST_CHECK(cache.getNObjects() == 1 && cache.getSize() == 100 && gNAlive == 1);
+  cache.clear();
+  BOOST_CHECK(cache.getNObjects() == 0 && cache.getSize() == 0 && gNAlive == 0);
+}
+
+BOOST_AUTO_TEST_CASE(TestCCDBObjectCacheEviction)
+{
+  CCDBObjectCache cache;
+  cache.setMemoryBudget(350);
+  for (int i = 0; i < 3; i++) {
+    cache.insert("A", makeObject("A" + std::to_string(i), 1000 * i, 1000 * (i + 1)));
+  }
+  BOOST_CHECK(cache.getNObjects() == 3);
+
+  // the least recently used version is evicted
+  cache.use("A", *cache.find("A", 500), false);
+  cache.insert("B", makeObject("B0", 0, 1000));
+  BOOST_CHECK(cache.getNObjects() == 3 && cache.getSize() == 300);
+  BOOST_CHECK(cache.find("A", 1500) == nullptr);
+  BOOST_CHECK(getValue(cache.find("A", 500)) == "A0");
+  BOOST_CHECK(getValue(cache.find("A", 2500)) == "A2");
+  BOOST_CHECK(cache.getStats().evictions == 1 && cache.getStats().bytesEvicted == 100 && cache.getStats().hits == 1);
+  BOOST_CHECK(gNAlive == 3);
+
+  // with a budget of 0 the current version of each path is kept
+  cache.setMemoryBudget(0);
+  BOOST_CHECK(cache.getNObjects() == 2);
+  BOOST_CHECK(getValue(cache.getCurrent("A")) == "A0");
+  BOOST_CHECK(getValue(cache.getCurrent("B")) == "B0");
+  cache.insert("A", makeObject("A3", 3000, 4000));
+  BOOST_CHECK(cache.getNObjects() == 2 && getValue(cache.getCurrent("A")) == "A3");
+  BOOST_CHECK(gNAlive == 2);
+}
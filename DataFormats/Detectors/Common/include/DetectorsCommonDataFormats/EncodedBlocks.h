@@ -17,9 +17,14 @@
 #ifndef ALICEO2_ENCODED_BLOCKS_H
 #define ALICEO2_ENCODED_BLOCKS_H
 #undef NDEBUG
+#include <algorithm>
 #include <cassert>
 #include <type_traits>
 #include <cstddef>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <numeric>
 #include <Rtypes.h>
 #include "rANS/rans.h"
 #include "rANS/utils.h"
@@ -95,10 +100,18 @@ inline size_t calculatePaddedSize(size_t nElems) noexcept
 ///>>======================== Auxiliary classes =======================>>
 
 struct ANSHeader {
+  // version 0.x: rANS with 2 interleaved states (LiteralEncoder64/LiteralDecoder64)
+  // version 1.x: rANS with (8 << x) interleaved states (InterleavedEncoder64/InterleavedDecoder64), x <= 2
+  static constexpr uint8_t InterleavedMajorVersion = 1;
+  static constexpr uint8_t MaxInterleavedMinorVersion = 2;
+
   uint8_t majorVersion;
   uint8_t minorVersion;
 
   void clear() { majorVersion = minorVersion = 0; }
+  /// number of interleaved rANS states used for entropy encoding, 0 for the 2-state LiteralEncoder format
+  int getNInterleavedStreams() const { return majorVersion == InterleavedMajorVersion ? (8 << minorVersion) : 0; }
+  bool isSupported() const { return majorVersion < InterleavedMajorVersion || (majorVersion == InterleavedMajorVersion && minorVersion <= MaxInterleavedMinorVersion); }
   ClassDefNV(ANSHeader, 1);
 };
 
@@ -334,11 +347,102 @@ struct Block {
 
 ///<<======================== Auxiliary classes =======================<<
 
+namespace detail
+{
+
+/// Encoding of a single block, independent of the container it will be stored in: prepare() builds the symbol statistics
+/// and the upper limit for the number of words to write, encode() writes the dictionary followed by the encoded data to
+/// the provided memory. The literals are kept to be stored by the caller behind the data.
+template <typename W>
+class BlockEncoderBase
+{
+ public:
+  BlockEncoderBase(int slot, size_t messageLength) : mSlot(slot), mMessageLength(messageLength) {}
+  virtual ~BlockEncoderBase() = default;
+
+  virtual void prepare() = 0;
+  virtual void encode(W* dest, size_t maxWords, int nInterleavedStreams) = 0;
+  virtual const W* getLiterals() const = 0;
+  /// use provided external encoder built from the dictionary, which is stored in the block, must be called before prepare()
+  virtual void setExternalEncoder(const void* encoderExt, const rans::FrequencyTable* dictionary) = 0;
+  /// add the symbols of the source message to the frequency table
+  virtual void sampleFrequencies(rans::FrequencyTable& frequencyTable) const = 0;
+
+  int getSlot() const { return mSlot; }
+  size_t getMessageLength() const { return mMessageLength; }
+  /// number of words to provide to encode(), valid after prepare()
+  size_t getNReservedWords() const { return mNDictWords + mNMaxDataWords; }
+  int getNDictWords() const { return mNDictWords; }
+  int getNDataWords() const { return mNDataWords; }
+  int getNLiteralWords() const { return mNLiteralWords; }
+  const Metadata& getMetadata() const { return mMetadata; }
+
+ protected:
+  int mSlot = 0;
+  size_t mMessageLength = 0;
+  int mNDictWords = 0;
+  int mNMaxDataWords = 0;
+  int mNDataWords = 0;
+  int mNLiteralWords = 0;
+  Metadata mMetadata;
+};
+
+template <typename input_IT, typename W>
+class BlockEncoder final : public BlockEncoderBase<W>
+{
+ public:
+  using input_t = typename std::iterator_traits<input_IT>::value_type;
+  using ransEncoder_t = typename rans::LiteralEncoder64<input_t>;
+  using ransState_t = typename ransEncoder_t::coder_t;
+  using ransStream_t = typename ransEncoder_t::stream_t;
+
+  // assert at compile time that output types align so that padding is not necessary.
+  static_assert(std::is_same_v<W, ransStream_t>);
+  static_assert(std::is_same_v<W, typename rans::count_t>);
+
+  BlockEncoder(const input_IT srcBegin, const input_IT srcEnd, int slot, uint8_t symbolTablePrecision, Metadata::OptStore opt, const void* encoderExt, float memfc)
+    : BlockEncoderBase<W>(slot, std::distance(srcBegin, srcEnd)), mSrcBegin(srcBegin), mSrcEnd(srcEnd), mSymbolTablePrecision(symbolTablePrecision), mOpt(opt), mEncoderExt(reinterpret_cast<const ransEncoder_t*>(encoderExt)), mMemFactor(memfc) {}
+
+  void prepare() final;
+  void encode(W* dest, size_t maxWords, int nInterleavedStreams) final;
+  const W* getLiterals() const final { return reinterpret_cast<const W*>(mLiterals.data()); }
+  void setExternalEncoder(const void* encoderExt, const rans::FrequencyTable* dictionary) final
+  {
+    mEncoderExt = reinterpret_cast<const ransEncoder_t*>(encoderExt);
+    mDictionaryExt = dictionary;
+  }
+  void sampleFrequencies(rans::FrequencyTable& frequencyTable) const final { frequencyTable.addSamples(mSrcBegin, mSrcEnd); }
+
+ private:
+  const rans::FrequencyTable& getDictionary() const { return mDictionaryExt ? *mDictionaryExt : mFrequencyTable; }
+
+  const input_IT mSrcBegin;
+  const input_IT mSrcEnd;
+  uint8_t mSymbolTablePrecision = 0;
+  Metadata::OptStore mOpt;
+  const ransEncoder_t* mEncoderExt = nullptr;
+  const rans::FrequencyTable* mDictionaryExt = nullptr; // dictionary of the external encoder to store in the block
+  float mMemFactor = 1.f;
+  rans::FrequencyTable mFrequencyTable;
+  std::unique_ptr<ransEncoder_t> mEncoderLoc;
+  std::vector<input_t> mLiterals; // padded to full W words
+};
+
+} // namespace detail
+
+template <typename H, int N, typename W>
+class BlockEncodingBatch;
+
+template <typename H, int N, typename W>
+class BlockDecodingBatch;
+
 template <typename H, int N, typename W = uint32_t>
 class EncodedBlocks
 {
  public:
   typedef EncodedBlocks<H, N, W> base;
+  using EncodingBatch = BlockEncodingBatch<H, N, W>;
+  using DecodingBatch = BlockDecodingBatch<H, N, W>;
 
   void setHeader(const H& h) { mHeader = h; }
   const H& getHeader() const { return mHeader; }
@@ -495,9 +599,82 @@ class EncodedBlocks
   template <typename D>
   static bool readTreeBranch(TTree& tree, const std::string& brname, D& dt, int ev = 0);
 
+  friend class BlockEncodingBatch<H, N, W>;
+
   ClassDefNV(EncodedBlocks, 2);
 };
 
+/// Encoding of several consecutive blocks of the container at once. The blocks registered with add(...) are encoded
+/// independently of each other, each into its own region of the buffer reserved according to its estimated size, so
+/// that the caller may run them concurrently. Afterwards the regions are compacted, the result is the same as for the
+/// consecutive EncodedBlocks::encode calls.
+template <typename H, int N, typename W>
+class BlockEncodingBatch
+{
+ public:
+  /// register vector src to be encoded to the block at provided slot, the data must stay valid until process() is called
+  template <typename VE>
+  void add(const VE& src, int slot, uint8_t symbolTablePrecision, Metadata::OptStore opt, const void* encoderExt = nullptr, float memfc = 1.f)
+  {
+    add(std::begin(src), std::end(src), slot, symbolTablePrecision, opt, encoderExt, memfc);
+  }
+
+  /// register source message to be encoded to the block at provided slot, the data must stay valid until process() is called
+  template <typename input_IT>
+  void add(const input_IT srcBegin, const input_IT srcEnd, int slot, uint8_t symbolTablePrecision, Metadata::OptStore opt, const void* encoderExt = nullptr, float memfc = 1.f)
+  {
+    mEncoders.emplace_back(std::make_unique<detail::BlockEncoder<input_IT, W>>(srcBegin, srcEnd, slot, symbolTablePrecision, opt, encoderExt, memfc));
+  }
+
+  size_t size() const { return mEncoders.size(); }
+  void clear() { mEncoders.clear(); }
+
+  detail::BlockEncoderBase<W>& getEncoder(size_t i) { return *mEncoders[i]; }
+  const detail::BlockEncoderBase<W>& getEncoder(size_t i) const { return *mEncoders[i]; }
+
+  /// encode registered blocks to the container at the head of the buffer (expanded if needed). The runner(n, task) must
+  /// call task(i) for every i < n, possibly concurrently. The block encoders are kept (with their metadata) until clear().
+  template <typename buffer_T, typename runner_T>
+  o2::ctf::CTFIOSize process(buffer_T& buffer, runner_T&& runner);
+
+ private:
+  std::vector<std::unique_ptr<detail::BlockEncoderBase<W>>> mEncoders;
+};
+
+/// Decoding of several blocks of the container at once, the blocks registered with add(...) are decoded independently of
+/// each other, so that the caller may run them concurrently.
+template <typename H, int N, typename W>
+class BlockDecodingBatch
+{
+ public:
+  explicit BlockDecodingBatch(const EncodedBlocks<H, N, W>& container) : mContainer(container) {}
+
+  /// register block at provided slot to be decoded to destination vector (will be resized as needed)
+  template <class container_T, class container_IT = typename container_T::iterator>
+  void add(container_T& dest, int slot, const void* decoderExt = nullptr)
+  {
+    mDecoders.emplace_back(slot, [&ec = mContainer, &dest, slot, decoderExt]() { return ec.decode(dest, slot, decoderExt); });
+  }
+
+  /// register block at provided slot to be decoded to destination pointer, the needed space assumed to be available
+  template <typename D_IT, std::enable_if_t<detail::is_iterator_v<D_IT>, bool> = true>
+  void add(D_IT dest, int slot, const void* decoderExt = nullptr)
+  {
+    mDecoders.emplace_back(slot, [&ec = mContainer, dest, slot, decoderExt]() { return ec.decode(dest, slot, decoderExt); });
+  }
+
+  size_t size() const { return mDecoders.size(); }
+  void clear() { mDecoders.clear(); }
+
+  /// decode registered blocks, the runner(n, task) must call task(i) for every i < n, possibly concurrently
+  template <typename runner_T>
+  o2::ctf::CTFIOSize process(runner_T&& runner);
+
+ private:
+  const EncodedBlocks<H, N, W>& mContainer;
+  std::vector<std::pair<int, std::function<o2::ctf::CTFIOSize()>>> mDecoders;
+};
+
 ///_____________________________________________________________________________
 /// read from tree to non-flat object
 template <typename H, int N, typename W>
@@ -804,11 +981,28 @@ o2::ctf::CTFIOSize EncodedBlocks<H, N, W>::decode(D_IT dest,
         // to D-word array
         literals = std::vector<dest_t>{reinterpret_cast<const dest_t*>(block.getLiterals()), reinterpret_cast<const dest_t*>(block.getLiterals()) + md.nLiterals};
       }
-      decoder->process(block.getData() + block.getNData(), dest, md.messageLength, literals);
+      const auto* const streamEnd = block.getData() + block.getNData();
+      switch (mANSHeader.getNInterleavedStreams()) {
+        case 0:
+          decoder->process(streamEnd, dest, md.messageLength, literals);
+          break;
+        case 8:
+          o2::rans::InterleavedDecoder64<dest_t, 8>::decode(decoder->getSymbolTable(), decoder->getReverseLUT(), streamEnd, dest, md.messageLength, literals);
+          break;
+        case 16:
+          o2::rans::InterleavedDecoder64<dest_t, 16>::decode(decoder->getSymbolTable(), decoder->getReverseLUT(), streamEnd, dest, md.messageLength, literals);
+          break;
+        case 32:
+          o2::rans::InterleavedDecoder64<dest_t, 32>::decode(decoder->getSymbolTable(), decoder->getReverseLUT(), streamEnd, dest, md.messageLength, literals);
+          break;
+        default:
+          LOG(error) << "Unsupported ANS version " << int(mANSHeader.majorVersion) << "." << int(mANSHeader.minorVersion) << " for slot " << slot;
+          throw std::runtime_error("Unsupported ANS version");
+      }
     } else { // data was stored as is
       using destPtr_t = typename std::iterator_traits<D_IT>::pointer;
       destPtr_t srcBegin = reinterpret_cast<destPtr_t>(block.payload);
-      destPtr_t srcEnd = srcBegin + md.messageLength * sizeof(dest_t);
+      destPtr_t srcEnd = srcBegin + md.messageLength;
       std::copy(srcBegin, srcEnd, dest);
       // std::memcpy(dest, block.payload, md.messageLength * sizeof(dest_t));
     }
@@ -828,30 +1022,23 @@ o2::ctf::CTFIOSize EncodedBlocks<H, N, W>::encode(const input_IT srcBegin,
                                                   const void* encoderExt,       // optional external encoder
                                                   float memfc)                  // memory allocation margin factor
 {
-
-  using storageBuffer_t = W;
-  using input_t = typename std::iterator_traits<input_IT>::value_type;
-  using ransEncoder_t = typename rans::LiteralEncoder64<input_t>;
-  using ransState_t = typename ransEncoder_t::coder_t;
-  using ransStream_t = typename ransEncoder_t::stream_t;
-
-  // assert at compile time that output types align so that padding is not necessary.
-  static_assert(std::is_same_v<storageBuffer_t, ransStream_t>);
-  static_assert(std::is_same_v<storageBuffer_t, typename rans::count_t>);
+  // "this" might be invalidated by the storage expansion, cache what is needed from it
+  const int nInterleavedStreams = mANSHeader.getNInterleavedStreams();
+  if (!mANSHeader.isSupported()) {
+    LOG(error) << "Unsupported ANS version " << int(mANSHeader.majorVersion) << "." << int(mANSHeader.minorVersion) << " for slot " << slot;
+    throw std::runtime_error("Unsupported ANS version");
+  }
 
   // fill a new block
   assert(slot == mRegistry.nFilledBlocks);
   mRegistry.nFilledBlocks++;
 
-  const size_t messageLength = std::distance(srcBegin, srcEnd);
-  // cover three cases:
-  // * empty source message: no entropy coding
-  // * source message to pass through without any entropy coding
-  // * source message where entropy coding should be applied
+  detail::BlockEncoder<input_IT, W> blockEncoder{srcBegin, srcEnd, slot, symbolTablePrecision, opt, encoderExt, memfc};
+  blockEncoder.prepare();
 
-  // case 1: empty source message
-  if (messageLength == 0) {
-    mMetadata[slot] = Metadata{0, 0, sizeof(input_t), sizeof(ransState_t), sizeof(ransStream_t), symbolTablePrecision, Metadata::OptStore::NODATA, 0, 0, 0, 0, 0};
+  // empty source message: no entropy coding
+  if (blockEncoder.getMessageLength() == 0) {
+    mMetadata[slot] = blockEncoder.getMetadata();
     return {};
   }
 
@@ -874,92 +1061,224 @@ o2::ctf::CTFIOSize EncodedBlocks<H, N, W>::encode(const input_IT srcBegin,
     }
   };
 
-  // case 3: message where entropy coding should be applied
-  if (opt == Metadata::OptStore::EENCODE) {
-    // build symbol statistics
-    constexpr size_t SizeEstMarginAbs = 10 * 1024;
-    const float SizeEstMarginRel = 1.5 * memfc;
+  // preliminary expansion of storage based on dict size + estimated size of encode buffer,
+  // then directly encode source message (or copy it, if no entropy coding is requested) into block buffer
+  expandStorage(blockEncoder.getNReservedWords());
+  W* const blockBufferBegin = thisBlock->getCreatePayload();
+  blockEncoder.encode(blockBufferBegin, thisBlock->registry->getFreeSize() / sizeof(W), nInterleavedStreams); // note: "this" might be not valid after expandStorage call!!!
+  thisBlock->setNDict(blockEncoder.getNDictWords());
+  thisBlock->setNData(blockEncoder.getNDataWords());
+  thisBlock->realignBlock();
+  LOGP(debug, "StoreDict {} bytes, offs: {}:{}", thisBlock->getNDict() * sizeof(W), thisBlock->getOffsDict(), thisBlock->getOffsDict() + thisBlock->getNDict() * sizeof(W));
+  LOGP(debug, "StoreData {} bytes, offs: {}:{}", thisBlock->getNData() * sizeof(W), thisBlock->getOffsData(), thisBlock->getOffsData() + thisBlock->getNData() * sizeof(W));
+
+  // store incompressible symbols if any
+  if (blockEncoder.getNLiteralWords()) {
+    expandStorage(blockEncoder.getNLiteralWords());
+    thisBlock->storeLiterals(blockEncoder.getNLiteralWords(), blockEncoder.getLiterals());
+    LOGP(debug, "StoreLiterals {} bytes, offs: {}:{}", thisBlock->getNLiterals() * sizeof(W), thisBlock->getOffsLiterals(), thisBlock->getOffsLiterals() + thisBlock->getNLiterals() * sizeof(W));
+  }
 
-    const auto [inplaceEncoder, frequencyTable] = [&]() {
-      if (encoderExt) {
-        return std::make_tuple(ransEncoder_t{}, rans::FrequencyTable{});
-      } else {
-        rans::FrequencyTable frequencyTable = rans::makeFrequencyTableFromSamples(srcBegin, srcEnd);
-        RenormedFrequencyTable renormedFrequencyTable = rans::renorm(frequencyTable, symbolTablePrecision);
-        return std::make_tuple(ransEncoder_t{renormedFrequencyTable}, frequencyTable);
-      }
-    }();
-    ransEncoder_t const* const encoder = encoderExt ? reinterpret_cast<ransEncoder_t const* const>(encoderExt) : &inplaceEncoder;
+  *thisMetadata = blockEncoder.getMetadata();
+  return {0, thisMetadata->getUncompressedSize(), thisMetadata->getCompressedSize()};
+}
 
+///_____________________________________________________________________________
+template <typename input_IT, typename W>
+void detail::BlockEncoder<input_IT, W>::prepare()
+{
+  const size_t messageLength = this->mMessageLength;
+  // cover three cases:
+  // * empty source message: no entropy coding
+  // * source message to pass through without any entropy coding
+  // * source message where entropy coding should be applied
+  if (messageLength == 0) {
+    this->mMetadata = Metadata{0, 0, sizeof(input_t), sizeof(ransState_t), sizeof(ransStream_t), mSymbolTablePrecision, Metadata::OptStore::NODATA, 0, 0, 0, 0, 0};
+  } else if (mOpt == Metadata::OptStore::EENCODE) {
+    // build symbol statistics
+    constexpr size_t SizeEstMarginAbs = 10 * 1024;
+    const float SizeEstMarginRel = 1.5 * mMemFactor;
+    if (!mEncoderExt) {
+      mFrequencyTable = rans::makeFrequencyTableFromSamples(mSrcBegin, mSrcEnd);
+      mEncoderLoc = std::make_unique<ransEncoder_t>(rans::renorm(mFrequencyTable, mSymbolTablePrecision));
+    }
+    const ransEncoder_t* const encoder = mEncoderExt ? mEncoderExt : mEncoderLoc.get();
     // estimate size of encode buffer
     int dataSize = rans::calculateMaxBufferSize(messageLength, encoder->getAlphabetRangeBits(), sizeof(input_t)); // size in bytes
-    // preliminary expansion of storage based on dict size + estimated size of encode buffer
-    dataSize = SizeEstMarginAbs + int(SizeEstMarginRel * (dataSize / sizeof(storageBuffer_t))) + (sizeof(input_t) < sizeof(storageBuffer_t)); // size in words of output stream
-    expandStorage(frequencyTable.size() + dataSize);
+    this->mNMaxDataWords = SizeEstMarginAbs + int(SizeEstMarginRel * (dataSize / sizeof(W))) + (sizeof(input_t) < sizeof(W)); // size in words of output stream
+    this->mNDictWords = getDictionary().size();
+  } else { // store original data w/o EEncoding
+    this->mNMaxDataWords = calculateNDestTElements<input_t, W>(messageLength);
+  }
+}
+
+///_____________________________________________________________________________
+template <typename input_IT, typename W>
+void detail::BlockEncoder<input_IT, W>::encode(W* dest, size_t maxWords, int nInterleavedStreams)
+{
+  const size_t messageLength = this->mMessageLength;
+  if (messageLength == 0) {
+    return;
+  }
+  if (mOpt == Metadata::OptStore::EENCODE) {
+    const ransEncoder_t* const encoder = mEncoderExt ? mEncoderExt : mEncoderLoc.get();
     // store dictionary first
-    if (!frequencyTable.empty()) {
-      thisBlock->storeDict(frequencyTable.size(), frequencyTable.data());
-      LOGP(debug, "StoreDict {} bytes, offs: {}:{}", frequencyTable.size() * sizeof(W), thisBlock->getOffsDict(), thisBlock->getOffsDict() + frequencyTable.size() * sizeof(W));
+    if (this->mNDictWords) {
+      std::memcpy(dest, getDictionary().data(), this->mNDictWords * sizeof(W));
     }
-    // vector of incompressible literal symbols
-    std::vector<input_t> literals;
-    // directly encode source message into block buffer.
-    storageBuffer_t* const blockBufferBegin = thisBlock->getCreateData();
-    const size_t maxBufferSize = thisBlock->registry->getFreeSize(); // note: "this" might be not valid after expandStorage call!!!
-    const auto encodedMessageEnd = encoder->process(srcBegin, srcEnd, blockBufferBegin, literals);
-    rans::utils::checkBounds(encodedMessageEnd, blockBufferBegin + maxBufferSize / sizeof(W));
-    dataSize = encodedMessageEnd - thisBlock->getDataPointer();
-    thisBlock->setNData(dataSize);
-    thisBlock->realignBlock();
-    LOGP(debug, "StoreData {} bytes, offs: {}:{}", dataSize * sizeof(W), thisBlock->getOffsData(), thisBlock->getOffsData() + dataSize * sizeof(W));
-    // update the size claimed by encode message directly inside the block
-
-    // store incompressible symbols if any
-    const size_t nLiteralSymbols = literals.size();
-    const size_t nLiteralWords = [&]() {
-      if (!literals.empty()) {
-        const size_t nSymbols = literals.size();
-        // introduce padding in case literals don't align;
-        const size_t nLiteralSymbolsPadded = calculatePaddedSize<input_t, storageBuffer_t>(nSymbols);
-        literals.resize(nLiteralSymbolsPadded, {});
-
-        const size_t nLiteralStorageElems = calculateNDestTElements<input_t, storageBuffer_t>(nSymbols);
-        expandStorage(nLiteralStorageElems);
-        thisBlock->storeLiterals(nLiteralStorageElems, reinterpret_cast<const storageBuffer_t*>(literals.data()));
-        LOGP(debug, "StoreLiterals {} bytes, offs: {}:{}", nLiteralStorageElems * sizeof(W), thisBlock->getOffsLiterals(), thisBlock->getOffsLiterals() + nLiteralStorageElems * sizeof(W));
-        return nLiteralStorageElems;
+    W* const dataBegin = dest + this->mNDictWords;
+    const auto encodedMessageEnd = [&]() {
+      switch (nInterleavedStreams) {
+        case 8:
+          return rans::InterleavedEncoder64<input_t, 8>::encode(encoder->getSymbolTable(), mSrcBegin, mSrcEnd, dataBegin, mLiterals);
+        case 16:
+          return rans::InterleavedEncoder64<input_t, 16>::encode(encoder->getSymbolTable(), mSrcBegin, mSrcEnd, dataBegin, mLiterals);
+        case 32:
+          return rans::InterleavedEncoder64<input_t, 32>::encode(encoder->getSymbolTable(), mSrcBegin, mSrcEnd, dataBegin, mLiterals);
+        default:
+          return encoder->process(mSrcBegin, mSrcEnd, dataBegin, mLiterals);
       }
-      return size_t(0);
     }();
+    rans::utils::checkBounds(encodedMessageEnd, dest + maxWords);
+    this->mNDataWords = encodedMessageEnd - dataBegin;
+
+    // incompressible symbols, if any, are stored in W words behind the data
+    const size_t nLiteralSymbols = mLiterals.size();
+    if (nLiteralSymbols) {
+      // introduce padding in case literals don't align;
+      mLiterals.resize(calculatePaddedSize<input_t, W>(nLiteralSymbols), {});
+      this->mNLiteralWords = calculateNDestTElements<input_t, W>(nLiteralSymbols);
+    }
 
-    *thisMetadata = Metadata{messageLength,
-                             nLiteralSymbols,
-                             sizeof(input_t),
-                             sizeof(ransState_t),
-                             sizeof(ransStream_t),
-                             static_cast<uint8_t>(encoder->getSymbolTablePrecision()),
-                             opt,
-                             encoder->getMinSymbol(),
-                             encoder->getMaxSymbol(),
-                             static_cast<int32_t>(frequencyTable.size()),
-                             dataSize,
-                             static_cast<int32_t>(nLiteralWords)};
+    this->mMetadata = Metadata{messageLength,
+                               nLiteralSymbols,
+                               sizeof(input_t),
+                               sizeof(ransState_t),
+                               sizeof(ransStream_t),
+                               static_cast<uint8_t>(encoder->getSymbolTablePrecision()),
+                               mOpt,
+                               encoder->getMinSymbol(),
+                               encoder->getMaxSymbol(),
+                               this->mNDictWords,
+                               this->mNDataWords,
+                               this->mNLiteralWords};
   } else { // store original data w/o EEncoding
-    // FIXME(milettri): we should be able to do without an intermediate vector;
-    //  provided iterator is not necessarily pointer, need to use intermediate vector!!!
+    // provided iterator is not necessarily pointer, copy element-wise, with the padding of the last word zeroed
+    const size_t nBufferElems = this->mNMaxDataWords;
+    assert(nBufferElems <= maxWords);
+    dest[nBufferElems - 1] = 0;
+    std::copy(mSrcBegin, mSrcEnd, reinterpret_cast<input_t*>(dest));
+    this->mNDataWords = nBufferElems;
+
+    this->mMetadata = Metadata{messageLength, 0, sizeof(input_t), sizeof(ransState_t), sizeof(W), mSymbolTablePrecision, mOpt, 0, 0, 0, static_cast<int>(nBufferElems), 0};
+  }
+}
 
-    // introduce padding in case literals don't align;
-    const size_t nSourceElemsPadded = calculatePaddedSize<input_t, storageBuffer_t>(messageLength);
-    std::vector<input_t> tmp(nSourceElemsPadded, {});
-    std::copy(srcBegin, srcEnd, std::begin(tmp));
+///_____________________________________________________________________________
+template <typename H, int N, typename W>
+template <typename buffer_T, typename runner_T>
+o2::ctf::CTFIOSize BlockEncodingBatch<H, N, W>::process(buffer_T& buffer, runner_T&& runner)
+{
+  using container_t = EncodedBlocks<H, N, W>;
+  o2::ctf::CTFIOSize iosize;
+  const int nBlocks = mEncoders.size();
+  if (!nBlocks) {
+    return iosize;
+  }
+  auto* ec = container_t::get(buffer.data());
+  const int nInterleavedStreams = ec->mANSHeader.getNInterleavedStreams();
+  if (!ec->mANSHeader.isSupported()) {
+    LOG(error) << "Unsupported ANS version " << int(ec->mANSHeader.majorVersion) << "." << int(ec->mANSHeader.minorVersion);
+    throw std::runtime_error("Unsupported ANS version");
+  }
+  std::stable_sort(mEncoders.begin(), mEncoders.end(), [](const auto& a, const auto& b) { return a->getSlot() < b->getSlot(); });
+  for (int i = 0; i < nBlocks; i++) {
+    if (mEncoders[i]->getSlot() != ec->mRegistry.nFilledBlocks + i) {
+      LOG(error) << "Block for slot " << mEncoders[i]->getSlot() << " is added to the batch while slot " << ec->mRegistry.nFilledBlocks + i << " is expected";
+      throw std::runtime_error("blocks must be filled consecutively");
+    }
+  }
+  // run the largest blocks first to balance the load of the runner
+  std::vector<int> order(nBlocks);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [this](int a, int b) { return mEncoders[a]->getMessageLength() > mEncoders[b]->getMessageLength(); });
+
+  // symbol statistics and size estimates
+  runner(nBlocks, [&](size_t i) { mEncoders[order[i]]->prepare(); });
+
+  // reserve consecutive regions for all blocks, in bytes wrt the head
+  std::vector<size_t> regionOffs(nBlocks + 1);
+  regionOffs[0] = ec->mRegistry.offsFreeStart;
+  for (int i = 0; i < nBlocks; i++) {
+    regionOffs[i + 1] = regionOffs[i] + Block<W>::estimateSize(mEncoders[i]->getNReservedWords());
+  }
+  if (regionOffs[nBlocks] > ec->size()) {
+    LOG(debug) << "Free size: " << ec->getFreeSize() << ", need " << regionOffs[nBlocks] - regionOffs[0] << " for " << nBlocks << " blocks";
+    container_t::expand(buffer, regionOffs[nBlocks]);
+  }
 
-    const size_t nBufferElems = calculateNDestTElements<input_t, storageBuffer_t>(messageLength);
-    expandStorage(nBufferElems);
-    thisBlock->storeData(nBufferElems, reinterpret_cast<const storageBuffer_t*>(tmp.data()));
+  char* head = reinterpret_cast<char*>(buffer.data());
+  runner(nBlocks, [&](size_t i) {
+    const int ib = order[i];
+    mEncoders[ib]->encode(reinterpret_cast<W*>(head + regionOffs[ib]), (regionOffs[ib + 1] - regionOffs[ib]) / sizeof(W), nInterleavedStreams);
+  });
 
-    *thisMetadata = Metadata{messageLength, 0, sizeof(input_t), sizeof(ransState_t), sizeof(storageBuffer_t), symbolTablePrecision, opt, 0, 0, 0, static_cast<int>(nBufferElems), 0};
+  // compactify: move every block to the end of the previous one and append its literals
+  size_t finalSize = regionOffs[0];
+  for (const auto& enc : mEncoders) {
+    finalSize += Block<W>::estimateSize(enc->getNDictWords() + enc->getNDataWords() + enc->getNLiteralWords());
   }
-  return {0, thisMetadata->getUncompressedSize(), thisMetadata->getCompressedSize()};
+  if (finalSize > container_t::get(buffer.data())->size()) { // possible only with many literals
+    container_t::expand(buffer, finalSize);
+    head = reinterpret_cast<char*>(buffer.data());
+  }
+  ec = container_t::get(buffer.data());
+  std::vector<std::vector<W>> stash(nBlocks); // copies of the blocks which would be overwritten by the literals of the preceding ones
+  int firstStashed = nBlocks;
+  for (int i = 0; i < nBlocks; i++) {
+    const auto& enc = *mEncoders[i];
+    const int slot = enc.getSlot();
+    ec->mRegistry.nFilledBlocks++;
+    ec->mMetadata[slot] = enc.getMetadata();
+    if (enc.getMessageLength() == 0) {
+      continue;
+    }
+    const size_t nPayload = enc.getNDictWords() + enc.getNDataWords();
+    const size_t nStored = nPayload + enc.getNLiteralWords();
+    if (i + 1 < firstStashed && ec->mRegistry.offsFreeStart + nStored * sizeof(W) > regionOffs[i + 1]) {
+      for (int j = i + 1; j < nBlocks; j++) {
+        const auto* src = reinterpret_cast<const W*>(head + regionOffs[j]);
+        stash[j].assign(src, src + mEncoders[j]->getNDictWords() + mEncoders[j]->getNDataWords());
+      }
+      firstStashed = i + 1;
+    }
+    const W* src = i < firstStashed ? reinterpret_cast<const W*>(head + regionOffs[i]) : stash[i].data();
+    auto& block = ec->mBlocks[slot];
+    block.setNDict(enc.getNDictWords());
+    block.setNData(enc.getNDataWords());
+    block.setNLiterals(enc.getNLiteralWords());
+    W* dest = block.getCreatePayload();
+    std::memmove(dest, src, nPayload * sizeof(W)); // regions may overlap
+    if (enc.getNLiteralWords()) {
+      std::memcpy(dest + nPayload, enc.getLiterals(), enc.getNLiteralWords() * sizeof(W));
+    }
+    block.realignBlock();
+    iosize += o2::ctf::CTFIOSize{0, enc.getMetadata().getUncompressedSize(), enc.getMetadata().getCompressedSize()};
+  }
+  return iosize;
+}
+
+///_____________________________________________________________________________
+template <typename H, int N, typename W>
+template <typename runner_T>
+o2::ctf::CTFIOSize BlockDecodingBatch<H, N, W>::process(runner_T&& runner)
+{
+  // run the largest blocks first to balance the load of the runner
+  std::stable_sort(mDecoders.begin(), mDecoders.end(), [&ec = mContainer](const auto& a, const auto& b) { return ec.getMetadata(a.first).messageLength > ec.getMetadata(b.first).messageLength; });
+  std::vector<o2::ctf::CTFIOSize> sizes(mDecoders.size());
+  runner(mDecoders.size(), [&](size_t i) { sizes[i] = mDecoders[i].second(); });
+  mDecoders.clear();
+  return std::accumulate(sizes.begin(), sizes.end(), o2::ctf::CTFIOSize{});
 }
 
 /// create a special EncodedBlocks containing only dictionaries made from provided vector of frequency tables
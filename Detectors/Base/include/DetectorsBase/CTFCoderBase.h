@@ -16,6 +16,9 @@
 #ifndef _ALICEO2_CTFCODER_BASE_H_
 #define _ALICEO2_CTFCODER_BASE_H_
 
+#include <functional>
+#include <future>
+#include <limits>
 #include <memory>
 #include <TFile.h>
 #include <TTree.h>
@@ -25,6 +28,7 @@
 #include "DetectorsCommonDataFormats/CTFDictHeader.h"
 #include "DetectorsCommonDataFormats/CTFHeader.h"
 #include "DetectorsCommonDataFormats/CTFIOSize.h"
+#include "DetectorsCommonDataFormats/EncodedBlocks.h"
 #include "rANS/rans.h"
 #include <filesystem>
 #include "Framework/InitContext.h"
@@ -53,8 +57,8 @@ class CTFCoderBase
                             Decoder };
 
   CTFCoderBase() = delete;
-  CTFCoderBase(int n, DetID det, float memFactor = 1.f) : mCoders(n), mDet(det), mMemMarginFactor(memFactor > 1.f ? memFactor : 1.f) {}
-  CTFCoderBase(OpType op, int n, DetID det, float memFactor = 1.f) : mOpType(op), mCoders(n), mDet(det), mMemMarginFactor(memFactor > 1.f ? memFactor : 1.f) {}
+  CTFCoderBase(int n, DetID det, float memFactor = 1.f) : mCoders(n), mDictRefresh(n), mDet(det), mMemMarginFactor(memFactor > 1.f ? memFactor : 1.f) {}
+  CTFCoderBase(OpType op, int n, DetID det, float memFactor = 1.f) : mOpType(op), mCoders(n), mDictRefresh(n), mDet(det), mMemMarginFactor(memFactor > 1.f ? memFactor : 1.f) {}
   virtual ~CTFCoderBase() = default;
 
   virtual void createCoders(const std::vector<char>& bufVec, o2::ctf::CTFCoderBase::OpType op) = 0;
@@ -78,6 +82,10 @@ class CTFCoderBase
     switch (op) {
       case OpType::Encoder:
         mCoders[slot].reset(new o2::rans::LiteralEncoder64<S>(renormedFrequencyTable));
+        // the refreshed dictionary is renormed to the precision of the one it replaces
+        mDictRefresh[slot].factory = [renormingBits = renormedFrequencyTable.getRenormingBits()](const o2::rans::FrequencyTable& frequencyTable) {
+          return std::shared_ptr<void>(new o2::rans::LiteralEncoder64<S>(o2::rans::renorm(frequencyTable, renormingBits)));
+        };
         break;
       case OpType::Decoder:
         mCoders[slot].reset(new o2::rans::LiteralDecoder64<S>(renormedFrequencyTable));
@@ -98,6 +106,39 @@ class CTFCoderBase
   void setVerbosity(int v) { mVerbosity = v; }
   int getVerbosity() const { return mVerbosity; }
 
+  void setNThreads(int n) { mNThreads = n > 1 ? n : 1; }
+  int getNThreads() const { return mNThreads; }
+
+  /// version of the ANS coder used for encoding, "major.minor": 0.1 for 2 interleaved rANS states, 1.x for (8 << x)
+  void setANSVersion(const std::string& version);
+  const ANSHeader& getANSVersion() const { return mANSVersion; }
+
+  /// number of TFs over which the symbols are sampled for the refresh of the external dictionary, 0 = no refresh
+  void setDictRefreshNTF(int n) { mDictRefreshNTF = n > 0 ? n : 0; }
+  int getDictRefreshNTF() const { return mDictRefreshNTF; }
+
+  /// min. relative size reduction expected from the refreshed dictionary to use it
+  void setDictRefreshMinGain(float v) { mDictRefreshMinGain = v > 0.f ? v : 0.f; }
+  float getDictRefreshMinGain() const { return mDictRefreshMinGain; }
+
+  /// number of refreshed dictionaries put in use so far
+  int getNDictRefreshes() const { return mNDictRefreshes; }
+
+  /// tells if a dictionary built from the sample of nTF TFs, which took currentBytes with the dictionary in use, and
+  /// stored with every TF, is expected to reduce the size by more than the minGain fraction. Provides the expected size.
+  static bool isDictRefreshWorth(const o2::rans::FrequencyTable& sample, size_t currentBytes, int nTF, float minGain, double& expected);
+
+  /// encode blocks registered in the batch to the CTF buffer, using up to getNThreads() threads
+  template <typename BATCH, typename BUF>
+  o2::ctf::CTFIOSize encodeBlocks(BATCH& batch, BUF& buffer);
+
+  /// decode blocks registered in the batch, using up to getNThreads() threads
+  template <typename BATCH>
+  o2::ctf::CTFIOSize decodeBlocks(BATCH& batch) const
+  {
+    return batch.process([this](size_t n, const std::function<void(size_t)>& task) { runConcurrently(n, task); });
+  }
+
   const CTFDictHeader& getExtDictHeader() const { return mExtHeader; }
 
   template <typename T>
@@ -122,7 +163,30 @@ class CTFCoderBase
 
   void checkDictVersion(const CTFDictHeader& h) const;
 
+  /// call task(i) for i in [0, n), concurrently if more than 1 thread is allowed
+  void runConcurrently(size_t n, const std::function<void(size_t)>& task) const;
+
+  // adaptive refresh of the external dictionary: the symbols of the slots encoded with the external dictionary are
+  // sampled over mDictRefreshNTF TFs. If the entropy of the sample plus the cost of storing the dictionary in every
+  // TF is sufficiently below the size produced by the current dictionary, an encoder is rebuilt from the sample in
+  // the background and used for the following TFs. Its dictionary is stored in the blocks, so that the decoding
+  // needs no external dictionary for them.
+  struct RefreshedDict {
+    std::shared_ptr<void> encoder;
+    std::shared_ptr<const o2::rans::FrequencyTable> dictionary;
+  };
+  struct DictRefresh {
+    std::function<std::shared_ptr<void>(const o2::rans::FrequencyTable&)> factory; // creates encoder of the slot type, set for external dictionary only
+    o2::rans::FrequencyTable sample; // symbols of the current window
+    size_t nSampledBytes = 0;        // encoded size of the sampled symbols with the current dictionary
+    RefreshedDict active;            // if set, used instead of the external encoder
+    std::future<RefreshedDict> pending;
+  };
+  void installRefreshedDictionaries();
+  void checkDictRefresh();
+
   std::vector<std::shared_ptr<void>> mCoders; // encoders/decoders
+  std::vector<DictRefresh> mDictRefresh;      // per slot
   DetID mDet;
   CTFDictHeader mExtHeader;      // external dictionary header
   o2::utils::IRFrameSelector mIRFrameSelector; // optional IR frames selector
@@ -130,8 +194,46 @@ class CTFCoderBase
   bool mLoadDictFromCCDB{true};
   OpType mOpType; // Encoder or Decoder
   int mVerbosity = 0;
+  int mNThreads = 1; // number of threads for concurrent encoding/decoding of the blocks
+  ANSHeader mANSVersion{0, 1}; // ANS version written by the encoder
+  int mDictRefreshNTF = 0;          // 0 = no adaptive refresh of the external dictionary
+  int mDictRefreshTFCounter = 0;
+  int mNDictRefreshes = 0;
+  float mDictRefreshMinGain = 0.05; // refresh if the encoded size is expected to shrink by at least this fraction
 };
 
+///________________________________
+template <typename BATCH, typename BUF>
+o2::ctf::CTFIOSize CTFCoderBase::encodeBlocks(BATCH& batch, BUF& buffer)
+{
+  auto runner = [this](size_t n, const std::function<void(size_t)>& task) { runConcurrently(n, task); };
+  if (!mDictRefreshNTF) {
+    return batch.process(buffer, runner);
+  }
+  installRefreshedDictionaries();
+  for (size_t i = 0; i < batch.size(); i++) {
+    auto& enc = batch.getEncoder(i);
+    const auto& active = mDictRefresh[enc.getSlot()].active;
+    if (active.encoder) {
+      enc.setExternalEncoder(active.encoder.get(), active.dictionary.get());
+    }
+  }
+  auto iosize = batch.process(buffer, runner);
+  runner(batch.size(), [this, &batch](size_t i) {
+    const auto& enc = batch.getEncoder(i);
+    auto& dr = mDictRefresh[enc.getSlot()];
+    const auto& md = enc.getMetadata();
+    if (!dr.factory || md.opt != Metadata::OptStore::EENCODE ||
+        dr.sample.getNumSamples() + md.messageLength > std::numeric_limits<o2::rans::count_t>::max()) { // avoid overflow of the counts
+      return;
+    }
+    dr.nSampledBytes += (md.nDataWords + md.nLiteralWords) * md.streamSize;
+    enc.sampleFrequencies(dr.sample);
+  });
+  checkDictRefresh();
+  return iosize;
+}
+
 ///________________________________
 template <typename T>
 bool CTFCoderBase::readFromTree(TTree& tree, const std::string brname, T& dest, int ev)
@@ -223,6 +325,15 @@ void CTFCoderBase::init(o2::framework::InitContext& ic)
   if (ic.options().hasOption("mem-factor")) {
     setMemMarginFactor(ic.options().get<float>("mem-factor"));
   }
+  if (ic.options().hasOption("ctf-threads")) {
+    setNThreads(ic.options().get<int>("ctf-threads"));
+  }
+  if (ic.options().hasOption("ans-version")) {
+    setANSVersion(ic.options().get<std::string>("ans-version"));
+  }
+  if (ic.options().hasOption("ctf-dict-refresh")) {
+    setDictRefreshNTF(ic.options().get<int>("ctf-dict-refresh"));
+  }
   auto dict = ic.options().get<std::string>("ctf-dict");
   if (dict.empty() || dict == "ccdb") { // load from CCDB
     mLoadDictFromCCDB = true;
@@ -89,6 +89,10 @@ class MatLayerCylSet : public o2::gpu::FlatObject
     // get material budget traversed on the line between point0 and point1
     return getMatBudget(point0.X(), point0.Y(), point0.Z(), point1.X(), point1.Y(), point1.Z());
   }
+
+  /// get material budgets of n segments points0[i]:points1[i] to budgets[i]. The segments are traversed ordered in
+  /// the range of layers they cross, so that consecutive traversals access the cells of the same layers
+  void getMatBudget(const math_utils::Point3D<float>* points0, const math_utils::Point3D<float>* points1, MatBudget* budgets, int n) const;
 #endif // !GPUCA_ALIGPUCODE
   GPUd() MatBudget getMatBudget(float x0, float y0, float z0, float x1, float y1, float z1) const;
 
@@ -114,6 +118,9 @@ class MatLayerCylSet : public o2::gpu::FlatObject
   static constexpr size_t getBufferAlignmentBytes() { return 8; }
 #endif // !GPUCA_GPUCODE
 
+ private:
+  GPUd() MatBudget traverseLayers(Ray& ray, short lmin, short lmax) const;
+
   ClassDefNV(MatLayerCylSet, 1);
 };
 
@@ -17,6 +17,13 @@
 #include "Framework/ControlService.h"
 #include "Framework/ProcessingContext.h"
 #include "Framework/InputRecord.h"
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/partitioner.h>
+#include <tbb/task_arena.h>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
 
 using namespace o2::ctf;
 using namespace o2::framework;
@@ -45,9 +52,95 @@ void CTFCoderBase::assignDictVersion(CTFDictHeader& h) const
   //  }
 }
 
+void CTFCoderBase::setANSVersion(const std::string& version)
+{
+  unsigned int major = 0, minor = 0;
+  char tail = 0;
+  if (std::sscanf(version.c_str(), "%u.%u%c", &major, &minor, &tail) != 2 || major > 255 || minor > 255) {
+    throw std::runtime_error(fmt::format("Invalid ANS version {}, expected major.minor", version));
+  }
+  ANSHeader h{uint8_t(major), uint8_t(minor)};
+  if (!h.isSupported()) {
+    throw std::runtime_error(fmt::format("ANS version {} is not supported", version));
+  }
+  mANSVersion = h;
+}
+
 void CTFCoderBase::updateTimeDependentParams(ProcessingContext& pc)
 {
   if (mLoadDictFromCCDB) {
     pc.inputs().get<std::vector<char>*>("ctfdict"); // just to trigger the finaliseCCDB
   }
 }
+
+void CTFCoderBase::runConcurrently(size_t n, const std::function<void(size_t)>& task) const
+{
+  if (mNThreads < 2 || n < 2) {
+    for (size_t i = 0; i < n; i++) {
+      task(i);
+    }
+    return;
+  }
+  // blocks are few and of very different size, schedule them one by one in the order provided by the caller
+  tbb::task_arena arena(std::min(size_t(mNThreads), n));
+  arena.execute([&]() {
+    tbb::parallel_for(
+      tbb::blocked_range<size_t>(0, n, 1), [&task](const tbb::blocked_range<size_t>& r) {
+        for (auto i = r.begin(); i != r.end(); ++i) {
+          task(i);
+        }
+      },
+      tbb::simple_partitioner());
+  });
+}
+
+void CTFCoderBase::installRefreshedDictionaries()
+{
+  for (size_t slot = 0; slot < mDictRefresh.size(); slot++) {
+    auto& dr = mDictRefresh[slot];
+    if (dr.pending.valid() && dr.pending.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+      dr.active = dr.pending.get();
+      mNDictRefreshes++;
+      LOGP(info, "{}using refreshed dictionary of {} words for slot {}", getPrefix(), dr.active.dictionary->size(), slot);
+    }
+  }
+}
+
+bool CTFCoderBase::isDictRefreshWorth(const o2::rans::FrequencyTable& sample, size_t currentBytes, int nTF, float minGain, double& expected)
+{
+  // expected size with the dictionary fitted to the sample: its entropy + the dictionary stored with every TF
+  const double nSamples = sample.getNumSamples();
+  double entropyBits = 0.;
+  for (auto freq : sample) {
+    if (freq) {
+      entropyBits += freq * std::log2(nSamples / freq);
+    }
+  }
+  const size_t dictBytesPerTF = sizeof(o2::rans::count_t) * sample.size();
+  expected = entropyBits / 8 + dictBytesPerTF * nTF;
+  return currentBytes > (1. + minGain) * expected;
+}
+
+void CTFCoderBase::checkDictRefresh()
+{
+  if (++mDictRefreshTFCounter < mDictRefreshNTF) {
+    return;
+  }
+  mDictRefreshTFCounter = 0;
+  for (size_t slot = 0; slot < mDictRefresh.size(); slot++) {
+    auto& dr = mDictRefresh[slot];
+    if (dr.nSampledBytes && !dr.pending.valid()) {
+      const size_t current = dr.nSampledBytes + (dr.active.dictionary ? sizeof(o2::rans::count_t) * dr.active.dictionary->size() * mDictRefreshNTF : 0);
+      double expected = 0.;
+      if (isDictRefreshWorth(dr.sample, current, mDictRefreshNTF, mDictRefreshMinGain, expected)) {
+        LOGP(info, "{}slot {}: {} bytes in last {} TFs, refreshed dictionary expected to give {:.0f} ({:.1f}% gain), rebuilding",
+             getPrefix(), slot, current, mDictRefreshNTF, expected, 100. * (current - expected) / current);
+        dr.pending = std::async(std::launch::async, [factory = dr.factory, dict = std::make_shared<const o2::rans::FrequencyTable>(std::move(dr.sample))]() {
+          return RefreshedDict{factory(*dict), dict};
+        });
+      }
+    }
+    dr.sample = o2::rans::FrequencyTable{};
+    dr.nSampledBytes = 0;
+  }
+}
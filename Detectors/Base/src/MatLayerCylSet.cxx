@@ -20,6 +20,8 @@
 #include "GPUCommonLogger.h"
 #include <TFile.h>
 #include "CommonUtils/TreeStreamRedirector.h"
+#include <algorithm>
+#include <vector>
 //#define _DBG_LOC_ // for local debugging only
 
 #endif // !GPUCA_ALIGPUCODE
@@ -248,13 +250,21 @@ std::size_t MatLayerCylSet::estimateFlatBufferSize() const
 GPUd() MatBudget MatLayerCylSet::getMatBudget(float x0, float y0, float z0, float x1, float y1, float z1) const
 {
   // get material budget traversed on the line between point0 and point1
-  MatBudget rval;
   Ray ray(x0, y0, z0, x1, y1, z1);
   short lmin, lmax; // get innermost and outermost relevant layer
   if (ray.isTooShort() || !getLayersRange(ray, lmin, lmax)) {
+    MatBudget rval;
     rval.length = ray.getDist();
     return rval;
   }
+  return traverseLayers(ray, lmin, lmax);
+}
+
+//_________________________________________________________________________________________________
+GPUd() MatBudget MatLayerCylSet::traverseLayers(Ray& ray, short lmin, short lmax) const
+{
+  // accumulate material budget of the ray in the layers lmin:lmax
+  MatBudget rval;
   short lrID = lmax;
   while (lrID >= lmin) { // go from outside to inside
     const auto& lr = getLayer(lrID);
@@ -369,6 +379,39 @@ GPUd() MatBudget MatLayerCylSet::getMatBudget(float x0, float y0, float z0, floa
   return rval;
 }
 
+#ifndef GPUCA_ALIGPUCODE // this part is unvisible on GPU version
+
+//_________________________________________________________________________________________________
+void MatLayerCylSet::getMatBudget(const math_utils::Point3D<float>* points0, const math_utils::Point3D<float>* points1, MatBudget* budgets, int n) const
+{
+  // get material budgets of n segments, the segments crossing the layers are traversed ordered in their layers range
+  struct Segment {
+    Ray ray;
+    int id;
+    short lmin, lmax;
+  };
+  std::vector<Segment> segments;
+  segments.reserve(n);
+  for (int i = 0; i < n; i++) {
+    Ray ray(points0[i], points1[i]);
+    short lmin, lmax;
+    if (ray.isTooShort() || !getLayersRange(ray, lmin, lmax)) {
+      budgets[i] = MatBudget();
+      budgets[i].length = ray.getDist();
+      continue;
+    }
+    segments.push_back({ray, i, lmin, lmax});
+  }
+  std::sort(segments.begin(), segments.end(), [](const Segment& a, const Segment& b) {
+    return a.lmax == b.lmax ? a.lmin > b.lmin : a.lmax > b.lmax;
+  });
+  for (auto& seg : segments) {
+    budgets[seg.id] = traverseLayers(seg.ray, seg.lmin, seg.lmax);
+  }
+}
+
+#endif // !GPUCA_ALIGPUCODE
+
 //_________________________________________________________________________________________________
 GPUd() bool MatLayerCylSet::getLayersRange(const Ray& ray, short& lmin, short& lmax) const
 {
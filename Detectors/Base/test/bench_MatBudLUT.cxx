@@ -0,0 +1,116 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+///
+/// \file bench_MatBudLUT.cxx
+/// \brief getMatBudget calls/s of the material LUT: single and batched queries
+///
+
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "CommonConstants/MathConstants.h"
+#include "DetectorsBase/MatLayerCylSet.h"
+#include "ReconstructionDataFormats/Track.h"
+
+namespace
+{
+using Point = o2::math_utils::Point3D<float>;
+
+// LUT is read from the file given by the MATBUD_LUT environment variable, matbud.root by default
+const o2::base::MatLayerCylSet* getLUT()
+{
+  static std::unique_ptr<o2::base::MatLayerCylSet> lut([]() {
+    const char* fname = std::getenv("MATBUD_LUT");
+    return o2::base::MatLayerCylSet::loadFromFile(fname ? fname : "matbud.root");
+  }());
+  return lut.get();
+}
+
+// Segments of the propagation of primary tracks with 2 cm steps through the LUT range, as done by the
+// Propagator::propagateToX. The range argument is the number of tracks.
+struct Segments {
+  Segments(int nTracks, float rMax)
+  {
+    constexpr float Bz = 5.f, MaxStep = 2.f;
+    std::mt19937 rng{0};
+    std::uniform_real_distribution<float> uni{0.f, 1.f};
+    std::normal_distribution<float> gaus{0.f, 1.f};
+    std::exponential_distribution<float> ptDist{2.f};
+    for (int it = 0; it < nTracks; it++) {
+      const float phi = o2::constants::math::TwoPI * uni(rng), pt = 0.15f + ptDist(rng);
+      std::array<float, 5> params{0.01f * gaus(rng), 5.f * gaus(rng), 0.f, gaus(rng), (uni(rng) > 0.5f ? 1.f : -1.f) / pt};
+      o2::track::TrackPar trc(0.f, phi, params);
+      while (trc.getX() < rMax) {
+        const auto xyz0 = trc.getXYZGlo();
+        if (!trc.propagateParamTo(trc.getX() + MaxStep, Bz) || std::abs(trc.getSnp()) > 0.85f) {
+          break;
+        }
+        points0.push_back(xyz0);
+        points1.push_back(trc.getXYZGlo());
+      }
+    }
+    budgets.resize(points0.size());
+  }
+  std::vector<Point> points0, points1;
+  std::vector<o2::base::MatBudget> budgets;
+};
+
+bool checkLUT(benchmark::State& state)
+{
+  if (!getLUT()) {
+    state.SkipWithError("material LUT is not available, set MATBUD_LUT");
+    return false;
+  }
+  return true;
+}
+
+void BM_MatBudget(benchmark::State& state)
+{
+  if (!checkLUT(state)) {
+    return;
+  }
+  const auto* lut = getLUT();
+  Segments seg(state.range(0), lut->getRMax());
+  for (auto _ : state) {
+    for (size_t i = 0; i < seg.points0.size(); i++) {
+      seg.budgets[i] = lut->getMatBudget(seg.points0[i], seg.points1[i]);
+    }
+    benchmark::DoNotOptimize(seg.budgets.data());
+  }
+  state.SetItemsProcessed(state.iterations() * seg.points0.size());
+}
+
+void BM_MatBudgetBatch(benchmark::State& state)
+{
+  if (!checkLUT(state)) {
+    return;
+  }
+  const auto* lut = getLUT();
+  Segments seg(state.range(0), lut->getRMax());
+  for (auto _ : state) {
+    lut->getMatBudget(seg.points0.data(), seg.points1.data(), seg.budgets.data(), seg.points0.size());
+    benchmark::DoNotOptimize(seg.budgets.data());
+  }
+  state.SetItemsProcessed(state.iterations() * seg.points0.size());
+}
+} // namespace
+
+BENCHMARK(BM_MatBudget)->RangeMultiplier(8)->Range(1 << 6, 1 << 12)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_MatBudgetBatch)->RangeMultiplier(8)->Range(1 << 6, 1 << 12)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
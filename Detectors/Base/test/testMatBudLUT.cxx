@@ -15,6 +15,11 @@
 #include <boost/test/unit_test.hpp>
 
 #include "buildMatBudLUT.C"
+#include <TRandom.h>
+#include <TMath.h>
+#include <cmath>
+#include <memory>
+#include <vector>
 
 namespace o2
 {
@@ -25,6 +30,30 @@ BOOST_AUTO_TEST_CASE(MatBudLUT)
   BOOST_CHECK(buildMatBudLUT(2, 20)); // generate LUT
   BOOST_CHECK(testMBLUT());           // test LUT manipulations
 
+#endif //!GPUCA_ALIGPUCODE
+}
+
+BOOST_AUTO_TEST_CASE(MatBudLUTQueries)
+{
+#ifndef GPUCA_ALIGPUCODE // this part is unvisible on GPU version
+
+  // batched queries must give the same budgets as the single ones
+  std::unique_ptr<o2::base::MatLayerCylSet> lut(o2::base::MatLayerCylSet::loadFromFile("matbud.root"));
+  BOOST_REQUIRE(lut);
+  const int nSeg = 1000;
+  std::vector<o2::math_utils::Point3D<float>> p0, p1;
+  for (int i = 0; i < nSeg; i++) {
+    float phi = gRandom->Rndm() * 2. * TMath::Pi(), r = gRandom->Rndm() * lut->getRMax(), z = (gRandom->Rndm() - 0.5) * lut->getZMax();
+    p0.emplace_back(r * std::cos(phi), r * std::sin(phi), z);
+    p1.emplace_back(p0.back().X() + 10. * (gRandom->Rndm() - 0.5), p0.back().Y() + 10. * (gRandom->Rndm() - 0.5), z + gRandom->Rndm());
+  }
+  std::vector<o2::base::MatBudget> budgets(nSeg);
+  lut->getMatBudget(p0.data(), p1.data(), budgets.data(), nSeg);
+  for (int i = 0; i < nSeg; i++) {
+    auto mb = lut->getMatBudget(p0[i], p1[i]);
+    BOOST_CHECK(mb.meanRho == budgets[i].meanRho && mb.meanX2X0 == budgets[i].meanX2X0 && mb.length == budgets[i].length);
+  }
+
 #endif //!GPUCA_ALIGPUCODE
 }
 } // namespace o2
@@ -106,21 +106,22 @@ o2::ctf::CTFIOSize CTFCoder::encode_impl(VEC& buff, const gsl::span<const Trigge
 
   ec->setHeader(helper.createHeader());
   assignDictVersion(static_cast<o2::ctf::CTFDictHeader&>(ec->getHeader()));
-  ec->getANSHeader().majorVersion = 0;
-  ec->getANSHeader().minorVersion = 1;
+  ec->setANSHeader(mANSVersion);
   // at every encoding the buffer might be autoexpanded, so we don't work with fixed pointer ec
   o2::ctf::CTFIOSize iosize;
-#define ENCODECPV(beg, end, slot, bits) CTF::get(buff.data())->encode(beg, end, int(slot), bits, optField[int(slot)], &buff, mCoders[int(slot)].get(), getMemMarginFactor());
+  CTF::EncodingBatch batch;
+#define ENCODECPV(beg, end, slot, bits) batch.add(beg, end, int(slot), bits, optField[int(slot)], mCoders[int(slot)].get(), getMemMarginFactor());
   // clang-format off
-  iosize += ENCODECPV(helper.begin_bcIncTrig(),    helper.end_bcIncTrig(),     CTF::BLC_bcIncTrig,    0);
-  iosize += ENCODECPV(helper.begin_orbitIncTrig(), helper.end_orbitIncTrig(),  CTF::BLC_orbitIncTrig, 0);
-  iosize += ENCODECPV(helper.begin_entriesTrig(),  helper.end_entriesTrig(),   CTF::BLC_entriesTrig,  0);
-
-  iosize += ENCODECPV(helper.begin_posX(),        helper.end_posX(),           CTF::BLC_posX,         0);
-  iosize += ENCODECPV(helper.begin_posZ(),        helper.end_posZ(),           CTF::BLC_posZ,         0);
-  iosize += ENCODECPV(helper.begin_energy(),      helper.end_energy(),         CTF::BLC_energy,       0);
-  iosize += ENCODECPV(helper.begin_status(),      helper.end_status(),         CTF::BLC_status,       0);
+  ENCODECPV(helper.begin_bcIncTrig(),    helper.end_bcIncTrig(),     CTF::BLC_bcIncTrig,    0);
+  ENCODECPV(helper.begin_orbitIncTrig(), helper.end_orbitIncTrig(),  CTF::BLC_orbitIncTrig, 0);
+  ENCODECPV(helper.begin_entriesTrig(),  helper.end_entriesTrig(),   CTF::BLC_entriesTrig,  0);
+
+  ENCODECPV(helper.begin_posX(),        helper.end_posX(),           CTF::BLC_posX,         0);
+  ENCODECPV(helper.begin_posZ(),        helper.end_posZ(),           CTF::BLC_posZ,         0);
+  ENCODECPV(helper.begin_energy(),      helper.end_energy(),         CTF::BLC_energy,       0);
+  ENCODECPV(helper.begin_status(),      helper.end_status(),         CTF::BLC_status,       0);
   // clang-format on
+  iosize += encodeBlocks(batch, buff);
   CTF::get(buff.data())->print(getPrefix(), mVerbosity);
   finaliseCTFOutput<CTF>(buff);
   iosize.rawIn = trigData.size() * sizeof(TriggerRecord) + cluData.size() * sizeof(Cluster);
@@ -139,15 +140,17 @@ o2::ctf::CTFIOSize CTFCoder::decode(const CTF::base& ec, VTRG& trigVec, VCLUSTER
   std::vector<uint8_t> energy, status;
 
   o2::ctf::CTFIOSize iosize;
-#define DECODECPV(part, slot) ec.decode(part, int(slot), mCoders[int(slot)].get())
+  CTF::DecodingBatch batch(ec);
+#define DECODECPV(part, slot) batch.add(part, int(slot), mCoders[int(slot)].get())
   // clang-format off
-  iosize += DECODECPV(bcInc,       CTF::BLC_bcIncTrig);
-  iosize += DECODECPV(orbitInc,    CTF::BLC_orbitIncTrig);
-  iosize += DECODECPV(entries,     CTF::BLC_entriesTrig);
-  iosize += DECODECPV(posX,        CTF::BLC_posX);
-  iosize += DECODECPV(posZ,        CTF::BLC_posZ);
-  iosize += DECODECPV(energy,      CTF::BLC_energy);
-  iosize += DECODECPV(status,      CTF::BLC_status);
+  DECODECPV(bcInc,       CTF::BLC_bcIncTrig);
+  DECODECPV(orbitInc,    CTF::BLC_orbitIncTrig);
+  DECODECPV(entries,     CTF::BLC_entriesTrig);
+  DECODECPV(posX,        CTF::BLC_posX);
+  DECODECPV(posZ,        CTF::BLC_posZ);
+  DECODECPV(energy,      CTF::BLC_energy);
+  DECODECPV(status,      CTF::BLC_status);
+  iosize += decodeBlocks(batch);
   // clang-format on
   //
   trigVec.clear();
@@ -86,6 +86,9 @@ DataProcessorSpec getEntropyEncoderSpec(bool selIR)
             {{"ctfrep"}, "CPV", "CTFENCREP", 0, Lifetime::Timeframe}},
     AlgorithmSpec{adaptFromTask<EntropyEncoderSpec>(selIR)},
     Options{{"ctf-dict", VariantType::String, "ccdb", {"CTF dictionary: empty or ccdb=CCDB, none=no external dictionary otherwise: local filename"}},
+            {"ctf-threads", VariantType::Int, 1, {"Number of threads for concurrent entropy (de)coding of CTF blocks"}},
+            {"ans-version", VariantType::String, "0.1", {"ANS version to encode with: 0.1 (2 interleaved states) or 1.x (8 << x states)"}},
+            {"ctf-dict-refresh", VariantType::Int, 0, {"If > 0, refresh external dictionary from symbols sampled over this number of TFs, storing it in the CTF"}},
             {"mem-factor", VariantType::Float, 1.f, {"Memory allocation margin factor"}}}};
 }
 
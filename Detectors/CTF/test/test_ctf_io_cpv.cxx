@@ -22,7 +22,10 @@
 #include <TRandom.h>
 #include <TStopwatch.h>
 #include <TSystem.h>
+#include <algorithm>
+#include <chrono>
 #include <cstring>
+#include <thread>
 
 using namespace o2::cpv;
 
@@ -132,3 +135,150 @@ BOOST_AUTO_TEST_CASE(CTFTest)
     BOOST_CHECK(TMath::Abs(zCor - zCdc) < 0.004);
   }
 }
+
+namespace
+{
+void fillClusters(std::vector<TriggerRecord>& triggers, std::vector<Cluster>& clusters, float eMax, int nROF = 1000)
+{
+  triggers.clear();
+  clusters.clear();
+  o2::InteractionRecord ir(0, 0);
+  for (int irof = 0; irof < nROF; irof++) {
+    ir += 1 + gRandom->Integer(200);
+    auto start = clusters.size();
+    int n = 1 + gRandom->Poisson(100);
+    for (int i = n; i--;) {
+      clusters.emplace_back(char(gRandom->Integer(30)), char(2 + gRandom->Integer(3)), char(gRandom->Integer(3)),
+                            72.3 * 2. * (gRandom->Rndm() - 0.5), 63.3 * 2. * (gRandom->Rndm() - 0.5), eMax * gRandom->Rndm());
+    }
+    triggers.emplace_back(ir, start, clusters.size() - start);
+  }
+}
+
+size_t encodedSize(const std::vector<o2::ctf::BufferType>& vec)
+{
+  const auto* ctf = o2::cpv::CTF::get(vec.data());
+  return ctf->size() - ctf->getFreeSize();
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(CTFDictRefreshGainTest)
+{
+  // uniform sample of 256 symbols: 8 bits per symbol are needed whatever the dictionary
+  std::vector<uint8_t> samples(1 << 16);
+  for (size_t i = 0; i < samples.size(); i++) {
+    samples[i] = i & 0xff;
+  }
+  o2::rans::FrequencyTable sample;
+  sample.addSamples(samples.begin(), samples.end());
+  double expected = 0.;
+  BOOST_CHECK(!o2::ctf::CTFCoderBase::isDictRefreshWorth(sample, samples.size(), 1, 0.05, expected));
+  BOOST_CHECK_CLOSE(expected, samples.size() + sizeof(o2::rans::count_t) * sample.size(), 1e-3);
+  BOOST_CHECK(o2::ctf::CTFCoderBase::isDictRefreshWorth(sample, 2 * samples.size(), 1, 0.05, expected));
+  // the dictionary stored with every TF of the window must be paid off
+  BOOST_CHECK(!o2::ctf::CTFCoderBase::isDictRefreshWorth(sample, 2 * samples.size(), 1000, 0.05, expected));
+}
+
+BOOST_AUTO_TEST_CASE(CTFDictRefreshTest)
+{
+  std::vector<TriggerRecord> triggers;
+  std::vector<Cluster> clusters;
+
+  // dictionary trained on low energy clusters only
+  std::vector<o2::ctf::BufferType> vec;
+  fillClusters(triggers, clusters, 100.);
+  {
+    CTFCoder coder(o2::ctf::CTFCoderBase::OpType::Encoder);
+    coder.encode(vec, triggers, clusters);
+  }
+  std::vector<char> dict(vec.begin(), vec.end());
+
+  CTFCoder encoder(o2::ctf::CTFCoderBase::OpType::Encoder);
+  encoder.createCoders(dict, o2::ctf::CTFCoderBase::OpType::Encoder);
+  encoder.setDictRefreshNTF(2);
+  CTFCoder decoder(o2::ctf::CTFCoderBase::OpType::Decoder);
+  decoder.createCoders(dict, o2::ctf::CTFCoderBase::OpType::Decoder);
+
+  // the data drift to the full energy range, most energies become literals of the external dictionary
+  size_t sizeBefore = 0, sizeAfter = 0;
+  for (int itf = 0; itf < 200 && !sizeAfter; itf++) {
+    const bool refreshed = encoder.getNDictRefreshes() > 0;
+    fillClusters(triggers, clusters, 10000.);
+    encoder.encode(vec, triggers, clusters);
+    if (itf == 0) {
+      sizeBefore = encodedSize(vec);
+    } else if (refreshed) {
+      sizeAfter = encodedSize(vec);
+    }
+
+    std::vector<TriggerRecord> triggersD;
+    std::vector<Cluster> clustersD;
+    decoder.decode(o2::cpv::CTF::getImage(vec.data()), triggersD, clustersD);
+    BOOST_REQUIRE(triggersD.size() == triggers.size());
+    BOOST_REQUIRE(clustersD.size() == clusters.size());
+    for (size_t i = 0; i < triggers.size(); i++) {
+      BOOST_CHECK(triggers[i].getBCData() == triggersD[i].getBCData());
+      BOOST_CHECK(triggers[i].getNumberOfObjects() == triggersD[i].getNumberOfObjects());
+    }
+    for (size_t i = 0; i < clusters.size(); i++) {
+      BOOST_CHECK(clusters[i].getMultiplicity() == clustersD[i].getMultiplicity());
+      BOOST_CHECK(clusters[i].getModule() == clustersD[i].getModule());
+      const float eTr = clusters[i].getEnergy();
+      BOOST_CHECK(TMath::Abs(eTr - clustersD[i].getEnergy()) <= std::max(1.f, eTr * (exp(kStepE * eTr) - 1.f)));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(5)); // let the dictionary be rebuilt in the background
+  }
+  LOG(info) << "Encoded size with the external dictionary: " << sizeBefore << ", with the refreshed one: " << sizeAfter;
+  BOOST_REQUIRE(encoder.getNDictRefreshes() > 0);
+  BOOST_CHECK(sizeAfter > 0 && sizeAfter < sizeBefore);
+}
+
+BOOST_AUTO_TEST_CASE(CTFInterleavedANSTest)
+{
+  std::vector<TriggerRecord> triggers;
+  std::vector<Cluster> clusters;
+  fillClusters(triggers, clusters, 10000.);
+
+  // external dictionary, in the Literal coder format of the slots
+  std::vector<o2::ctf::BufferType> vec;
+  {
+    CTFCoder coder(o2::ctf::CTFCoderBase::OpType::Encoder);
+    coder.encode(vec, triggers, clusters);
+  }
+  std::vector<char> dict(vec.begin(), vec.end());
+
+  for (const auto* version : {"1.0", "1.1", "1.2"}) {
+    for (bool extDict : {false, true}) {
+      CTFCoder encoder(o2::ctf::CTFCoderBase::OpType::Encoder);
+      CTFCoder decoder(o2::ctf::CTFCoderBase::OpType::Decoder);
+      if (extDict) {
+        encoder.createCoders(dict, o2::ctf::CTFCoderBase::OpType::Encoder);
+        decoder.createCoders(dict, o2::ctf::CTFCoderBase::OpType::Decoder);
+      }
+      encoder.setANSVersion(version);
+      encoder.encode(vec, triggers, clusters);
+      const auto ctfImage = o2::cpv::CTF::getImage(vec.data());
+      BOOST_CHECK(ctfImage.getANSHeader().majorVersion == o2::ctf::ANSHeader::InterleavedMajorVersion);
+      BOOST_CHECK(ctfImage.getANSHeader().getNInterleavedStreams() == encoder.getANSVersion().getNInterleavedStreams());
+
+      std::vector<TriggerRecord> triggersD;
+      std::vector<Cluster> clustersD;
+      decoder.decode(ctfImage, triggersD, clustersD);
+      BOOST_REQUIRE(triggersD.size() == triggers.size());
+      BOOST_REQUIRE(clustersD.size() == clusters.size());
+      for (size_t i = 0; i < triggers.size(); i++) {
+        BOOST_CHECK(triggers[i].getBCData() == triggersD[i].getBCData());
+        BOOST_CHECK(triggers[i].getNumberOfObjects() == triggersD[i].getNumberOfObjects());
+      }
+      for (size_t i = 0; i < clusters.size(); i++) {
+        BOOST_CHECK(clusters[i].getMultiplicity() == clustersD[i].getMultiplicity());
+        BOOST_CHECK(clusters[i].getModule() == clustersD[i].getModule());
+        const float eTr = clusters[i].getEnergy();
+        BOOST_CHECK(TMath::Abs(eTr - clustersD[i].getEnergy()) <= std::max(1.f, eTr * (exp(kStepE * eTr) - 1.f)));
+      }
+    }
+  }
+  CTFCoder coder(o2::ctf::CTFCoderBase::OpType::Encoder);
+  BOOST_CHECK_THROW(coder.setANSVersion("1.3"), std::runtime_error);
+  BOOST_CHECK_THROW(coder.setANSVersion("1"), std::runtime_error);
+}
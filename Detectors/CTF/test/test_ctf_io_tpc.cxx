@@ -132,4 +132,22 @@ BOOST_AUTO_TEST_CASE(CTFTest)
   // compare with original flat clusters
   BOOST_CHECK(vecIn.size() == bVec.size());
   BOOST_CHECK(memcmp(vecIn.data(), bVec.data(), bVec.size()) == 0);
+
+  // concurrent encoding and decoding of the blocks must give the same result
+  std::vector<o2::ctf::BufferType> vecIOMT;
+  {
+    CTFCoder coder(o2::ctf::CTFCoderBase::OpType::Encoder);
+    coder.setCombineColumns(true);
+    coder.setNThreads(4);
+    coder.encode(vecIOMT, c);
+  }
+  std::vector<char> vecInMT;
+  {
+    CTFCoder coder(o2::ctf::CTFCoderBase::OpType::Decoder);
+    coder.setCombineColumns(true);
+    coder.setNThreads(4);
+    coder.decode(o2::tpc::CTF::getImage(vecIOMT.data()), vecInMT);
+  }
+  BOOST_CHECK(vecInMT.size() == bVec.size());
+  BOOST_CHECK(memcmp(vecInMT.data(), bVec.data(), bVec.size()) == 0);
 }
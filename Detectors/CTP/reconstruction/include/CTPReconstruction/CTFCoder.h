@@ -97,17 +97,18 @@ o2::ctf::CTFIOSize CTFCoder::encode_impl(VEC& buff, const gsl::span<const CTPDig
 
   ec->setHeader(helper.createHeader());
   assignDictVersion(static_cast<o2::ctf::CTFDictHeader&>(ec->getHeader()));
-  ec->getANSHeader().majorVersion = 0;
-  ec->getANSHeader().minorVersion = 1;
+  ec->setANSHeader(mANSVersion);
   // at every encoding the buffer might be autoexpanded, so we don't work with fixed pointer ec
   o2::ctf::CTFIOSize iosize;
-#define ENCODECTP(beg, end, slot, bits) CTF::get(buff.data())->encode(beg, end, int(slot), bits, optField[int(slot)], &buff, mCoders[int(slot)].get(), getMemMarginFactor());
+  CTF::EncodingBatch batch;
+#define ENCODECTP(beg, end, slot, bits) batch.add(beg, end, int(slot), bits, optField[int(slot)], mCoders[int(slot)].get(), getMemMarginFactor());
   // clang-format off
-  iosize += ENCODECTP(helper.begin_bcIncTrig(),    helper.end_bcIncTrig(),     CTF::BLC_bcIncTrig,    0);
-  iosize += ENCODECTP(helper.begin_orbitIncTrig(), helper.end_orbitIncTrig(),  CTF::BLC_orbitIncTrig, 0);
-  iosize += ENCODECTP(helper.begin_bytesInput(),  helper.end_bytesInput(),     CTF::BLC_bytesInput,   0);
-  iosize += ENCODECTP(helper.begin_bytesClass(),  helper.end_bytesClass(),     CTF::BLC_bytesClass,   0);
+  ENCODECTP(helper.begin_bcIncTrig(),    helper.end_bcIncTrig(),     CTF::BLC_bcIncTrig,    0);
+  ENCODECTP(helper.begin_orbitIncTrig(), helper.end_orbitIncTrig(),  CTF::BLC_orbitIncTrig, 0);
+  ENCODECTP(helper.begin_bytesInput(),  helper.end_bytesInput(),     CTF::BLC_bytesInput,   0);
+  ENCODECTP(helper.begin_bytesClass(),  helper.end_bytesClass(),     CTF::BLC_bytesClass,   0);
   // clang-format on
+  iosize += encodeBlocks(batch, buff);
   CTF::get(buff.data())->print(getPrefix(), mVerbosity);
   finaliseCTFOutput<CTF>(buff);
   iosize.rawIn = data.size() * sizeof(CTPDigit);
@@ -126,12 +127,14 @@ o2::ctf::CTFIOSize CTFCoder::decode(const CTF::base& ec, VTRG& data)
   std::vector<uint8_t> bytesInput, bytesClass;
 
   o2::ctf::CTFIOSize iosize;
-#define DECODECTP(part, slot) ec.decode(part, int(slot), mCoders[int(slot)].get())
+  CTF::DecodingBatch batch(ec);
+#define DECODECTP(part, slot) batch.add(part, int(slot), mCoders[int(slot)].get())
   // clang-format off
-  iosize += DECODECTP(bcInc,       CTF::BLC_bcIncTrig);
-  iosize += DECODECTP(orbitInc,    CTF::BLC_orbitIncTrig);
-  iosize += DECODECTP(bytesInput,  CTF::BLC_bytesInput);
-  iosize += DECODECTP(bytesClass,  CTF::BLC_bytesClass);
+  DECODECTP(bcInc,       CTF::BLC_bcIncTrig);
+  DECODECTP(orbitInc,    CTF::BLC_orbitIncTrig);
+  DECODECTP(bytesInput,  CTF::BLC_bytesInput);
+  DECODECTP(bytesClass,  CTF::BLC_bytesClass);
+  iosize += decodeBlocks(batch);
   // clang-format on
   //
   data.clear();
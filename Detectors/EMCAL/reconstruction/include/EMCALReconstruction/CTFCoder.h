@@ -107,23 +107,24 @@ o2::ctf::CTFIOSize CTFCoder::encode_impl(VEC& buff, const gsl::span<const Trigge
 
   ec->setHeader(helper.createHeader());
   assignDictVersion(static_cast<o2::ctf::CTFDictHeader&>(ec->getHeader()));
-  ec->getANSHeader().majorVersion = 0;
-  ec->getANSHeader().minorVersion = 1;
+  ec->setANSHeader(mANSVersion);
   // at every encoding the buffer might be autoexpanded, so we don't work with fixed pointer ec
   o2::ctf::CTFIOSize iosize;
-#define ENCODEEMC(beg, end, slot, bits) CTF::get(buff.data())->encode(beg, end, int(slot), bits, optField[int(slot)], &buff, mCoders[int(slot)].get(), getMemMarginFactor());
+  CTF::EncodingBatch batch;
+#define ENCODEEMC(beg, end, slot, bits) batch.add(beg, end, int(slot), bits, optField[int(slot)], mCoders[int(slot)].get(), getMemMarginFactor());
   // clang-format off
-  iosize += ENCODEEMC(helper.begin_bcIncTrig(),    helper.end_bcIncTrig(),     CTF::BLC_bcIncTrig,    0);
-  iosize += ENCODEEMC(helper.begin_orbitIncTrig(), helper.end_orbitIncTrig(),  CTF::BLC_orbitIncTrig, 0);
-  iosize += ENCODEEMC(helper.begin_entriesTrig(),  helper.end_entriesTrig(),   CTF::BLC_entriesTrig,  0);
-
-  iosize += ENCODEEMC(helper.begin_towerID(),     helper.end_towerID(),      CTF::BLC_towerID,     0);
-  iosize += ENCODEEMC(helper.begin_time(),        helper.end_time(),         CTF::BLC_time,        0);
-  iosize += ENCODEEMC(helper.begin_energy(),      helper.end_energy(),       CTF::BLC_energy,      0);
-  iosize += ENCODEEMC(helper.begin_status(),      helper.end_status(),       CTF::BLC_status,      0);
+  ENCODEEMC(helper.begin_bcIncTrig(),    helper.end_bcIncTrig(),     CTF::BLC_bcIncTrig,    0);
+  ENCODEEMC(helper.begin_orbitIncTrig(), helper.end_orbitIncTrig(),  CTF::BLC_orbitIncTrig, 0);
+  ENCODEEMC(helper.begin_entriesTrig(),  helper.end_entriesTrig(),   CTF::BLC_entriesTrig,  0);
+
+  ENCODEEMC(helper.begin_towerID(),     helper.end_towerID(),      CTF::BLC_towerID,     0);
+  ENCODEEMC(helper.begin_time(),        helper.end_time(),         CTF::BLC_time,        0);
+  ENCODEEMC(helper.begin_energy(),      helper.end_energy(),       CTF::BLC_energy,      0);
+  ENCODEEMC(helper.begin_status(),      helper.end_status(),       CTF::BLC_status,      0);
   // extra slot was added in the end
-  iosize += ENCODEEMC(helper.begin_trigger(),  helper.end_trigger(),         CTF::BLC_trigger,     0);
+  ENCODEEMC(helper.begin_trigger(),  helper.end_trigger(),         CTF::BLC_trigger,     0);
   // clang-format on
+  iosize += encodeBlocks(batch, buff);
   CTF::get(buff.data())->print(getPrefix(), mVerbosity);
   finaliseCTFOutput<CTF>(buff);
   iosize.rawIn = sizeof(TriggerRecord) * trigData.size() + sizeof(Cell) * cellData.size();
@@ -142,18 +143,20 @@ o2::ctf::CTFIOSize CTFCoder::decode(const CTF::base& ec, VTRG& trigVec, VCELL& c
   std::vector<uint8_t> status;
 
   o2::ctf::CTFIOSize iosize;
-#define DECODEEMCAL(part, slot) ec.decode(part, int(slot), mCoders[int(slot)].get())
+  CTF::DecodingBatch batch(ec);
+#define DECODEEMCAL(part, slot) batch.add(part, int(slot), mCoders[int(slot)].get())
   // clang-format off
-  iosize += DECODEEMCAL(bcInc,       CTF::BLC_bcIncTrig);
-  iosize += DECODEEMCAL(orbitInc,    CTF::BLC_orbitIncTrig);
-  iosize += DECODEEMCAL(entries,     CTF::BLC_entriesTrig);
-  iosize += DECODEEMCAL(tower,       CTF::BLC_towerID);
-
-  iosize += DECODEEMCAL(cellTime,    CTF::BLC_time);
-  iosize += DECODEEMCAL(energy,      CTF::BLC_energy);
-  iosize += DECODEEMCAL(status,      CTF::BLC_status);
+  DECODEEMCAL(bcInc,       CTF::BLC_bcIncTrig);
+  DECODEEMCAL(orbitInc,    CTF::BLC_orbitIncTrig);
+  DECODEEMCAL(entries,     CTF::BLC_entriesTrig);
+  DECODEEMCAL(tower,       CTF::BLC_towerID);
+
+  DECODEEMCAL(cellTime,    CTF::BLC_time);
+  DECODEEMCAL(energy,      CTF::BLC_energy);
+  DECODEEMCAL(status,      CTF::BLC_status);
   // extra slot was added in the end
-  iosize += DECODEEMCAL(trigger,     CTF::BLC_trigger);
+  DECODEEMCAL(trigger,     CTF::BLC_trigger);
+  iosize += decodeBlocks(batch);
   // triggers were added later, in old data they are absent:
   if (trigger.empty()) {
     trigger.resize(header.nTriggers);
@@ -101,22 +101,23 @@ o2::ctf::CTFIOSize CTFCoder::encode(VEC& buff, const gsl::span<const Digit>& dig
 
   ec->setHeader(cd.header);
   assignDictVersion(static_cast<o2::ctf::CTFDictHeader&>(ec->getHeader()));
-  ec->getANSHeader().majorVersion = 0;
-  ec->getANSHeader().minorVersion = 1;
+  ec->setANSHeader(mANSVersion);
   // at every encoding the buffer might be autoexpanded, so we don't work with fixed pointer ec
   o2::ctf::CTFIOSize iosize;
-#define ENCODEFDD(part, slot, bits) CTF::get(buff.data())->encode(part, int(slot), bits, optField[int(slot)], &buff, mCoders[int(slot)].get(), getMemMarginFactor());
+  CTF::EncodingBatch batch;
+#define ENCODEFDD(part, slot, bits) batch.add(part, int(slot), bits, optField[int(slot)], mCoders[int(slot)].get(), getMemMarginFactor());
   // clang-format off
-  iosize += ENCODEFDD(cd.trigger,   CTF::BLC_trigger,  0);
-  iosize += ENCODEFDD(cd.bcInc,     CTF::BLC_bcInc,    0);
-  iosize += ENCODEFDD(cd.orbitInc,  CTF::BLC_orbitInc, 0);
-  iosize += ENCODEFDD(cd.nChan,     CTF::BLC_nChan,    0);
+  ENCODEFDD(cd.trigger,   CTF::BLC_trigger,  0);
+  ENCODEFDD(cd.bcInc,     CTF::BLC_bcInc,    0);
+  ENCODEFDD(cd.orbitInc,  CTF::BLC_orbitInc, 0);
+  ENCODEFDD(cd.nChan,     CTF::BLC_nChan,    0);
 
-  iosize += ENCODEFDD(cd.idChan ,   CTF::BLC_idChan,   0);
-  iosize += ENCODEFDD(cd.time,      CTF::BLC_time,     0);
-  iosize += ENCODEFDD(cd.charge,    CTF::BLC_charge,   0);
-  iosize += ENCODEFDD(cd.feeBits,   CTF::BLC_feeBits,  0);
+  ENCODEFDD(cd.idChan ,   CTF::BLC_idChan,   0);
+  ENCODEFDD(cd.time,      CTF::BLC_time,     0);
+  ENCODEFDD(cd.charge,    CTF::BLC_charge,   0);
+  ENCODEFDD(cd.feeBits,   CTF::BLC_feeBits,  0);
   // clang-format on
+  iosize += encodeBlocks(batch, buff);
   CTF::get(buff.data())->print(getPrefix(), mVerbosity);
   finaliseCTFOutput<CTF>(buff);
   iosize.rawIn = sizeof(Digit) * digitVec.size() + sizeof(ChannelData) * channelVec.size();
@@ -133,17 +134,19 @@ o2::ctf::CTFIOSize CTFCoder::decode(const CTF::base& ec, VDIG& digitVec, VCHAN&
   checkDictVersion(hd);
   ec.print(getPrefix(), mVerbosity);
   o2::ctf::CTFIOSize iosize;
-#define DECODEFDD(part, slot) ec.decode(part, int(slot), mCoders[int(slot)].get())
+  CTF::DecodingBatch batch(ec);
+#define DECODEFDD(part, slot) batch.add(part, int(slot), mCoders[int(slot)].get())
   // clang-format off
-  iosize += DECODEFDD(cd.trigger,   CTF::BLC_trigger);
-  iosize += DECODEFDD(cd.bcInc,     CTF::BLC_bcInc);
-  iosize += DECODEFDD(cd.orbitInc,  CTF::BLC_orbitInc);
-  iosize += DECODEFDD(cd.nChan,     CTF::BLC_nChan);
+  DECODEFDD(cd.trigger,   CTF::BLC_trigger);
+  DECODEFDD(cd.bcInc,     CTF::BLC_bcInc);
+  DECODEFDD(cd.orbitInc,  CTF::BLC_orbitInc);
+  DECODEFDD(cd.nChan,     CTF::BLC_nChan);
 
-  iosize += DECODEFDD(cd.idChan,    CTF::BLC_idChan);
-  iosize += DECODEFDD(cd.time,      CTF::BLC_time);
-  iosize += DECODEFDD(cd.charge,    CTF::BLC_charge);
-  iosize += DECODEFDD(cd.feeBits,   CTF::BLC_feeBits);
+  DECODEFDD(cd.idChan,    CTF::BLC_idChan);
+  DECODEFDD(cd.time,      CTF::BLC_time);
+  DECODEFDD(cd.charge,    CTF::BLC_charge);
+  DECODEFDD(cd.feeBits,   CTF::BLC_feeBits);
+  iosize += decodeBlocks(batch);
   // clang-format on
   //
   if (hd.minorVersion == 0 && hd.majorVersion == 1) {
@@ -102,22 +102,23 @@ o2::ctf::CTFIOSize CTFCoder::encode(VEC& buff, const gsl::span<const Digit>& dig
 
   ec->setHeader(cd.header);
   assignDictVersion(static_cast<o2::ctf::CTFDictHeader&>(ec->getHeader()));
-  ec->getANSHeader().majorVersion = 0;
-  ec->getANSHeader().minorVersion = 1;
+  ec->setANSHeader(mANSVersion);
   // at every encoding the buffer might be autoexpanded, so we don't work with fixed pointer ec
   o2::ctf::CTFIOSize iosize;
-#define ENCODEFT0(part, slot, bits) CTF::get(buff.data())->encode(part, int(slot), bits, optField[int(slot)], &buff, mCoders[int(slot)].get(), getMemMarginFactor());
+  CTF::EncodingBatch batch;
+#define ENCODEFT0(part, slot, bits) batch.add(part, int(slot), bits, optField[int(slot)], mCoders[int(slot)].get(), getMemMarginFactor());
   // clang-format off
-  iosize += ENCODEFT0(cd.trigger,     CTF::BLC_trigger,  0);
-  iosize += ENCODEFT0(cd.bcInc,       CTF::BLC_bcInc,    0);
-  iosize += ENCODEFT0(cd.orbitInc,    CTF::BLC_orbitInc, 0);
-  iosize += ENCODEFT0(cd.nChan,       CTF::BLC_nChan,    0);
-  iosize += ENCODEFT0(cd.eventStatus, CTF::BLC_status,   0);
-  iosize += ENCODEFT0(cd.idChan ,     CTF::BLC_idChan,   0);
-  iosize += ENCODEFT0(cd.qtcChain,    CTF::BLC_qtcChain, 0);
-  iosize += ENCODEFT0(cd.cfdTime,     CTF::BLC_cfdTime,  0);
-  iosize += ENCODEFT0(cd.qtcAmpl,     CTF::BLC_qtcAmpl,  0);
+  ENCODEFT0(cd.trigger,     CTF::BLC_trigger,  0);
+  ENCODEFT0(cd.bcInc,       CTF::BLC_bcInc,    0);
+  ENCODEFT0(cd.orbitInc,    CTF::BLC_orbitInc, 0);
+  ENCODEFT0(cd.nChan,       CTF::BLC_nChan,    0);
+  ENCODEFT0(cd.eventStatus, CTF::BLC_status,   0);
+  ENCODEFT0(cd.idChan ,     CTF::BLC_idChan,   0);
+  ENCODEFT0(cd.qtcChain,    CTF::BLC_qtcChain, 0);
+  ENCODEFT0(cd.cfdTime,     CTF::BLC_cfdTime,  0);
+  ENCODEFT0(cd.qtcAmpl,     CTF::BLC_qtcAmpl,  0);
   // clang-format on
+  iosize += encodeBlocks(batch, buff);
   CTF::get(buff.data())->print(getPrefix(), mVerbosity);
   finaliseCTFOutput<CTF>(buff);
   iosize.rawIn = sizeof(Digit) * digitVec.size() + sizeof(ChannelData) * channelVec.size();
@@ -134,17 +135,19 @@ o2::ctf::CTFIOSize CTFCoder::decode(const CTF::base& ec, VDIG& digitVec, VCHAN&
   checkDictVersion(hd);
   ec.print(getPrefix(), mVerbosity);
   o2::ctf::CTFIOSize iosize;
-#define DECODEFT0(part, slot) ec.decode(part, int(slot), mCoders[int(slot)].get())
+  CTF::DecodingBatch batch(ec);
+#define DECODEFT0(part, slot) batch.add(part, int(slot), mCoders[int(slot)].get())
   // clang-format off
-  iosize += DECODEFT0(cd.trigger,     CTF::BLC_trigger);
-  iosize += DECODEFT0(cd.bcInc,       CTF::BLC_bcInc);
-  iosize += DECODEFT0(cd.orbitInc,    CTF::BLC_orbitInc);
-  iosize += DECODEFT0(cd.nChan,       CTF::BLC_nChan);
-  iosize += DECODEFT0(cd.eventStatus, CTF::BLC_status);
-  iosize += DECODEFT0(cd.idChan,      CTF::BLC_idChan);
-  iosize += DECODEFT0(cd.qtcChain,    CTF::BLC_qtcChain);
-  iosize += DECODEFT0(cd.cfdTime,     CTF::BLC_cfdTime);
-  iosize += DECODEFT0(cd.qtcAmpl,     CTF::BLC_qtcAmpl);
+  DECODEFT0(cd.trigger,     CTF::BLC_trigger);
+  DECODEFT0(cd.bcInc,       CTF::BLC_bcInc);
+  DECODEFT0(cd.orbitInc,    CTF::BLC_orbitInc);
+  DECODEFT0(cd.nChan,       CTF::BLC_nChan);
+  DECODEFT0(cd.eventStatus, CTF::BLC_status);
+  DECODEFT0(cd.idChan,      CTF::BLC_idChan);
+  DECODEFT0(cd.qtcChain,    CTF::BLC_qtcChain);
+  DECODEFT0(cd.cfdTime,     CTF::BLC_cfdTime);
+  DECODEFT0(cd.qtcAmpl,     CTF::BLC_qtcAmpl);
+  iosize += decodeBlocks(batch);
   // clang-format on
   //
   if (hd.minorVersion == 0 && hd.majorVersion == 1) {
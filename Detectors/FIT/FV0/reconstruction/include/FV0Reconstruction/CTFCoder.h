@@ -97,22 +97,23 @@ o2::ctf::CTFIOSize CTFCoder::encode(VEC& buff, const gsl::span<const Digit>& dig
 
   ec->setHeader(cd.header);
   assignDictVersion(static_cast<o2::ctf::CTFDictHeader&>(ec->getHeader()));
-  ec->getANSHeader().majorVersion = 0;
-  ec->getANSHeader().minorVersion = 1;
+  ec->setANSHeader(mANSVersion);
   // at every encoding the buffer might be autoexpanded, so we don't work with fixed pointer ec
   o2::ctf::CTFIOSize iosize;
-#define ENCODEFV0(part, slot, bits) CTF::get(buff.data())->encode(part, int(slot), bits, optField[int(slot)], &buff, mCoders[int(slot)].get(), getMemMarginFactor());
+  CTF::EncodingBatch batch;
+#define ENCODEFV0(part, slot, bits) batch.add(part, int(slot), bits, optField[int(slot)], mCoders[int(slot)].get(), getMemMarginFactor());
   // clang-format off
-  iosize += ENCODEFV0(cd.bcInc,     CTF::BLC_bcInc,    0);
-  iosize += ENCODEFV0(cd.orbitInc,  CTF::BLC_orbitInc, 0);
-  iosize += ENCODEFV0(cd.nChan,     CTF::BLC_nChan,    0);
-  iosize += ENCODEFV0(cd.idChan ,   CTF::BLC_idChan,   0);
-  iosize += ENCODEFV0(cd.cfdTime,   CTF::BLC_cfdTime,  0);
-  iosize += ENCODEFV0(cd.qtcAmpl,   CTF::BLC_qtcAmpl,  0);
+  ENCODEFV0(cd.bcInc,     CTF::BLC_bcInc,    0);
+  ENCODEFV0(cd.orbitInc,  CTF::BLC_orbitInc, 0);
+  ENCODEFV0(cd.nChan,     CTF::BLC_nChan,    0);
+  ENCODEFV0(cd.idChan ,   CTF::BLC_idChan,   0);
+  ENCODEFV0(cd.cfdTime,   CTF::BLC_cfdTime,  0);
+  ENCODEFV0(cd.qtcAmpl,   CTF::BLC_qtcAmpl,  0);
   // extra slot was added in the end
-  iosize += ENCODEFV0(cd.trigger,   CTF::BLC_trigger,  0);
-  iosize += ENCODEFV0(cd.qtcChain,  CTF::BLC_qtcChain, 0);
+  ENCODEFV0(cd.trigger,   CTF::BLC_trigger,  0);
+  ENCODEFV0(cd.qtcChain,  CTF::BLC_qtcChain, 0);
   // clang-format on
+  iosize += encodeBlocks(batch, buff);
   CTF::get(buff.data())->print(getPrefix(), mVerbosity);
   finaliseCTFOutput<CTF>(buff);
   iosize.rawIn = sizeof(Digit) * digitVec.size() + sizeof(ChannelData) * channelVec.size();
@@ -129,17 +130,19 @@ o2::ctf::CTFIOSize CTFCoder::decode(const CTF::base& ec, VDIG& digitVec, VCHAN&
   checkDictVersion(hd);
   ec.print(getPrefix(), mVerbosity);
   o2::ctf::CTFIOSize iosize;
-#define DECODEFV0(part, slot) ec.decode(part, int(slot), mCoders[int(slot)].get())
+  CTF::DecodingBatch batch(ec);
+#define DECODEFV0(part, slot) batch.add(part, int(slot), mCoders[int(slot)].get())
   // clang-format off
-  iosize += DECODEFV0(cd.bcInc,     CTF::BLC_bcInc);
-  iosize += DECODEFV0(cd.orbitInc,  CTF::BLC_orbitInc);
-  iosize += DECODEFV0(cd.nChan,     CTF::BLC_nChan);
-  iosize += DECODEFV0(cd.idChan,    CTF::BLC_idChan);
-  iosize += DECODEFV0(cd.cfdTime,   CTF::BLC_cfdTime);
-  iosize += DECODEFV0(cd.qtcAmpl,   CTF::BLC_qtcAmpl);
+  DECODEFV0(cd.bcInc,     CTF::BLC_bcInc);
+  DECODEFV0(cd.orbitInc,  CTF::BLC_orbitInc);
+  DECODEFV0(cd.nChan,     CTF::BLC_nChan);
+  DECODEFV0(cd.idChan,    CTF::BLC_idChan);
+  DECODEFV0(cd.cfdTime,   CTF::BLC_cfdTime);
+  DECODEFV0(cd.qtcAmpl,   CTF::BLC_qtcAmpl);
   // extra slot was added in the end
-  iosize += DECODEFV0(cd.trigger,   CTF::BLC_trigger);
-  iosize += DECODEFV0(cd.qtcChain,  CTF::BLC_qtcChain);
+  DECODEFV0(cd.trigger,   CTF::BLC_trigger);
+  DECODEFV0(cd.qtcChain,  CTF::BLC_qtcChain);
+  iosize += decodeBlocks(batch);
   // triggers and qtcChain were added later, in old data they are absent:
   if (cd.trigger.empty()) {
     cd.trigger.resize(cd.header.nTriggers);
@@ -173,6 +173,16 @@ struct MatchRecord {
   }
 };
 
+///< TPC-ITS pair accepted by the sector matching, to be registered in the match records
+struct MatchCandidate {
+  int iITS = MinusOne;      ///< entry in mITSWork
+  int iTPC = MinusOne;      ///< entry in mTPCWork
+  float chi2 = -1.f;        ///< matching chi2
+  int matchedIC = MinusOne; ///< index of eventually matched InteractionCandidate
+  MatchCandidate(int its, int tpc, float chi2match, int candIC) : iITS(its), iTPC(tpc), chi2(chi2match), matchedIC(candIC) {}
+  MatchCandidate() = default;
+};
+
 ///< Link of the AfterBurner track: update at sertain cluster
 ///< original track in the currently loaded TPC reco output
 struct ABTrackLink : public o2::track::TrackParCov {
@@ -422,7 +432,7 @@ class MatchTPCITS
   void doMatching(int sec);
 
   void refitWinners();
-  bool refitTrackTPCITS(int iTPC, int& iITS);
+  bool refitTrackTPCITS(int iTPC, int& iITS, o2::dataformats::TrackTPCITS& trfit) const;
   bool refitTPCInward(o2::track::TrackParCov& trcIn, float& chi2, float xTgt, int trcID, float timeTB) const;
 
   void selectBestMatches();
@@ -621,6 +631,9 @@ class MatchTPCITS
   ///< per sector indices of ITS track entry in mITSWork
   std::array<std::vector<int>, o2::constants::math::NSectors> mITSSectIndexCache;
 
+  ///< per sector matching candidates, in the order they were found
+  std::array<std::vector<MatchCandidate>, o2::constants::math::NSectors> mSectorMatchCandidates;
+
   ///< indices of 1st TPC tracks with time above the ITS ROF time
   std::array<std::vector<int>, o2::constants::math::NSectors> mTPCTimeStart;
   ///< indices of 1st entries of ITS tracks starting at given ROframe
@@ -90,9 +90,25 @@ void MatchTPCITS::run(const o2::globaltracking::RecoContainer& inp)
     }
 
     mTimer[SWDoMatching].Start(false);
-    for (int sec = o2::constants::math::NSectors; sec--;) {
+    int nThreads = mNThreads;
+#ifdef _ALLOW_DEBUG_TREES_
+    if (mDBGOut) {
+      nThreads = 1; // debug trees are filled during the matching
+    }
+#endif
+    // sectors are matched independently, the candidates are registered afterwards in the order of the
+    // serial sector loop, so that the match records do not depend on the number of threads
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(nThreads)
+#endif
+    for (int sec = 0; sec < o2::constants::math::NSectors; sec++) {
       doMatching(sec);
     }
+    for (int sec = o2::constants::math::NSectors; sec--;) {
+      for (const auto& cand : mSectorMatchCandidates[sec]) {
+        registerMatchRecordTPC(cand.iITS, cand.iTPC, cand.chi2, cand.matchedIC);
+      }
+    }
     mTimer[SWDoMatching].Stop();
     if (0) { // enabling this creates very verbose output
       mTimer[SWTot].Stop();
@@ -163,6 +179,7 @@ void MatchTPCITS::clear()
     mITSTimeStart[sec].clear();
     mTPCSectIndexCache[sec].clear();
     mTPCTimeStart[sec].clear();
+    mSectorMatchCandidates[sec].clear();
   }
 
   if (mMCTruthON) {
@@ -690,7 +707,10 @@ bool MatchTPCITS::prepareFITData()
 //_____________________________________________________
 void MatchTPCITS::doMatching(int sec)
 {
-  ///< run matching for currently cached ITS data for given TPC sector
+  ///< run matching for currently cached ITS data for given TPC sector, the accepted pairs are stored in
+  ///< mSectorMatchCandidates[sec] to be registered in the match records
+  auto& candidates = mSectorMatchCandidates[sec];
+  candidates.clear();
   auto& cacheITS = mITSSectIndexCache[sec]; // array of cached ITS track indices for this sector
   auto& cacheTPC = mTPCSectIndexCache[sec]; // array of cached ITS track indices for this sector
   auto& timeStartTPC = mTPCTimeStart[sec];  // array of 1st TPC track with timeMax in ITS ROFrame
@@ -826,7 +846,7 @@ void MatchTPCITS::doMatching(int sec)
           continue;
         }
       }
-      registerMatchRecordTPC(cacheITS[iits], cacheTPC[itpc], chi2, matchedIC); // register matching candidate
+      candidates.emplace_back(cacheITS[iits], cacheTPC[itpc], chi2, matchedIC); // matching candidate to register
       nMatchesControl++;
     }
   }
@@ -1217,20 +1237,74 @@ void MatchTPCITS::refitWinners()
   mTimer[SWRefit].Start(false);
   LOG(debug) << "Refitting winner matches";
   mWinnerChi2Refit.resize(mITSWork.size(), -1.f);
-  int iITS;
+  // winners are refitted in parallel into their own slots, then the successful ones are stored in the order of
+  // TPC tracks, as in the serial loop
+  std::vector<int> tpcWinners;
   for (int iTPC = 0; iTPC < (int)mTPCWork.size(); iTPC++) {
-    if (!refitTrackTPCITS(iTPC, iITS)) {
+    if (!isDisabledTPC(mTPCWork[iTPC])) {
+      tpcWinners.push_back(iTPC);
+    }
+  }
+  int nWinners = tpcWinners.size();
+  std::vector<o2::dataformats::TrackTPCITS> refitted(nWinners);
+  std::vector<int> itsWinners(nWinners, MinusOne); // MinusOne for failed refit
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(mNThreads)
+#endif
+  for (int iw = 0; iw < nWinners; iw++) {
+    int iITS;
+    if (refitTrackTPCITS(tpcWinners[iw], iITS, refitted[iw])) {
+      itsWinners[iw] = iITS;
+    }
+  }
+  for (int iw = 0; iw < nWinners; iw++) {
+    int iTPC = tpcWinners[iw], iITS = itsWinners[iw];
+    if (iITS == MinusOne) {
       continue;
     }
-    mWinnerChi2Refit[iITS] = mMatchedTracks.back().getChi2Refit();
+    const auto& tTPC = mTPCWork[iTPC];
+    const auto& tITS = mITSWork[iITS];
+    const auto& trfit = mMatchedTracks.emplace_back(refitted[iw]);
+    mWinnerChi2Refit[iITS] = trfit.getChi2Refit();
+
+#ifdef _ALLOW_DEBUG_TREES_
+    if (mDBGOut) {
+      auto tpcOrigC = mTPCTracksArray[tTPC.sourceID];
+      auto itsOrigC = mITSTracksArray[tITS.sourceID];
+      auto tITSC = tITS;
+      auto tTPCC = tTPC;
+      o2::MCCompLabel lblITS, lblTPC;
+      (*mDBGOut) << "refit"
+                 << "tpcOrig=" << tpcOrigC << "itsOrig=" << itsOrigC << "itsRef=" << tITSC << "tpcRef=" << tTPCC << "matchRefit=" << trfit;
+      if (mMCTruthON) {
+        lblITS = mITSLblWork[iITS];
+        lblTPC = mTPCLblWork[iTPC];
+        (*mDBGOut) << "refit"
+                   << "itsLbl=" << lblITS << "tpcLbl=" << lblTPC;
+      }
+      (*mDBGOut) << "refit"
+                 << "\n";
+    }
+#endif
+
+    if (mMCTruthON) { // store MC info: we assign TPC track label and declare the match fake if the ITS and TPC labels are different (their fake flag is ignored)
+      auto& lbl = mOutLabels.emplace_back(mTPCLblWork[iTPC]);
+      lbl.setFakeFlag(mITSLblWork[iITS] != mTPCLblWork[iTPC]);
+    }
+
+    // if requested, fill the difference of ITS and TPC tracks tgl for vdrift calibation
+    if (mVDriftCalibOn) {
+      mTglITSTPC.emplace_back(tITS.getTgl(), tTPC.getTgl());
+    }
   }
   mTimer[SWRefit].Stop();
 }
 
 //______________________________________________
-bool MatchTPCITS::refitTrackTPCITS(int iTPC, int& iITS)
+bool MatchTPCITS::refitTrackTPCITS(int iTPC, int& iITS, o2::dataformats::TrackTPCITS& trfit) const
 {
-  ///< refit in inward direction the pair of TPC and ITS tracks
+  ///< refit in inward direction the pair of TPC and ITS tracks, the result is stored in trfit.
+  ///< Only reads the matching data, so that the winners can be refitted concurrently
 
   const float maxStep = 2.f; // max propagation step (TODO: tune)
   const auto& tTPC = mTPCWork[iTPC];
@@ -1242,8 +1316,7 @@ bool MatchTPCITS::refitTrackTPCITS(int iTPC, int& iITS)
   const auto& tITS = mITSWork[iITS];
   const auto& itsTrOrig = mITSTracksArray[tITS.sourceID];
 
-  mMatchedTracks.emplace_back(tTPC, tITS); // create a copy of TPC track at xRef
-  auto& trfit = mMatchedTracks.back();
+  trfit = o2::dataformats::TrackTPCITS(tTPC, tITS); // create a copy of TPC track at xRef
   // in continuos mode the Z of TPC track is meaningless, unless it is CE crossing
   // track (currently absent, TODO)
   if (!mCompareTracksDZ) {
@@ -1258,7 +1331,6 @@ bool MatchTPCITS::refitTrackTPCITS(int iTPC, int& iITS)
   float timeC = tTPC.getCorrectedTime(deltaT);                                                                                                    /// precise time estimate
   if (timeC < 0) {                                                                                                                                // RS TODO similar check is needed for other edge of TF
     if (timeC + std::min(timeErr, mParams->tfEdgeTimeToleranceMUS * mTPCTBinMUSInv) < 0) {
-      mMatchedTracks.pop_back(); // destroy failed track
       return false;
     }
     timeC = 0.;
@@ -1299,7 +1371,6 @@ bool MatchTPCITS::refitTrackTPCITS(int iTPC, int& iITS)
   if (nclRefit != ncl) {
     LOGP(debug, "Refit in ITS failed after ncl={}, match between TPC track #{} and ITS track #{}", nclRefit, tTPC.sourceID, tITS.sourceID);
     LOGP(debug, "{:s}", trfit.asString());
-    mMatchedTracks.pop_back(); // destroy failed track
     return false;
   }
 
@@ -1321,7 +1392,6 @@ bool MatchTPCITS::refitTrackTPCITS(int iTPC, int& iITS)
     if (!tracOut.getXatLabR(o2::constants::geom::XTPCInnerRef, xtogo, mBz, o2::track::DirOutward) ||
         !propagator->PropagateToXBxByBz(tracOut, xtogo, MaxSnp, 10., mUseMatCorrFlag, &tofL)) {
       LOG(debug) << "Propagation to inner TPC boundary X=" << xtogo << " failed, Xtr=" << tracOut.getX() << " snp=" << tracOut.getSnp();
-      mMatchedTracks.pop_back(); // destroy failed track
       return false;
     }
     if (mVDriftCalibOn) {
@@ -1332,13 +1402,11 @@ bool MatchTPCITS::refitTrackTPCITS(int iTPC, int& iITS)
     auto tImposed = timeC * mTPCTBinMUSInv;
     if (std::abs(tImposed - mTPCTracksArray[tTPC.sourceID].getTime0()) > 550) { // RS FIXME: should be removed once TOF fixes https://github.com/AliceO2Group/AliceO2/pull/6540#issuecomment-880060760
       LOG(error) << "Impossible imposed timebin " << tImposed << " for TPC track with timebin0 " << mTPCTracksArray[tTPC.sourceID].getTime0() << " TB";
-      mMatchedTracks.pop_back(); // destroy failed track
       return false;
     }
     int retVal = mTPCRefitter->RefitTrackAsTrackParCov(tracOut, mTPCTracksArray[tTPC.sourceID].getClusterRef(), tImposed, &chi2Out, true, false); // outward refit
     if (retVal < 0) {
       LOG(debug) << "Refit failed";
-      mMatchedTracks.pop_back(); // destroy failed track
       return false;
     }
     auto posEnd = tracOut.getXYZGlo();
@@ -1369,37 +1437,6 @@ bool MatchTPCITS::refitTrackTPCITS(int iTPC, int& iITS)
   trfit.setRefTPC({unsigned(tTPC.sourceID), o2::dataformats::GlobalTrackID::TPC});
   trfit.setRefITS({unsigned(tITS.sourceID), o2::dataformats::GlobalTrackID::ITS});
 
-#ifdef _ALLOW_DEBUG_TREES_
-  if (mDBGOut) {
-    auto tpcOrigC = mTPCTracksArray[tTPC.sourceID];
-    auto itsOrigC = itsTrOrig;
-    auto tITSC = tITS;
-    auto tTPCC = tTPC;
-    o2::MCCompLabel lblITS, lblTPC;
-    (*mDBGOut) << "refit"
-               << "tpcOrig=" << tpcOrigC << "itsOrig=" << itsOrigC << "itsRef=" << tITSC << "tpcRef=" << tTPCC << "matchRefit=" << trfit;
-    if (mMCTruthON) {
-      lblITS = mITSLblWork[iITS];
-      lblTPC = mTPCLblWork[iTPC];
-      (*mDBGOut) << "refit"
-                 << "itsLbl=" << lblITS << "tpcLbl=" << lblTPC;
-    }
-    (*mDBGOut) << "refit"
-               << "\n";
-  }
-#endif
-
-  if (mMCTruthON) { // store MC info: we assign TPC track label and declare the match fake if the ITS and TPC labels are different (their fake flag is ignored)
-    auto& lbl = mOutLabels.emplace_back(mTPCLblWork[iTPC]);
-    lbl.setFakeFlag(mITSLblWork[iITS] != mTPCLblWork[iTPC]);
-  }
-
-  // if requested, fill the difference of ITS and TPC tracks tgl for vdrift calibation
-  if (mVDriftCalibOn) {
-    mTglITSTPC.emplace_back(tITS.getTgl(), tTPC.getTgl());
-  }
-  //  trfit.print(); // DBG
-
   return true;
 }
 
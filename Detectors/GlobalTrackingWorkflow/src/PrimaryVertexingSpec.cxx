@@ -77,6 +77,7 @@ void PrimaryVertexingSpec::init(InitContext& ic)
     throw std::runtime_error(fmt::format("directory {} for raw data dumps does not exist", dumpDir));
   }
   mVertexer.setPoolDumpDirectory(dumpDir);
+  mVertexer.setNThreads(ic.options().get<int>("threads"));
 }
 
 void PrimaryVertexingSpec::run(ProcessingContext& pc)
@@ -147,9 +148,9 @@ void PrimaryVertexingSpec::run(ProcessingContext& pc)
   }
 
   mTimer.Stop();
-  LOGP(info, "Found {} PVs, Time CPU/Real:{:.3f}/{:.3f} (DBScan: {:.4f}, Finder:{:.4f}, Rej.Debris:{:.4f}, Reattach:{:.4f}) | {} trials for {} TZ-clusters, max.trials: {}, Slowest TZ-cluster: {} ms of mult {}",
+  LOGP(info, "Found {} PVs, Time CPU/Real:{:.3f}/{:.3f} (DBScan: {:.4f}/{:.4f}, Finder:{:.4f}, Rej.Debris:{:.4f}, Reattach:{:.4f}) | {} trials for {} TZ-clusters, max.trials: {}, Slowest TZ-cluster: {} ms of mult {}",
        vertices.size(), mTimer.CpuTime() - timeCPU0, mTimer.RealTime() - timeReal0,
-       mVertexer.getTimeDBScan().CpuTime(), mVertexer.getTimeVertexing().CpuTime(), mVertexer.getTimeDebris().CpuTime(), mVertexer.getTimeReAttach().CpuTime(),
+       mVertexer.getTimeDBScan().CpuTime(), mVertexer.getTimeDBScan().RealTime(), mVertexer.getTimeVertexing().CpuTime(), mVertexer.getTimeDebris().CpuTime(), mVertexer.getTimeReAttach().CpuTime(),
        mVertexer.getTotTrials(), mVertexer.getNTZClusters(), mVertexer.getMaxTrialsPerCluster(),
        mVertexer.getLongestClusterTimeMS(), mVertexer.getLongestClusterMult());
 }
@@ -231,7 +232,8 @@ DataProcessorSpec getPrimaryVertexingSpec(GTrackID::mask_t src, bool skip, bool
     dataRequest->inputs,
     outputs,
     AlgorithmSpec{adaptFromTask<PrimaryVertexingSpec>(dataRequest, ggRequest, skip, validateWithFT0, useMC)},
-    Options{{"pool-dumps-directory", VariantType::String, "", {"Destination directory for the tracks pool dumps"}}}};
+    Options{{"pool-dumps-directory", VariantType::String, "", {"Destination directory for the tracks pool dumps"}},
+            {"threads", VariantType::Int, 1, {"Number of threads for the DBScan clustering"}}}};
 }
 
 } // namespace vertexing
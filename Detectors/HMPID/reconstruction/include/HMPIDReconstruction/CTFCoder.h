@@ -106,23 +106,24 @@ o2::ctf::CTFIOSize CTFCoder::encode_impl(VEC& buff, const gsl::span<const Trigge
 
   ec->setHeader(helper.createHeader());
   assignDictVersion(static_cast<o2::ctf::CTFDictHeader&>(ec->getHeader()));
-  ec->getANSHeader().majorVersion = 0;
-  ec->getANSHeader().minorVersion = 1;
+  ec->setANSHeader(mANSVersion);
   // at every encoding the buffer might be autoexpanded, so we don't work with fixed pointer ec
   o2::ctf::CTFIOSize iosize;
-#define ENCODEHMP(beg, end, slot, bits) CTF::get(buff.data())->encode(beg, end, int(slot), bits, optField[int(slot)], &buff, mCoders[int(slot)].get(), getMemMarginFactor());
+  CTF::EncodingBatch batch;
+#define ENCODEHMP(beg, end, slot, bits) batch.add(beg, end, int(slot), bits, optField[int(slot)], mCoders[int(slot)].get(), getMemMarginFactor());
   // clang-format off
-  iosize += ENCODEHMP(helper.begin_bcIncTrig(),    helper.end_bcIncTrig(),     CTF::BLC_bcIncTrig,    0);
-  iosize += ENCODEHMP(helper.begin_orbitIncTrig(), helper.end_orbitIncTrig(),  CTF::BLC_orbitIncTrig, 0);
-  iosize += ENCODEHMP(helper.begin_entriesDig(),   helper.end_entriesDig(),    CTF::BLC_entriesDig,   0);
+  ENCODEHMP(helper.begin_bcIncTrig(),    helper.end_bcIncTrig(),     CTF::BLC_bcIncTrig,    0);
+  ENCODEHMP(helper.begin_orbitIncTrig(), helper.end_orbitIncTrig(),  CTF::BLC_orbitIncTrig, 0);
+  ENCODEHMP(helper.begin_entriesDig(),   helper.end_entriesDig(),    CTF::BLC_entriesDig,   0);
 
-  iosize += ENCODEHMP(helper.begin_ChID(),         helper.end_ChID(),          CTF::BLC_ChID,         0);
-  iosize += ENCODEHMP(helper.begin_Q(),            helper.end_Q(),             CTF::BLC_Q,            0);
-  iosize += ENCODEHMP(helper.begin_Ph(),           helper.end_Ph(),            CTF::BLC_Ph,           0);
-  iosize += ENCODEHMP(helper.begin_X(),            helper.end_X(),             CTF::BLC_X,            0);
-  iosize += ENCODEHMP(helper.begin_Y(),            helper.end_Y(),             CTF::BLC_Y,            0);
+  ENCODEHMP(helper.begin_ChID(),         helper.end_ChID(),          CTF::BLC_ChID,         0);
+  ENCODEHMP(helper.begin_Q(),            helper.end_Q(),             CTF::BLC_Q,            0);
+  ENCODEHMP(helper.begin_Ph(),           helper.end_Ph(),            CTF::BLC_Ph,           0);
+  ENCODEHMP(helper.begin_X(),            helper.end_X(),             CTF::BLC_X,            0);
+  ENCODEHMP(helper.begin_Y(),            helper.end_Y(),             CTF::BLC_Y,            0);
 
   // clang-format on
+  iosize += encodeBlocks(batch, buff);
   CTF::get(buff.data())->print(getPrefix(), mVerbosity);
   finaliseCTFOutput<CTF>(buff);
   iosize.rawIn = trigData.size() * sizeof(Trigger) + digData.size() * sizeof(Digit);
@@ -141,17 +142,19 @@ o2::ctf::CTFIOSize CTFCoder::decode(const CTF::base& ec, VTRG& trigVec, VDIG& di
   std::vector<uint8_t> chID, ph, x, y;
 
   o2::ctf::CTFIOSize iosize;
-#define DECODEHMP(part, slot) ec.decode(part, int(slot), mCoders[int(slot)].get())
+  CTF::DecodingBatch batch(ec);
+#define DECODEHMP(part, slot) batch.add(part, int(slot), mCoders[int(slot)].get())
   // clang-format off
-  iosize += DECODEHMP(bcInc,       CTF::BLC_bcIncTrig);
-  iosize += DECODEHMP(orbitInc,    CTF::BLC_orbitIncTrig);
-  iosize += DECODEHMP(entriesDig,  CTF::BLC_entriesDig);
-
-  iosize += DECODEHMP(chID,        CTF::BLC_ChID);
-  iosize += DECODEHMP(q,           CTF::BLC_Q);
-  iosize += DECODEHMP(ph,          CTF::BLC_Ph);
-  iosize += DECODEHMP(x,           CTF::BLC_X);
-  iosize += DECODEHMP(y,           CTF::BLC_Y);
+  DECODEHMP(bcInc,       CTF::BLC_bcIncTrig);
+  DECODEHMP(orbitInc,    CTF::BLC_orbitIncTrig);
+  DECODEHMP(entriesDig,  CTF::BLC_entriesDig);
+
+  DECODEHMP(chID,        CTF::BLC_ChID);
+  DECODEHMP(q,           CTF::BLC_Q);
+  DECODEHMP(ph,          CTF::BLC_Ph);
+  DECODEHMP(x,           CTF::BLC_X);
+  DECODEHMP(y,           CTF::BLC_Y);
+  iosize += decodeBlocks(batch);
   // clang-format on
   //
   trigVec.clear();
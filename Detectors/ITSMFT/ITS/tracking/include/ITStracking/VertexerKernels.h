@@ -0,0 +1,137 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+///
+/// \file VertexerKernels.h
+/// \brief Batched compatibility checks used by the CPU vertexer kernels
+///
+
+#ifndef TRACKINGITSU_INCLUDE_VERTEXERKERNELS_H_
+#define TRACKINGITSU_INCLUDE_VERTEXERKERNELS_H_
+
+#include <cmath>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace o2
+{
+namespace its
+{
+namespace vertexer
+{
+
+// The selections test a contiguous range of candidates against one reference and write the indices of the
+// passing candidates, in increasing order, to selected, which must have room for the whole range. The number of
+// selected candidates is returned.
+// The vectorised paths compute exactly the scalar expressions, std::abs(a - b) < cut with the same single precision
+// operations, so the selection does not depend on the instruction set the library was compiled for. The indices
+// of the passing lanes are compacted without branches.
+
+namespace detail
+{
+#if defined(__AVX2__)
+constexpr int BatchSize = 8;
+#elif defined(__SSE2__)
+constexpr int BatchSize = 4;
+#else
+constexpr int BatchSize = 1;
+#endif
+
+inline int compact(int mask, int first, int* selected, int nSelected)
+{
+  for (int lane{0}; lane < BatchSize; ++lane) {
+    selected[nSelected] = first + lane;
+    nSelected += (mask >> lane) & 0x1;
+  }
+  return nSelected;
+}
+
+#if defined(__AVX2__)
+inline __m256 absDiff(__m256 a, __m256 b)
+{
+  return _mm256_andnot_ps(_mm256_set1_ps(-0.f), _mm256_sub_ps(a, b));
+}
+#elif defined(__SSE2__)
+inline __m128 absDiff(__m128 a, __m128 b)
+{
+  return _mm_andnot_ps(_mm_set1_ps(-0.f), _mm_sub_ps(a, b));
+}
+#endif
+} // namespace detail
+
+/// Select i in [first, last) with |phi0 - phi[i]| < phiCut
+inline int selectPhiCompatible(const float* phi, int first, int last, const float phi0, const float phiCut, int* selected)
+{
+  int nSelected{0};
+  int i{first};
+#if defined(__AVX2__)
+  const __m256 ref = _mm256_set1_ps(phi0);
+  const __m256 cut = _mm256_set1_ps(phiCut);
+  for (; i + detail::BatchSize <= last; i += detail::BatchSize) {
+    const __m256 pass = _mm256_cmp_ps(detail::absDiff(ref, _mm256_loadu_ps(phi + i)), cut, _CMP_LT_OQ);
+    nSelected = detail::compact(_mm256_movemask_ps(pass), i, selected, nSelected);
+  }
+#elif defined(__SSE2__)
+  const __m128 ref = _mm_set1_ps(phi0);
+  const __m128 cut = _mm_set1_ps(phiCut);
+  for (; i + detail::BatchSize <= last; i += detail::BatchSize) {
+    const __m128 pass = _mm_cmplt_ps(detail::absDiff(ref, _mm_loadu_ps(phi + i)), cut);
+    nSelected = detail::compact(_mm_movemask_ps(pass), i, selected, nSelected);
+  }
+#endif
+  for (; i < last; ++i) {
+    selected[nSelected] = i;
+    nSelected += std::abs(phi0 - phi[i]) < phiCut;
+  }
+  return nSelected;
+}
+
+/// Select i in [first, last) with |tanLambda0 - tanLambda[i]| < tanLambdaCut and |phi0 - phi[i]| < phiCut
+inline int selectTrackletsCompatible(const float* tanLambda, const float* phi, int first, int last,
+                                     const float tanLambda0, const float phi0, const float tanLambdaCut, const float phiCut,
+                                     int* selected)
+{
+  int nSelected{0};
+  int i{first};
+#if defined(__AVX2__)
+  const __m256 refTanLambda = _mm256_set1_ps(tanLambda0);
+  const __m256 refPhi = _mm256_set1_ps(phi0);
+  const __m256 cutTanLambda = _mm256_set1_ps(tanLambdaCut);
+  const __m256 cutPhi = _mm256_set1_ps(phiCut);
+  for (; i + detail::BatchSize <= last; i += detail::BatchSize) {
+    const __m256 passTanLambda = _mm256_cmp_ps(detail::absDiff(refTanLambda, _mm256_loadu_ps(tanLambda + i)), cutTanLambda, _CMP_LT_OQ);
+    const __m256 passPhi = _mm256_cmp_ps(detail::absDiff(refPhi, _mm256_loadu_ps(phi + i)), cutPhi, _CMP_LT_OQ);
+    nSelected = detail::compact(_mm256_movemask_ps(_mm256_and_ps(passTanLambda, passPhi)), i, selected, nSelected);
+  }
+#elif defined(__SSE2__)
+  const __m128 refTanLambda = _mm_set1_ps(tanLambda0);
+  const __m128 refPhi = _mm_set1_ps(phi0);
+  const __m128 cutTanLambda = _mm_set1_ps(tanLambdaCut);
+  const __m128 cutPhi = _mm_set1_ps(phiCut);
+  for (; i + detail::BatchSize <= last; i += detail::BatchSize) {
+    const __m128 passTanLambda = _mm_cmplt_ps(detail::absDiff(refTanLambda, _mm_loadu_ps(tanLambda + i)), cutTanLambda);
+    const __m128 passPhi = _mm_cmplt_ps(detail::absDiff(refPhi, _mm_loadu_ps(phi + i)), cutPhi);
+    nSelected = detail::compact(_mm_movemask_ps(_mm_and_ps(passTanLambda, passPhi)), i, selected, nSelected);
+  }
+#endif
+  for (; i < last; ++i) {
+    selected[nSelected] = i;
+    nSelected += std::abs(tanLambda0 - tanLambda[i]) < tanLambdaCut && std::abs(phi0 - phi[i]) < phiCut;
+  }
+  return nSelected;
+}
+
+} // namespace vertexer
+} // namespace its
+} // namespace o2
+
+#endif /* TRACKINGITSU_INCLUDE_VERTEXERKERNELS_H_ */
@@ -15,8 +15,10 @@
 
 #include "ITStracking/TrackerTraits.h"
 
+#include <algorithm>
 #include <cassert>
 #include <iostream>
+#include <numeric>
 
 #include <fmt/format.h>
 
@@ -61,16 +63,38 @@ void TrackerTraits::computeLayerTracklets(const int iteration)
 
   const Vertex diamondVert({mTrkParams[iteration].Diamond[0], mTrkParams[iteration].Diamond[1], mTrkParams[iteration].Diamond[2]}, {25.e-6f, 0.f, 0.f, 25.e-6f, 0.f, 36.f}, 1, 1.f);
   gsl::span<const Vertex> diamondSpan(&diamondVert, 1);
-  for (int rof0{0}; rof0 < tf->getNrof(); ++rof0) {
-    gsl::span<const Vertex> primaryVertices = mTrkParams[iteration].UseDiamond ? diamondSpan : tf->getPrimaryVertices(rof0);
-    int minRof = (rof0 >= mTrkParams[iteration].DeltaROF) ? rof0 - mTrkParams[iteration].DeltaROF : 0;
-    int maxRof = (rof0 == tf->getNrof() - mTrkParams[iteration].DeltaROF) ? rof0 : rof0 + mTrkParams[iteration].DeltaROF;
-    for (int iLayer{0}; iLayer < mTrkParams[iteration].TrackletsPerRoad(); ++iLayer) {
+
+  /// The ROFs of a layer are processed in parallel, each thread appends the tracklets to its own buffer.
+  /// Duplicates can only come from the same first cluster, so the tracklets of every cluster are sorted and
+  /// cleaned right after being found: copying the buffers back in order of the ROFs gives the tracklets sorted
+  /// by (firstClusterIndex, secondClusterIndex) independently of the number of threads.
+  std::vector<std::vector<Tracklet>> threadTracklets(mNThreads);
+  std::vector<int> rofThread(tf->getNrof()), rofBegin(tf->getNrof()), rofOffset(tf->getNrof() + 1);
+  for (int iLayer{0}; iLayer < mTrkParams[iteration].TrackletsPerRoad(); ++iLayer) {
+    const float meanDeltaR{mTrkParams[iteration].LayerRadii[iLayer + 1] - mTrkParams[iteration].LayerRadii[iLayer]};
+    for (auto& tracklets : threadTracklets) {
+      tracklets.clear();
+    }
+    std::fill(rofOffset.begin(), rofOffset.end(), 0);
+
+#pragma omp parallel for num_threads(mNThreads) schedule(dynamic)
+    for (int rof0 = 0; rof0 < tf->getNrof(); ++rof0) {
+#ifdef WITH_OPENMP
+      const int iThread = omp_get_thread_num();
+#else
+      const int iThread = 0;
+#endif
+      auto& tracklets = threadTracklets[iThread];
+      rofThread[rof0] = iThread;
+      rofBegin[rof0] = tracklets.size();
+
       gsl::span<const Cluster> layer0 = tf->getClustersOnLayer(rof0, iLayer);
       if (layer0.empty()) {
         continue;
       }
-      float meanDeltaR{mTrkParams[iteration].LayerRadii[iLayer + 1] - mTrkParams[iteration].LayerRadii[iLayer]};
+      gsl::span<const Vertex> primaryVertices = mTrkParams[iteration].UseDiamond ? diamondSpan : tf->getPrimaryVertices(rof0);
+      int minRof = (rof0 >= mTrkParams[iteration].DeltaROF) ? rof0 - mTrkParams[iteration].DeltaROF : 0;
+      int maxRof = (rof0 == tf->getNrof() - mTrkParams[iteration].DeltaROF) ? rof0 : rof0 + mTrkParams[iteration].DeltaROF;
 
       const int currentLayerClustersNum{static_cast<int>(layer0.size())};
       for (int iCluster{0}; iCluster < currentLayerClustersNum; ++iCluster) {
@@ -81,6 +105,7 @@ void TrackerTraits::computeLayerTracklets(const int iteration)
           continue;
         }
         const float inverseR0{1.f / currentCluster.radius};
+        const int clusterBegin{static_cast<int>(tracklets.size())};
 
         for (auto& primaryVertex : primaryVertices) {
           const float resolution = std::sqrt(Sq(mTrkParams[iteration].PVres) / primaryVertex.getNContributors() + Sq(tf->getPositionResolution(iLayer)));
@@ -159,73 +184,61 @@ void TrackerTraits::computeLayerTracklets(const int iteration)
                     break;
                   }
                 }
+#pragma omp critical
                 off << fmt::format("{}\t{:d}\t{}\t{}\t{}\t{}", iLayer, label.isValid(), (tanLambda * (nextCluster.radius - currentCluster.radius) + currentCluster.zCoordinate - nextCluster.zCoordinate) / sigmaZ, tanLambda, resolution, sigmaZ) << std::endl;
 #endif
 
                 if (deltaZ / sigmaZ < mTrkParams[iteration].NSigmaCut &&
                     (deltaPhi < tf->getPhiCut(iLayer) ||
                      gpu::GPUCommonMath::Abs(deltaPhi - constants::math::TwoPi) < tf->getPhiCut(iLayer))) {
-                  if (iLayer > 0) {
-                    tf->getTrackletsLookupTable()[iLayer - 1][currentSortedIndex]++;
-                  }
                   const float phi{o2::gpu::GPUCommonMath::ATan2(currentCluster.yCoordinate - nextCluster.yCoordinate,
                                                                 currentCluster.xCoordinate - nextCluster.xCoordinate)};
                   const float tanL{(currentCluster.zCoordinate - nextCluster.zCoordinate) /
                                    (currentCluster.radius - nextCluster.radius)};
-                  tf->getTracklets()[iLayer].emplace_back(currentSortedIndex, tf->getSortedIndex(rof1, iLayer + 1, iNextCluster), tanL, phi, rof0, rof1);
+                  tracklets.emplace_back(currentSortedIndex, tf->getSortedIndex(rof1, iLayer + 1, iNextCluster), tanL, phi, rof0, rof1);
                 }
               }
             }
           }
         }
+
+        /// Sort tracklets of the current cluster and remove duplicates found with different vertices
+        auto clusterTracklets = tracklets.begin() + clusterBegin;
+        std::sort(clusterTracklets, tracklets.end(), [](const Tracklet& a, const Tracklet& b) {
+          return a.secondClusterIndex < b.secondClusterIndex;
+        });
+        tracklets.erase(std::unique(clusterTracklets, tracklets.end(), [](const Tracklet& a, const Tracklet& b) {
+                          return a.secondClusterIndex == b.secondClusterIndex;
+                        }),
+                        tracklets.end());
+        if (iLayer > 0) {
+          tf->getTrackletsLookupTable()[iLayer - 1][currentSortedIndex] = tracklets.size() - clusterBegin;
+        }
       }
-      if (!tf->checkMemory(mTrkParams[iteration].MaxMemory)) {
-        return;
-      }
+      rofOffset[rof0] = tracklets.size() - rofBegin[rof0];
     }
-  }
 
-  for (int iLayer{0}; iLayer < mTrkParams[iteration].CellsPerRoad(); ++iLayer) {
-    /// Sort tracklets
-    auto& trkl{tf->getTracklets()[iLayer + 1]};
-    std::sort(trkl.begin(), trkl.end(), [](const Tracklet& a, const Tracklet& b) {
-      return a.firstClusterIndex < b.firstClusterIndex || (a.firstClusterIndex == b.firstClusterIndex && a.secondClusterIndex < b.secondClusterIndex);
-    });
-    /// Remove duplicates
-    auto& lut{tf->getTrackletsLookupTable()[iLayer]};
-    int id0{-1}, id1{-1};
-    std::vector<Tracklet> newTrk;
-    newTrk.reserve(trkl.size());
-    for (auto& trk : trkl) {
-      if (trk.firstClusterIndex == id0 && trk.secondClusterIndex == id1) {
-        lut[id0]--;
-      } else {
-        id0 = trk.firstClusterIndex;
-        id1 = trk.secondClusterIndex;
-        newTrk.push_back(trk);
-      }
+    /// Merge the thread buffers
+    std::exclusive_scan(rofOffset.begin(), rofOffset.end(), rofOffset.begin(), 0);
+    auto& layerTracklets{tf->getTracklets()[iLayer]};
+    layerTracklets.resize(rofOffset.back());
+#pragma omp parallel for num_threads(mNThreads)
+    for (int rof0 = 0; rof0 < tf->getNrof(); ++rof0) {
+      auto first = threadTracklets[rofThread[rof0]].begin() + rofBegin[rof0];
+      std::copy(first, first + (rofOffset[rof0 + 1] - rofOffset[rof0]), layerTracklets.begin() + rofOffset[rof0]);
     }
-    trkl.swap(newTrk);
 
     /// Compute LUT
-    std::exclusive_scan(lut.begin(), lut.end(), lut.begin(), 0);
-    lut.push_back(trkl.size());
-  }
-  /// Layer 0 is done outside the loop
-  std::sort(tf->getTracklets()[0].begin(), tf->getTracklets()[0].end(), [](const Tracklet& a, const Tracklet& b) {
-    return a.firstClusterIndex < b.firstClusterIndex || (a.firstClusterIndex == b.firstClusterIndex && a.secondClusterIndex < b.secondClusterIndex);
-  });
-  int id0{-1}, id1{-1};
-  std::vector<Tracklet> newTrk;
-  newTrk.reserve(tf->getTracklets()[0].size());
-  for (auto& trk : tf->getTracklets()[0]) {
-    if (trk.firstClusterIndex != id0 || trk.secondClusterIndex != id1) {
-      id0 = trk.firstClusterIndex;
-      id1 = trk.secondClusterIndex;
-      newTrk.push_back(trk);
+    if (iLayer > 0) {
+      auto& lut{tf->getTrackletsLookupTable()[iLayer - 1]};
+      std::exclusive_scan(lut.begin(), lut.end(), lut.begin(), 0);
+      lut.push_back(layerTracklets.size());
+    }
+
+    if (!tf->checkMemory(mTrkParams[iteration].MaxMemory)) {
+      return;
     }
   }
-  tf->getTracklets()[0].swap(newTrk);
 
   /// Create tracklets labels
   if (tf->hasMCinformation()) {
@@ -273,8 +286,9 @@ void TrackerTraits::computeLayerCells(const int iteration)
 #endif
     const int currentLayerTrackletsNum{static_cast<int>(tf->getTracklets()[iLayer].size())};
 
-    for (int iTracklet{0}; iTracklet < currentLayerTrackletsNum; ++iTracklet) {
-
+    /// Cells starting from a tracklet are only counted if cells == nullptr, otherwise they are stored from there on
+    auto findCells = [&](const int iTracklet, Cell* cells) -> int {
+      int nCells{0};
       const Tracklet& currentTracklet{tf->getTracklets()[iLayer][iTracklet]};
       const int nextLayerClusterIndex{currentTracklet.secondClusterIndex};
       const int nextLayerFirstTrackletIndex{
@@ -282,10 +296,6 @@ void TrackerTraits::computeLayerCells(const int iteration)
       const int nextLayerLastTrackletIndex{
         tf->getTrackletsLookupTable()[iLayer][nextLayerClusterIndex + 1]};
 
-      if (nextLayerFirstTrackletIndex == nextLayerLastTrackletIndex) {
-        continue;
-      }
-
       for (int iNextTracklet{nextLayerFirstTrackletIndex}; iNextTracklet < nextLayerLastTrackletIndex; ++iNextTracklet) {
         if (tf->getTracklets()[iLayer + 1][iNextTracklet].firstClusterIndex != nextLayerClusterIndex) {
           break;
@@ -295,25 +305,44 @@ void TrackerTraits::computeLayerCells(const int iteration)
         const float tanLambda{(currentTracklet.tanLambda + nextTracklet.tanLambda) * 0.5f};
 
 #ifdef OPTIMISATION_OUTPUT
-        bool good{tf->getTrackletsLabel(iLayer)[iTracklet] == tf->getTrackletsLabel(iLayer + 1)[iNextTracklet]};
-        float signedDelta{currentTracklet.tanLambda - nextTracklet.tanLambda};
-        off << fmt::format("{}\t{:d}\t{}\t{}\t{}\t{}", iLayer, good, signedDelta, signedDelta / (mTrkParams[iteration].CellDeltaTanLambdaSigma), tanLambda, resolution) << std::endl;
+        if (!cells) {
+          bool good{tf->getTrackletsLabel(iLayer)[iTracklet] == tf->getTrackletsLabel(iLayer + 1)[iNextTracklet]};
+          float signedDelta{currentTracklet.tanLambda - nextTracklet.tanLambda};
+#pragma omp critical
+          off << fmt::format("{}\t{:d}\t{}\t{}\t{}\t{}", iLayer, good, signedDelta, signedDelta / (mTrkParams[iteration].CellDeltaTanLambdaSigma), tanLambda, resolution) << std::endl;
+        }
 #endif
 
         if (deltaTanLambda / mTrkParams[iteration].CellDeltaTanLambdaSigma < mTrkParams[iteration].NSigmaCut) {
-
-          if (iLayer > 0 && (int)tf->getCellsLookupTable()[iLayer - 1].size() <= iTracklet) {
-            tf->getCellsLookupTable()[iLayer - 1].resize(iTracklet + 1, tf->getCells()[iLayer].size());
+          if (cells) {
+            cells[nCells] = Cell(currentTracklet.firstClusterIndex, nextTracklet.firstClusterIndex, nextTracklet.secondClusterIndex,
+                                 iTracklet, iNextTracklet, tanLambda);
           }
-
-          tf->getCells()[iLayer].emplace_back(
-            currentTracklet.firstClusterIndex, nextTracklet.firstClusterIndex, nextTracklet.secondClusterIndex,
-            iTracklet, iNextTracklet, tanLambda);
+          ++nCells;
         }
       }
+      return nCells;
+    };
+
+    /// Count the cells per tracklet, the exclusive scan of the counts is the lookup table of the cells and
+    /// gives every tracklet the position of its cells, which are then filled in parallel
+    std::vector<int> cellsLookupTable(currentLayerTrackletsNum + 1, 0);
+#pragma omp parallel for num_threads(mNThreads)
+    for (int iTracklet = 0; iTracklet < currentLayerTrackletsNum; ++iTracklet) {
+      cellsLookupTable[iTracklet] = findCells(iTracklet, nullptr);
+    }
+    std::exclusive_scan(cellsLookupTable.begin(), cellsLookupTable.end(), cellsLookupTable.begin(), 0);
+
+    auto& layerCells{tf->getCells()[iLayer]};
+    layerCells.resize(cellsLookupTable.back());
+#pragma omp parallel for num_threads(mNThreads)
+    for (int iTracklet = 0; iTracklet < currentLayerTrackletsNum; ++iTracklet) {
+      if (cellsLookupTable[iTracklet] != cellsLookupTable[iTracklet + 1]) {
+        findCells(iTracklet, layerCells.data() + cellsLookupTable[iTracklet]);
+      }
     }
     if (iLayer > 0) {
-      tf->getCellsLookupTable()[iLayer - 1].resize(currentLayerTrackletsNum + 1, tf->getCells()[iLayer].size());
+      tf->getCellsLookupTable()[iLayer - 1].swap(cellsLookupTable);
     }
     if (!tf->checkMemory(mTrkParams[iteration].MaxMemory)) {
       return;
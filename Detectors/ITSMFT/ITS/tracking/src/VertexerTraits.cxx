@@ -16,6 +16,7 @@
 #include "ITStracking/VertexerTraits.h"
 #include "ITStracking/ClusterLines.h"
 #include "ITStracking/Tracklet.h"
+#include "ITStracking/VertexerKernels.h"
 
 #ifdef VTX_DEBUG
 #include "TTree.h"
@@ -45,6 +46,12 @@ void trackleterKernelSerial(
 {
   const int PhiBins{utils.getNphiBins()};
   const int ZBins{utils.getNzBins()};
+  std::vector<int> selected(clustersNextLayer.size());
+  // phi of the next layer clusters as a contiguous array for the batched selection
+  std::vector<float> phiNextLayer(clustersNextLayer.size());
+  for (size_t iNextLayerClusterIndex{0}; iNextLayerClusterIndex < clustersNextLayer.size(); ++iNextLayerClusterIndex) {
+    phiNextLayer[iNextLayerClusterIndex] = clustersNextLayer[iNextLayerClusterIndex].phi;
+  }
   // loop on layer1 clusters
   for (unsigned int iCurrentLayerClusterIndex{0}; iCurrentLayerClusterIndex < clustersCurrentLayer.size(); ++iCurrentLayerClusterIndex) {
     int storedTracklets{0};
@@ -60,19 +67,19 @@ void trackleterKernelSerial(
         const int firstBinIndex{utils.getBinIndex(selectedBinsRect.x, iPhiBin)};
         const int firstRowClusterIndex{indexTableNext[firstBinIndex]};
         const int maxRowClusterIndex{indexTableNext[firstBinIndex + ZBins]};
-        // loop on clusters next layer
-        for (int iNextLayerClusterIndex{firstRowClusterIndex}; iNextLayerClusterIndex < maxRowClusterIndex && iNextLayerClusterIndex < static_cast<int>(clustersNextLayer.size()); ++iNextLayerClusterIndex) {
+        const int lastRowClusterIndex{std::min(maxRowClusterIndex, static_cast<int>(clustersNextLayer.size()))};
+        // select the compatible clusters of the row at once, then store them in order
+        const int nSelected{vertexer::selectPhiCompatible(phiNextLayer.data(), firstRowClusterIndex, lastRowClusterIndex,
+                                                          currentCluster.phi, phiCut, selected.data())};
+        for (int iSelected{0}; iSelected < nSelected && storedTracklets < maxTrackletsPerCluster; ++iSelected) {
+          const int iNextLayerClusterIndex{selected[iSelected]};
           const Cluster& nextCluster{clustersNextLayer[iNextLayerClusterIndex]};
-          if (o2::gpu::GPUCommonMath::Abs(currentCluster.phi - nextCluster.phi) < phiCut) {
-            if (storedTracklets < maxTrackletsPerCluster) {
-              if constexpr (Mode == TrackletMode::Layer0Layer1) {
-                Tracklets.emplace_back(iNextLayerClusterIndex, iCurrentLayerClusterIndex, nextCluster, currentCluster, rof, rof);
-              } else {
-                Tracklets.emplace_back(iCurrentLayerClusterIndex, iNextLayerClusterIndex, currentCluster, nextCluster, rof, rof);
-              }
-              ++storedTracklets;
-            }
+          if constexpr (Mode == TrackletMode::Layer0Layer1) {
+            Tracklets.emplace_back(iNextLayerClusterIndex, iCurrentLayerClusterIndex, nextCluster, currentCluster, rof, rof);
+          } else {
+            Tracklets.emplace_back(iCurrentLayerClusterIndex, iNextLayerClusterIndex, currentCluster, nextCluster, rof, rof);
           }
+          ++storedTracklets;
         }
       }
     }
@@ -96,13 +103,21 @@ void trackletSelectionKernelSerial(
 {
   int offset01{0}, offset12{0};
   std::vector<bool> usedTracklets(tracklets01.size(), false);
+  // tanLambda and phi of the L0-L1 tracklets as contiguous arrays for the batched selection
+  std::vector<float> tanLambda01(tracklets01.size()), phi01(tracklets01.size());
+  std::vector<int> selected(tracklets01.size());
+  for (size_t iTracklet01{0}; iTracklet01 < tracklets01.size(); ++iTracklet01) {
+    tanLambda01[iTracklet01] = tracklets01[iTracklet01].tanLambda;
+    phi01[iTracklet01] = tracklets01[iTracklet01].phi;
+  }
   for (unsigned int iCurrentLayerClusterIndex{0}; iCurrentLayerClusterIndex < clusters1.size(); ++iCurrentLayerClusterIndex) {
     int validTracklets{0};
     for (int iTracklet12{offset12}; iTracklet12 < offset12 + foundTracklets12[iCurrentLayerClusterIndex]; ++iTracklet12) {
-      for (int iTracklet01{offset01}; iTracklet01 < offset01 + foundTracklets01[iCurrentLayerClusterIndex]; ++iTracklet01) {
-        const float deltaTanLambda{o2::gpu::GPUCommonMath::Abs(tracklets01[iTracklet01].tanLambda - tracklets12[iTracklet12].tanLambda)};
-        const float deltaPhi{o2::gpu::GPUCommonMath::Abs(tracklets01[iTracklet01].phi - tracklets12[iTracklet12].phi)};
-        if (!usedTracklets[iTracklet01] && deltaTanLambda < tanLambdaCut && deltaPhi < phiCut && validTracklets != maxTracklets) {
+      const int nSelected{vertexer::selectTrackletsCompatible(tanLambda01.data(), phi01.data(), offset01, offset01 + foundTracklets01[iCurrentLayerClusterIndex],
+                                                              tracklets12[iTracklet12].tanLambda, tracklets12[iTracklet12].phi, tanLambdaCut, phiCut, selected.data())};
+      for (int iSelected{0}; iSelected < nSelected; ++iSelected) {
+        const int iTracklet01{selected[iSelected]};
+        if (!usedTracklets[iTracklet01] && validTracklets != maxTracklets) {
           usedTracklets[iTracklet01] = true;
           destTracklets.emplace_back(tracklets01[iTracklet01], clusters0.data(), clusters1.data());
           if (trackletLabels.size()) {
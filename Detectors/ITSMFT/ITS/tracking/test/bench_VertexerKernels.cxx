@@ -0,0 +1,175 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+///
+/// \file bench_VertexerKernels.cxx
+/// \brief scalar vs. batched cluster and tracklet selection of the CPU vertexer
+///
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "CommonConstants/MathConstants.h"
+#include "ITStracking/VertexerKernels.h"
+
+namespace
+{
+constexpr float PhiCut{0.005f};
+constexpr float TanLambdaCut{0.025f};
+constexpr int PhiBins{128};
+
+// Clusters of one ROF sorted in phi bins, the rows of the index table are the clusters of a bin and its neighbours.
+// The range argument is the number of clusters on the layer: O(100) for pp, O(10^4) for central Pb-Pb ROFs.
+struct ROFData {
+  ROFData(int nClusters)
+  {
+    std::mt19937 rng{0};
+    std::uniform_real_distribution<float> phiDist{0.f, o2::constants::math::TwoPI};
+    std::normal_distribution<float> tanLambdaDist{0.f, 1.f};
+    phi.resize(nClusters);
+    tanLambda.resize(nClusters);
+    std::generate(phi.begin(), phi.end(), [&]() { return phiDist(rng); });
+    std::generate(tanLambda.begin(), tanLambda.end(), [&]() { return tanLambdaDist(rng); });
+    std::sort(phi.begin(), phi.end());
+    binStart.resize(PhiBins + 1);
+    for (int iBin{0}; iBin <= PhiBins; ++iBin) {
+      binStart[iBin] = std::lower_bound(phi.begin(), phi.end(), iBin * o2::constants::math::TwoPI / PhiBins) - phi.begin();
+    }
+    selected.resize(nClusters);
+  }
+
+  std::pair<int, int> row(float phi0) const
+  {
+    const int bin = std::min(static_cast<int>(phi0 / o2::constants::math::TwoPI * PhiBins), PhiBins - 1);
+    return {binStart[std::max(bin - 1, 0)], binStart[std::min(bin + 2, PhiBins)]};
+  }
+
+  std::vector<float> phi;
+  std::vector<float> tanLambda;
+  std::vector<int> binStart;
+  mutable std::vector<int> selected;
+};
+
+int selectPhiScalar(const float* phi, int first, int last, const float phi0, const float phiCut, int* selected)
+{
+  int nSelected{0};
+  for (int i{first}; i < last; ++i) {
+    if (std::abs(phi0 - phi[i]) < phiCut) {
+      selected[nSelected++] = i;
+    }
+  }
+  return nSelected;
+}
+
+int selectTrackletsScalar(const float* tanLambda, const float* phi, int first, int last, const float tanLambda0, const float phi0,
+                          const float tanLambdaCut, const float phiCut, int* selected)
+{
+  int nSelected{0};
+  for (int i{first}; i < last; ++i) {
+    if (std::abs(tanLambda0 - tanLambda[i]) < tanLambdaCut && std::abs(phi0 - phi[i]) < phiCut) {
+      selected[nSelected++] = i;
+    }
+  }
+  return nSelected;
+}
+
+// every cluster of the ROF is used as reference once, as in the trackleter kernel
+template <bool Batched>
+size_t selectClusters(const ROFData& rof)
+{
+  size_t nSelected{0};
+  for (const float phi0 : rof.phi) {
+    const auto [first, last] = rof.row(phi0);
+    if constexpr (Batched) {
+      nSelected += o2::its::vertexer::selectPhiCompatible(rof.phi.data(), first, last, phi0, PhiCut * 4, rof.selected.data());
+    } else {
+      nSelected += selectPhiScalar(rof.phi.data(), first, last, phi0, PhiCut * 4, rof.selected.data());
+    }
+  }
+  return nSelected;
+}
+
+template <bool Batched>
+size_t selectTracklets(const ROFData& rof)
+{
+  size_t nSelected{0};
+  for (size_t i{0}; i < rof.phi.size(); ++i) {
+    const auto [first, last] = rof.row(rof.phi[i]);
+    if constexpr (Batched) {
+      nSelected += o2::its::vertexer::selectTrackletsCompatible(rof.tanLambda.data(), rof.phi.data(), first, last, rof.tanLambda[i], rof.phi[i],
+                                                                TanLambdaCut * 4, PhiCut * 4, rof.selected.data());
+    } else {
+      nSelected += selectTrackletsScalar(rof.tanLambda.data(), rof.phi.data(), first, last, rof.tanLambda[i], rof.phi[i],
+                                         TanLambdaCut * 4, PhiCut * 4, rof.selected.data());
+    }
+  }
+  return nSelected;
+}
+
+// the batched kernels must select the same clusters, in the same order, as the scalar loops
+bool sameSelections(const ROFData& rof)
+{
+  std::vector<int> scalar(rof.phi.size()), batched(rof.phi.size());
+  auto same = [&](int nScalar, int nBatched) {
+    return nScalar == nBatched && std::equal(scalar.begin(), scalar.begin() + nScalar, batched.begin());
+  };
+  for (size_t i{0}; i < rof.phi.size(); ++i) {
+    const auto [first, last] = rof.row(rof.phi[i]);
+    if (!same(selectPhiScalar(rof.phi.data(), first, last, rof.phi[i], PhiCut * 4, scalar.data()),
+              o2::its::vertexer::selectPhiCompatible(rof.phi.data(), first, last, rof.phi[i], PhiCut * 4, batched.data()))) {
+      return false;
+    }
+    if (!same(selectTrackletsScalar(rof.tanLambda.data(), rof.phi.data(), first, last, rof.tanLambda[i], rof.phi[i],
+                                    TanLambdaCut * 4, PhiCut * 4, scalar.data()),
+              o2::its::vertexer::selectTrackletsCompatible(rof.tanLambda.data(), rof.phi.data(), first, last, rof.tanLambda[i], rof.phi[i],
+                                                           TanLambdaCut * 4, PhiCut * 4, batched.data()))) {
+      return false;
+    }
+  }
+  return true;
+}
+} // namespace
+
+template <bool Batched>
+static void BM_SelectClusters(benchmark::State& state)
+{
+  const ROFData rof(state.range(0));
+  if (!sameSelections(rof)) {
+    state.SkipWithError("batched selection differs from the scalar one");
+  }
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(selectClusters<Batched>(rof));
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * state.range(0));
+}
+
+template <bool Batched>
+static void BM_SelectTracklets(benchmark::State& state)
+{
+  const ROFData rof(state.range(0));
+  if (!sameSelections(rof)) {
+    state.SkipWithError("batched selection differs from the scalar one");
+  }
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(selectTracklets<Batched>(rof));
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * state.range(0));
+}
+
+BENCHMARK_TEMPLATE(BM_SelectClusters, false)->RangeMultiplier(10)->Range(100, 10000);
+BENCHMARK_TEMPLATE(BM_SelectClusters, true)->RangeMultiplier(10)->Range(100, 10000);
+BENCHMARK_TEMPLATE(BM_SelectTracklets, false)->RangeMultiplier(10)->Range(100, 10000);
+BENCHMARK_TEMPLATE(BM_SelectTracklets, true)->RangeMultiplier(10)->Range(100, 10000);
+
+BENCHMARK_MAIN();
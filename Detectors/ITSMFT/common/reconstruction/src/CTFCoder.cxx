@@ -243,19 +243,21 @@ CompressedClusters CTFCoder::decodeCompressedClusters(const CTF::base& ec, o2::c
   cc.header = ec.getHeader();
   checkDictVersion(static_cast<const o2::ctf::CTFDictHeader&>(cc.header));
   ec.print(getPrefix(), mVerbosity);
-#define DECODEITSMFT(part, slot) ec.decode(part, int(slot), mCoders[int(slot)].get())
+  CTF::DecodingBatch batch(ec);
+#define DECODEITSMFT(part, slot) batch.add(part, int(slot), mCoders[int(slot)].get())
   // clang-format off
-  iosize += DECODEITSMFT(cc.firstChipROF, CTF::BLCfirstChipROF);
-  iosize += DECODEITSMFT(cc.bcIncROF,     CTF::BLCbcIncROF);
-  iosize += DECODEITSMFT(cc.orbitIncROF,  CTF::BLCorbitIncROF);
-  iosize += DECODEITSMFT(cc.nclusROF,     CTF::BLCnclusROF);
+  DECODEITSMFT(cc.firstChipROF, CTF::BLCfirstChipROF);
+  DECODEITSMFT(cc.bcIncROF,     CTF::BLCbcIncROF);
+  DECODEITSMFT(cc.orbitIncROF,  CTF::BLCorbitIncROF);
+  DECODEITSMFT(cc.nclusROF,     CTF::BLCnclusROF);
   //
-  iosize += DECODEITSMFT(cc.chipInc,      CTF::BLCchipInc);
-  iosize += DECODEITSMFT(cc.chipMul,      CTF::BLCchipMul);
-  iosize += DECODEITSMFT(cc.row,          CTF::BLCrow);
-  iosize += DECODEITSMFT(cc.colInc,       CTF::BLCcolInc);
-  iosize += DECODEITSMFT(cc.pattID,       CTF::BLCpattID);
-  iosize += DECODEITSMFT(cc.pattMap,      CTF::BLCpattMap);
+  DECODEITSMFT(cc.chipInc,      CTF::BLCchipInc);
+  DECODEITSMFT(cc.chipMul,      CTF::BLCchipMul);
+  DECODEITSMFT(cc.row,          CTF::BLCrow);
+  DECODEITSMFT(cc.colInc,       CTF::BLCcolInc);
+  DECODEITSMFT(cc.pattID,       CTF::BLCpattID);
+  DECODEITSMFT(cc.pattMap,      CTF::BLCpattMap);
+  iosize += decodeBlocks(batch);
   // clang-format on
   return cc;
 }
@@ -91,24 +91,25 @@ o2::ctf::CTFIOSize CTFCoder::encode(VEC& buff, const gsl::span<const ReadoutWind
 
   ec->setHeader(cc.header);
   assignDictVersion(static_cast<o2::ctf::CTFDictHeader&>(ec->getHeader()));
-  ec->getANSHeader().majorVersion = 0;
-  ec->getANSHeader().minorVersion = 1;
+  ec->setANSHeader(mANSVersion);
   // at every encoding the buffer might be autoexpanded, so we don't work with fixed pointer ec
   o2::ctf::CTFIOSize iosize;
-#define ENCODETOF(part, slot, bits) CTF::get(buff.data())->encode(part, int(slot), bits, optField[int(slot)], &buff, mCoders[int(slot)].get(), getMemMarginFactor());
+  CTF::EncodingBatch batch;
+#define ENCODETOF(part, slot, bits) batch.add(part, int(slot), bits, optField[int(slot)], mCoders[int(slot)].get(), getMemMarginFactor());
   // clang-format off
-  iosize += ENCODETOF(cc.bcIncROF,     CTF::BLCbcIncROF,     0);
-  iosize += ENCODETOF(cc.orbitIncROF,  CTF::BLCorbitIncROF,  0);
-  iosize += ENCODETOF(cc.ndigROF,      CTF::BLCndigROF,      0);
-  iosize += ENCODETOF(cc.ndiaROF,      CTF::BLCndiaROF,      0);
-  iosize += ENCODETOF(cc.ndiaCrate,    CTF::BLCndiaCrate,    0);
-  iosize += ENCODETOF(cc.timeFrameInc, CTF::BLCtimeFrameInc, 0);
-  iosize += ENCODETOF(cc.timeTDCInc,   CTF::BLCtimeTDCInc,   0);
-  iosize += ENCODETOF(cc.stripID,      CTF::BLCstripID,      0);
-  iosize += ENCODETOF(cc.chanInStrip,  CTF::BLCchanInStrip,  0);
-  iosize += ENCODETOF(cc.tot,          CTF::BLCtot,          0);
-  iosize += ENCODETOF(cc.pattMap,      CTF::BLCpattMap,      0);
+  ENCODETOF(cc.bcIncROF,     CTF::BLCbcIncROF,     0);
+  ENCODETOF(cc.orbitIncROF,  CTF::BLCorbitIncROF,  0);
+  ENCODETOF(cc.ndigROF,      CTF::BLCndigROF,      0);
+  ENCODETOF(cc.ndiaROF,      CTF::BLCndiaROF,      0);
+  ENCODETOF(cc.ndiaCrate,    CTF::BLCndiaCrate,    0);
+  ENCODETOF(cc.timeFrameInc, CTF::BLCtimeFrameInc, 0);
+  ENCODETOF(cc.timeTDCInc,   CTF::BLCtimeTDCInc,   0);
+  ENCODETOF(cc.stripID,      CTF::BLCstripID,      0);
+  ENCODETOF(cc.chanInStrip,  CTF::BLCchanInStrip,  0);
+  ENCODETOF(cc.tot,          CTF::BLCtot,          0);
+  ENCODETOF(cc.pattMap,      CTF::BLCpattMap,      0);
   // clang-format on
+  iosize += encodeBlocks(batch, buff);
   CTF::get(buff.data())->print(getPrefix(), mVerbosity);
   finaliseCTFOutput<CTF>(buff);
   iosize.rawIn = sizeof(ReadoutWindowData) * rofRecVec.size() + sizeof(Digit) * cdigVec.size() + sizeof(uint8_t) * pattVec.size();
@@ -125,20 +126,22 @@ o2::ctf::CTFIOSize CTFCoder::decode(const CTF::base& ec, VROF& rofRecVec, VDIG&
   cc.header = ec.getHeader();
   checkDictVersion(static_cast<const o2::ctf::CTFDictHeader&>(cc.header));
   o2::ctf::CTFIOSize iosize;
-#define DECODETOF(part, slot) ec.decode(part, int(slot), mCoders[int(slot)].get())
+  CTF::DecodingBatch batch(ec);
+#define DECODETOF(part, slot) batch.add(part, int(slot), mCoders[int(slot)].get())
   // clang-format off
-  iosize += DECODETOF(cc.bcIncROF,     CTF::BLCbcIncROF);
-  iosize += DECODETOF(cc.orbitIncROF,  CTF::BLCorbitIncROF);
-  iosize += DECODETOF(cc.ndigROF,      CTF::BLCndigROF);
-  iosize += DECODETOF(cc.ndiaROF,      CTF::BLCndiaROF);
-  iosize += DECODETOF(cc.ndiaCrate,    CTF::BLCndiaCrate);
-
-  iosize += DECODETOF(cc.timeFrameInc, CTF::BLCtimeFrameInc);
-  iosize += DECODETOF(cc.timeTDCInc,   CTF::BLCtimeTDCInc);
-  iosize += DECODETOF(cc.stripID,      CTF::BLCstripID);
-  iosize += DECODETOF(cc.chanInStrip,  CTF::BLCchanInStrip);
-  iosize += DECODETOF(cc.tot,          CTF::BLCtot);
-  iosize += DECODETOF(cc.pattMap,      CTF::BLCpattMap);
+  DECODETOF(cc.bcIncROF,     CTF::BLCbcIncROF);
+  DECODETOF(cc.orbitIncROF,  CTF::BLCorbitIncROF);
+  DECODETOF(cc.ndigROF,      CTF::BLCndigROF);
+  DECODETOF(cc.ndiaROF,      CTF::BLCndiaROF);
+  DECODETOF(cc.ndiaCrate,    CTF::BLCndiaCrate);
+
+  DECODETOF(cc.timeFrameInc, CTF::BLCtimeFrameInc);
+  DECODETOF(cc.timeTDCInc,   CTF::BLCtimeTDCInc);
+  DECODETOF(cc.stripID,      CTF::BLCstripID);
+  DECODETOF(cc.chanInStrip,  CTF::BLCchanInStrip);
+  DECODETOF(cc.tot,          CTF::BLCtot);
+  DECODETOF(cc.pattMap,      CTF::BLCpattMap);
+  iosize += decodeBlocks(batch);
   // clang-format on
   //
   decompress(cc, rofRecVec, cdigVec, pattVec);
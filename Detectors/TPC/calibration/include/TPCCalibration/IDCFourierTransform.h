@@ -17,6 +17,7 @@
 #ifndef ALICEO2_IDCFOURIERTRANSFORM_H_
 #define ALICEO2_IDCFOURIERTRANSFORM_H_
 
+#include <string>
 #include <vector>
 #include "Rtypes.h"
 #include "DataFormatsTPC/Defs.h"
@@ -71,6 +72,22 @@ class IDCFourierTransform : public IDCFourierTransformBase<Type>
     sNThreads = nThreads;
   }
 
+  /// set batched fast fourier transform for the aggregator: the intervals with the same distance between them are transformed with one FFTW plan
+  /// \param batched use batched FFTW plans or transform each interval separately
+  template <bool IsEnabled = true, typename std::enable_if<(IsEnabled && (std::is_same<Type, IDCFourierTransformBaseAggregator>::value)), int>::type = 0>
+  static void setBatchedFFT(const bool batched)
+  {
+    sBatchedFFT = batched;
+  }
+
+  /// set the file for the FFTW wisdom. If set, the batched FFTW plans are measured once and read from the wisdom in later runs
+  /// \param file name of the file from which the wisdom is read and to which new wisdom is written
+  static void setFFTWWisdomFile(const std::string& file)
+  {
+    sFFTWWisdomFile = file;
+    sFFTWWisdomImported = false;
+  }
+
   /// calculate fourier coefficients for one TPC side
   template <bool IsEnabled = true, typename std::enable_if<(IsEnabled && (std::is_same<Type, IDCFourierTransformBaseAggregator>::value)), int>::type = 0>
   void calcFourierCoefficients(const unsigned int timeFrames = 2000)
@@ -101,6 +118,12 @@ class IDCFourierTransform : public IDCFourierTransformBase<Type>
   /// get the number of threads used for calculation of the fourier coefficients
   static int getNThreads() { return sNThreads; }
 
+  /// get if batched FFTW plans are used for the aggregator
+  static bool getBatchedFFT() { return sBatchedFFT; }
+
+  /// get the file for the FFTW wisdom
+  static const std::string& getFFTWWisdomFile() { return sFFTWWisdomFile; }
+
   /// dump object to disc
   /// \param outFileName name of the output file
   /// \param outName name of the object in the output file
@@ -114,12 +137,18 @@ class IDCFourierTransform : public IDCFourierTransformBase<Type>
   void printFFTWPlan() const;
 
  private:
-  FourierCoeff mFourierCoefficients;         ///< fourier coefficients. interval -> coefficient
-  inline static int sFftw{1};                ///< using fftw or naive approach for calculation of fourier coefficients
-  inline static int sNThreads{1};            ///< number of threads which are used during the calculation of the fourier coefficients
-  fftwf_plan mFFTWPlan{nullptr};             ///<! FFTW plan which is used during the ft
-  std::vector<float*> mVal1DIDCs;            ///<! buffer for the 1D-IDC values for SIMD usage (each thread will get his one obejct)
-  std::vector<fftwf_complex*> mCoefficients; ///<! buffer for coefficients (each thread will get his one obejct)
+  FourierCoeff mFourierCoefficients;             ///< fourier coefficients. interval -> coefficient
+  inline static int sFftw{1};                    ///< using fftw or naive approach for calculation of fourier coefficients
+  inline static int sNThreads{1};                ///< number of threads which are used during the calculation of the fourier coefficients
+  inline static bool sBatchedFFT{true};          ///< using batched FFTW plans for the aggregator
+  inline static std::string sFFTWWisdomFile{};   ///< file for reading and writing the FFTW wisdom
+  inline static bool sFFTWWisdomImported{false}; ///< wisdom from sFFTWWisdomFile is already imported
+  fftwf_plan mFFTWPlan{nullptr};                 ///<! FFTW plan which is used during the ft
+  std::vector<float*> mVal1DIDCs;                ///<! buffer for the 1D-IDC values for SIMD usage (each thread will get his one obejct)
+  std::vector<fftwf_complex*> mCoefficients;     ///<! buffer for coefficients (each thread will get his one obejct)
+  std::vector<fftwf_plan> mFFTWPlansBatch;       ///<! batched FFTW plans: for each class of equidistant intervals the plan for the full chunks and for the last chunk
+  std::vector<unsigned int> mFFTWPlansBatchKey;  ///<! parameters (number of intervals, distances, alignments) for which the batched plans were created
+  std::vector<float> mCoefficientsBatch;         ///<! output of the batched ft in case less than all coefficients are stored
 
   /// calculate fourier coefficients
   void calcFourierCoefficientsNaive();
@@ -145,6 +174,21 @@ class IDCFourierTransform : public IDCFourierTransformBase<Type>
   /// initalizing fftw members
   void initFFTW3Members();
 
+  /// performing of ft of all intervals using batched FFTW plans. The intervals are split in classes of equidistant intervals: interval, interval + period, ...
+  /// \return returns false if the offsets of the intervals have no period and the ft was not performed
+  bool fftwBatch(const std::vector<float>& idcOneExpanded, const std::vector<unsigned int>& offsetIndex);
+
+  /// create FFTW plan for howmany ft of mRangeIDC values. If a wisdom file is set, the plan is measured or taken from the wisdom
+  /// \param howmany number of ft
+  /// \param idist distance between the input of two ft
+  /// \param odist distance between the output of two ft
+  /// \param in input of the first ft
+  /// \param out output of the first ft
+  fftwf_plan createFFTWPlanBatch(const int howmany, const int idist, const int odist, float* in, fftwf_complex* out) const;
+
+  /// destroy batched FFTW plans
+  void destroyFFTWPlansBatch();
+
   /// performing of ft using FFTW
   void fftwLoop(const std::vector<float>& idcOneExpanded, const std::vector<unsigned int>& offsetIndex, const unsigned int interval, const unsigned int thread);
 
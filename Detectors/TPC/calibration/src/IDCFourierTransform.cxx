@@ -15,6 +15,9 @@
 #include "Framework/Logger.h"
 #include "TFile.h"
 #include <fftw3.h>
+#include <algorithm>
+#include <cstring>
+#include <utility>
 
 #if (defined(WITH_OPENMP) || defined(_OPENMP)) && !defined(__CLING__)
 #include <omp.h>
@@ -30,6 +33,7 @@ o2::tpc::IDCFourierTransform<Type>::~IDCFourierTransform()
     fftwf_free(mCoefficients[thread]);
   }
   fftwf_destroy_plan(mFFTWPlan);
+  destroyFFTWPlansBatch();
 }
 
 template <class Type>
@@ -105,9 +109,11 @@ void o2::tpc::IDCFourierTransform<Type>::calcFourierCoefficientsFFTW3()
   const std::vector<float>& idcOneExpanded{this->getExpandedIDCOne()}; // 1D-IDC values which will be used for the FFT
 
   if constexpr (std::is_same_v<Type, IDCFourierTransformBaseAggregator>) {
+    if (!sBatchedFFT || !fftwBatch(idcOneExpanded, offsetIndex)) {
 #pragma omp parallel for num_threads(sNThreads)
-    for (unsigned int interval = 0; interval < this->getNIntervals(); ++interval) {
-      fftwLoop(idcOneExpanded, offsetIndex, interval, omp_get_thread_num());
+      for (unsigned int interval = 0; interval < this->getNIntervals(); ++interval) {
+        fftwLoop(idcOneExpanded, offsetIndex, interval, omp_get_thread_num());
+      }
     }
   } else {
     fftwLoop(idcOneExpanded, offsetIndex, 0, 0);
@@ -124,6 +130,150 @@ inline void o2::tpc::IDCFourierTransform<Type>::fftwLoop(const std::vector<float
   std::memcpy(&(*(mFourierCoefficients.mFourierCoefficients.begin() + mFourierCoefficients.getIndex(interval, 0))), mCoefficients[thread], mFourierCoefficients.getNCoefficientsPerTF() * sizeof(float)); // store coefficients
 }
 
+template <class Type>
+bool o2::tpc::IDCFourierTransform<Type>::fftwBatch(const std::vector<float>& idcOneExpanded, const std::vector<unsigned int>& offsetIndex)
+{
+  // find the period of the offsets of the intervals: e.g. for 128 orbits per TF and 12 orbits integration length the number of integration
+  // intervals per TF are 10, 11, 11, 10, ... and the intervals interval, interval + 3, interval + 6, ... have all the same distance
+  constexpr unsigned int MaxPeriod = 16;
+  const unsigned int nIntervals = this->getNIntervals();
+  unsigned int period = 1;
+  for (; period <= MaxPeriod && period < nIntervals; ++period) {
+    const unsigned int dist = offsetIndex[period] - offsetIndex[0];
+    unsigned int interval = period + 1;
+    for (; (interval < nIntervals) && (offsetIndex[interval] - offsetIndex[interval - period] == dist); ++interval) {
+    }
+    if (interval == nIntervals) {
+      break;
+    }
+  }
+  if (period > MaxPeriod) {
+    return false;
+  }
+  const unsigned int dist = (period < nIntervals) ? offsetIndex[period] - offsetIndex[0] : 0;
+
+  // the coefficients are written directly to the output if all coefficients are stored
+  const unsigned int nMax = getNMaxCoefficients();
+  const unsigned int nCoeffPerTF = mFourierCoefficients.getNCoefficientsPerTF();
+  const bool storeDirect = (nCoeffPerTF == 2 * nMax) && (mFourierCoefficients.getNCoefficients() >= nIntervals * nCoeffPerTF);
+  if (!storeDirect) {
+    mCoefficientsBatch.resize(2 * nMax * nIntervals);
+  }
+  float* outBase = storeDirect ? mFourierCoefficients.mFourierCoefficients.data() : mCoefficientsBatch.data();
+  float* in = const_cast<float*>(idcOneExpanded.data()); // the input of out of place r2c transforms is not modified by FFTW
+
+  // each class is split in chunks which are processed in parallel. Chunks of a multiple of 16 ft keep the SIMD alignment of the input and output
+  constexpr unsigned int ChunkAlign = 16;
+  const unsigned int nPerClassMax = (nIntervals + period - 1) / period;
+  const unsigned int nChunksPerClass = (sNThreads + period - 1) / period;
+  const unsigned int chunkSize = ((nPerClassMax + nChunksPerClass - 1) / nChunksPerClass + ChunkAlign - 1) / ChunkAlign * ChunkAlign;
+  const auto getNPerClass = [nIntervals, period](const unsigned int iClass) { return (nIntervals - iClass + period - 1) / period; };
+
+  // the plans can be reused as long as the intervals and the alignment of the input and output are the same
+  std::vector<unsigned int> key{nIntervals, period, dist, chunkSize, storeDirect};
+  for (unsigned int iClass = 0; iClass < std::min(period, nIntervals); ++iClass) {
+    key.emplace_back(fftwf_alignment_of(in + offsetIndex[iClass]));
+    key.emplace_back(fftwf_alignment_of(outBase + 2 * nMax * iClass));
+  }
+
+  if (key != mFFTWPlansBatchKey) {
+    destroyFFTWPlansBatch();
+    mFFTWPlansBatch.resize(2 * period, nullptr);
+    for (unsigned int iClass = 0; iClass < std::min(period, nIntervals); ++iClass) {
+      const unsigned int nFull = getNPerClass(iClass) / chunkSize;
+      const unsigned int nLast = getNPerClass(iClass) % chunkSize;
+      float* inClass = in + offsetIndex[iClass];
+      fftwf_complex* outClass = reinterpret_cast<fftwf_complex*>(outBase) + nMax * iClass;
+      if (nFull) {
+        mFFTWPlansBatch[2 * iClass] = createFFTWPlanBatch(chunkSize, dist, period * nMax, inClass, outClass);
+      }
+      if (nLast) {
+        mFFTWPlansBatch[2 * iClass + 1] = createFFTWPlanBatch(nLast, dist, period * nMax, inClass + nFull * chunkSize * dist, outClass + nFull * chunkSize * period * nMax);
+      }
+      if ((nFull && !mFFTWPlansBatch[2 * iClass]) || (nLast && !mFFTWPlansBatch[2 * iClass + 1])) {
+        LOGP(warning, "creation of batched FFTW plan failed, performing ft for each interval");
+        destroyFFTWPlansBatch();
+        return false;
+      }
+    }
+    mFFTWPlansBatchKey = std::move(key);
+  }
+
+  // class and index of first interval in the class for each chunk
+  std::vector<std::pair<unsigned int, unsigned int>> chunks;
+  for (unsigned int iClass = 0; iClass < std::min(period, nIntervals); ++iClass) {
+    for (unsigned int first = 0; first < getNPerClass(iClass); first += chunkSize) {
+      chunks.emplace_back(iClass, first);
+    }
+  }
+
+#pragma omp parallel for num_threads(sNThreads)
+  for (unsigned int iChunk = 0; iChunk < chunks.size(); ++iChunk) {
+    const auto [iClass, first] = chunks[iChunk];
+    const unsigned int nFT = std::min(chunkSize, getNPerClass(iClass) - first);
+    const unsigned int firstInterval = iClass + first * period;
+    const fftwf_plan plan = (nFT == chunkSize) ? mFFTWPlansBatch[2 * iClass] : mFFTWPlansBatch[2 * iClass + 1];
+    fftwf_execute_dft_r2c(plan, in + offsetIndex[firstInterval], reinterpret_cast<fftwf_complex*>(outBase) + nMax * firstInterval);
+    if (!storeDirect) {
+      // store only the requested coefficients
+      const unsigned int nCoeffCopy = std::min(nCoeffPerTF, 2 * nMax);
+      for (unsigned int iFT = 0; iFT < nFT; ++iFT) {
+        const unsigned int interval = firstInterval + iFT * period;
+        std::memcpy(&mFourierCoefficients(mFourierCoefficients.getIndex(interval, 0)), &mCoefficientsBatch[2 * nMax * interval], nCoeffCopy * sizeof(float));
+      }
+    }
+  }
+  return true;
+}
+
+template <class Type>
+fftwf_plan o2::tpc::IDCFourierTransform<Type>::createFFTWPlanBatch(const int howmany, const int idist, const int odist, float* in, fftwf_complex* out) const
+{
+  const int n = this->mRangeIDC;
+  if (sFFTWWisdomFile.empty()) {
+    return fftwf_plan_many_dft_r2c(1, &n, howmany, in, nullptr, 1, idist, out, nullptr, 1, odist, FFTW_ESTIMATE);
+  }
+
+  if (!sFFTWWisdomImported) {
+    sFFTWWisdomImported = true;
+    if (!fftwf_import_wisdom_from_filename(sFFTWWisdomFile.data())) {
+      LOGP(info, "no FFTW wisdom read from {}", sFFTWWisdomFile);
+    }
+  }
+
+  // measuring overwrites the input and output: plans which are not in the wisdom are measured on buffers with the same alignment and the wisdom is stored
+  fftwf_plan plan = fftwf_plan_many_dft_r2c(1, &n, howmany, in, nullptr, 1, idist, out, nullptr, 1, odist, FFTW_MEASURE | FFTW_WISDOM_ONLY);
+  if (!plan) {
+    const int alignIn = fftwf_alignment_of(in) / sizeof(float);
+    const int alignOut = fftwf_alignment_of(reinterpret_cast<float*>(out)) / sizeof(float);
+    float* bufIn = fftwf_alloc_real(static_cast<size_t>(howmany - 1) * idist + n + alignIn);
+    float* bufOut = fftwf_alloc_real(2 * (static_cast<size_t>(howmany - 1) * odist + getNMaxCoefficients()) + alignOut);
+    fftwf_plan planMeasure = fftwf_plan_many_dft_r2c(1, &n, howmany, bufIn + alignIn, nullptr, 1, idist, reinterpret_cast<fftwf_complex*>(bufOut + alignOut), nullptr, 1, odist, FFTW_MEASURE);
+    if (planMeasure) {
+      fftwf_destroy_plan(planMeasure);
+      if (!fftwf_export_wisdom_to_filename(sFFTWWisdomFile.data())) {
+        LOGP(warning, "FFTW wisdom could not be written to {}", sFFTWWisdomFile);
+      }
+    }
+    fftwf_free(bufIn);
+    fftwf_free(bufOut);
+    plan = fftwf_plan_many_dft_r2c(1, &n, howmany, in, nullptr, 1, idist, out, nullptr, 1, odist, FFTW_MEASURE | FFTW_WISDOM_ONLY);
+  }
+  return plan ? plan : fftwf_plan_many_dft_r2c(1, &n, howmany, in, nullptr, 1, idist, out, nullptr, 1, odist, FFTW_ESTIMATE);
+}
+
+template <class Type>
+void o2::tpc::IDCFourierTransform<Type>::destroyFFTWPlansBatch()
+{
+  for (auto& plan : mFFTWPlansBatch) {
+    if (plan) {
+      fftwf_destroy_plan(plan);
+    }
+  }
+  mFFTWPlansBatch.clear();
+  mFFTWPlansBatchKey.clear();
+}
+
 template <class Type>
 std::vector<std::vector<float>> o2::tpc::IDCFourierTransform<Type>::inverseFourierTransformNaive() const
 {
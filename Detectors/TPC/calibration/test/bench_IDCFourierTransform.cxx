@@ -0,0 +1,80 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+///
+/// \file bench_IDCFourierTransform.cxx
+/// \brief fourier coefficients/s of the aggregator with batched FFTW plans and with the ft of each interval
+///
+
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "TPCCalibration/IDCFourierTransform.h"
+
+namespace
+{
+using FtType = o2::tpc::IDCFourierTransform<o2::tpc::IDCFourierTransformBaseAggregator>;
+constexpr unsigned int RangeIDC = 200;
+
+// 1D-IDCs of the aggregator workflow: 10 or 11 integration intervals per TF for 128 orbits per TF and 12 orbits integration length.
+// The range arguments are the number of TFs, the number of stored coefficients, the number of threads and whether batched plans are used.
+// The FFTW wisdom is read from and written to the file given by the FFTW_WISDOM environment variable if set.
+void BM_IDCFourierTransform(benchmark::State& state)
+{
+  const unsigned int tfs = state.range(0);
+  const unsigned int nCoeff = state.range(1);
+  std::vector<unsigned int> intervalsPerTF;
+  for (unsigned int i = 0; i < tfs; ++i) {
+    intervalsPerTF.emplace_back((i % 3) ? 11 : 10);
+  }
+  std::mt19937 rng{0};
+  std::normal_distribution<float> gaus{1.f, 0.2f};
+  o2::tpc::IDCOne idcsLast, idcs;
+  for (const auto nIntervals : intervalsPerTF) {
+    for (unsigned int i = 0; i < nIntervals; ++i) {
+      idcsLast.mIDCOne.emplace_back(gaus(rng));
+      idcs.mIDCOne.emplace_back(gaus(rng));
+    }
+  }
+
+  const char* wisdom = std::getenv("FFTW_WISDOM");
+  FtType::setFFTWWisdomFile(wisdom ? wisdom : "");
+  FtType::setFFT(true);
+  FtType::setNThreads(state.range(2));
+  FtType::setBatchedFFT(state.range(3));
+  FtType idcFourierTransform{RangeIDC, nCoeff};
+  idcFourierTransform.setIDCs(idcsLast, intervalsPerTF);
+  idcFourierTransform.setIDCs(idcs, intervalsPerTF);
+  for (auto _ : state) {
+    idcFourierTransform.calcFourierCoefficients(tfs);
+    benchmark::DoNotOptimize(idcFourierTransform.getFourierCoefficients().getFourierCoefficients().data());
+  }
+  state.SetItemsProcessed(state.iterations() * tfs * (RangeIDC / 2 + 1));
+}
+
+void ftArgs(benchmark::internal::Benchmark* b)
+{
+  for (int nCoeff : {static_cast<int>(RangeIDC + 2), 60}) {
+    for (int nThreads : {1, 2, 4, 8}) {
+      for (int batched : {0, 1}) {
+        b->Args({2000, nCoeff, nThreads, batched});
+      }
+    }
+  }
+  b->ArgNames({"tfs", "nCoeff", "threads", "batched"});
+}
+} // namespace
+
+BENCHMARK(BM_IDCFourierTransform)->Apply(ftArgs)->Unit(benchmark::kMicrosecond)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -20,6 +20,7 @@
 #include <boost/test/unit_test.hpp>
 #include "TPCCalibration/IDCFourierTransform.h"
 #include "TRandom.h"
+#include <array>
 #include <numeric>
 
 namespace o2::tpc
@@ -27,6 +28,7 @@ namespace o2::tpc
 
 static constexpr float ABSTOLERANCE = 0.01f; // absolute tolerance is taken at small values near 0
 static constexpr float TOLERANCE = 0.4f;     // difference between original 1D-IDC and 1D-IDC from fourier transform -> inverse fourier transform
+static constexpr float FFTTOLERANCE = 1e-3f;  // relative difference in percent between the coefficients of the batched and of the single FFTs
 
 o2::tpc::IDCOne get1DIDCs(const std::vector<unsigned int>& integrationIntervals)
 {
@@ -89,6 +91,42 @@ BOOST_AUTO_TEST_CASE(IDCFourierTransformAggregator_test)
   }
 }
 
+// testing batched FT of aggregator by comparing with the FT of each interval
+BOOST_AUTO_TEST_CASE(IDCFourierTransformAggregatorBatched_test)
+{
+  const unsigned int integrationIntervals = 10; // number of integration intervals for first TF
+  const unsigned int tfs = 200;                 // number of aggregated TFs
+  const unsigned int rangeIDC = 200;            // number of IDCs used to calculate the fourier coefficients
+  using FtType = IDCFourierTransform<IDCFourierTransformBaseAggregator>;
+  gRandom->SetSeed(0);
+  FtType::setFFT(true);
+  FtType::setNThreads(3);
+
+  const auto intervalsPerTF = getIntegrationIntervalsPerTF(integrationIntervals, tfs);
+  const auto idcsLast = get1DIDCs(intervalsPerTF);
+  const auto idcs = get1DIDCs(intervalsPerTF);
+  for (const unsigned int nFourierCoeff : {rangeIDC + 2, 60u}) {
+    std::array<std::vector<float>, 2> coefficients;
+    for (int iType = 0; iType < 2; ++iType) {
+      FtType::setBatchedFFT(iType == 1);
+      FtType idcFourierTransform{rangeIDC, nFourierCoeff};
+      idcFourierTransform.setIDCs(idcsLast, intervalsPerTF);
+      idcFourierTransform.setIDCs(idcs, intervalsPerTF);
+      idcFourierTransform.calcFourierCoefficients(tfs);
+      coefficients[iType] = idcFourierTransform.getFourierCoefficients().getFourierCoefficients();
+    }
+    BOOST_REQUIRE(coefficients[0].size() == coefficients[1].size());
+    for (size_t i = 0; i < coefficients[0].size(); ++i) {
+      if (std::fabs(coefficients[0][i]) < ABSTOLERANCE) {
+        BOOST_CHECK_SMALL(coefficients[1][i] - coefficients[0][i], ABSTOLERANCE * FFTTOLERANCE / 100);
+      } else {
+        BOOST_CHECK_CLOSE(coefficients[1][i], coefficients[0][i], FFTTOLERANCE);
+      }
+    }
+  }
+  FtType::setBatchedFFT(true);
+}
+
 // testing FT of EPN
 BOOST_AUTO_TEST_CASE(IDCFourierTransformEPN_test)
 {
@@ -100,7 +100,7 @@ class PoissonSolver
   const RegularGrid& mGrid3D{};                                      ///< grid properties
   inline static DataT sConvergenceError{1e-6};                       ///< Error tolerated
   static constexpr DataT INVTWOPI = 1. / o2::constants::math::TwoPI; ///< inverse of 2*pi
-  inline static int sNThreads{4};                                    ///< number of threads which are used during some of the calculations (increasing this number has no big impact)
+  inline static int sNThreads{4};                                    ///< number of threads which are used during some of the calculations (relaxation, residue, restriction)
 
   /// Relative error calculation: comparison with exact solution
   ///
@@ -238,6 +238,24 @@ class PoissonSolver
   void relax3D(Vector& matricesCurrentV, const Vector& matricesCurrentCharge, const int tnRRow, const int tnZColumn, const int iPhi, const int symmetry, const DataT h2, const DataT tempRatioZ,
                const std::vector<DataT>& coefficient1, const std::vector<DataT>& coefficient2, const std::vector<DataT>& coefficient3, const std::vector<DataT>& coefficient4) const;
 
+  /// Cache-blocked Gauss-Seidel red-black relaxation, used by relax3D if MGParameters::blockedKernels is set.
+  /// The phi slices are split in contiguous blocks, one per thread. Within a block the black points of a slice are
+  /// relaxed as soon as the red points of both neighbouring slices are relaxed, so that each slice is loaded once per
+  /// relaxation instead of once per colour. The black points of the first and last slice of a block are relaxed after
+  /// all blocks are done. The result is identical to the one of the plain red-black sweeps.
+  /// For an odd number of slices without symmetry the first and last slice have the same colouring, in this case the
+  /// two colours are relaxed one after the other and the last slice is relaxed after the others.
+  /// The parameters are the same as for relax3D
+  void relax3DBlocked(Vector& matricesCurrentV, const Vector& matricesCurrentCharge, const int tnRRow, const int tnZColumn, const int iPhi, const int symmetry, const DataT h2, const DataT tempRatioZ,
+                      const std::vector<DataT>& coefficient1, const std::vector<DataT>& coefficient2, const std::vector<DataT>& coefficient3, const std::vector<DataT>& coefficient4) const;
+
+  /// Gauss-Seidel relaxation of the points of one colour of a phi slice
+  /// \param m phi slice
+  /// \param colour points with (i + j + m) % 2 == colour are relaxed, colour 0 is the first pass of the red-black relaxation
+  /// the other parameters are the same as for relax3D
+  void relaxSlice3D(Vector& matricesCurrentV, const Vector& matricesCurrentCharge, const int tnRRow, const int tnZColumn, const int iPhi, const int symmetry, const int m, const int colour, const DataT h2,
+                    const DataT tempRatioZ, const std::vector<DataT>& coefficient1, const std::vector<DataT>& coefficient2, const std::vector<DataT>& coefficient3, const std::vector<DataT>& coefficient4) const;
+
   /// Relax2D
   ///
   ///    Relaxation operation for multiGrid
@@ -441,6 +459,41 @@ class PoissonSolver
   void residue3D(Vector& residue, const Vector& matricesCurrentV, const Vector& matricesCurrentCharge, const int tnRRow, const int tnZColumn, const int tnPhi, const int symmetry, const DataT ih2, const DataT tempRatioZ,
                  const std::vector<DataT>& coefficient1, const std::vector<DataT>& coefficient2, const std::vector<DataT>& coefficient3, const std::vector<DataT>& inverseCoefficient4) const;
 
+  /// Residue of one phi slice, the inner points of the slice are written to residue
+  /// \param residue tnRRow * tnZColumn values of the residue of the slice
+  /// \param m phi slice
+  /// the other parameters are the same as for residue3D
+  void residueSlice3D(DataT* residue, const Vector& matricesCurrentV, const Vector& matricesCurrentCharge, const int tnRRow, const int tnZColumn, const int tnPhi, const int symmetry, const int m, const DataT ih2,
+                      const DataT tempRatioZ, const std::vector<DataT>& coefficient1, const std::vector<DataT>& coefficient2, const std::vector<DataT>& coefficient3, const std::vector<DataT>& inverseCoefficient4) const;
+
+  /// Residue calculation followed by the restriction to the coarser grid with full coarsening in phi (tnPhi == 2 * newPhiSlice)
+  /// done in one pass: each thread keeps the residue of the 3 fine slices needed for one coarse slice in a buffer,
+  /// so that the residue of the fine grid is not written to memory. The result is identical to residue3D + restrict3D.
+  /// \param matricesCurrentCharge coarser grid 2h
+  /// the other parameters are the same as for residue3D and describe the finer grid
+  void residueRestrict3D(Vector& matricesCurrentCharge, const Vector& matricesCurrentV, const Vector& matricesFineCharge, const int tnRRow, const int tnZColumn, const int tnPhi, const int symmetry, const DataT ih2,
+                         const DataT tempRatioZ, const std::vector<DataT>& coefficient1, const std::vector<DataT>& coefficient2, const std::vector<DataT>& coefficient3, const std::vector<DataT>& inverseCoefficient4) const;
+
+  /// Full weighting restriction of the fine slices 2m-1, 2m, 2m+1 to the slice m of the coarser grid, see restrict3D
+  /// \param matricesCurrentCharge coarser grid 2h
+  /// \param residueM residue of the fine slice 2m - 1
+  /// \param residue0 residue of the fine slice 2m, the boundary is taken from this slice
+  /// \param residueP residue of the fine slice 2m + 1
+  /// \param tnRRow number of vertices in r direction for coarser grid
+  /// \param tnZColumn number of vertices in z direction for coarser grid
+  /// \param m phi slice of the coarser grid
+  void restrictSlice3D(Vector& matricesCurrentCharge, const DataT* residueM, const DataT* residue0, const DataT* residueP, const int tnRRow, const int tnZColumn, const int m) const;
+
+  /// neighbouring phi slices of slice m, see relax3D for the treatment of the symmetries
+  static void getPhiNeighbours(const int m, const int nPhi, const int symmetry, int& mp1, int& mm1, DataT& signPlus, DataT& signMinus);
+
+  /// contiguous range [first, last) of the phi slices processed by a thread, used by the blocked kernels and for the first touch of the memory
+  static void getSliceRange(const int nPhi, const int nThreads, const int thread, int& first, int& last);
+
+  /// resize the vector and set all values to 0, each thread writes the slices it processes in the blocked kernels so that
+  /// the memory is placed on its NUMA node
+  void initVector(Vector& vec, const int tnRRow, const int tnZColumn, const int tnPhi) const;
+
   /// Residue2D
   ///
   ///    Compute residue from V(.) where V(.) is numerical potential and f(.).
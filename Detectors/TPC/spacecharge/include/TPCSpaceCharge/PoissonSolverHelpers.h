@@ -55,6 +55,7 @@ struct MGParameters {                                             ///< Parameter
   inline static int nMGCycle = 200;                               ///< number of multi grid cycle (V type)
   inline static int maxLoop = 7;                                  ///< the number of tree-deep of multi grid
   inline static int gamma = 1;                                    ///< number of iteration at coarsest level !TODO SET TO REASONABLE VALUE!
+  inline static bool blockedKernels = true;                       ///< use the cache-blocked red-black relaxation and the fused residue and restriction (same result as the plain loops)
 };
 
 template <typename DataT = double>
@@ -18,11 +18,40 @@
 #ifndef ALICEO2_TPC_VECTOR3D_H_
 #define ALICEO2_TPC_VECTOR3D_H_
 
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
 namespace o2
 {
 namespace tpc
 {
 
+/// allocator which default-initialises the values, i.e. resizing a vector of a fundamental type does not write to
+/// the new memory. Used to place the memory pages on the NUMA node of the thread which first writes them.
+template <typename T>
+struct DefaultInitAllocator : std::allocator<T> {
+  template <typename U>
+  struct rebind {
+    using other = DefaultInitAllocator<U>;
+  };
+
+  using std::allocator<T>::allocator;
+
+  template <typename U>
+  void construct(U* ptr) noexcept(std::is_nothrow_default_constructible_v<U>)
+  {
+    ::new (static_cast<void*>(ptr)) U;
+  }
+
+  template <typename U, typename... Args>
+  void construct(U* ptr, Args&&... args)
+  {
+    ::new (static_cast<void*>(ptr)) U(std::forward<Args>(args)...);
+  }
+};
+
 /// this is a simple vector class which is used in the poisson solver class
 
 /// \tparam DataT the data type of the mStorage which is used during the calculations
@@ -76,6 +105,18 @@ class Vector3D
   /// \param nz number of data points in r directions
   /// \param nphi number of data points in r directions
   void resize(const unsigned int nr, const unsigned int nz, const unsigned int nphi)
+  {
+    mNr = nr;
+    mNz = nz;
+    mNphi = nphi;
+    mStorage.resize(nr * nz * nphi, DataT{});
+  }
+
+  /// resize the vector without initialising the new values, they have to be set before they are read
+  /// \param nr number of data points in r directions
+  /// \param nz number of data points in r directions
+  /// \param nphi number of data points in r directions
+  void resizeNoInit(const unsigned int nr, const unsigned int nz, const unsigned int nphi)
   {
     mNr = nr;
     mNz = nz;
@@ -101,7 +142,7 @@ class Vector3D
   unsigned int mNr{};            ///< number of data points in r direction
   unsigned int mNz{};            ///< number of data points in z direction
   unsigned int mNphi{};          ///< number of data points in phi direction
-  std::vector<DataT> mStorage{}; ///< vector containing the data
+  std::vector<DataT, DefaultInitAllocator<DataT>> mStorage{}; ///< vector containing the data
 };
 
 } // namespace tpc
@@ -21,6 +21,7 @@
 #include "TPCSpaceCharge/PoissonSolver.h"
 #include "TPCSpaceCharge/PoissonSolverHelpers.h"
 #include "Framework/Logger.h"
+#include <algorithm>
 #include <numeric>
 #include <fmt/core.h>
 #include "TPCSpaceCharge/Vector3D.h"
@@ -416,14 +417,15 @@ void PoissonSolver<DataT>::poissonMultiGrid3D(DataContainer& matricesV, const Da
 
     // allocate memory for residue
     const int index = count - 1;
-    tvResidue[index].resize(tnRRow, tnZColumn, tPhiSlice);
-    tvPrevArrayV[index].resize(tnRRow, tnZColumn, tPhiSlice);
-    tvChargeFMG[index].resize(tnRRow, tnZColumn, tPhiSlice);
-    tvArrayV[index].resize(tnRRow, tnZColumn, tPhiSlice);
-    tvCharge[index].resize(tnRRow, tnZColumn, tPhiSlice);
+    initVector(tvResidue[index], tnRRow, tnZColumn, tPhiSlice);
+    initVector(tvPrevArrayV[index], tnRRow, tnZColumn, tPhiSlice);
+    initVector(tvChargeFMG[index], tnRRow, tnZColumn, tPhiSlice);
+    initVector(tvArrayV[index], tnRRow, tnZColumn, tPhiSlice);
+    initVector(tvCharge[index], tnRRow, tnZColumn, tPhiSlice);
 
     // memory for the finest grid is from parameters
     if (count == 1) {
+#pragma omp parallel for num_threads(sNThreads)
       for (int iphi = 0; iphi < mParamGrid.NPhiVertices; ++iphi) {
         for (int ir = 0; ir < mParamGrid.NRVertices; ++ir) {
           for (int iz = 0; iz < mParamGrid.NZVertices; ++iz) {
@@ -848,8 +850,14 @@ void PoissonSolver<DataT>::vCycle3D(const int symmetry, const int gridFrom, cons
       relax3D(tvArrayV[index], tvCharge[index], tnRRow, tnZColumn, tPhiSlice, symmetry, h2, tempRatioZ, coefficient1, coefficient2, coefficient3, coefficient4);
     } // end pre smoothing
 
-    // 2) Residue calculation
-    residue3D(tvResidue[index], tvArrayV[index], tvCharge[index], tnRRow, tnZColumn, tPhiSlice, symmetry, ih2, tempRatioZ, coefficient1, coefficient2, coefficient3, inverseCoefficient4);
+    // 2) Residue calculation and 3) Restriction, in one pass if the number of phi slices is halved
+    const int newPhiSlice = std::max(static_cast<int>(mParamGrid.NPhiVertices / (2 * kOne)), nnPhi);
+    const bool fuseResidueRestriction = MGParameters::blockedKernels && (2 * newPhiSlice == otPhiSlice);
+    if (fuseResidueRestriction) {
+      residueRestrict3D(tvCharge[count], tvArrayV[index], tvCharge[index], tnRRow, tnZColumn, tPhiSlice, symmetry, ih2, tempRatioZ, coefficient1, coefficient2, coefficient3, inverseCoefficient4);
+    } else {
+      residue3D(tvResidue[index], tvArrayV[index], tvCharge[index], tnRRow, tnZColumn, tPhiSlice, symmetry, ih2, tempRatioZ, coefficient1, coefficient2, coefficient3, inverseCoefficient4);
+    }
 
     iOne *= 2;
     jOne *= 2;
@@ -860,7 +868,9 @@ void PoissonSolver<DataT>::vCycle3D(const int symmetry, const int gridFrom, cons
     tPhiSlice = tPhiSlice < nnPhi ? nnPhi : tPhiSlice;
 
     //3) Restriction
-    restrict3D(tvCharge[count], tvResidue[index], tnRRow, tnZColumn, tPhiSlice, otPhiSlice);
+    if (!fuseResidueRestriction) {
+      restrict3D(tvCharge[count], tvResidue[index], tnRRow, tnZColumn, tPhiSlice, otPhiSlice);
+    }
 
     //4) Zeroing coarser V
     std::fill(tvArrayV[count].begin(), tvArrayV[count].end(), 0);
@@ -936,46 +946,83 @@ void PoissonSolver<DataT>::residue3D(Vector& residue, const Vector& matricesCurr
 {
 #pragma omp parallel for num_threads(sNThreads) // parallising this loop is possible - but using more than 2 cores makes it slower -
   for (int m = 0; m < tnPhi; ++m) {
-    int mp1 = m + 1;
-    int signPlus = 1;
-    int mm1 = m - 1;
-    int signMinus = 1;
-
-    // Reflection symmetry in phi (e.g. symmetry at sector boundaries, or half sectors, etc.)
-    if (symmetry == 1) {
-      if (mp1 > tnPhi - 1) {
-        mp1 = tnPhi - 2;
-      }
-      if (mm1 < 0) {
-        mm1 = 1;
-      }
-    }
-    // Anti-symmetry in phi
-    else if (symmetry == -1) {
-      if (mp1 > tnPhi - 1) {
-        mp1 = tnPhi - 2;
-        signPlus = -1;
-      }
-      if (mm1 < 0) {
-        mm1 = 1;
-        signMinus = -1;
-      }
-    } else { // No Symmetries in phi, no boundaries, the calculation is continuous across all phi
-      if (mp1 > tnPhi - 1) {
-        mp1 = m + 1 - tnPhi;
-      }
-      if (mm1 < 0) {
-        mm1 = m - 1 + tnPhi;
+    residueSlice3D(&residue(0, 0, m), matricesCurrentV, matricesCurrentCharge, tnRRow, tnZColumn, tnPhi, symmetry, m, ih2, tempRatioZ, coefficient1, coefficient2, coefficient3, inverseCoefficient4);
+  }
+}
+
+template <typename DataT>
+void PoissonSolver<DataT>::residueSlice3D(DataT* residue, const Vector& matricesCurrentV, const Vector& matricesCurrentCharge, const int tnRRow, const int tnZColumn, const int tnPhi, const int symmetry, const int m,
+                                          const DataT ih2, const DataT tempRatioZ, const std::vector<DataT>& coefficient1, const std::vector<DataT>& coefficient2, const std::vector<DataT>& coefficient3, const std::vector<DataT>& inverseCoefficient4) const
+{
+  int mp1 = 0;
+  int mm1 = 0;
+  DataT signPlus = 1;
+  DataT signMinus = 1;
+  getPhiNeighbours(m, tnPhi, symmetry, mp1, mm1, signPlus, signMinus);
+
+  const DataT* __restrict__ c1 = coefficient1.data();
+  const DataT* __restrict__ c2 = coefficient2.data();
+  const DataT* __restrict__ c3 = coefficient3.data();
+  const DataT* __restrict__ ic4 = inverseCoefficient4.data();
+  for (int j = 1; j < tnZColumn - 1; ++j) {
+    // rows in r direction
+    const DataT* __restrict__ v = &matricesCurrentV(0, j, m);
+    const DataT* __restrict__ vZMinus = &matricesCurrentV(0, j - 1, m);
+    const DataT* __restrict__ vZPlus = &matricesCurrentV(0, j + 1, m);
+    const DataT* __restrict__ vPhiPlus = &matricesCurrentV(0, j, mp1);
+    const DataT* __restrict__ vPhiMinus = &matricesCurrentV(0, j, mm1);
+    const DataT* __restrict__ charge = &matricesCurrentCharge(0, j, m);
+    DataT* __restrict__ res = residue + j * tnRRow;
+    for (int i = 1; i < tnRRow - 1; ++i) {
+      res[i] = ih2 * (c2[i] * v[i - 1] + tempRatioZ * (vZMinus[i] + vZPlus[i]) + c1[i] * v[i + 1] + c3[i] * (signPlus * vPhiPlus[i] + signMinus * vPhiMinus[i]) - ic4[i] * v[i]) + charge[i];
+    } // end cols
+  }   // end mParamGrid.NRVertices
+}
+
+template <typename DataT>
+void PoissonSolver<DataT>::residueRestrict3D(Vector& matricesCurrentCharge, const Vector& matricesCurrentV, const Vector& matricesFineCharge, const int tnRRow, const int tnZColumn, const int tnPhi, const int symmetry,
+                                             const DataT ih2, const DataT tempRatioZ, const std::vector<DataT>& coefficient1, const std::vector<DataT>& coefficient2, const std::vector<DataT>& coefficient3, const std::vector<DataT>& inverseCoefficient4) const
+{
+  const int newRRow = (tnRRow - 1) / 2 + 1;
+  const int newZColumn = (tnZColumn - 1) / 2 + 1;
+  const int newPhiSlice = tnPhi / 2;
+  const int sliceSize = tnRRow * tnZColumn;
+#ifdef WITH_OPENMP
+  const int nThreads = std::min(sNThreads, newPhiSlice);
+#else
+  const int nThreads = 1;
+#endif
+
+#pragma omp parallel num_threads(nThreads)
+  {
+#ifdef WITH_OPENMP
+    const int thread = omp_get_thread_num();
+    const int nBlocks = omp_get_num_threads();
+#else
+    const int thread = 0;
+    const int nBlocks = 1;
+#endif
+    int first = 0;
+    int last = 0;
+    getSliceRange(newPhiSlice, nBlocks, thread, first, last);
+
+    // residue of the fine slices 2m-1, 2m, 2m+1. The boundary points are never written and stay 0 as in residue3D
+    std::vector<DataT> buffer(3 * sliceSize);
+    DataT* residueM = buffer.data();
+    DataT* residue0 = residueM + sliceSize;
+    DataT* residueP = residue0 + sliceSize;
+    for (int m = first; m < last; ++m) {
+      const int mm = 2 * m;
+      if (m == first) {
+        // assuming no symmetry as in restrict3D
+        residueSlice3D(residueM, matricesCurrentV, matricesFineCharge, tnRRow, tnZColumn, tnPhi, symmetry, mm > 0 ? mm - 1 : tnPhi - 1, ih2, tempRatioZ, coefficient1, coefficient2, coefficient3, inverseCoefficient4);
+      } else {
+        std::swap(residueM, residueP); // slice 2m+1 of the previous coarse slice
       }
+      residueSlice3D(residue0, matricesCurrentV, matricesFineCharge, tnRRow, tnZColumn, tnPhi, symmetry, mm, ih2, tempRatioZ, coefficient1, coefficient2, coefficient3, inverseCoefficient4);
+      residueSlice3D(residueP, matricesCurrentV, matricesFineCharge, tnRRow, tnZColumn, tnPhi, symmetry, mm + 1, ih2, tempRatioZ, coefficient1, coefficient2, coefficient3, inverseCoefficient4);
+      restrictSlice3D(matricesCurrentCharge, residueM, residue0, residueP, newRRow, newZColumn, m);
     }
-
-    for (int j = 1; j < tnZColumn - 1; ++j) {
-      for (int i = 1; i < tnRRow - 1; ++i) {
-        residue(i, j, m) = ih2 * (coefficient2[i] * matricesCurrentV(i - 1, j, m) + tempRatioZ * (matricesCurrentV(i, j - 1, m) + matricesCurrentV(i, j + 1, m)) + coefficient1[i] * matricesCurrentV(i + 1, j, m) +
-                                  coefficient3[i] * (signPlus * matricesCurrentV(i, j, mp1) + signMinus * matricesCurrentV(i, j, mm1)) - inverseCoefficient4[i] * matricesCurrentV(i, j, m)) +
-                           matricesCurrentCharge(i, j, m);
-      } // end cols
-    }   // end mParamGrid.NRVertices
   }
 }
 
@@ -1200,6 +1247,10 @@ void PoissonSolver<DataT>::relax3D(Vector& matricesCurrentV, const Vector& matri
 {
   // Gauss-Seidel (Read Black}
   if (MGParameters::relaxType == RelaxType::GaussSeidel) {
+    if (MGParameters::blockedKernels) {
+      relax3DBlocked(matricesCurrentV, matricesCurrentCharge, tnRRow, tnZColumn, iPhi, symmetry, h2, tempRatioZ, coefficient1, coefficient2, coefficient3, coefficient4);
+      return;
+    }
     // for each slice
     for (int iPass = 1; iPass <= 2; ++iPass) {
       const int msw = (iPass % 2) ? 1 : 2;
@@ -1292,6 +1343,162 @@ void PoissonSolver<DataT>::relax3D(Vector& matricesCurrentV, const Vector& matri
   }
 }
 
+template <typename DataT>
+void PoissonSolver<DataT>::relax3DBlocked(Vector& matricesCurrentV, const Vector& matricesCurrentCharge, const int tnRRow, const int tnZColumn, const int iPhi, const int symmetry, const DataT h2,
+                                          const DataT tempRatioZ, const std::vector<DataT>& coefficient1, const std::vector<DataT>& coefficient2, const std::vector<DataT>& coefficient3, const std::vector<DataT>& coefficient4) const
+{
+#ifdef WITH_OPENMP
+  const int nThreads = std::min(sNThreads, iPhi);
+#else
+  const int nThreads = 1;
+#endif
+
+  // for an odd number of slices the periodic neighbours 0 and iPhi - 1 have the same colouring: relax the colours one after the other
+  // and the last slice, which needs the already relaxed points of the slice 0, at the end
+  if (symmetry == 0 && (iPhi % 2)) {
+    for (int colour = 0; colour < 2; ++colour) {
+#pragma omp parallel for num_threads(nThreads)
+      for (int m = 0; m < iPhi - 1; ++m) {
+        relaxSlice3D(matricesCurrentV, matricesCurrentCharge, tnRRow, tnZColumn, iPhi, symmetry, m, colour, h2, tempRatioZ, coefficient1, coefficient2, coefficient3, coefficient4);
+      }
+      relaxSlice3D(matricesCurrentV, matricesCurrentCharge, tnRRow, tnZColumn, iPhi, symmetry, iPhi - 1, colour, h2, tempRatioZ, coefficient1, coefficient2, coefficient3, coefficient4);
+    }
+    return;
+  }
+
+#pragma omp parallel num_threads(nThreads)
+  {
+#ifdef WITH_OPENMP
+    const int thread = omp_get_thread_num();
+    const int nBlocks = omp_get_num_threads();
+#else
+    const int thread = 0;
+    const int nBlocks = 1;
+#endif
+    int first = 0;
+    int last = 0;
+    getSliceRange(iPhi, nBlocks, thread, first, last);
+
+    // red points of slice m, then the black points of slice m - 1, whose red neighbours are all relaxed now.
+    // The red points of slice m + 1 still see the black points of slice m before the relaxation, as in the plain sweeps
+    for (int m = first; m < last; ++m) {
+      relaxSlice3D(matricesCurrentV, matricesCurrentCharge, tnRRow, tnZColumn, iPhi, symmetry, m, 0, h2, tempRatioZ, coefficient1, coefficient2, coefficient3, coefficient4);
+      if (m - 1 > first) {
+        relaxSlice3D(matricesCurrentV, matricesCurrentCharge, tnRRow, tnZColumn, iPhi, symmetry, m - 1, 1, h2, tempRatioZ, coefficient1, coefficient2, coefficient3, coefficient4);
+      }
+    }
+
+    // the black points of the first and last slice of the block need the red points of the neighbouring blocks
+#pragma omp barrier
+    if (first < last) {
+      relaxSlice3D(matricesCurrentV, matricesCurrentCharge, tnRRow, tnZColumn, iPhi, symmetry, first, 1, h2, tempRatioZ, coefficient1, coefficient2, coefficient3, coefficient4);
+    }
+    if (last - 1 > first) {
+      relaxSlice3D(matricesCurrentV, matricesCurrentCharge, tnRRow, tnZColumn, iPhi, symmetry, last - 1, 1, h2, tempRatioZ, coefficient1, coefficient2, coefficient3, coefficient4);
+    }
+  }
+}
+
+template <typename DataT>
+void PoissonSolver<DataT>::relaxSlice3D(Vector& matricesCurrentV, const Vector& matricesCurrentCharge, const int tnRRow, const int tnZColumn, const int iPhi, const int symmetry, const int m, const int colour,
+                                        const DataT h2, const DataT tempRatioZ, const std::vector<DataT>& coefficient1, const std::vector<DataT>& coefficient2, const std::vector<DataT>& coefficient3, const std::vector<DataT>& coefficient4) const
+{
+  int mp1 = 0;
+  int mm1 = 0;
+  DataT signPlus = 1;
+  DataT signMinus = 1;
+  getPhiNeighbours(m, iPhi, symmetry, mp1, mm1, signPlus, signMinus);
+
+  const DataT* __restrict__ c1 = coefficient1.data();
+  const DataT* __restrict__ c2 = coefficient2.data();
+  const DataT* __restrict__ c3 = coefficient3.data();
+  const DataT* __restrict__ c4 = coefficient4.data();
+  for (int j = 1; j < tnZColumn - 1; ++j) {
+    // the points of the other colour, which are read, are not modified in this loop
+    DataT* v = &matricesCurrentV(0, j, m);
+    const DataT* vZMinus = &matricesCurrentV(0, j - 1, m);
+    const DataT* vZPlus = &matricesCurrentV(0, j + 1, m);
+    const DataT* vPhiPlus = &matricesCurrentV(0, j, mp1);
+    const DataT* vPhiMinus = &matricesCurrentV(0, j, mm1);
+    const DataT* charge = &matricesCurrentCharge(0, j, m);
+    const int firstI = 1 + ((1 + j + m + colour) % 2);
+    for (int i = firstI; i < tnRRow - 1; i += 2) {
+      v[i] = (c2[i] * v[i - 1] + tempRatioZ * (vZMinus[i] + vZPlus[i]) + c1[i] * v[i + 1] + c3[i] * (signPlus * vPhiPlus[i] + signMinus * vPhiMinus[i]) + (h2 * charge[i])) * c4[i];
+    } // end cols
+  }   // end mParamGrid.NZVertices
+}
+
+template <typename DataT>
+void PoissonSolver<DataT>::getPhiNeighbours(const int m, const int nPhi, const int symmetry, int& mp1, int& mm1, DataT& signPlus, DataT& signMinus)
+{
+  mp1 = m + 1;
+  mm1 = m - 1;
+  signPlus = 1;
+  signMinus = 1;
+  // Reflection symmetry in phi (e.g. symmetry at sector boundaries, or half sectors, etc.)
+  if (symmetry == 1) {
+    if (mp1 > nPhi - 1) {
+      mp1 = nPhi - 2;
+    }
+    if (mm1 < 0) {
+      mm1 = 1;
+    }
+  }
+  // Anti-symmetry in phi
+  else if (symmetry == -1) {
+    if (mp1 > nPhi - 1) {
+      mp1 = nPhi - 2;
+      signPlus = -1;
+    }
+    if (mm1 < 0) {
+      mm1 = 1;
+      signMinus = -1;
+    }
+  } else { // No Symmetries in phi, no boundaries, the calculation is continuous across all phi
+    if (mp1 > nPhi - 1) {
+      mp1 = m + 1 - nPhi;
+    }
+    if (mm1 < 0) {
+      mm1 = m - 1 + nPhi;
+    }
+  }
+}
+
+template <typename DataT>
+void PoissonSolver<DataT>::getSliceRange(const int nPhi, const int nThreads, const int thread, int& first, int& last)
+{
+  first = nPhi * thread / nThreads;
+  last = nPhi * (thread + 1) / nThreads;
+}
+
+template <typename DataT>
+void PoissonSolver<DataT>::initVector(Vector& vec, const int tnRRow, const int tnZColumn, const int tnPhi) const
+{
+  vec.resizeNoInit(tnRRow, tnZColumn, tnPhi);
+#ifdef WITH_OPENMP
+  const int nThreads = std::min(sNThreads, tnPhi);
+#else
+  const int nThreads = 1;
+#endif
+
+#pragma omp parallel num_threads(nThreads)
+  {
+#ifdef WITH_OPENMP
+    const int thread = omp_get_thread_num();
+    const int nBlocks = omp_get_num_threads();
+#else
+    const int thread = 0;
+    const int nBlocks = 1;
+#endif
+    int first = 0;
+    int last = 0;
+    getSliceRange(tnPhi, nBlocks, thread, first, last);
+    if (first < last) {
+      std::fill_n(&vec(0, 0, first), (last - first) * tnRRow * tnZColumn, DataT(0));
+    }
+  }
+}
+
 template <typename DataT>
 void PoissonSolver<DataT>::relax2D(Vector& matricesCurrentV, const Vector& matricesCurrentCharge, const int tnRRow, const int tnZColumn, const DataT h2, const DataT tempFourth, const DataT tempRatio,
                                    std::vector<DataT>& coefficient1, std::vector<DataT>& coefficient2)
@@ -1379,45 +1586,53 @@ void PoissonSolver<DataT>::restrict3D(Vector& matricesCurrentCharge, const Vecto
       if (mm1 < 0) {
         mm1 = mm - 1 + (oldPhiSlice);
       }
+      restrictSlice3D(matricesCurrentCharge, &residue(0, 0, mm1), &residue(0, 0, mm), &residue(0, 0, mp1), tnRRow, tnZColumn, m);
+    } // end phis
 
-      for (int i = 1, ii = 2; i < tnRRow - 1; ++i, ii += 2) {
-        for (int j = 1, jj = 2; j < tnZColumn - 1; ++j, jj += 2) {
-
-          // at the same plane
-          const int iip1 = ii + 1;
-          const int iim1 = ii - 1;
-          const int jjp1 = jj + 1;
-          const int jjm1 = jj - 1;
-          const DataT s1 = residue(iip1, jj, mm) + residue(iim1, jj, mm) + residue(ii, jjp1, mm) + residue(ii, jjm1, mm) + residue(ii, jj, mp1) + residue(ii, jj, mm1);
+  } else {
+    for (int m = 0; m < newPhiSlice; ++m) {
+      restrict2D(matricesCurrentCharge, residue, tnRRow, tnZColumn, m);
+    }
+  }
+}
 
-          const DataT s2 = (residue(iip1, jjp1, mm) + residue(iip1, jjm1, mm) + residue(iip1, jj, mp1) + residue(iip1, jj, mm1)) +
-                           (residue(iim1, jjm1, mm) + residue(iim1, jjp1, mm) + residue(iim1, jj, mp1) + residue(iim1, jj, mm1)) +
-                           residue(ii, jjm1, mp1) + residue(ii, jjp1, mm1) + residue(ii, jjm1, mm1) + residue(ii, jjp1, mp1);
+template <typename DataT>
+void PoissonSolver<DataT>::restrictSlice3D(Vector& matricesCurrentCharge, const DataT* residueM, const DataT* residue0, const DataT* residueP, const int tnRRow, const int tnZColumn, const int m) const
+{
+  const int oldRRow = 2 * (tnRRow - 1) + 1; // number of vertices in r direction of the finer grid
+  for (int j = 1, jj = 2; j < tnZColumn - 1; ++j, jj += 2) {
+    // rows in r direction of the fine slices 2m-1, 2m, 2m+1 at jj-1, jj, jj+1
+    const DataT* rM[3] = {residueM + (jj - 1) * oldRRow, residueM + jj * oldRRow, residueM + (jj + 1) * oldRRow};
+    const DataT* r0[3] = {residue0 + (jj - 1) * oldRRow, residue0 + jj * oldRRow, residue0 + (jj + 1) * oldRRow};
+    const DataT* rP[3] = {residueP + (jj - 1) * oldRRow, residueP + jj * oldRRow, residueP + (jj + 1) * oldRRow};
+    DataT* charge = &matricesCurrentCharge(0, j, m);
+    for (int i = 1, ii = 2; i < tnRRow - 1; ++i, ii += 2) {
+      // at the same plane
+      const int iip1 = ii + 1;
+      const int iim1 = ii - 1;
+      const DataT s1 = r0[1][iip1] + r0[1][iim1] + r0[2][ii] + r0[0][ii] + rP[1][ii] + rM[1][ii];
 
-          const DataT s3 = (residue(iip1, jjp1, mp1) + residue(iip1, jjm1, mp1) + residue(iip1, jjp1, mm1) + residue(iip1, jjm1, mm1)) +
-                           (residue(iim1, jjm1, mm1) + residue(iim1, jjp1, mm1) + residue(iim1, jjm1, mp1) + residue(iim1, jjp1, mp1));
+      const DataT s2 = (r0[2][iip1] + r0[0][iip1] + rP[1][iip1] + rM[1][iip1]) +
+                       (r0[0][iim1] + r0[2][iim1] + rP[1][iim1] + rM[1][iim1]) +
+                       rP[0][ii] + rM[2][ii] + rM[0][ii] + rP[2][ii];
 
-          matricesCurrentCharge(i, j, m) = residue(ii, jj, mm) / 8 + s1 / 16 + s2 / 32 + s3 / 64;
-        } // end cols
-      }   // end mParamGrid.NRVertices
+      const DataT s3 = (rP[2][iip1] + rP[0][iip1] + rM[2][iip1] + rM[0][iip1]) +
+                       (rM[0][iim1] + rM[2][iim1] + rP[0][iim1] + rP[2][iim1]);
 
-      // for boundary
-      for (int j = 0, jj = 0; j < tnZColumn; ++j, jj += 2) {
-        matricesCurrentCharge(0, j, m) = residue(0, jj, mm);
-        matricesCurrentCharge(tnRRow - 1, j, m) = residue((tnRRow - 1) * 2, jj, mm);
-      }
+      charge[i] = r0[1][ii] / 8 + s1 / 16 + s2 / 32 + s3 / 64;
+    } // end cols
+  }   // end mParamGrid.NZVertices
 
-      // for boundary
-      for (int i = 0, ii = 0; i < tnRRow; ++i, ii += 2) {
-        matricesCurrentCharge(i, 0, m) = residue(ii, 0, mm);
-        matricesCurrentCharge(i, tnZColumn - 1, m) = residue(ii, (tnZColumn - 1) * 2, mm);
-      }
-    } // end phis
+  // for boundary
+  for (int j = 0, jj = 0; j < tnZColumn; ++j, jj += 2) {
+    matricesCurrentCharge(0, j, m) = residue0[jj * oldRRow];
+    matricesCurrentCharge(tnRRow - 1, j, m) = residue0[(tnRRow - 1) * 2 + jj * oldRRow];
+  }
 
-  } else {
-    for (int m = 0; m < newPhiSlice; ++m) {
-      restrict2D(matricesCurrentCharge, residue, tnRRow, tnZColumn, m);
-    }
+  // for boundary
+  for (int i = 0, ii = 0; i < tnRRow; ++i, ii += 2) {
+    matricesCurrentCharge(i, 0, m) = residue0[ii];
+    matricesCurrentCharge(i, tnZColumn - 1, m) = residue0[ii + (tnZColumn - 1) * 2 * oldRRow];
   }
 }
 
@@ -0,0 +1,115 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+///
+/// \file bench_PoissonSolver.cxx
+/// \brief time of the 3D multigrid poisson solver with the plain and the blocked kernels and the differences of the results
+///
+
+#include <algorithm>
+#include <cmath>
+
+#include <benchmark/benchmark.h>
+
+#include "CommonUtils/ConfigurableParam.h"
+#include "TPCSpaceCharge/DataContainer3D.h"
+#include "TPCSpaceCharge/PoissonSolver.h"
+#include "TPCSpaceCharge/PoissonSolverHelpers.h"
+#include "TPCSpaceCharge/SpaceChargeHelpers.h"
+
+namespace
+{
+using DataT = double;
+using DataContainer = o2::tpc::DataContainer3D<DataT>;
+using GridProp = o2::tpc::GridProperties<DataT>;
+constexpr unsigned short NPhi = 180;
+
+// charge density and boundary potential of the AnalyticalFields, as in the unit test of the solver.
+// The range arguments are the number of vertices in r and z, the cycle type and whether the blocked kernels are used.
+struct Problem {
+  Problem(unsigned short nRZ) : grid{GridProp::ZMIN, GridProp::RMIN, GridProp::PHIMIN, GridProp::getGridSpacingZ(nRZ), GridProp::getGridSpacingR(nRZ), GridProp::getGridSpacingPhi(NPhi)},
+                                charge(nRZ, nRZ, NPhi), potentialBoundary(nRZ, nRZ, NPhi)
+  {
+    o2::conf::ConfigurableParam::setValue<unsigned short>("TPCSpaceChargeParam", "NZVertices", nRZ);
+    o2::conf::ConfigurableParam::setValue<unsigned short>("TPCSpaceChargeParam", "NRVertices", nRZ);
+    o2::conf::ConfigurableParam::setValue<unsigned short>("TPCSpaceChargeParam", "NPhiVertices", NPhi);
+    const o2::tpc::AnalyticalFields<DataT> fields;
+    for (unsigned short iPhi = 0; iPhi < NPhi; ++iPhi) {
+      const DataT phi = grid.getPhiVertex(iPhi);
+      for (unsigned short iR = 0; iR < nRZ; ++iR) {
+        const DataT radius = grid.getRVertex(iR);
+        for (unsigned short iZ = 0; iZ < nRZ; ++iZ) {
+          const DataT z = grid.getZVertex(iZ);
+          charge(iZ, iR, iPhi) = fields.evalDensity(z, radius, phi);
+          if (iR == 0 || iR == nRZ - 1 || iZ == 0 || iZ == nRZ - 1) {
+            potentialBoundary(iZ, iR, iPhi) = fields.evalPotential(z, radius, phi);
+          }
+        }
+      }
+    }
+  }
+
+  DataContainer solve(bool blocked) const
+  {
+    o2::tpc::MGParameters::blockedKernels = blocked;
+    DataContainer potential = potentialBoundary;
+    o2::tpc::PoissonSolver<DataT> solver(grid);
+    solver.poissonSolver3D(potential, charge, 0);
+    return potential;
+  }
+
+  const o2::tpc::RegularGrid3D<DataT> grid;
+  DataContainer charge;
+  DataContainer potentialBoundary;
+};
+
+void BM_PoissonSolver3D(benchmark::State& state)
+{
+  const auto cycleTypeOld = o2::tpc::MGParameters::cycleType;
+  const auto blockedOld = o2::tpc::MGParameters::blockedKernels;
+  o2::tpc::MGParameters::isFull3D = true;
+  o2::tpc::MGParameters::cycleType = static_cast<o2::tpc::CycleType>(state.range(1));
+  const Problem problem(state.range(0));
+  const bool blocked = state.range(2);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(problem.solve(blocked));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0) * state.range(0) * NPhi);
+
+  // max. difference of the potential to the one obtained with the plain kernels
+  if (blocked) {
+    const auto potential = problem.solve(true);
+    const auto potentialPlain = problem.solve(false);
+    double maxDiff = 0;
+    for (size_t i = 0; i < potential.getData().size(); ++i) {
+      maxDiff = std::max(maxDiff, std::abs(potential[i] - potentialPlain[i]));
+    }
+    state.counters["maxDiffPlain"] = maxDiff;
+  }
+  o2::tpc::MGParameters::cycleType = cycleTypeOld;
+  o2::tpc::MGParameters::blockedKernels = blockedOld;
+}
+
+void solverArgs(benchmark::internal::Benchmark* b)
+{
+  for (int cycle : {static_cast<int>(o2::tpc::CycleType::FCycle), static_cast<int>(o2::tpc::CycleType::VCycle)}) {
+    for (int nRZ : {65, 129}) {
+      for (int blocked : {0, 1}) {
+        b->Args({nRZ, cycle, blocked});
+      }
+    }
+  }
+  b->ArgNames({"nRZ", "cycle", "blocked"});
+}
+} // namespace
+
+BENCHMARK(BM_PoissonSolver3D)->Apply(solverArgs)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -224,6 +224,41 @@ void poissonSolver2D()
   testAlmostEqualArray2D<DataT>(potentialAnalytical, potentialNumerical);
 }
 
+/// the blocked relaxation and the fused residue and restriction have to give the same potential as the plain loops
+template <typename DataT>
+void poissonSolver3DBlocked(const int nThreads)
+{
+  using GridProp = GridProperties<DataT>;
+  const o2::tpc::RegularGrid3D<DataT> grid3D{GridProp::ZMIN, GridProp::RMIN, GridProp::PHIMIN, GridProp::getGridSpacingZ(NZ), GridProp::getGridSpacingR(NR), GridProp::getGridSpacingPhi(NPHI)};
+
+  using DataContainer = o2::tpc::DataContainer3D<DataT>;
+  DataContainer potentialPlain(NZ, NR, NPHI);
+  DataContainer charge(NZ, NR, NPHI);
+
+  const o2::tpc::AnalyticalFields<DataT> analyticalFields;
+  setChargeDensityFromFormula<DataT>(analyticalFields, grid3D, charge);
+  setPotentialBoundaryFromFormula<DataT>(analyticalFields, grid3D, potentialPlain);
+  DataContainer potentialBlocked = potentialPlain;
+
+  const int nThreadsOld = PoissonSolver<DataT>::getNThreads();
+  PoissonSolver<DataT>::setNThreads(nThreads);
+  PoissonSolver<DataT> poissonSolver(grid3D);
+  const int symmetry = 0;
+  o2::tpc::MGParameters::blockedKernels = false;
+  poissonSolver.poissonSolver3D(potentialPlain, charge, symmetry);
+  o2::tpc::MGParameters::blockedKernels = true;
+  poissonSolver.poissonSolver3D(potentialBlocked, charge, symmetry);
+  PoissonSolver<DataT>::setNThreads(nThreadsOld);
+
+  for (size_t iPhi = 0; iPhi < potentialPlain.getNPhi(); ++iPhi) {
+    for (size_t iR = 0; iR < potentialPlain.getNR(); ++iR) {
+      for (size_t iZ = 0; iZ < potentialPlain.getNZ(); ++iZ) {
+        BOOST_CHECK_SMALL(potentialBlocked(iZ, iR, iPhi) - potentialPlain(iZ, iR, iPhi), DataT(1e-9));
+      }
+    }
+  }
+}
+
 BOOST_AUTO_TEST_CASE(PoissonSolver3D_test)
 {
   o2::tpc::MGParameters::isFull3D = true; //3D
@@ -244,6 +279,16 @@ BOOST_AUTO_TEST_CASE(PoissonSolver3D2D_test)
   poissonSolver3D<DataT>();
 }
 
+BOOST_AUTO_TEST_CASE(PoissonSolver3DBlocked_test)
+{
+  o2::tpc::MGParameters::isFull3D = true; //3D
+  o2::conf::ConfigurableParam::setValue<unsigned short>("TPCSpaceChargeParam", "NZVertices", NZ);
+  o2::conf::ConfigurableParam::setValue<unsigned short>("TPCSpaceChargeParam", "NRVertices", NR);
+  o2::conf::ConfigurableParam::setValue<unsigned short>("TPCSpaceChargeParam", "NPhiVertices", NPHI);
+  poissonSolver3DBlocked<DataT>(1);
+  poissonSolver3DBlocked<DataT>(3);
+}
+
 BOOST_AUTO_TEST_CASE(PoissonSolver2D_test)
 {
   o2::conf::ConfigurableParam::setValue<unsigned short>("TPCSpaceChargeParam", "NZVertices", NZ2D);
@@ -30,6 +30,8 @@ void customize(std::vector<ConfigParamSpec>& workflowOptions)
     {"inputLanes", VariantType::Int, 2, {"Number of expected input lanes."}},
     {"sendOutput", VariantType::Bool, false, {"send fourier coefficients"}},
     {"use-naive-fft", VariantType::Bool, false, {"using naive fourier transform (true) or FFTW (false)"}},
+    {"disable-batched-fft", VariantType::Bool, false, {"perform the FFTW fourier transform for each interval instead of using batched plans"}},
+    {"fftw-wisdom", VariantType::String, "", {"file from which the FFTW wisdom is read and to which new wisdom is written. If set, the FFTW plans are measured instead of estimated"}},
     {"process-SACs", VariantType::Bool, false, {"Process SACs instead if IDCs"}},
     {"configKeyValues", VariantType::String, "", {"Semicolon separated key=value strings"}}};
 
@@ -54,6 +56,8 @@ WorkflowSpec defineDataProcessing(ConfigContext const& config)
   const auto nthreadsFourier = static_cast<unsigned long>(config.options().get<int>("nthreads"));
   TPCFourierTransformAggregatorSpec::IDCFType::setNThreads(nthreadsFourier);
   TPCFourierTransformAggregatorSpec::IDCFType::setFFT(!fft);
+  TPCFourierTransformAggregatorSpec::IDCFType::setBatchedFFT(!config.options().get<bool>("disable-batched-fft"));
+  TPCFourierTransformAggregatorSpec::IDCFType::setFFTWWisdomFile(config.options().get<std::string>("fftw-wisdom"));
   const auto inputLanes = config.options().get<int>("inputLanes");
   WorkflowSpec workflow{getTPCFourierTransformAggregatorSpec(rangeIDC, nFourierCoeff, sendOutput, processSACs, inputLanes)};
   return workflow;
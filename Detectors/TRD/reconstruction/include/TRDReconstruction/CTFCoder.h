@@ -149,31 +149,32 @@ o2::ctf::CTFIOSize CTFCoder::encode_impl(VEC& buff, const gsl::span<const Trigge
 
   ec->setHeader(helper.createHeader());
   assignDictVersion(static_cast<o2::ctf::CTFDictHeader&>(ec->getHeader()));
-  ec->getANSHeader().majorVersion = 0;
-  ec->getANSHeader().minorVersion = 1;
+  ec->setANSHeader(mANSVersion);
   // at every encoding the buffer might be autoexpanded, so we don't work with fixed pointer ec
   o2::ctf::CTFIOSize iosize;
-#define ENCODETRD(beg, end, slot, bits) CTF::get(buff.data())->encode(beg, end, int(slot), bits, optField[int(slot)], &buff, mCoders[int(slot)].get(), getMemMarginFactor());
+  CTF::EncodingBatch batch;
+#define ENCODETRD(beg, end, slot, bits) batch.add(beg, end, int(slot), bits, optField[int(slot)], mCoders[int(slot)].get(), getMemMarginFactor());
   // clang-format off
-  iosize += ENCODETRD(helper.begin_bcIncTrig(),    helper.end_bcIncTrig(),     CTF::BLC_bcIncTrig,    0);
-  iosize += ENCODETRD(helper.begin_orbitIncTrig(), helper.end_orbitIncTrig(),  CTF::BLC_orbitIncTrig, 0);
-  iosize += ENCODETRD(helper.begin_entriesTrk(),   helper.end_entriesTrk(),    CTF::BLC_entriesTrk,   0);
-  iosize += ENCODETRD(helper.begin_entriesDig(),   helper.end_entriesDig(),    CTF::BLC_entriesDig,   0);
+  ENCODETRD(helper.begin_bcIncTrig(),    helper.end_bcIncTrig(),     CTF::BLC_bcIncTrig,    0);
+  ENCODETRD(helper.begin_orbitIncTrig(), helper.end_orbitIncTrig(),  CTF::BLC_orbitIncTrig, 0);
+  ENCODETRD(helper.begin_entriesTrk(),   helper.end_entriesTrk(),    CTF::BLC_entriesTrk,   0);
+  ENCODETRD(helper.begin_entriesDig(),   helper.end_entriesDig(),    CTF::BLC_entriesDig,   0);
 
-  iosize += ENCODETRD(helper.begin_HCIDTrk(),      helper.end_HCIDTrk(),       CTF::BLC_HCIDTrk,      0);
-  iosize += ENCODETRD(helper.begin_padrowTrk(),    helper.end_padrowTrk(),     CTF::BLC_padrowTrk,    0);
-  iosize += ENCODETRD(helper.begin_colTrk(),       helper.end_colTrk(),        CTF::BLC_colTrk,       0);
-  iosize += ENCODETRD(helper.begin_posTrk(),       helper.end_posTrk(),        CTF::BLC_posTrk,       0);
-  iosize += ENCODETRD(helper.begin_slopeTrk(),     helper.end_slopeTrk(),      CTF::BLC_slopeTrk,     0);
-  iosize += ENCODETRD(helper.begin_pidTrk(),       helper.end_pidTrk(),        CTF::BLC_pidTrk,       0);
+  ENCODETRD(helper.begin_HCIDTrk(),      helper.end_HCIDTrk(),       CTF::BLC_HCIDTrk,      0);
+  ENCODETRD(helper.begin_padrowTrk(),    helper.end_padrowTrk(),     CTF::BLC_padrowTrk,    0);
+  ENCODETRD(helper.begin_colTrk(),       helper.end_colTrk(),        CTF::BLC_colTrk,       0);
+  ENCODETRD(helper.begin_posTrk(),       helper.end_posTrk(),        CTF::BLC_posTrk,       0);
+  ENCODETRD(helper.begin_slopeTrk(),     helper.end_slopeTrk(),      CTF::BLC_slopeTrk,     0);
+  ENCODETRD(helper.begin_pidTrk(),       helper.end_pidTrk(),        CTF::BLC_pidTrk,       0);
 
-  iosize += ENCODETRD(helper.begin_CIDDig(),       helper.end_CIDDig(),        CTF::BLC_CIDDig,       0);
-  iosize += ENCODETRD(helper.begin_ROBDig(),       helper.end_ROBDig(),        CTF::BLC_ROBDig,       0);
-  iosize += ENCODETRD(helper.begin_MCMDig(),       helper.end_MCMDig(),        CTF::BLC_MCMDig,       0);
-  iosize += ENCODETRD(helper.begin_chanDig(),      helper.end_chanDig(),       CTF::BLC_chanDig,      0);
-  iosize += ENCODETRD(helper.begin_ADCDig(),       helper.end_ADCDig(),        CTF::BLC_ADCDig,       0);
+  ENCODETRD(helper.begin_CIDDig(),       helper.end_CIDDig(),        CTF::BLC_CIDDig,       0);
+  ENCODETRD(helper.begin_ROBDig(),       helper.end_ROBDig(),        CTF::BLC_ROBDig,       0);
+  ENCODETRD(helper.begin_MCMDig(),       helper.end_MCMDig(),        CTF::BLC_MCMDig,       0);
+  ENCODETRD(helper.begin_chanDig(),      helper.end_chanDig(),       CTF::BLC_chanDig,      0);
+  ENCODETRD(helper.begin_ADCDig(),       helper.end_ADCDig(),        CTF::BLC_ADCDig,       0);
 
   // clang-format on
+  iosize += encodeBlocks(batch, buff);
   CTF::get(buff.data())->print(getPrefix(), mVerbosity);
   finaliseCTFOutput<CTF>(buff);
   iosize.rawIn = trigData.size() * sizeof(TriggerRecord) + sizeof(Tracklet64) * trkData.size() + sizeof(Digit) * digData.size();
@@ -194,25 +195,27 @@ o2::ctf::CTFIOSize CTFCoder::decode(const CTF::base& ec, VTRG& trigVec, VTRK& tr
   std::vector<uint8_t> padrowTrk, colTrk, slopeTrk, ROBDig, MCMDig, chanDig;
 
   o2::ctf::CTFIOSize iosize;
-#define DECODETRD(part, slot) ec.decode(part, int(slot), mCoders[int(slot)].get())
+  CTF::DecodingBatch batch(ec);
+#define DECODETRD(part, slot) batch.add(part, int(slot), mCoders[int(slot)].get())
   // clang-format off
-  iosize += DECODETRD(bcInc,       CTF::BLC_bcIncTrig);
-  iosize += DECODETRD(orbitInc,    CTF::BLC_orbitIncTrig);
-  iosize += DECODETRD(entriesTrk,  CTF::BLC_entriesTrk);
-  iosize += DECODETRD(entriesDig,  CTF::BLC_entriesDig);
+  DECODETRD(bcInc,       CTF::BLC_bcIncTrig);
+  DECODETRD(orbitInc,    CTF::BLC_orbitIncTrig);
+  DECODETRD(entriesTrk,  CTF::BLC_entriesTrk);
+  DECODETRD(entriesDig,  CTF::BLC_entriesDig);
 
-  iosize += DECODETRD(HCIDTrk,     CTF::BLC_HCIDTrk);
-  iosize += DECODETRD(padrowTrk,   CTF::BLC_padrowTrk);
-  iosize += DECODETRD(colTrk,      CTF::BLC_colTrk);
-  iosize += DECODETRD(posTrk,      CTF::BLC_posTrk);
-  iosize += DECODETRD(slopeTrk,    CTF::BLC_slopeTrk);
-  iosize += DECODETRD(pidTrk,      CTF::BLC_pidTrk);
+  DECODETRD(HCIDTrk,     CTF::BLC_HCIDTrk);
+  DECODETRD(padrowTrk,   CTF::BLC_padrowTrk);
+  DECODETRD(colTrk,      CTF::BLC_colTrk);
+  DECODETRD(posTrk,      CTF::BLC_posTrk);
+  DECODETRD(slopeTrk,    CTF::BLC_slopeTrk);
+  DECODETRD(pidTrk,      CTF::BLC_pidTrk);
 
-  iosize += DECODETRD(CIDDig,      CTF::BLC_CIDDig);
-  iosize += DECODETRD(ROBDig,      CTF::BLC_ROBDig);
-  iosize += DECODETRD(MCMDig,      CTF::BLC_MCMDig);
-  iosize += DECODETRD(chanDig,     CTF::BLC_chanDig);
-  iosize += DECODETRD(ADCDig,      CTF::BLC_ADCDig);
+  DECODETRD(CIDDig,      CTF::BLC_CIDDig);
+  DECODETRD(ROBDig,      CTF::BLC_ROBDig);
+  DECODETRD(MCMDig,      CTF::BLC_MCMDig);
+  DECODETRD(chanDig,     CTF::BLC_chanDig);
+  DECODETRD(ADCDig,      CTF::BLC_ADCDig);
+  iosize += decodeBlocks(batch);
   // clang-format on
   //
   trigVec.clear();
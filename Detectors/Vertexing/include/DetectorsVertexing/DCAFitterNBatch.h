@@ -0,0 +1,743 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file DCAFitterNBatch.h
+/// \brief Batched single precision PCA finder for N-prongs candidates, same minimization as DCAFitterN
+
+#ifndef _ALICEO2_DCA_FITTERN_BATCH_
+#define _ALICEO2_DCA_FITTERN_BATCH_
+
+#include <array>
+#include <vector>
+#include <stdexcept>
+#include <type_traits>
+#include "gsl/span"
+#include "DetectorsVertexing/DCAFitterN.h"
+
+namespace o2
+{
+namespace vertexing
+{
+
+///__________________________________________________________________________________
+/// Finds the PCA of many N-prong candidates at once.
+/// The seeding (circles crossing, propagation of the prongs to the seed) is done per candidate exactly as in the
+/// DCAFitterN. The Newton iterations of Width seeds are then run in lockstep, in single precision and with all
+/// per seed quantities stored as arrays over the seeds, so that the compiler can vectorize the loops over the seeds.
+/// Seeds which converged or failed are masked and the lockstep loop stops once all seeds of the block are done.
+/// Since the tracks derivatives and the inverse covariances do not change during the minimization, everything but
+/// the residuals dependent terms of the chi2 derivatives is precalculated at the seed.
+/// Only the PCA, chi2 and number of iterations are provided: the tracks propagated to the PCA and the PCA
+/// covariance of the retained candidates should be obtained by the DCAFitterN.
+template <int N>
+class DCAFitterNBatch
+{
+  static_assert(N == 2 || N == 3, "batched fitter is implemented for 2 and 3 prongs only");
+  static constexpr float NInv = 1.f / N;
+  static constexpr int MAXHYP = 2;
+  static constexpr float XerrFactor = 5.; // factor for conversion of track covYY to dummy covXX, as in the DCAFitterN
+  static constexpr int NSym = N * (N + 1) / 2;
+  using Track = o2::track::TrackParCov;
+  using TrackAuxPar = o2::track::TrackAuxPar;
+  using CrossInfo = o2::track::CrossInfo;
+
+ public:
+  static constexpr int Width = 8; // number of seeds iterated in lockstep
+
+  ///< fit results of single candidate, hypotheses ordered in chi2
+  struct Fit {
+    int nCand = 0;
+    std::array<std::array<float, 3>, MAXHYP> pca{};
+    std::array<float, MAXHYP> chi2{};
+    std::array<int, MAXHYP> nIters{};
+  };
+
+  static constexpr int getNProngs() { return N; }
+
+  DCAFitterNBatch() = default;
+  DCAFitterNBatch(float bz, bool useAbsDCA) : mBz(bz), mUseAbsDCA(useAbsDCA) {}
+  explicit DCAFitterNBatch(const DCAFitterN<N>& fitter) { configure(fitter); }
+
+  ///< take the settings of the scalar fitter
+  void configure(const DCAFitterN<N>& fitter);
+
+  ///< fit all candidates: prongs[i][k] is the i-th prong of the k-th candidate. Returns the number of candidates with at least 1 PCA
+  template <typename T>
+  int process(const std::array<gsl::span<const T>, N>& prongs);
+
+  size_t size() const { return mFits.size(); }
+  const Fit& getFit(int k) const { return mFits[k]; }
+  int getNCandidates(int k) const { return mFits[k].nCand; }
+  const std::array<float, 3>& getPCACandidatePos(int k, int cand = 0) const { return mFits[k].pca[cand]; }
+  float getChi2AtPCACandidate(int k, int cand = 0) const { return mFits[k].chi2[cand]; }
+  int getNIterations(int k, int cand = 0) const { return mFits[k].nIters[cand]; }
+
+  void setMaxIter(int n = 20) { mMaxIter = n > 2 ? n : 2; }
+  void setMaxR(float r = 200.) { mMaxR2 = r * r; }
+  void setMaxDZIni(float d = 4.) { mMaxDZIni = d; }
+  void setMaxDXYIni(float d = 4.) { mMaxDXYIni = d > 0 ? d : 1e9; }
+  void setMaxChi2(float chi2 = 999.) { mMaxChi2 = chi2; }
+  void setBz(float bz) { mBz = std::abs(bz) > o2::constants::math::Almost0 ? bz : 0.f; }
+  void setMinParamChange(float x = 1e-3) { mMinParamChange = x > 1e-4 ? x : 1.e-4; }
+  void setMinRelChi2Change(float r = 0.9) { mMinRelChi2Change = r > 0.1 ? r : 999.; }
+  void setUseAbsDCA(bool v) { mUseAbsDCA = v; }
+  void setMaxDistance2ToMerge(float v) { mMaxDist2ToMergeSeeds = v; }
+  void setMatCorrType(o2::base::Propagator::MatCorrType m = o2::base::Propagator::MatCorrType::USEMatCorrLUT) { mMatCorr = m; }
+  void setUsePropagator(bool v) { mUsePropagator = v; }
+  void setMaxSnp(float s) { mMaxSnp = s; }
+  void setMaxStep(float s) { mMaxStep = s; }
+  void setMinXSeed(float x) { mMinXSeed = x; }
+
+  int getMaxIter() const { return mMaxIter; }
+  float getMaxChi2() const { return mMaxChi2; }
+  float getBz() const { return mBz; }
+  bool getUseAbsDCA() const { return mUseAbsDCA; }
+
+ private:
+  using Lanes = std::array<float, Width>;
+  enum Status : int { Active,
+                      Done,
+                      Failed,
+                      Abandoned }; // Abandoned: converged to the alternative seed
+
+  ///< seed to minimize: candidate, crossing point and alternative crossing point
+  struct Seed {
+    int cand = 0;
+    int crossID = 0;
+    bool checkAlt = false;
+    float x = 0, y = 0, xAlt = 0, yAlt = 0;
+  };
+
+  ///< result of the minimization of the seed
+  struct SeedFit {
+    int status = Failed;
+    int nIters = 0;
+    float chi2 = 0;
+    std::array<float, 3> pca{};
+  };
+
+  ///< Width seeds minimized in lockstep, each quantity is stored per seed
+  struct Block {
+    int nSeeds = 0;
+    std::array<int, Width> status;
+    std::array<int, Width> nIters;
+    std::array<int, Width> checkAlt;
+    Lanes chi2, maxCorr, seedX, seedY, altX, altY;
+    std::array<Lanes, 3> pca;
+    std::array<Lanes, N> cosA, sinA;                // track alpha cos and sin
+    std::array<Lanes, N> dydx, dzdx, d2ydx2, d2zdx2; // track derivatives over X param
+    std::array<Lanes, N> sxx, syy, syz, szz;         // track inverse cov. matrices (weighted distance only)
+    std::array<std::array<Lanes, 9>, N> coefT;       // tracks contributions to the PCA (weighted distance only)
+    std::array<std::array<Lanes, 3>, N> pos, res;    // tracks positions and residuals
+    std::array<std::array<Lanes, 3>, N * N> gradCoef; // DChi2/Dx_i = sum_j res_j * gradCoef[i*N+j]
+    std::array<std::array<Lanes, 3>, NSym> hessCoef; // D2Chi2/Dx_i/Dx_j = hessConst[ij] + res_{i or j} * hessCoef[ij]
+    std::array<Lanes, NSym> hessConst;
+  };
+
+  static constexpr int symID(int i, int j) { return i * (i + 1) / 2 + j; } // i >= j
+
+  template <typename T>
+  void setupSeed(Block& b, int l, const Seed& seed, const std::array<gsl::span<const T>, N>& prongs) const;
+  bool setupSeed(Block& b, int l, const Seed& seed, std::array<Track, N>& tracks) const;
+  template <typename T>
+  void minimize(std::vector<Seed>& seeds, std::vector<SeedFit>& fits, const std::array<gsl::span<const T>, N>& prongs) const;
+  void precalculate(Block& b) const;
+  void minimize(Block& b) const;
+  void calcPCA(Block& b) const;
+  void calcResiduals(Block& b) const;
+  void calcChi2(const Block& b, Lanes& chi2) const;
+  void correctTracks(Block& b) const;
+  bool propagateToX(Track& t, float x) const;
+  bool propagateParamToX(o2::track::TrackPar& t, float x) const;
+
+  ///< solve H * dx = g for all seeds, H is MxM symmetric matrix packed as 00, 10, 11, 20, 21, 22
+  template <int M>
+  static void solveSym(const std::array<Lanes, M*(M + 1) / 2>& h, const std::array<Lanes, M>& g, std::array<Lanes, M>& dx, Lanes& det);
+
+  std::vector<Fit> mFits;
+  std::vector<Seed> mSeeds;
+  std::vector<SeedFit> mSeedFits;
+
+  bool mUseAbsDCA = false;          // use abs. distance minimization rather than chi2
+  bool mUsePropagator = false;      // use propagator with 3D B-field, set automatically if material correction is requested
+  o2::base::Propagator::MatCorrType mMatCorr = o2::base::Propagator::MatCorrType::USEMatCorrNONE; // material corrections type
+  int mMaxIter = 20;                // max number of iterations
+  float mBz = 0;                    // bz field, to be set by user
+  float mMaxR2 = 200. * 200.;       // reject PCA's above this radius
+  float mMinXSeed = -50.;           // reject seed if it corresponds to X-param < mMinXSeed for one of candidates
+  float mMaxDZIni = 4.;             // reject (if>0) PCA candidate if tracks DZ exceeds threshold
+  float mMaxDXYIni = 4.;            // reject (if>0) PCA candidate if tracks dXY exceeds threshold
+  float mMinParamChange = 1e-3;     // stop iterations if largest change of any X is smaller than this
+  float mMinRelChi2Change = 0.9;    // stop iterations is chi2/chi2old > this
+  float mMaxChi2 = 100;             // abs cut on chi2 or abs distance
+  float mMaxDist2ToMergeSeeds = 1.; // merge 2 seeds to their average if their distance^2 is below the threshold
+  float mMaxSnp = 0.95;             // Max snp for propagation with Propagator
+  float mMaxStep = 2.0;             // Max step for propagation with Propagator
+};
+
+///_________________________________________________________________________
+template <int N>
+void DCAFitterNBatch<N>::configure(const DCAFitterN<N>& fitter)
+{
+  mUseAbsDCA = fitter.getUseAbsDCA();
+  mUsePropagator = fitter.getUsePropagator();
+  mMatCorr = fitter.getMatCorrType();
+  mMaxIter = fitter.getMaxIter();
+  mBz = fitter.getBz();
+  mMaxR2 = fitter.getMaxR() * fitter.getMaxR();
+  mMinXSeed = fitter.getMinXSeed();
+  mMaxDZIni = fitter.getMaxDZIni();
+  mMaxDXYIni = fitter.getMaxDXYIni();
+  mMinParamChange = fitter.getMinParamChange();
+  mMinRelChi2Change = fitter.getMinRelChi2Change();
+  mMaxChi2 = fitter.getMaxChi2();
+  mMaxDist2ToMergeSeeds = fitter.getMaxDistance2ToMerge();
+  mMaxSnp = fitter.getMaxSnp();
+  mMaxStep = fitter.getMasStep();
+}
+
+///_________________________________________________________________________
+template <int N>
+template <typename T>
+int DCAFitterNBatch<N>::process(const std::array<gsl::span<const T>, N>& prongs)
+{
+  // This is a main entry point: fit PCA of all N-prongs candidates
+  static_assert(std::is_convertible<T, Track>(), "Wrong track type");
+  size_t nCand = prongs[0].size();
+  for (int i = 1; i < N; i++) {
+    if (prongs[i].size() != nCand) {
+      throw std::runtime_error("different number of tracks provided for the prongs");
+    }
+  }
+  mFits.clear();
+  mFits.resize(nCand);
+  mSeeds.clear();
+  // seeding, as in the DCAFitterN::process
+  for (size_t k = 0; k < nCand; k++) {
+    TrackAuxPar aux0(prongs[0][k], mBz), aux1(prongs[1][k], mBz);
+    CrossInfo crossings;
+    if (!crossings.set(aux0, prongs[0][k], aux1, prongs[1][k], mMaxDXYIni)) { // even for N>2 it should be enough to test just 1 loop
+      continue;
+    }
+    if (crossings.nDCA == MAXHYP) { // if there are 2 candidates and they are too close, chose their mean as a starting point
+      auto dst2 = (crossings.xDCA[0] - crossings.xDCA[1]) * (crossings.xDCA[0] - crossings.xDCA[1]) +
+                  (crossings.yDCA[0] - crossings.yDCA[1]) * (crossings.yDCA[0] - crossings.yDCA[1]);
+      if (dst2 < mMaxDist2ToMergeSeeds) {
+        crossings.nDCA = 1;
+        crossings.xDCA[0] = 0.5 * (crossings.xDCA[0] + crossings.xDCA[1]);
+        crossings.yDCA[0] = 0.5 * (crossings.yDCA[0] + crossings.yDCA[1]);
+      }
+    }
+    for (int ic = 0; ic < crossings.nDCA; ic++) {
+      if (crossings.xDCA[ic] * crossings.xDCA[ic] + crossings.yDCA[ic] * crossings.yDCA[ic] > mMaxR2) {
+        continue;
+      }
+      auto& seed = mSeeds.emplace_back();
+      seed.cand = k;
+      seed.crossID = ic;
+      seed.x = crossings.xDCA[ic];
+      seed.y = crossings.yDCA[ic];
+      // In the DCAFitterN the alternative crossing is not checked anymore once the fit of the 1st seed converged to
+      // it. Here both seeds are minimized simultaneously with the check, the 2nd one is redone below if needed.
+      seed.checkAlt = crossings.nDCA == MAXHYP;
+      if (seed.checkAlt) {
+        seed.xAlt = crossings.xDCA[1 - ic];
+        seed.yAlt = crossings.yDCA[1 - ic];
+      }
+    }
+  }
+  mSeedFits.clear();
+  mSeedFits.resize(mSeeds.size());
+  minimize(mSeeds, mSeedFits, prongs);
+
+  std::vector<Seed> redoSeeds;
+  std::vector<int> redoIDs;
+  for (size_t is = 1; is < mSeeds.size(); is++) {
+    const auto &seed = mSeeds[is], &seedPrev = mSeeds[is - 1];
+    if (seed.crossID == 1 && seedPrev.cand == seed.cand && mSeedFits[is - 1].status == Abandoned && mSeedFits[is].status == Abandoned) {
+      redoSeeds.push_back(seed);
+      redoSeeds.back().checkAlt = false;
+      redoIDs.push_back(is);
+    }
+  }
+  if (redoSeeds.size()) {
+    std::vector<SeedFit> redoFits(redoSeeds.size());
+    minimize(redoSeeds, redoFits, prongs);
+    for (size_t ir = 0; ir < redoIDs.size(); ir++) {
+      mSeedFits[redoIDs[ir]] = redoFits[ir];
+    }
+  }
+
+  int nFound = 0;
+  for (size_t is = 0; is < mSeeds.size(); is++) {
+    const auto& sfit = mSeedFits[is];
+    if (sfit.status != Done || sfit.chi2 >= mMaxChi2) {
+      continue;
+    }
+    auto& fit = mFits[mSeeds[is].cand];
+    nFound += fit.nCand == 0;
+    fit.pca[fit.nCand] = sfit.pca;
+    fit.chi2[fit.nCand] = sfit.chi2;
+    fit.nIters[fit.nCand] = sfit.nIters;
+    fit.nCand++;
+  }
+  for (auto& fit : mFits) { // order in quality
+    if (fit.nCand == MAXHYP && fit.chi2[1] < fit.chi2[0]) {
+      std::swap(fit.pca[0], fit.pca[1]);
+      std::swap(fit.chi2[0], fit.chi2[1]);
+      std::swap(fit.nIters[0], fit.nIters[1]);
+    }
+  }
+  return nFound;
+}
+
+//__________________________________________________________________________
+template <int N>
+template <typename T>
+void DCAFitterNBatch<N>::minimize(std::vector<Seed>& seeds, std::vector<SeedFit>& fits, const std::array<gsl::span<const T>, N>& prongs) const
+{
+  // minimize the seeds in blocks of Width
+  Block b{};
+  for (size_t first = 0; first < seeds.size(); first += Width) {
+    b.nSeeds = std::min(int(seeds.size() - first), Width);
+    for (int l = 0; l < Width; l++) {
+      if (l < b.nSeeds) {
+        setupSeed(b, l, seeds[first + l], prongs);
+      } else {
+        b.status[l] = Failed;
+      }
+    }
+    precalculate(b);
+    minimize(b);
+    for (int l = 0; l < b.nSeeds; l++) {
+      auto& sfit = fits[first + l];
+      sfit.status = b.status[l];
+      sfit.nIters = b.nIters[l];
+      sfit.chi2 = b.chi2[l] * NInv;
+      sfit.pca = {b.pca[0][l], b.pca[1][l], b.pca[2][l]};
+    }
+  }
+}
+
+//__________________________________________________________________________
+template <int N>
+template <typename T>
+void DCAFitterNBatch<N>::setupSeed(Block& b, int l, const Seed& seed, const std::array<gsl::span<const T>, N>& prongs) const
+{
+  std::array<Track, N> tracks;
+  for (int i = 0; i < N; i++) {
+    tracks[i] = prongs[i][seed.cand];
+  }
+  b.status[l] = setupSeed(b, l, seed, tracks) ? Active : Failed;
+}
+
+//__________________________________________________________________________
+template <int N>
+bool DCAFitterNBatch<N>::setupSeed(Block& b, int l, const Seed& seed, std::array<Track, N>& tracks) const
+{
+  // propagate the tracks to the seed and fetch their parameters
+  b.nIters[l] = 0;
+  b.checkAlt[l] = seed.checkAlt;
+  b.seedX[l] = seed.x;
+  b.seedY[l] = seed.y;
+  b.altX[l] = seed.xAlt;
+  b.altY[l] = seed.yAlt;
+  b.chi2[l] = 0.f;
+  for (int i = 0; i < N; i++) {
+    float s, c;
+    o2::math_utils::sincos(tracks[i].getAlpha(), s, c);
+    b.cosA[i][l] = c;
+    b.sinA[i][l] = s;
+    auto x = c * seed.x + s * seed.y; // X of PCA in the track frame
+    if (x < mMinXSeed || !(mUseAbsDCA ? propagateParamToX(tracks[i], x) : propagateToX(tracks[i], x))) {
+      return false;
+    }
+    b.pos[i][0][l] = tracks[i].getX();
+    b.pos[i][1][l] = tracks[i].getY();
+    b.pos[i][2][l] = tracks[i].getZ();
+    TrackDeriv der(tracks[i], mBz);
+    b.dydx[i][l] = der.dydx;
+    b.dzdx[i][l] = der.dzdx;
+    b.d2ydx2[i][l] = der.d2ydx2;
+    b.d2zdx2[i][l] = der.d2zdx2;
+    if (!mUseAbsDCA) {
+      TrackCovI covI(tracks[i], XerrFactor);
+      b.sxx[i][l] = covI.sxx;
+      b.syy[i][l] = covI.syy;
+      b.syz[i][l] = covI.syz;
+      b.szz[i][l] = covI.szz;
+    }
+  }
+  if (mMaxDZIni > 0) { // apply rough cut on tracks Z difference
+    for (int i = N; i--;) {
+      for (int j = i; j--;) {
+        if (std::abs(b.pos[i][2][l] - b.pos[j][2][l]) > mMaxDZIni) {
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+//__________________________________________________________________________
+template <int N>
+void DCAFitterNBatch<N>::precalculate(Block& b) const
+{
+  // residuals derivatives (see DCAFitterN::calcResidDerivatives and DCAFitterN::calcResidDerivativesNoErr) and the
+  // parts of the chi2 derivatives which do not depend on the residuals
+  std::array<std::array<std::array<Lanes, 3>, N>, N> dr1, dr2;
+  if (!mUseAbsDCA) {
+    // tracks contribution matrices to the global PCA, T_i = [sum_{0<j<N} M_j*E_j*M_j^T]^-1 * M_i*E_i
+    std::array<Lanes, 6> wgh{};
+    for (int i = N; i--;) {
+      const auto &c = b.cosA[i], &s = b.sinA[i], &sxx = b.sxx[i], &syy = b.syy[i], &syz = b.syz[i], &szz = b.szz[i];
+      for (int l = 0; l < Width; l++) {
+        wgh[0][l] += c[l] * c[l] * sxx[l] + s[l] * s[l] * syy[l];
+        wgh[1][l] += c[l] * s[l] * (sxx[l] - syy[l]);
+        wgh[2][l] += c[l] * c[l] * syy[l] + s[l] * s[l] * sxx[l];
+        wgh[3][l] += -s[l] * syz[l];
+        wgh[4][l] += c[l] * syz[l];
+        wgh[5][l] += szz[l];
+      }
+    }
+    std::array<std::array<Lanes, 3>, 3> wghInv; // columns of the inverse
+    Lanes det;
+    for (int k = 0; k < 3; k++) {
+      std::array<Lanes, 3> unit{};
+      unit[k].fill(1.f);
+      solveSym<3>(wgh, unit, wghInv[k], det);
+    }
+    for (int l = 0; l < Width; l++) {
+      b.status[l] = det[l] == 0.f ? Failed : b.status[l];
+    }
+    for (int i = N; i--;) {
+      const auto &c = b.cosA[i], &s = b.sinA[i], &sxx = b.sxx[i], &syy = b.syy[i], &syz = b.syz[i], &szz = b.szz[i];
+      for (int r = 0; r < 3; r++) {
+        const auto &w0 = wghInv[0][r], &w1 = wghInv[1][r], &w2 = wghInv[2][r]; // row r of the inverse
+        auto &t0 = b.coefT[i][r * 3], &t1 = b.coefT[i][r * 3 + 1], &t2 = b.coefT[i][r * 3 + 2];
+        for (int l = 0; l < Width; l++) { // M_i*E_i = {{c*sxx, -s*syy, -s*syz}, {s*sxx, c*syy, c*syz}, {0, syz, szz}}
+          t0[l] = (w0[l] * c[l] + w1[l] * s[l]) * sxx[l];
+          t1[l] = (w1[l] * c[l] - w0[l] * s[l]) * syy[l] + w2[l] * syz[l];
+          t2[l] = (w1[l] * c[l] - w0[l] * s[l]) * syz[l] + w2[l] * szz[l];
+        }
+      }
+    }
+    for (int i = N; i--;) { // residual being differentiated
+      const auto &ci = b.cosA[i], &si = b.sinA[i];
+      for (int j = N; j--;) { // track over which we differentiate
+        const auto& t = b.coefT[j];
+        for (int l = 0; l < Width; l++) {
+          float matMT[3][3];
+          for (int k = 0; k < 3; k++) { // M_i^tr * T_j
+            matMT[0][k] = ci[l] * t[k][l] + si[l] * t[3 + k][l];
+            matMT[1][k] = -si[l] * t[k][l] + ci[l] * t[3 + k][l];
+            matMT[2][k] = t[6 + k][l];
+          }
+          for (int r = 0; r < 3; r++) {
+            dr1[i][j][r][l] = -(matMT[r][0] + matMT[r][1] * b.dydx[j][l] + matMT[r][2] * b.dzdx[j][l]);
+            dr2[i][j][r][l] = -(matMT[r][1] * b.d2ydx2[j][l] + matMT[r][2] * b.d2zdx2[j][l]);
+          }
+        }
+      }
+      for (int l = 0; l < Width; l++) {
+        dr1[i][i][0][l] += 1.f;
+        dr1[i][i][1][l] += b.dydx[i][l];
+        dr1[i][i][2][l] += b.dzdx[i][l];
+        dr2[i][i][1][l] += b.d2ydx2[i][l];
+        dr2[i][i][2][l] += b.d2zdx2[i][l];
+      }
+    }
+    // chi2 derivatives, see DCAFitterN::calcChi2Derivatives
+    for (int i = N; i--;) {
+      for (int j = N; j--;) {
+        const auto& d = dr1[j][i];
+        auto& cidr = b.gradCoef[i * N + j]; // covI_j * dres_j/dx_i
+        for (int l = 0; l < Width; l++) {
+          cidr[0][l] = b.sxx[j][l] * d[0][l];
+          cidr[1][l] = b.syy[j][l] * d[1][l] + b.syz[j][l] * d[2][l];
+          cidr[2][l] = b.syz[j][l] * d[1][l] + b.szz[j][l] * d[2][l];
+        }
+      }
+    }
+    for (int i = N; i--;) {
+      for (int j = i + 1; j--;) {
+        auto& hc = b.hessConst[symID(i, j)];
+        auto& hr = b.hessCoef[symID(i, j)];
+        const auto& d = dr2[j][j];
+        hc.fill(0.f);
+        for (int k = N; k--;) {
+          const auto &dk = dr1[k][j], &cidr = b.gradCoef[i * N + k];
+          for (int l = 0; l < Width; l++) {
+            hc[l] += dk[0][l] * cidr[0][l] + dk[1][l] * cidr[1][l] + dk[2][l] * cidr[2][l];
+          }
+        }
+        for (int l = 0; l < Width; l++) {
+          hr[0][l] = b.sxx[j][l] * d[0][l];
+          hr[1][l] = b.syy[j][l] * d[1][l] + b.syz[j][l] * d[2][l];
+          hr[2][l] = b.syz[j][l] * d[1][l] + b.szz[j][l] * d[2][l];
+        }
+      }
+    }
+  } else {
+    constexpr float NInv1 = 1.f - NInv;
+    for (int i = N; i--;) {
+      for (int l = 0; l < Width; l++) {
+        dr1[i][i][0][l] = NInv1;
+        dr1[i][i][1][l] = NInv1 * b.dydx[i][l];
+        dr1[i][i][2][l] = NInv1 * b.dzdx[i][l];
+        dr2[i][i][0][l] = 0.f;
+        dr2[i][i][1][l] = NInv1 * b.d2ydx2[i][l];
+        dr2[i][i][2][l] = NInv1 * b.d2zdx2[i][l];
+      }
+      for (int j = i; j--;) {
+        for (int l = 0; l < Width; l++) {
+          float cij = (b.cosA[i][l] * b.cosA[j][l] + b.sinA[i][l] * b.sinA[j][l]) * NInv; // cos(alp_i-alp_j) / N
+          float sij = (b.sinA[i][l] * b.cosA[j][l] - b.cosA[i][l] * b.sinA[j][l]) * NInv; // sin(alp_i-alp_j) / N
+          dr1[i][j][0][l] = -(cij + sij * b.dydx[j][l]);
+          dr1[i][j][1][l] = -(-sij + cij * b.dydx[j][l]);
+          dr1[i][j][2][l] = -b.dzdx[j][l] * NInv;
+          dr1[j][i][0][l] = -(cij - sij * b.dydx[i][l]);
+          dr1[j][i][1][l] = -(sij + cij * b.dydx[i][l]);
+          dr1[j][i][2][l] = -b.dzdx[i][l] * NInv;
+          dr2[i][j][0][l] = -sij * b.d2ydx2[j][l];
+          dr2[i][j][1][l] = -cij * b.d2ydx2[j][l];
+          dr2[i][j][2][l] = -b.d2zdx2[j][l] * NInv;
+        }
+      }
+    }
+    // chi2 derivatives, see DCAFitterN::calcChi2DerivativesNoErr
+    for (int i = N; i--;) {
+      for (int j = N; j--;) {
+        b.gradCoef[i * N + j] = dr1[j][i];
+      }
+      for (int j = i + 1; j--;) {
+        auto& hc = b.hessConst[symID(i, j)];
+        hc.fill(0.f);
+        for (int k = N; k--;) {
+          const auto &dki = dr1[k][i], &dkj = dr1[k][j];
+          for (int l = 0; l < Width; l++) {
+            hc[l] += dki[0][l] * dkj[0][l] + dki[1][l] * dkj[1][l] + dki[2][l] * dkj[2][l];
+          }
+        }
+        b.hessCoef[symID(i, j)] = dr2[i][j];
+      }
+    }
+  }
+}
+
+//__________________________________________________________________________
+template <int N>
+void DCAFitterNBatch<N>::minimize(Block& b) const
+{
+  // Newton-Raphson iterations of all seeds of the block, see DCAFitterN::minimizeChi2
+  calcPCA(b);
+  calcResiduals(b);
+  calcChi2(b, b.chi2);
+  Lanes chi2Upd;
+  while (true) {
+    bool active = false;
+    for (int l = 0; l < Width; l++) {
+      active |= b.status[l] == Active;
+    }
+    if (!active) {
+      break;
+    }
+    correctTracks(b);
+    calcPCA(b);
+    for (int l = 0; l < Width; l++) { // check if the PCA is closer to the alternative seed
+      float dxCur = b.pca[0][l] - b.seedX[l], dyCur = b.pca[1][l] - b.seedY[l];
+      float dxAlt = b.pca[0][l] - b.altX[l], dyAlt = b.pca[1][l] - b.altY[l];
+      bool abandon = b.status[l] == Active && b.checkAlt[l] && dxCur * dxCur + dyCur * dyCur > dxAlt * dxAlt + dyAlt * dyAlt;
+      b.status[l] = abandon ? Abandoned : b.status[l];
+    }
+    calcResiduals(b);
+    calcChi2(b, chi2Upd);
+    for (int l = 0; l < Width; l++) {
+      bool act = b.status[l] == Active;
+      bool converged = b.maxCorr[l] < mMinParamChange || chi2Upd[l] > b.chi2[l] * mMinRelChi2Change;
+      b.chi2[l] = act ? chi2Upd[l] : b.chi2[l];
+      b.nIters[l] += act && !converged;
+      b.status[l] = act && (converged || b.nIters[l] >= mMaxIter) ? Done : b.status[l];
+    }
+  }
+}
+
+//___________________________________________________________________
+template <int N>
+void DCAFitterNBatch<N>::correctTracks(Block& b) const
+{
+  // do Newton-Raphson step with corrections = - dchi2/d{x0..xN} * [ d^2chi2/d{x0..xN}^2 ]^-1 for active seeds
+  // and update the track positions
+  std::array<Lanes, N> grad{};
+  std::array<Lanes, NSym> hess;
+  for (int i = N; i--;) {
+    for (int j = N; j--;) {
+      const auto& res = b.res[j];
+      const auto& cf = b.gradCoef[i * N + j];
+      for (int l = 0; l < Width; l++) {
+        grad[i][l] += res[0][l] * cf[0][l] + res[1][l] * cf[1][l] + res[2][l] * cf[2][l];
+      }
+    }
+    for (int j = i + 1; j--;) {
+      const auto& res = b.res[mUseAbsDCA ? i : j];
+      const auto& cf = b.hessCoef[symID(i, j)];
+      const auto& hc = b.hessConst[symID(i, j)];
+      for (int l = 0; l < Width; l++) {
+        hess[symID(i, j)][l] = hc[l] + res[0][l] * cf[0][l] + res[1][l] * cf[1][l] + res[2][l] * cf[2][l];
+      }
+    }
+  }
+  std::array<Lanes, N> corr;
+  Lanes det;
+  solveSym<N>(hess, grad, corr, det);
+  for (int l = 0; l < Width; l++) {
+    b.status[l] = b.status[l] == Active && det[l] == 0.f ? Failed : b.status[l];
+    b.maxCorr[l] = 0.f;
+  }
+  for (int i = 0; i < N; i++) {
+    for (int l = 0; l < Width; l++) {
+      float dx = b.status[l] == Active ? corr[i][l] : 0.f, dx2h = 0.5f * dx * dx;
+      b.pos[i][0][l] -= dx;
+      b.pos[i][1][l] -= b.dydx[i][l] * dx - dx2h * b.d2ydx2[i][l];
+      b.pos[i][2][l] -= b.dzdx[i][l] * dx - dx2h * b.d2zdx2[i][l];
+      b.maxCorr[l] = std::max(b.maxCorr[l], std::abs(dx));
+    }
+  }
+}
+
+//___________________________________________________________________
+template <int N>
+void DCAFitterNBatch<N>::calcPCA(Block& b) const
+{
+  // calculate point of closest approach for the active seeds
+  std::array<Lanes, 3> pca{};
+  if (mUseAbsDCA) {
+    for (int i = N; i--;) {
+      const auto& pos = b.pos[i];
+      for (int l = 0; l < Width; l++) {
+        pca[0][l] += pos[0][l] * b.cosA[i][l] - pos[1][l] * b.sinA[i][l];
+        pca[1][l] += pos[0][l] * b.sinA[i][l] + pos[1][l] * b.cosA[i][l];
+        pca[2][l] += pos[2][l];
+      }
+    }
+    for (int r = 0; r < 3; r++) {
+      for (int l = 0; l < Width; l++) {
+        pca[r][l] *= NInv;
+      }
+    }
+  } else {
+    for (int i = N; i--;) {
+      const auto& pos = b.pos[i];
+      const auto& t = b.coefT[i];
+      for (int r = 0; r < 3; r++) {
+        for (int l = 0; l < Width; l++) {
+          pca[r][l] += t[r * 3][l] * pos[0][l] + t[r * 3 + 1][l] * pos[1][l] + t[r * 3 + 2][l] * pos[2][l];
+        }
+      }
+    }
+  }
+  for (int r = 0; r < 3; r++) {
+    for (int l = 0; l < Width; l++) {
+      b.pca[r][l] = b.status[l] == Active ? pca[r][l] : b.pca[r][l];
+    }
+  }
+}
+
+//___________________________________________________________________
+template <int N>
+void DCAFitterNBatch<N>::calcResiduals(Block& b) const
+{
+  // calculate residuals of tracks positions wrt the PCA in the tracks frames
+  for (int i = N; i--;) {
+    auto& res = b.res[i];
+    const auto& pos = b.pos[i];
+    for (int l = 0; l < Width; l++) {
+      res[0][l] = pos[0][l] - (b.pca[0][l] * b.cosA[i][l] + b.pca[1][l] * b.sinA[i][l]);
+      res[1][l] = pos[1][l] - (b.pca[1][l] * b.cosA[i][l] - b.pca[0][l] * b.sinA[i][l]);
+      res[2][l] = pos[2][l] - b.pca[2][l];
+    }
+  }
+}
+
+//___________________________________________________________________
+template <int N>
+void DCAFitterNBatch<N>::calcChi2(const Block& b, Lanes& chi2) const
+{
+  // calculate current chi2 (or abs. distance)
+  chi2.fill(0.f);
+  for (int i = N; i--;) {
+    const auto& res = b.res[i];
+    if (mUseAbsDCA) {
+      for (int l = 0; l < Width; l++) {
+        chi2[l] += res[0][l] * res[0][l] + res[1][l] * res[1][l] + res[2][l] * res[2][l];
+      }
+    } else {
+      for (int l = 0; l < Width; l++) {
+        chi2[l] += res[0][l] * res[0][l] * b.sxx[i][l] + res[1][l] * res[1][l] * b.syy[i][l] + res[2][l] * res[2][l] * b.szz[i][l] + 2.f * res[1][l] * res[2][l] * b.syz[i][l];
+      }
+    }
+  }
+}
+
+//___________________________________________________________________
+template <int N>
+template <int M>
+inline void DCAFitterNBatch<N>::solveSym(const std::array<Lanes, M*(M + 1) / 2>& h, const std::array<Lanes, M>& g, std::array<Lanes, M>& dx, Lanes& det)
+{
+  // by cofactors, dx is set to 0 for singular matrices
+  static_assert(M == 2 || M == 3, "only 2x2 and 3x3 matrices are supported");
+  for (int l = 0; l < Width; l++) {
+    if constexpr (M == 2) {
+      det[l] = h[0][l] * h[2][l] - h[1][l] * h[1][l];
+      float detI = det[l] != 0.f ? 1.f / det[l] : 0.f;
+      dx[0][l] = (h[2][l] * g[0][l] - h[1][l] * g[1][l]) * detI;
+      dx[1][l] = (h[0][l] * g[1][l] - h[1][l] * g[0][l]) * detI;
+    } else {
+      float c00 = h[2][l] * h[5][l] - h[4][l] * h[4][l], c10 = h[3][l] * h[4][l] - h[1][l] * h[5][l], c11 = h[0][l] * h[5][l] - h[3][l] * h[3][l];
+      float c20 = h[1][l] * h[4][l] - h[2][l] * h[3][l], c21 = h[1][l] * h[3][l] - h[0][l] * h[4][l], c22 = h[0][l] * h[2][l] - h[1][l] * h[1][l];
+      det[l] = h[0][l] * c00 + h[1][l] * c10 + h[3][l] * c20;
+      float detI = det[l] != 0.f ? 1.f / det[l] : 0.f;
+      dx[0][l] = (c00 * g[0][l] + c10 * g[1][l] + c20 * g[2][l]) * detI;
+      dx[1][l] = (c10 * g[0][l] + c11 * g[1][l] + c21 * g[2][l]) * detI;
+      dx[2][l] = (c20 * g[0][l] + c21 * g[1][l] + c22 * g[2][l]) * detI;
+    }
+  }
+}
+
+//___________________________________________________________________
+template <int N>
+inline bool DCAFitterNBatch<N>::propagateParamToX(o2::track::TrackPar& t, float x) const
+{
+  if (mUsePropagator || mMatCorr != o2::base::Propagator::MatCorrType::USEMatCorrNONE) {
+    return o2::base::Propagator::Instance()->PropagateToXBxByBz(t, x, mMaxSnp, mMaxStep, mMatCorr);
+  } else {
+    return t.propagateParamTo(x, mBz);
+  }
+}
+
+//___________________________________________________________________
+template <int N>
+inline bool DCAFitterNBatch<N>::propagateToX(o2::track::TrackParCov& t, float x) const
+{
+  if (mUsePropagator || mMatCorr != o2::base::Propagator::MatCorrType::USEMatCorrNONE) {
+    return o2::base::Propagator::Instance()->PropagateToXBxByBz(t, x, mMaxSnp, mMaxStep, mMatCorr);
+  } else {
+    return t.propagateTo(x, mBz);
+  }
+}
+
+using DCAFitter2Batch = DCAFitterNBatch<2>;
+using DCAFitter3Batch = DCAFitterNBatch<3>;
+
+} // namespace vertexing
+} // namespace o2
+#endif // _ALICEO2_DCA_FITTERN_BATCH_
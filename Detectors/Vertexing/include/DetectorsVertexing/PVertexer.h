@@ -119,10 +119,21 @@ class PVertexer
 
   void setPoolDumpDirectory(const std::string& d) { mPoolDumpDirectory = d; }
 
+  void setNThreads(int n);
+  int getNThreads() const { return mNThreads; }
+
   void printInpuTracksStatus(const VertexingInput& input) const;
 
  private:
   static constexpr int DBS_UNDEF = -2, DBS_NOISE = -1, DBS_INCHECK = -10;
+  static constexpr float DBS_MinZBin = 0.5f; ///< min. Z bin of the DBScan neighbours index
+  static constexpr int DBS_MaxZBins = 64;     ///< max. number of Z bins of the DBScan neighbours index
+
+  struct DBSCellEntry {
+    float z;     ///< track Z
+    float dzMax; ///< max |dz| at which the track can be a neighbour of the core point
+    int id;      ///< track ID in the pool
+  };
 
   SeedHistoTZ buildHistoTZ(const VertexingInput& input);
   int runVertexing(gsl::span<o2d::GlobalTrackID> gids, const gsl::span<o2::InteractionRecord> bcData,
@@ -151,7 +162,9 @@ class PVertexer
 
   std::pair<int, int> getBestIR(const PVertex& vtx, const gsl::span<o2::InteractionRecord> bcData, int& currEntry) const;
 
-  int dbscan_RangeQuery(int idxs, std::vector<int>& cand, std::vector<int>& status);
+  void dbscan_buildIndex();
+  int dbscan_RangeQuery(int idxs, std::vector<int>& cand, std::vector<int>& status, std::vector<int>& nbBuff) const;
+  void dbscan_clusterize(int first, int last, std::vector<int>& status, std::vector<TimeZCluster>& clusters) const;
   void dbscan_clusterize();
   void doDBScanDump(const VertexingInput& input, gsl::span<const o2::MCCompLabel> lblTracks);
   void doVtxDump(std::vector<PVertex>& vertices, std::vector<uint32_t> trackIDsLoc, std::vector<V2TRef>& v2tRefsLoc, gsl::span<const o2::MCCompLabel> lblTracks);
@@ -166,11 +179,19 @@ class PVertexer
   //
   std::vector<TrackVF> mTracksPool;         ///< tracks in internal representation used for vertexing, sorted in time
   std::vector<TimeZCluster> mTimeZClusters; ///< set of time clusters
+  std::vector<int> mDBSSliceID;             ///< DBScan time slice of each track
+  std::vector<int> mDBSCellStart;           ///< first entry of each DBScan (time slice, Z bin) cell, last element is the number of entries
+  std::vector<DBSCellEntry> mDBSCells;      ///< tracks which can be DBScan neighbours of the core points in the cell
+  float mDBSZMin = 0.;                      ///< lower edge of DBScan Z bins
+  float mDBSZBinI = 0.;                     ///< inverse DBScan Z bin width
+  int mDBSNZBins = 0;                       ///< number of DBScan Z bins
+  int mDBSNSlices = 0;                      ///< number of DBScan time slices
   float mITSROFrameLengthMUS = 0;           ///< ITS readout time span in \mus
   float mBz = 0.;                           ///< mag.field at beam line
   float mDBScanDeltaT = 0.;                 ///< deltaT cut for DBScan check
   float mDBSMaxZ2InvCorePoint = 0;          ///< inverse of max sigZ^2 of the track which can be core point in the DBScan
   bool mValidateWithIR = false;             ///< require vertex validation with InteractionRecords (if available)
+  int mNThreads = 1;                        ///< number of threads for the DBScan clustering
 
   o2::InteractionRecord mStartIR{0, 0}; ///< IR corresponding to the start of the TF
 
@@ -14,6 +14,7 @@
 /// \author ruben.shahoyan@cern.ch
 
 #include "DetectorsVertexing/DCAFitterN.h"
+#include "DetectorsVertexing/DCAFitterNBatch.h"
 
 namespace o2
 {
@@ -27,6 +28,11 @@ void __dummy_instance__()
   o2::track::TrackParCov tr;
   ft2.process(tr, tr);
   ft3.process(tr, tr, tr);
+  DCAFitter2Batch ft2b(ft2);
+  DCAFitter3Batch ft3b(ft3);
+  gsl::span<const o2::track::TrackParCov> trs(&tr, 1);
+  ft2b.process<o2::track::TrackParCov>({trs, trs});
+  ft3b.process<o2::track::TrackParCov>({trs, trs, trs});
 }
 
 } // namespace vertexing
@@ -20,6 +20,13 @@
 #include <unordered_map>
 #include "CommonUtils/StringUtils.h"
 #include <TH2F.h>
+#include <algorithm>
+#include <iterator>
+#include <limits>
+
+#ifdef WITH_OPENMP
+#include <omp.h>
+#endif
 
 using namespace o2::vertexing;
 
@@ -854,7 +861,64 @@ bool PVertexer::setCompatibleIR(PVertex& vtx)
 }
 
 //___________________________________________________________________
-int PVertexer::dbscan_RangeQuery(int id, std::vector<int>& cand, std::vector<int>& status)
+void PVertexer::dbscan_buildIndex()
+{
+  // Split the time sorted tracks pool to slices longer than the DBScan deltaT, so that the neighbours of the track
+  // may be only in its own or adjacent slices. Since the distance used by DBScan is >= dz^2*sig2ZI of the neighbour,
+  // the track can be a neighbour only of the core points within the dzMax = sqrt(dbscanMaxDist2/sig2ZI) from it,
+  // the tracks are registered in every Z bin of their slice overlapping with this range.
+  int ntr = mTracksPool.size();
+  mDBSSliceID.resize(ntr);
+  mDBSNSlices = 0;
+  if (!ntr) {
+    mDBSCellStart.assign(1, 0);
+    mDBSCells.clear();
+    return;
+  }
+  const float sliceDT = mDBScanDeltaT * 1.01f + 1e-3f; // margin for the rounding of the time differences
+  float zmin = mTracksPool[0].z, zmax = zmin, tSlice = 0.;
+  for (int it = 0; it < ntr; it++) {
+    const auto& trc = mTracksPool[it];
+    if (!mDBSNSlices || trc.timeEst.getTimeStamp() > tSlice + sliceDT) {
+      tSlice = trc.timeEst.getTimeStamp();
+      mDBSNSlices++;
+    }
+    mDBSSliceID[it] = mDBSNSlices - 1;
+    zmin = std::min(zmin, trc.z);
+    zmax = std::max(zmax, trc.z);
+  }
+  mDBSNZBins = std::clamp(int((zmax - zmin) / DBS_MinZBin) + 1, 1, DBS_MaxZBins);
+  mDBSZMin = zmin;
+  mDBSZBinI = mDBSNZBins / (zmax - zmin + 1e-3f);
+  auto zRange = [this](const TrackVF& trc, int& binMin, int& binMax) {
+    float dzMax = trc.sig2ZI > 0.f ? std::sqrt(mPVParams->dbscanMaxDist2 / trc.sig2ZI) * 1.001f + 1e-4f : std::numeric_limits<float>::infinity();
+    binMin = int(std::clamp((trc.z - dzMax - mDBSZMin) * mDBSZBinI, 0.f, mDBSNZBins - 1.f));
+    binMax = int(std::clamp((trc.z + dzMax - mDBSZMin) * mDBSZBinI, 0.f, mDBSNZBins - 1.f));
+    return dzMax;
+  };
+  mDBSCellStart.assign(mDBSNSlices * mDBSNZBins + 1, 0);
+  int binMin, binMax;
+  for (int it = 0; it < ntr; it++) {
+    zRange(mTracksPool[it], binMin, binMax);
+    for (int ib = binMin; ib <= binMax; ib++) {
+      mDBSCellStart[mDBSSliceID[it] * mDBSNZBins + ib + 1]++;
+    }
+  }
+  for (size_t ic = 1; ic < mDBSCellStart.size(); ic++) {
+    mDBSCellStart[ic] += mDBSCellStart[ic - 1];
+  }
+  mDBSCells.resize(mDBSCellStart.back());
+  std::vector<int> fill(mDBSCellStart.begin(), mDBSCellStart.end() - 1);
+  for (int it = 0; it < ntr; it++) { // entries of every cell are in increasing track ID
+    float dzMax = zRange(mTracksPool[it], binMin, binMax);
+    for (int ib = binMin; ib <= binMax; ib++) {
+      mDBSCells[fill[mDBSSliceID[it] * mDBSNZBins + ib]++] = DBSCellEntry{mTracksPool[it].z, dzMax, it};
+    }
+  }
+}
+
+//___________________________________________________________________
+int PVertexer::dbscan_RangeQuery(int id, std::vector<int>& cand, std::vector<int>& status, std::vector<int>& nbBuff) const
 {
   // find neighbours for dbscan cluster core point candidate
   // Since we use asymmetric distance definition, is it bit more complex than simple search within chi2 proximity
@@ -863,57 +927,52 @@ int PVertexer::dbscan_RangeQuery(int id, std::vector<int>& cand, std::vector<int
   if (tI.sig2ZI < mDBSMaxZ2InvCorePoint) {
     return nFound;
   }
-  int ntr = mTracksPool.size();
-
-  auto procPnt = [this, &tI, &status, &cand, &nFound, id](int idN) {
-    const auto& tL = this->mTracksPool[idN];
-    if (std::abs(tI.timeEst.getTimeStamp() - tL.timeEst.getTimeStamp()) > this->mDBScanDeltaT) {
-      return -1;
+  // Collect the neighbour candidates from the cells of the core point Z bin in the same and adjacent time slices and
+  // process them in the same order as the scan of the time sorted pool would do: first in time decreasing, then in
+  // time increasing direction.
+  const int slice = mDBSSliceID[id], bin = int(std::clamp((tI.z - mDBSZMin) * mDBSZBinI, 0.f, mDBSNZBins - 1.f));
+  nbBuff.clear();
+  for (int is = std::max(slice - 1, 0); is <= std::min(slice + 1, mDBSNSlices - 1); is++) {
+    int cell = is * mDBSNZBins + bin;
+    for (int ie = mDBSCellStart[cell]; ie < mDBSCellStart[cell + 1]; ie++) {
+      const auto& entry = mDBSCells[ie];
+      if (entry.id != id && std::abs(entry.z - tI.z) <= entry.dzMax &&
+          !(std::abs(tI.timeEst.getTimeStamp() - mTracksPool[entry.id].timeEst.getTimeStamp()) > mDBScanDeltaT)) {
+        nbBuff.push_back(entry.id);
+      }
     }
-    auto statN = status[idN], stat = status[id];
+  }
+  std::reverse(nbBuff.begin(), std::lower_bound(nbBuff.begin(), nbBuff.end(), id));
+
+  const auto stat = status[id];
+  for (auto idN : nbBuff) {
+    auto statN = status[idN];
     if (statN >= 0 && (stat < 0 || (stat >= 0 && statN != stat))) { // do not consider as a neighbour if already added to other cluster
-      return 0;
+      continue;
     }
-    auto dist2 = tL.getDist2(tI);
-    if (dist2 < this->mPVParams->dbscanMaxDist2) {
+    auto dist2 = mTracksPool[idN].getDist2(tI);
+    if (dist2 < mPVParams->dbscanMaxDist2) {
       nFound++;
       if (statN < 0 && statN > DBS_INCHECK) { // no point in adding for check already assigned point, or which is already in the list (i.e. < INCHECK)
         cand.push_back(idN);
         status[idN] += DBS_INCHECK; // flag that the track is in the candidates list (i.e. DBS_UDEF-10 = -12 or DPB_NOISE-10 = -11).
       }
     }
-    return 1;
-  };
-  int idL = id;
-  while (--idL >= 0) { // index in time decreasing direction
-    if (procPnt(idL) < 0) {
-      break;
-    }
-  }
-  int idU = id;
-  while (++idU < ntr) { // index in time increasing direction
-    if (procPnt(idU) < 0) {
-      break;
-    }
   }
   return nFound;
 }
 
-//_____________________________________________________
-void PVertexer::dbscan_clusterize()
+//___________________________________________________________________
+void PVertexer::dbscan_clusterize(int first, int last, std::vector<int>& status, std::vector<TimeZCluster>& clusters) const
 {
-  mTimeZClusters.clear();
-  int ntr = mTracksPool.size();
-  std::vector<int> status(ntr, DBS_UNDEF);
-  int clID = -1;
-
-  std::vector<int> nbVec;
-  for (int it = 0; it < ntr; it++) {
+  // clusterize tracks [first:last), which have no neighbours outside of this range
+  std::vector<int> nbVec, nbBuff;
+  for (int it = first; it < last; it++) {
     if (status[it] != DBS_UNDEF) {
       continue;
     }
     nbVec.clear();
-    auto nnb0 = dbscan_RangeQuery(it, nbVec, status);
+    auto nnb0 = dbscan_RangeQuery(it, nbVec, status, nbBuff);
     int minNeighbours = mPVParams->minTracksPerVtx - 1;
     if (nnb0 < minNeighbours) {
       status[it] = DBS_NOISE; // noise
@@ -922,8 +981,9 @@ void PVertexer::dbscan_clusterize()
     if (nnb0 > minNeighbours) {
       minNeighbours = std::max(minNeighbours, int(nnb0 * mPVParams->dbscanAdaptCoef));
     }
-    status[it] = ++clID;
-    auto& clusVec = mTimeZClusters.emplace_back().trackIDs; // new cluster
+    int clID = clusters.size();
+    status[it] = clID;
+    auto& clusVec = clusters.emplace_back().trackIDs; // new cluster
     clusVec.push_back(it);
 
     for (int j = 0; j < nnb0; j++) {
@@ -942,7 +1002,7 @@ void PVertexer::dbscan_clusterize()
       if (clusVec.size() > minNeighbours) {
         minNeighbours = std::max(minNeighbours, int(clusVec.size() * mPVParams->dbscanAdaptCoef));
       }
-      auto nnb1 = dbscan_RangeQuery(jt, nbVec, status);
+      auto nnb1 = dbscan_RangeQuery(jt, nbVec, status, nbBuff);
       if (nnb1 < minNeighbours) {
         for (unsigned k = ncurr; k < nbVec.size(); k++) {
           if (status[nbVec[k]] < DBS_INCHECK) {
@@ -955,6 +1015,45 @@ void PVertexer::dbscan_clusterize()
       }
     }
   }
+}
+
+//___________________________________________________________________
+void PVertexer::dbscan_clusterize()
+{
+  mTimeZClusters.clear();
+  int ntr = mTracksPool.size();
+  std::vector<int> status(ntr, DBS_UNDEF);
+  dbscan_buildIndex();
+
+  // Tracks separated by a time gap longer than the DBScan time slice cannot be neighbours, so the pool is split at such
+  // gaps to chunks which are clusterized independently. The cluster IDs in the status are local to the chunk, the
+  // clusters of all chunks are then concatenated in time order, which reproduces the result of the serial processing.
+  std::vector<int> chunkStart{0};
+  if (mNThreads > 1) {
+    const float gapDT = mDBScanDeltaT * 1.01f + 1e-3f;
+    const int minChunk = ntr / (4 * mNThreads) + 1;
+    for (int it = 1; it < ntr; it++) {
+      if (it - chunkStart.back() >= minChunk && mTracksPool[it].timeEst.getTimeStamp() > mTracksPool[it - 1].timeEst.getTimeStamp() + gapDT) {
+        chunkStart.push_back(it);
+      }
+    }
+  }
+  chunkStart.push_back(ntr);
+  int nChunks = chunkStart.size() - 1;
+  if (nChunks == 1) {
+    dbscan_clusterize(0, ntr, status, mTimeZClusters);
+  } else {
+    std::vector<std::vector<TimeZCluster>> chunkClusters(nChunks);
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(mNThreads)
+#endif
+    for (int ic = 0; ic < nChunks; ic++) {
+      dbscan_clusterize(chunkStart[ic], chunkStart[ic + 1], status, chunkClusters[ic]);
+    }
+    for (auto& clusters : chunkClusters) {
+      std::move(clusters.begin(), clusters.end(), std::back_inserter(mTimeZClusters));
+    }
+  }
 
   for (auto& clus : mTimeZClusters) {
     if (clus.trackIDs.size() < mPVParams->minTracksPerVtx) {
@@ -1199,3 +1298,13 @@ int PVertexer::processFromExternalPool(const std::vector<TrackVF>& pool, std::ve
   }
   return runVertexing(gids, bcData, vertices, vertexTrackIDs, v2tRefs, lblTracks, lblVtx);
 }
+
+//___________________________________________________________________
+void PVertexer::setNThreads(int n)
+{
+#ifdef WITH_OPENMP
+  mNThreads = n > 0 ? n : 1;
+#else
+  mNThreads = 1;
+#endif
+}
@@ -0,0 +1,190 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+///
+/// \file bench_DCAFitterNBatch.cxx
+/// \brief candidates/s of the DCAFitterN vs. DCAFitterNBatch and the differences of their results
+///
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "CommonConstants/MathConstants.h"
+#include "DetectorsVertexing/DCAFitterN.h"
+#include "DetectorsVertexing/DCAFitterNBatch.h"
+
+namespace
+{
+using Track = o2::track::TrackParCov;
+constexpr float Bz{5.f};
+
+// N-prong decays at 2-30 cm from the beam line, prongs smeared with the errors of the DCAFitterN unit test and
+// propagated by a random fraction of the curvature radius, so that the seeds need a few iterations.
+// The range argument is the number of candidates, O(10^3-10^5) per TF slice in the SVertexer.
+template <int N>
+struct Candidates {
+  Candidates(int nCand)
+  {
+    std::mt19937 rng{0};
+    std::uniform_real_distribution<float> uni{0.f, 1.f};
+    std::normal_distribution<float> gaus{0.f, 1.f};
+    const float errYZ = 1e-2, errSlp = 1e-3, errQPT = 2e-2;
+    std::array<float, 15> covm = {
+      errYZ * errYZ,
+      0., errYZ * errYZ,
+      0, 0., errSlp * errSlp,
+      0., 0., 0., errSlp * errSlp,
+      0., 0., 0., 0., errQPT * errQPT};
+    for (int i = 0; i < N; i++) {
+      prongs[i].reserve(nCand);
+    }
+    while (int(prongs[0].size()) < nCand) {
+      const float rdec = 2.f + 28.f * uni(rng), phiV = o2::constants::math::TwoPI * uni(rng);
+      const float vtx[3] = {rdec * std::cos(phiV), rdec * std::sin(phiV), 10.f * gaus(rng)};
+      std::array<Track, N> trc;
+      bool ok = true;
+      for (int i = 0; i < N && ok; i++) {
+        const float phi = phiV + 0.5f * gaus(rng), pt = 0.2f + 2.f * uni(rng);
+        float s, c, x;
+        std::array<float, 5> params;
+        o2::math_utils::sincos(phi, s, c);
+        o2::math_utils::rotateZInv(vtx[0], vtx[1], x, params[0], s, c);
+        params[0] += gaus(rng) * errYZ;
+        params[1] = vtx[2] + gaus(rng) * errYZ;
+        params[2] = gaus(rng) * errSlp;
+        params[3] = 0.5f * gaus(rng) + gaus(rng) * errSlp;
+        params[4] = (i % 2 ? -1.f : 1.f) / pt * (1.f + gaus(rng) * errQPT);
+        covm[14] = errQPT * errQPT * params[4] * params[4];
+        trc[i] = Track(x, phi, params, covm);
+        const float rad = std::abs(1.f / trc[i].getCurvature(Bz));
+        ok = trc[i].propagateTo(trc[i].getX() + (uni(rng) - 0.5f) * rad * 0.05f, Bz) && trc[i].rotate(trc[i].getAlpha() + (uni(rng) - 0.5f) * 0.2f);
+      }
+      if (ok) {
+        for (int i = 0; i < N; i++) {
+          prongs[i].push_back(trc[i]);
+        }
+      }
+    }
+  }
+
+  std::array<gsl::span<const Track>, N> spans() const
+  {
+    std::array<gsl::span<const Track>, N> sp;
+    for (int i = 0; i < N; i++) {
+      sp[i] = gsl::span<const Track>(prongs[i]);
+    }
+    return sp;
+  }
+
+  std::array<std::vector<Track>, N> prongs;
+};
+
+template <int N>
+o2::vertexing::DCAFitterN<N> makeFitter(bool useAbsDCA)
+{
+  o2::vertexing::DCAFitterN<N> ft;
+  ft.setBz(Bz);
+  ft.setPropagateToPCA(false); // the batch fitter does not provide the tracks at the PCA
+  ft.setMaxR(200);
+  ft.setMaxDZIni(4);
+  ft.setMinParamChange(1e-3);
+  ft.setMinRelChi2Change(0.9);
+  ft.setUseAbsDCA(useAbsDCA);
+  return ft;
+}
+
+template <int N>
+int processScalar(o2::vertexing::DCAFitterN<N>& ft, const Candidates<N>& cands, int k)
+{
+  if constexpr (N == 2) {
+    return ft.process(cands.prongs[0][k], cands.prongs[1][k]);
+  } else {
+    return ft.process(cands.prongs[0][k], cands.prongs[1][k], cands.prongs[2][k]);
+  }
+}
+
+template <int N>
+void BM_DCAFitterScalar(benchmark::State& state)
+{
+  const Candidates<N> cands(state.range(0));
+  auto ft = makeFitter<N>(state.range(1));
+  for (auto _ : state) {
+    int nFound = 0;
+    for (int k = 0; k < int(state.range(0)); k++) {
+      nFound += processScalar(ft, cands, k) > 0;
+    }
+    benchmark::DoNotOptimize(nFound);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Besides the timing, the results of the best hypothesis are compared with those of the DCAFitterN: the number of
+// candidates found by only one of the fitters, the mean and max. distance between the PCAs and the max. relative
+// difference of the chi2.
+template <int N>
+void BM_DCAFitterBatch(benchmark::State& state)
+{
+  const Candidates<N> cands(state.range(0));
+  auto ft = makeFitter<N>(state.range(1));
+  o2::vertexing::DCAFitterNBatch<N> ftb(ft);
+  const auto prongs = cands.spans();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(ftb.process(prongs));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+
+  int nDiff = 0, nCommon = 0;
+  double meanDPCA = 0, maxDPCA = 0, maxRelDChi2 = 0;
+  for (int k = 0; k < int(state.range(0)); k++) {
+    const int nc = processScalar(ft, cands, k);
+    if ((nc > 0) != (ftb.getNCandidates(k) > 0)) {
+      nDiff++;
+      continue;
+    }
+    if (!nc) {
+      continue;
+    }
+    const auto& pca = ft.getPCACandidatePos(0);
+    const auto& pcab = ftb.getPCACandidatePos(k);
+    const double d = std::sqrt((pca[0] - pcab[0]) * (pca[0] - pcab[0]) + (pca[1] - pcab[1]) * (pca[1] - pcab[1]) + (pca[2] - pcab[2]) * (pca[2] - pcab[2]));
+    const double chi2 = ft.getChi2AtPCACandidate(0);
+    meanDPCA += d;
+    maxDPCA = std::max(maxDPCA, d);
+    maxRelDChi2 = std::max(maxRelDChi2, std::abs(chi2 - ftb.getChi2AtPCACandidate(k)) / std::max(chi2, 1e-6));
+    nCommon++;
+  }
+  state.counters["nDiffCand"] = nDiff;
+  state.counters["meanDPCA"] = nCommon ? meanDPCA / nCommon : 0.;
+  state.counters["maxDPCA"] = maxDPCA;
+  state.counters["maxRelDChi2"] = maxRelDChi2;
+}
+
+void candidateArgs(benchmark::internal::Benchmark* b)
+{
+  for (int useAbsDCA : {1, 0}) {
+    for (int n = 1 << 10; n <= 1 << 16; n <<= 3) {
+      b->Args({n, useAbsDCA});
+    }
+  }
+  b->ArgNames({"candidates", "absDCA"});
+}
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_DCAFitterScalar, 2)->Apply(candidateArgs)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_DCAFitterBatch, 2)->Apply(candidateArgs)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_DCAFitterScalar, 3)->Apply(candidateArgs)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_DCAFitterBatch, 3)->Apply(candidateArgs)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
@@ -15,6 +15,7 @@
 #include <boost/test/unit_test.hpp>
 
 #include "DetectorsVertexing/DCAFitterN.h"
+#include "DetectorsVertexing/DCAFitterNBatch.h"
 #include "CommonUtils/TreeStreamRedirector.h"
 #include <TRandom.h>
 #include <TGenPhaseSpace.h>
@@ -387,5 +388,80 @@ BOOST_AUTO_TEST_CASE(DCAFitterNProngs)
   outStream.Close();
 }
 
+// the batched fitter should find the same candidates as the DCAFitterN, up to the single precision of its minimization
+template <int N>
+void compareBatch(bool useAbsDCA, TGenPhaseSpace& genPHS, double parMass, const std::vector<double>& dtMass)
+{
+  constexpr int NTest = 10000;
+  double bz = 5.0;
+  std::vector<int> forceQ(N, 1);
+  std::vector<o2::track::TrackParCov> vctracks;
+  std::array<std::vector<o2::track::TrackParCov>, N> prongs;
+  Vec3D vtxGen;
+  for (int iev = 0; iev < NTest; iev++) {
+    generate(vtxGen, vctracks, bz, genPHS, parMass, dtMass, forceQ);
+    for (int i = 0; i < N; i++) {
+      prongs[i].push_back(vctracks[i]);
+    }
+  }
+  o2::vertexing::DCAFitterN<N> ft;
+  ft.setBz(bz);
+  ft.setPropagateToPCA(false);
+  ft.setUseAbsDCA(useAbsDCA);
+  o2::vertexing::DCAFitterNBatch<N> ftb(ft);
+  std::array<gsl::span<const o2::track::TrackParCov>, N> spans;
+  for (int i = 0; i < N; i++) {
+    spans[i] = gsl::span<const o2::track::TrackParCov>(prongs[i]);
+  }
+  TStopwatch swB;
+  int nfoundB = ftb.process(spans);
+  swB.Stop();
+
+  TStopwatch swS;
+  swS.Stop();
+  int nfoundS = 0, nDiff = 0, nClose = 0;
+  for (int iev = 0; iev < NTest; iev++) {
+    swS.Start(false);
+    int nc = 0;
+    if constexpr (N == 2) {
+      nc = ft.process(prongs[0][iev], prongs[1][iev]);
+    } else {
+      nc = ft.process(prongs[0][iev], prongs[1][iev], prongs[2][iev]);
+    }
+    swS.Stop();
+    nfoundS += nc > 0;
+    if ((nc > 0) != (ftb.getNCandidates(iev) > 0)) {
+      nDiff++;
+      continue;
+    }
+    if (nc) {
+      const auto pca = ft.getPCACandidatePos(0);
+      const auto& pcab = ftb.getPCACandidatePos(iev);
+      float dx = pca[0] - pcab[0], dy = pca[1] - pcab[1], dz = pca[2] - pcab[2];
+      nClose += dx * dx + dy * dy + dz * dz < 5e-3 * 5e-3;
+    }
+  }
+  LOG(info) << N << "-prongs " << (useAbsDCA ? "abs" : "wgh") << ".dist: batched fitter found " << nfoundB << " scalar " << nfoundS
+            << " candidates, " << nDiff << " differ, " << nClose << " PCAs within 50 mum. CPU time batched: "
+            << swB.CpuTime() << " scalar: " << swS.CpuTime();
+  BOOST_CHECK(nDiff < 0.01 * NTest);
+  BOOST_CHECK(nClose > 0.98 * (nfoundS - nDiff));
+}
+
+BOOST_AUTO_TEST_CASE(DCAFitterNBatchProngs)
+{
+  TGenPhaseSpace genPHS;
+  constexpr double pion = 0.13957;
+  constexpr double k0 = 0.49761;
+  constexpr double kch = 0.49368;
+  constexpr double dch = 1.86965;
+  std::vector<double> k0dec = {pion, pion};
+  std::vector<double> dchdec = {pion, kch, pion};
+  for (bool useAbsDCA : {true, false}) {
+    compareBatch<2>(useAbsDCA, genPHS, k0, k0dec);
+    compareBatch<3>(useAbsDCA, genPHS, dch, dchdec);
+  }
+}
+
 } // namespace vertexing
 } // namespace o2
@@ -199,10 +199,32 @@ AlgorithmSpec AODJAlienReaderHelpers::rootFileReaderCallback()
       }
     }
 
+    // read the next dataframes on background threads while the current one
+    // is processed
+    std::vector<header::DataHeader> prefetchedHeaders;
+    std::shared_ptr<DataFramePrefetcher> prefetcher = nullptr;
+    auto prefetchDepth = options.get<int>("aod-prefetch");
+    auto columnThreads = options.get<int>("aod-column-threads");
+    if (prefetchDepth > 0) {
+      for (auto& route : requestedTables) {
+        if ((spec.inputTimesliceId % route.maxTimeslices) != route.timeslice) {
+          continue;
+        }
+        auto concrete = DataSpecUtils::asConcreteDataMatcher(route.matcher);
+        prefetchedHeaders.emplace_back(concrete.description, concrete.origin, concrete.subSpec);
+      }
+      auto memoryLimit = options.get<int64_t>("aod-prefetch-memory-limit") * 1024 * 1024;
+      prefetcher = std::make_shared<DataFramePrefetcher>(didir, prefetchedHeaders, spec.inputTimesliceId, spec.maxInputTimeslices,
+                                                         prefetchDepth, options.get<int>("aod-prefetch-threads"), memoryLimit, columnThreads);
+    }
+
     auto fileCounter = std::make_shared<int>(0);
     auto numTF = std::make_shared<int>(-1);
     return adaptStateless([TFNumberHeader,
                            requestedTables,
+                           columnThreads,
+                           prefetchedHeaders,
+                           prefetcher,
                            fileCounter,
                            numTF,
                            watchdog,
@@ -236,6 +258,9 @@ AlgorithmSpec AODJAlienReaderHelpers::rootFileReaderCallback()
         LOGP(info, "Stopping reader {} after time frame {}.", device.inputTimesliceId, watchdog->numberTimeFrames - 1);
         dumpFileMetrics(monitoring, currentFile, currentFileStartedAt, currentFileIOTime, tfCurrentFile, ntf);
         monitoring.flushBuffer();
+        if (prefetcher) {
+          prefetcher->stop();
+        }
         didir->closeInputFiles();
         control.endOfStream();
         control.readyToQuit(QuitRequest::Me);
@@ -244,6 +269,35 @@ AlgorithmSpec AODJAlienReaderHelpers::rootFileReaderCallback()
 
       auto ioStart = uv_hrtime();
 
+      // the tables were read ahead, only hand them over
+      if (prefetcher) {
+        PrefetchedDataFrame df;
+        if (!prefetcher->next(df)) {
+          LOGP(info, "No input files left to read for reader {}!", device.inputTimesliceId);
+          prefetcher->stop();
+          didir->closeInputFiles();
+          control.endOfStream();
+          control.readyToQuit(QuitRequest::Me);
+          return;
+        }
+        outputs.make<uint64_t>(Output(TFNumberHeader)) = df.timeFrameNumber;
+        for (auto i = 0u; i < prefetchedHeaders.size(); ++i) {
+          outputs.adopt(Output(prefetchedHeaders[i]), df.tables[i]);
+        }
+        totalSizeCompressed += df.bytesCompressed;
+        totalSizeUncompressed += df.bytesUncompressed;
+
+        totalDFSent++;
+        monitoring.send(Metric{(uint64_t)totalDFSent, "df-sent"}.addTag(Key::Subsystem, monitoring::tags::Value::DPL));
+        monitoring.send(Metric{(uint64_t)totalSizeUncompressed / 1000, "aod-bytes-read-uncompressed"}.addTag(Key::Subsystem, monitoring::tags::Value::DPL));
+        monitoring.send(Metric{(uint64_t)totalSizeCompressed / 1000, "aod-bytes-read-compressed"}.addTag(Key::Subsystem, monitoring::tags::Value::DPL));
+        monitoring.send(Metric{(uint64_t)(uv_hrtime() - ioStart) / 1000, "aod-prefetch-wait-time"}.addTag(Key::Subsystem, monitoring::tags::Value::DPL));
+
+        *fileCounter = (df.counter - device.inputTimesliceId) / device.maxInputTimeslices;
+        *numTF = df.numTF;
+        return;
+      }
+
       for (auto& route : requestedTables) {
         if ((device.inputTimesliceId % route.maxTimeslices) != route.timeslice) {
           continue;
@@ -299,6 +353,7 @@ AlgorithmSpec AODJAlienReaderHelpers::rootFileReaderCallback()
         // fill the table
         auto colnames = getColumnNames(dh);
         t2t.setLabel(tr->GetName());
+        t2t.setNThreads(columnThreads);
         if (colnames.size() == 0) {
           totalSizeCompressed += tr->GetZipBytes();
           totalSizeUncompressed += tr->GetTotBytes();
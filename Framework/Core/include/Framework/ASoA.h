@@ -22,6 +22,7 @@
 #include "Framework/ArrowTypes.h"
 #include "Framework/RuntimeError.h"
 #include "Framework/Kernels.h"
+#include "Framework/ArrowTableSlicingCache.h"
 #include <arrow/table.h>
 #include <arrow/array.h>
 #include <arrow/util/variant.h>
@@ -42,34 +43,41 @@ struct Preslice {
     if (newDataframe) {
       fullSize = input->num_rows();
       newDataframe = false;
-      return o2::framework::getSlices(index.name.c_str(), input, mValues, mCounts);
+      return updateSliceInfo(input);
     } else {
       return arrow::Status::OK();
     }
   };
 
-  void setNewDF()
+  /// get the slices of input, from the slicing cache service if it is set
+  arrow::Status updateSliceInfo(std::shared_ptr<arrow::Table> const& input)
+  {
+    if (cache) {
+      return cache->getCacheFor(input, index.name, sliceInfo);
+    }
+    auto info = std::make_shared<SliceInfo>();
+    auto status = o2::framework::getSliceInfo(index.name.c_str(), input, *info);
+    sliceInfo = info;
+    return status;
+  }
+
+  void setNewDF(ArrowTableSlicingCache* cache_ = nullptr)
   {
     newDataframe = true;
+    cache = cache_;
   };
 
-  std::shared_ptr<arrow::NumericArray<arrow::Int32Type>> mValues = nullptr;
-  std::shared_ptr<arrow::NumericArray<arrow::Int64Type>> mCounts = nullptr;
+  std::shared_ptr<SliceInfo const> sliceInfo = nullptr;
+  ArrowTableSlicingCache* cache = nullptr;
   size_t fullSize;
   expressions::BindingNode index;
   bool newDataframe = false;
 
   arrow::Status getSliceFor(int value, std::shared_ptr<arrow::Table> const& input, std::shared_ptr<arrow::Table>& output, uint64_t& offset) const
   {
-    arrow::Status status;
-    for (auto slice = 0; slice < mValues->length(); ++slice) {
-      if (mValues->Value(slice) == value) {
-        output = input->Slice(offset, mCounts->Value(slice));
-        return arrow::Status::OK();
-      }
-      offset += mCounts->Value(slice);
-    }
-    output = input->Slice(offset, 0);
+    auto [start, size] = sliceInfo->getSliceFor(value);
+    offset += start;
+    output = input->Slice(offset, size);
     return arrow::Status::OK();
   }
 };
@@ -1362,13 +1370,13 @@ class Table
   /// Cached end iterator for this table.
   RowViewSentinel mEnd;
   std::string mCurrentKey;
-  std::shared_ptr<arrow::NumericArray<arrow::Int32Type>> mValues = nullptr;
-  std::shared_ptr<arrow::NumericArray<arrow::Int64Type>> mCounts = nullptr;
+  std::shared_ptr<o2::framework::SliceInfo> mSliceInfo = nullptr;
 
   arrow::Status initializeSliceCaches(char const* key)
   {
     mCurrentKey = key;
-    return o2::framework::getSlices(key, mTable, mValues, mCounts);
+    mSliceInfo = std::make_shared<o2::framework::SliceInfo>();
+    return o2::framework::getSliceInfo(key, mTable, *mSliceInfo);
   }
 
  public:
@@ -1381,14 +1389,9 @@ class Table
     if (!status.ok()) {
       return status;
     }
-    for (auto slice = 0; slice < mValues->length(); ++slice) {
-      if (mValues->Value(slice) == value) {
-        output = mTable->Slice(offset, mCounts->Value(slice));
-        return arrow::Status::OK();
-      }
-      offset += mCounts->Value(slice);
-    }
-    output = mTable->Slice(offset, 0);
+    auto [start, size] = mSliceInfo->getSliceFor(value);
+    offset += start;
+    output = mTable->Slice(offset, size);
     return arrow::Status::OK();
   }
 };
@@ -575,7 +575,7 @@ struct PresliceManager {
     return false;
   }
 
-  static bool setNewDF(T&) { return false; };
+  static bool setNewDF(T&, ArrowTableSlicingCache&) { return false; };
 };
 
 template <typename T>
@@ -584,16 +584,16 @@ struct PresliceManager<Preslice<T>> {
   static bool processTable(Preslice<T>& container, T1& table)
   {
     if constexpr (o2::soa::is_binding_compatible_v<T, std::decay_t<T1>>()) {
-      auto status = o2::framework::getSlices(container.index.name.c_str(), table.asArrowTable(), container.mValues, container.mCounts);
+      auto status = container.updateSliceInfo(table.asArrowTable());
       return status.ok();
     } else {
       return false;
     }
   }
 
-  static bool setNewDF(Preslice<T>& container)
+  static bool setNewDF(Preslice<T>& container, ArrowTableSlicingCache& cache)
   {
-    container.setNewDF();
+    container.setNewDF(&cache);
     return true;
   }
 };
@@ -637,8 +637,9 @@ DataProcessorSpec adaptAnalysisTask(ConfigContext const& ctx, Args&&... args)
       for (auto& info : expressionInfos) {
         info.resetSelection = true;
       }
-      // reset pre-slice for the next dataframe
-      homogeneous_apply_refs([](auto& x) { return PresliceManager<std::decay_t<decltype(x)>>::setNewDF(x); }, *(task.get()));
+      // reset pre-slice for the next dataframe, the slices are shared with the other tasks of the device
+      auto& slicingCache = pc.services().get<ArrowTableSlicingCache>();
+      homogeneous_apply_refs([&slicingCache](auto& x) { return PresliceManager<std::decay_t<decltype(x)>>::setNewDF(x, slicingCache); }, *(task.get()));
       // prepare outputs
       homogeneous_apply_refs([&pc](auto&& x) { return OutputManager<std::decay_t<decltype(x)>>::prepare(pc, x); }, *task.get());
       // execute run()
@@ -0,0 +1,48 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#ifndef O2_FRAMEWORK_ARROWTABLESLICINGCACHE_H_
+#define O2_FRAMEWORK_ARROWTABLESLICINGCACHE_H_
+
+#include "Framework/Kernels.h"
+
+#include <arrow/table.h>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace o2::framework
+{
+/// Service caching the SliceInfo of the tables of the current dataframe, by table and index column,
+/// so that all the users in a device (Preslice of all tasks) build it only once.
+/// It is cleared before each dataframe is processed.
+class ArrowTableSlicingCache
+{
+ public:
+  /// get the SliceInfo of table grouped by the key column, building it if it is not yet cached
+  arrow::Status getCacheFor(std::shared_ptr<arrow::Table> const& table, std::string const& key, std::shared_ptr<SliceInfo const>& info);
+
+  void clear() { mCache.clear(); }
+
+  /// number of cached SliceInfos
+  size_t size() const { return mCache.size(); }
+
+ private:
+  // a table is identified by the buffers of its key column, which are the same for all the arrow::Tables
+  // created from the same message
+  using CacheKey = std::pair<std::string, std::vector<std::pair<void const*, int64_t>>>;
+  std::map<CacheKey, std::shared_ptr<SliceInfo const>> mCache;
+};
+} // namespace o2::framework
+
+#endif // O2_FRAMEWORK_ARROWTABLESLICINGCACHE_H_
@@ -13,6 +13,7 @@
 
 #include "Framework/TimesliceSlot.h"
 #include <functional>
+#include <map>
 #include <string>
 #include <vector>
 
@@ -39,12 +40,16 @@ struct AsyncTask {
   TimesliceId timeslice = {TimesliceId::INVALID};
   // Only the task with the highest debounce value will be executed
   int debounce = 0;
-  bool runnable = false;
 };
 
 struct AsyncQueue {
   std::vector<AsyncTaskSpec> prototypes;
-  std::vector<AsyncTask> tasks;
+  // The pending tasks, indexed by timeslice. Within a timeslice the tasks
+  // are kept sorted by score and debounce, so that no sorting is needed when
+  // running them.
+  std::map<size_t, std::vector<AsyncTask>> tasks;
+  // Total number of pending tasks
+  size_t pending = 0;
   size_t iteration = 0;
 };
 
@@ -52,10 +57,12 @@ struct AsyncQueueHelpers {
   static AsyncTaskId create(AsyncQueue& queue, AsyncTaskSpec spec);
   // Schedule a task with @a taskId to be executed whenever the timeslice
   // is past timeslice. If debounce is provided, only execute the task
+  // with the highest debounce value. Debounced tasks with the same id and
+  // timeslice are collapsed as soon as they are posted.
   static void post(AsyncQueue& queue, AsyncTaskId taskId, std::function<void()> task, TimesliceId timeslice, int64_t debounce = 0);
   /// Run all the tasks which are older than the oldestPossible timeslice
   /// executing them by:
-  /// 1. sorting the tasks by timeslice
+  /// 1. descending timeslice
   /// 2. then priority
   /// 3. only execute the highest (timeslice, debounce) value
   static void run(AsyncQueue& queue, TimesliceId oldestPossibleTimeslice);
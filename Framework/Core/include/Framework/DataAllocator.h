@@ -325,8 +325,8 @@ class DataAllocator
                       "\n - types with ROOT dictionary and implementing ROOT ClassDef interface");
       }
     } else if constexpr (has_root_dictionary<T>::value == true || is_specialization_v<T, ROOTSerialized> == true) {
-      // Serialize a snapshot of an object with root dictionary
-      payloadMessage = proxy.createOutputMessage(routeIndex);
+      // Serialize a snapshot of an object with root dictionary directly into the output message
+      auto creator = [&proxy, routeIndex](size_t size) { return proxy.createOutputMessage(routeIndex, size); };
       if constexpr (is_specialization_v<T, ROOTSerialized> == true) {
         // Explicitely ROOT serialize a snapshot of object.
         // An object wrapped into type `ROOTSerialized` is explicitely marked to be ROOT serialized
@@ -358,9 +358,9 @@ class DataAllocator
                                   typeid(WrappedType).name());
           }
         }
-        TMessageSerializer().Serialize(*payloadMessage, &object(), cl);
+        payloadMessage = TMessageSerializer::Serialize(creator, &object(), cl);
       } else {
-        TMessageSerializer().Serialize(*payloadMessage, &object, TClass::GetClass(typeid(T)));
+        payloadMessage = TMessageSerializer::Serialize(creator, &object, TClass::GetClass(typeid(T)));
       }
       serializationType = o2::header::gSerializationMethodROOT;
     } else {
@@ -16,9 +16,21 @@
 
 #include "Framework/DataDescriptorMatcher.h"
 
+#include <condition_variable>
+#include <exception>
+#include <limits>
+#include <map>
+#include <mutex>
 #include <regex>
+#include <thread>
+#include <unordered_map>
 #include "rapidjson/fwd.h"
 
+namespace arrow
+{
+class Table;
+}
+
 namespace o2::framework
 {
 
@@ -66,6 +78,7 @@ struct DataInputDescriptor {
   std::string getFilenamesRegexString();
   std::regex getFilenamesRegex();
   int getNumberInputfiles() { return mfilenames.size(); }
+  std::string getFileName(int counter) { return mfilenames.at(counter)->fileName; }
   int getNumberTimeFrames() { return mtotalNumberTimeFrames; }
 
   uint64_t getTimeFrameNumber(int counter, int numTF);
@@ -112,6 +125,8 @@ struct DataInputDirector {
   DataInputDescriptor* getDataInputDescriptor(header::DataHeader dh);
   int getNumberInputDescriptors() { return mdataInputDescriptors.size(); }
 
+  std::string getFileName(header::DataHeader dh, int counter);
+  std::string getTreeName(header::DataHeader dh);
   std::unique_ptr<TTreeReader> getTreeReader(header::DataHeader dh, int counter, int numTF, std::string treeName);
   TTree* getDataTree(header::DataHeader dh, int counter, int numTF);
   uint64_t getTimeFrameNumber(header::DataHeader dh, int counter, int numTF);
@@ -134,6 +149,77 @@ struct DataInputDirector {
   bool isValid();
 };
 
+struct PrefetchedDataFrame {
+  /// A dataframe read ahead by the DataFramePrefetcher
+
+  int counter = -1;
+  int numTF = -1;
+  uint64_t timeFrameNumber = 0;
+  /// tables in the order of the requested headers
+  std::vector<std::shared_ptr<arrow::Table>> tables;
+  size_t bytesCompressed = 0;
+  size_t bytesUncompressed = 0;
+  /// set if the reading failed, rethrown by DataFramePrefetcher::next
+  std::exception_ptr error = nullptr;
+};
+
+class DataFramePrefetcher
+{
+  /// Reads the dataframes which follow the one being processed on a pool of
+  /// background threads, so that opening the files, I/O and decompression
+  /// overlap with the processing downstream. Each thread opens its own
+  /// TFile handles and reads the trees through a TTreeCache sized from
+  /// their columns. At most depth dataframes are read ahead and no new one
+  /// is started while the ones already read exceed the memory limit.
+
+ public:
+  /// Reads the tables \a headers of the files \a first, first + \a stride, ...
+  /// The columns of each table are read on \a columnThreads threads. The
+  /// director is shared with the threads, which may outlive its other owners.
+  DataFramePrefetcher(std::shared_ptr<DataInputDirector> didir, std::vector<header::DataHeader> headers, int first, int stride,
+                      int depth, int nThreads, size_t memoryLimit, int columnThreads = 1);
+  ~DataFramePrefetcher();
+
+  /// Moves the next dataframe in reading order into \a df, waiting for it
+  /// to be read if needed. Returns false once all the input files are read.
+  bool next(PrefetchedDataFrame& df);
+  /// Stops and joins the background threads
+  void stop();
+  /// Number of dataframes read ahead which were not handed out yet
+  size_t getNReadAhead();
+
+ private:
+  void run();
+  FileNameHolder const& getTimeFrameKeys(std::string const& fileName, TFile* file);
+  void read(PrefetchedDataFrame& df, std::map<std::string, std::unique_ptr<TFile>>& files);
+
+  std::shared_ptr<DataInputDirector> mDirector;
+  std::vector<header::DataHeader> mHeaders;
+  std::vector<std::string> mTreeNames;
+  int mStride;
+  int mDepth;
+  size_t mMemoryLimit;
+  int mColumnThreads;
+
+  std::mutex mMutex;
+  std::condition_variable mCondition;
+  std::vector<std::thread> mThreads;
+  /// DF_ folders of the files opened so far
+  std::unordered_map<std::string, FileNameHolder> mTimeFrameKeys;
+  /// position of the next dataframe to read
+  int mCounter;
+  int mNumTF = 0;
+  FileNameHolder const* mCurrentKeys = nullptr;
+  bool mListing = false;
+  /// sequence numbers of the dataframes
+  size_t mNextRead = 0;
+  size_t mNextHandOut = 0;
+  size_t mEnd = std::numeric_limits<size_t>::max();
+  std::map<size_t, PrefetchedDataFrame> mReady;
+  size_t mBytesHeld = 0;
+  bool mStop = false;
+};
+
 } // namespace o2::framework
 
 #endif // o2_framework_DataInputDirector_H_INCLUDED
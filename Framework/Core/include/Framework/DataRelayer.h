@@ -21,7 +21,10 @@
 #include "Framework/Tracing.h"
 #include "Framework/TimesliceSlot.h"
 
+#include <atomic>
+#include <condition_variable>
 #include <cstddef>
+#include <memory>
 #include <mutex>
 #include <vector>
 #include <functional>
@@ -54,9 +57,12 @@ enum struct CacheEntryStatus : int {
 class DataRelayer
 {
  public:
-  /// DataRelayer is thread safe because we have a lock around
-  /// each method and there is no particular order in which
-  /// methods need to be called.
+  /// DataRelayer is thread safe. The TimesliceIndex bookkeeping (i.e.
+  /// deciding which slot a message belongs to and which slots are complete)
+  /// is protected by a single, short lived, lock, while the actual moving
+  /// of the messages in and out of the cache is guarded by a per slot
+  /// atomic state, so that relaying into different slots, and consuming
+  /// completed ones, can proceed concurrently.
   constexpr static ServiceKind service_kind = ServiceKind::Global;
   enum RelayChoice {
     WillRelay,     /// Ownership of the data has been taken
@@ -168,9 +174,55 @@ class DataRelayer
 
   /// Rescan the whole data to see if there is anything new we should do,
   /// e.g. as consequnce of an OOB event.
-  void rescan() { mTimesliceIndex.rescan(); };
+  void rescan();
 
  private:
+  /// Per slot state. The lower bits count the number of relay operations
+  /// currently writing into the slot, the highest bit is set while the
+  /// slot content is being moved out of the cache. Threads which need the
+  /// slot to be released park on its condition variable.
+  struct SlotState {
+    std::atomic<uint32_t> state{0};
+    std::mutex mutex;
+    std::condition_variable released;
+  };
+  constexpr static uint32_t SLOT_CONSUMING = 1u << 31;
+
+  /// The waits below happen with mMutex held, so that the decision taken on
+  /// the TimesliceIndex stays valid. They cannot deadlock, because writers and
+  /// consumers release the slot without taking mMutex, but a relay or a
+  /// consumer waiting for a slot delays every other relay until the slot is
+  /// released. This is bounded by the time needed to move the messages of one
+  /// slot in or out of the cache, or to copy their headers.
+  ///
+  /// Register a writer for @a slot, waiting for a consumer to be done.
+  /// Must be called with mMutex held.
+  void beginWrite(TimesliceSlot slot);
+  void endWrite(TimesliceSlot slot);
+  /// Mark @a slot as being consumed and wait for pending writers to be done.
+  /// Only one consumer at the time can own a slot, others wait for it to be
+  /// done. Must be called with mMutex held.
+  void beginConsume(TimesliceSlot slot);
+  void endConsume(TimesliceSlot slot);
+  /// Wait until nobody is writing into or consuming @a slot. Must be called
+  /// with mMutex held, so that no new writer can appear.
+  void waitForExclusive(TimesliceSlot slot);
+  /// Park until none of the @a mask bits of the state of @a slot are set
+  void waitForRelease(TimesliceSlot slot, uint32_t mask);
+  /// Wake up the threads waiting for @a slot, after its state changed
+  void notifyRelease(TimesliceSlot slot);
+  /// @return true if some relay operation is writing in @a slot or if it is being consumed
+  bool isSlotBusy(TimesliceSlot slot) const;
+  /// Bookkeeping of which routes have data in a given slot.
+  /// All of them must be invoked with mMutex held.
+  void markRouteFilled(TimesliceSlot slot, size_t route);
+  void clearFilledRoutes(TimesliceSlot slot);
+  bool hasFilledRoutes(TimesliceSlot slot) const;
+  /// Implementation of pruneCache, to be invoked with mMutex held
+  void doPruneCache(TimesliceSlot slot, OnDropCallback const& onDrop);
+  /// Implementation of publishMetrics, to be invoked with mMutex held
+  void doPublishMetrics();
+
   monitoring::Monitoring& mMetrics;
 
   /// This is the actual cache of all the parts in flight.
@@ -178,6 +230,9 @@ class DataRelayer
   /// N is the maximum number of inflight timeslices, while
   /// M is the number of inputs which are requested.
   std::vector<MessageSet> mCache;
+  /// One mutex per cache entry, taken by the relays writing into it, since
+  /// several writers can share a slot.
+  std::unique_ptr<std::mutex[]> mCacheMutexes;
 
   /// This is the index which maps a given timestamp to the associated
   /// cacheline.
@@ -189,6 +244,16 @@ class DataRelayer
   std::vector<data_matcher::DataDescriptorMatcher> mInputMatchers;
   std::vector<data_matcher::VariableContext> mVariableContextes;
   std::vector<CacheEntryStatus> mCachedStateMetrics;
+  std::unique_ptr<SlotState[]> mSlotStates;
+  /// One bit per route for each slot, set when the route has some data.
+  /// Each slot uses mFilledRoutesWords consecutive words.
+  std::vector<uint64_t> mFilledRoutes;
+  size_t mFilledRoutesWords = 0;
+  /// Routes whose matcher cannot be pre-filtered with an empty context,
+  /// because it contains a negation.
+  std::vector<bool> mRouteNeedsFullMatch;
+  /// Scratch space for the routes matching the message being relayed.
+  std::vector<size_t> mCandidateRoutes;
   std::vector<PruneOp> mPruneOps;
   size_t mMaxLanes;
 
@@ -197,7 +262,7 @@ class DataRelayer
   static std::vector<std::string> sQueriesMetricsNames;
 
   DataRelayerStats mStats;
-  TracyLockableN(std::recursive_mutex, mMutex, "data relayer mutex");
+  TracyLockableN(std::mutex, mMutex, "data relayer mutex");
 };
 
 } // namespace o2::framework
@@ -501,6 +501,17 @@ std::shared_ptr<gandiva::Projector> createProjector(gandiva::SchemaPtr const& Sc
 std::shared_ptr<gandiva::Projector> createProjector(gandiva::SchemaPtr const& Schema,
                                                     Projector&& p,
                                                     gandiva::FieldPtr result);
+/// Statistics of the cache of the compiled gandiva filters and projectors, shared by all users in a process
+struct ExpressionCacheStats {
+  uint64_t hits = 0;        /// filters and projectors found in the cache
+  uint64_t misses = 0;      /// filters and projectors built
+  uint64_t evictions = 0;   /// least recently used entries dropped to keep the cache within its size
+  uint64_t size = 0;        /// entries currently in the cache
+  uint64_t buildTimeUs = 0; /// time spent building the missing ones, including the hits of the internal cache of gandiva
+};
+ExpressionCacheStats getExpressionCacheStats();
+/// Set the maximum number of filters and of projectors kept in the cache, 0 disables it
+void setExpressionCacheSize(size_t size);
 /// Function for attaching gandiva filters to to compatible task inputs
 void updateExpressionInfos(expressions::Filter const& filter, std::vector<ExpressionInfo>& eInfos);
 /// Function to create gandiva condition expression from generic gandiva expression tree
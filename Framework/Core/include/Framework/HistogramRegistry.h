@@ -26,7 +26,10 @@
 #include <TDataMember.h>
 #include <TDataType.h>
 
+#include <algorithm>
+#include <array>
 #include <deque>
+#include <vector>
 
 class TList;
 
@@ -48,6 +51,10 @@ struct HistFiller {
   template <typename... Cs, typename R, typename T>
   static void fillHistAny(std::shared_ptr<R> hist, const T& table, const o2::framework::expressions::Filter& filter);
 
+  // fill n entries at once into any type of histogram but StepTHn, columns holds one array of n values for each argument of fillHistAny
+  template <typename T>
+  static void fillHistBulk(std::shared_ptr<T> hist, double const* const* columns, int nColumns, size_t n);
+
   // function that returns rough estimate for the size of a histogram in MB
   template <typename T>
   static double getSize(std::shared_ptr<T> hist, double fillFraction = 1.);
@@ -62,6 +69,13 @@ struct HistFiller {
 
   template <typename B, typename T>
   static int getBaseElementSize(T* ptr);
+
+  // fill n entries into a TH1, TH2 or TH3, with the bins of uniform axes computed for all entries at once
+  static void fillBinnedBulk(TH1* hist, int nDim, double const* const* x, double const* w, size_t n);
+
+  // values of column C of table in the given rows
+  template <typename C>
+  static std::vector<double> getColumnValues(arrow::Table* table, o2::soa::SelectionVector const& rows);
 };
 
 //**************************************************************************************************
@@ -104,7 +118,7 @@ class HistogramRegistry
   // function to query if name is already in use
   bool contains(const HistName& histName);
 
-  // get the underlying histogram pointer
+  // get the underlying histogram pointer, with the buffered entries filled
   template <typename T>
   std::shared_ptr<T> get(const HistName& histName);
 
@@ -128,6 +142,14 @@ class HistogramRegistry
   template <typename... Cs, typename T>
   void fill(const HistName& histName, const T& table, const o2::framework::expressions::Filter& filter);
 
+  // buffer up to nEntries calls of fill(histName, values...) per histogram, which are then filled at once.
+  // 0 (default) fills the histograms directly. The histograms are complete only after flush() or get(),
+  // which should be taken into account when using the pointers returned by add()
+  void setFillBufferSize(uint32_t nEntries);
+
+  // fill the buffered entries into the histograms
+  void flush();
+
   // get rough estimate for size of histogram stored in registry
   double getSize(const HistName& histName, double fillFraction = 1.);
 
@@ -169,6 +191,11 @@ class HistogramRegistry
   // helper function that checks if name of histogram is reasonable and keeps track of names already in use
   void registerName(const std::string& name);
 
+  // helper functions to buffer the values of a fill call resp. to fill the buffered entries of the histogram at idx
+  template <typename... Ts>
+  void bufferFill(uint32_t idx, Ts... values);
+  void flushBuffer(uint32_t idx);
+
   std::string mName{};
   OutputObjHandlingPolicy mPolicy{};
   bool mCreateRegistryDir{};
@@ -182,6 +209,15 @@ class HistogramRegistry
   static constexpr uint32_t MAX_REGISTRY_SIZE{REGISTRY_BITMASK + 1};
   std::array<uint32_t, MAX_REGISTRY_SIZE> mRegistryKey{};
   std::array<HistPtr, MAX_REGISTRY_SIZE> mRegistryValue{};
+
+  // buffered entries of a histogram, stored column-wise with one column of mFillBufferSize values per fill argument
+  struct FillBuffer {
+    std::vector<double> values{};
+    uint32_t nEntries{};
+    int nColumns{};
+  };
+  uint32_t mFillBufferSize{};
+  std::vector<FillBuffer> mFillBuffers{}; // same indices as mRegistryValue, empty if entries are not buffered
 };
 
 //--------------------------------------------------------------------------------------------------
@@ -229,15 +265,90 @@ void HistFiller::fillHistAny(std::shared_ptr<T> hist, const Ts&... positionAndWe
 template <typename... Cs, typename R, typename T>
 void HistFiller::fillHistAny(std::shared_ptr<R> hist, const T& table, const o2::framework::expressions::Filter& filter)
 {
-  if constexpr (std::is_base_of_v<StepTHn, T>) {
+  if constexpr (std::is_base_of_v<StepTHn, R>) {
     LOGF(fatal, "Table filling is not (yet?) supported for StepTHn.");
     return;
+  } else {
+    auto arrowTable = table.asArrowTable();
+    auto rows = o2::soa::selectionToVector(o2::framework::expressions::createSelection(arrowTable, filter));
+    std::array<std::vector<double>, sizeof...(Cs)> values{getColumnValues<Cs>(arrowTable.get(), rows)...};
+    std::array<double const*, sizeof...(Cs)> columns{};
+    std::transform(values.begin(), values.end(), columns.begin(), [](auto& column) { return column.data(); });
+    fillHistBulk(hist, columns.data(), sizeof...(Cs), rows.size());
+  }
+}
+
+template <typename T>
+void HistFiller::fillHistBulk(std::shared_ptr<T> hist, double const* const* columns, int nColumns, size_t n)
+{
+  int nDim{};
+  if constexpr (std::is_same_v<TH1, T>) {
+    nDim = 1;
+  } else if constexpr (std::is_same_v<TH2, T> || std::is_same_v<TProfile, T>) {
+    nDim = 2;
+  } else if constexpr (std::is_same_v<TH3, T> || std::is_same_v<TProfile2D, T>) {
+    nDim = 3;
+  } else if constexpr (std::is_same_v<TProfile3D, T>) {
+    nDim = 4;
+  } else if constexpr (std::is_base_of_v<THnBase, T>) {
+    nDim = hist->GetNdimensions();
+  } else {
+    LOGF(fatal, "Bulk filling is not supported for histogram %s.", hist->GetName());
+    return;
   }
-  auto s = o2::framework::expressions::createSelection(table.asArrowTable(), filter);
-  auto filtered = o2::soa::Filtered<T>{{table.asArrowTable()}, s};
-  for (auto& t : filtered) {
-    fillHistAny(hist, (*(static_cast<Cs>(t).getIterator()))...);
+  if (nColumns != nDim && nColumns != nDim + 1) {
+    LOGF(fatal, "The number of arguments in fill function called for histogram %s is incompatible with histogram dimensions.", hist->GetName());
   }
+  if (n == 0) {
+    return;
+  }
+  double const* weights = (nColumns > nDim) ? columns[nDim] : nullptr;
+
+  if constexpr (std::is_same_v<TH1, T> || std::is_same_v<TH2, T> || std::is_same_v<TH3, T>) {
+    fillBinnedBulk(hist.get(), nDim, columns, weights, n);
+  } else if constexpr (std::is_same_v<TProfile, T>) {
+    hist->FillN(static_cast<int>(n), columns[0], columns[1], weights);
+  } else if constexpr (std::is_same_v<TProfile2D, T>) {
+    for (size_t i = 0; i < n; ++i) {
+      weights ? hist->Fill(columns[0][i], columns[1][i], columns[2][i], weights[i]) : hist->Fill(columns[0][i], columns[1][i], columns[2][i]);
+    }
+  } else if constexpr (std::is_same_v<TProfile3D, T>) {
+    for (size_t i = 0; i < n; ++i) {
+      weights ? hist->Fill(columns[0][i], columns[1][i], columns[2][i], columns[3][i], weights[i]) : hist->Fill(columns[0][i], columns[1][i], columns[2][i], columns[3][i]);
+    }
+  } else if constexpr (std::is_base_of_v<THnBase, T>) {
+    // THn(Sparse) take the coordinates of an entry as array
+    std::vector<double> coordinates(n * nDim);
+    for (int d = 0; d < nDim; ++d) {
+      for (size_t i = 0; i < n; ++i) {
+        coordinates[i * nDim + d] = columns[d][i];
+      }
+    }
+    for (size_t i = 0; i < n; ++i) {
+      hist->Fill(&coordinates[i * nDim], weights ? weights[i] : 1.);
+    }
+  }
+}
+
+template <typename C>
+std::vector<double> HistFiller::getColumnValues(arrow::Table* table, o2::soa::SelectionVector const& rows)
+{
+  auto column = table->GetColumnByName(C::columnLabel());
+  if (!column) {
+    throw runtime_error_f("Column %s used to fill histogram not found in table.", C::columnLabel());
+  }
+  std::vector<double> values(rows.size());
+  size_t i = 0;
+  int64_t offset = 0;
+  for (auto const& chunk : column->chunks()) {
+    auto array = std::static_pointer_cast<arrow_array_for_t<typename C::type>>(chunk);
+    const int64_t end = offset + chunk->length();
+    for (; i < rows.size() && rows[i] < end; ++i) {
+      values[i] = static_cast<double>(array->Value(rows[i] - offset));
+    }
+    offset = end;
+  }
+  return values;
 }
 
 template <typename T>
@@ -359,7 +470,11 @@ std::shared_ptr<T> HistogramRegistry::add(char const* const name, char const* co
 template <typename T>
 std::shared_ptr<T> HistogramRegistry::get(const HistName& histName)
 {
-  if (auto histPtr = std::get_if<std::shared_ptr<T>>(&mRegistryValue[getHistIndex(histName)])) {
+  const uint32_t idx = getHistIndex(histName);
+  if (!mFillBuffers.empty()) {
+    flushBuffer(idx);
+  }
+  if (auto histPtr = std::get_if<std::shared_ptr<T>>(&mRegistryValue[idx])) {
     return *histPtr;
   } else {
     throw runtime_error_f(R"(Histogram type specified in get<>(HIST("%s")) does not match the actual type of the histogram!)", histName.str);
@@ -408,13 +523,39 @@ uint32_t HistogramRegistry::getHistIndex(const T& histName)
 template <typename... Ts>
 void HistogramRegistry::fill(const HistName& histName, Ts&&... positionAndWeight)
 {
-  std::visit([&positionAndWeight...](auto&& hist) { HistFiller::fillHistAny(hist, std::forward<Ts>(positionAndWeight)...); }, mRegistryValue[getHistIndex(histName)]);
+  const uint32_t idx = getHistIndex(histName);
+  if (!mFillBuffers.empty() && !std::holds_alternative<std::shared_ptr<StepTHn>>(mRegistryValue[idx])) {
+    bufferFill(idx, static_cast<double>(positionAndWeight)...);
+    return;
+  }
+  std::visit([&positionAndWeight...](auto&& hist) { HistFiller::fillHistAny(hist, std::forward<Ts>(positionAndWeight)...); }, mRegistryValue[idx]);
 }
 
 template <typename... Cs, typename T>
 void HistogramRegistry::fill(const HistName& histName, const T& table, const o2::framework::expressions::Filter& filter)
 {
-  std::visit([&table, &filter](auto&& hist) { HistFiller::fillHistAny<Cs...>(hist, table, filter); }, mRegistryValue[getHistIndex(histName)]);
+  const uint32_t idx = getHistIndex(histName);
+  if (!mFillBuffers.empty()) {
+    flushBuffer(idx);
+  }
+  std::visit([&table, &filter](auto&& hist) { HistFiller::fillHistAny<Cs...>(hist, table, filter); }, mRegistryValue[idx]);
+}
+
+template <typename... Ts>
+void HistogramRegistry::bufferFill(uint32_t idx, Ts... values)
+{
+  constexpr int nColumns = sizeof...(Ts);
+  auto& buffer = mFillBuffers[idx];
+  if (buffer.nColumns != nColumns) {
+    flushBuffer(idx);
+    buffer.nColumns = nColumns;
+    buffer.values.resize(nColumns * mFillBufferSize);
+  }
+  double* column = buffer.values.data() + buffer.nEntries;
+  ((*column = values, column += mFillBufferSize), ...);
+  if (++buffer.nEntries == mFillBufferSize) {
+    flushBuffer(idx);
+  }
 }
 
 } // namespace o2::framework
@@ -14,9 +14,39 @@
 
 #include <arrow/table.h>
 
+#include <algorithm>
+#include <array>
+#include <utility>
+#include <vector>
+
 namespace o2::framework
 {
 using ListVector = std::vector<std::vector<int64_t>>;
+
+/// Offset and size of the slice of each group of a table grouped by an index column.
+/// The groups of non-negative values are stored densely by value, so that the slice of a group
+/// is found in constant time. The groups of negative values (unassigned rows) and those of
+/// sparse values are kept in a list sorted by value.
+struct SliceInfo {
+  std::vector<int64_t> offsets;               // offset of the group of each value, -1 if the value is absent
+  std::vector<int64_t> sizes;                 // size of the group of each value
+  std::vector<std::array<int64_t, 3>> sparse; // value, offset and size of the other groups
+  int64_t nRows = 0;
+
+  /// offset and size of the slice of value, (number of rows, 0) if the value is absent
+  std::pair<int64_t, int64_t> getSliceFor(int value) const
+  {
+    if (value >= 0 && value < (int64_t)offsets.size()) {
+      return offsets[value] < 0 ? std::make_pair(nRows, int64_t{0}) : std::make_pair(offsets[value], sizes[value]);
+    }
+    auto it = std::lower_bound(sparse.begin(), sparse.end(), value, [](auto const& group, int v) { return group[0] < v; });
+    if (it != sparse.end() && (*it)[0] == value) {
+      return {(*it)[1], (*it)[2]};
+    }
+    return {nRows, int64_t{0}};
+  }
+};
+
 /// Slice a given table uncheked, filling slice caches
 arrow::Status getSlices(
   const char* key,
@@ -24,6 +54,12 @@ arrow::Status getSlices(
   std::shared_ptr<arrow::NumericArray<arrow::Int32Type>>& values,
   std::shared_ptr<arrow::NumericArray<arrow::Int64Type>>& counts);
 
+/// Slice a given table unchecked, filling the offsets and sizes of all groups
+arrow::Status getSliceInfo(
+  const char* key,
+  std::shared_ptr<arrow::Table> const& input,
+  SliceInfo& info);
+
 /// Slice a given table unchecked
 arrow::Status getSliceFor(
   int value,
@@ -372,7 +372,7 @@ class MessageContext
       : ContextObject(std::forward<fair::mq::MessagePtr>(headerMsg), routeIndex)
     {
       mObject = std::make_unique<value_type>(std::forward<Args>(args)...);
-      mPayloadMsg = context->proxy().createOutputMessage(routeIndex);
+      mCreator = [&proxy = context->proxy(), routeIndex](size_t size) { return proxy.createOutputMessage(routeIndex, size); };
     }
     ~RootSerializedObject() override = default;
 
@@ -381,8 +381,7 @@ class MessageContext
     fair::mq::Parts finalize() final
     {
       assert(mParts.Size() == 1);
-      TMessageSerializer::Serialize(*mPayloadMsg, mObject.get(), nullptr);
-      mParts.AddPart(std::move(mPayloadMsg));
+      mParts.AddPart(TMessageSerializer::Serialize(mCreator, mObject.get(), nullptr));
       return ContextObject::finalize();
     }
 
@@ -398,7 +397,7 @@ class MessageContext
 
    private:
     std::unique_ptr<value_type> mObject;
-    fair::mq::MessagePtr mPayloadMsg;
+    TMessageSerializer::MessageCreator mCreator;
   };
 
   using Messages = std::vector<std::unique_ptr<ContextObject>>;
@@ -16,16 +16,48 @@
 #include <cstddef>
 #include <cstdint>
 
+namespace fair::mq
+{
+class Device;
+}
+
 namespace o2::framework
 {
+/// Throttles a reader device so that at most maxInFlight timeframes are
+/// being processed downstream and at least minSHM bytes of shared memory
+/// are free before the next timeframe is published.
+///
+/// Waiting is done by blocking on the metric-feedback channel (so that the
+/// limiter is woken up as soon as a timeframe is consumed) or, when no
+/// notification is available, by sleeping with an exponential back-off.
+/// Once the limiter starts waiting, it only resumes publishing when both
+/// conditions are satisfied with some margin (hysteresis), to avoid
+/// flipping between waiting and publishing on every timeframe: fewer than
+/// 90% of maxInFlight timeframes in flight and more than 110% of minSHM free.
 class RateLimiter
 {
  public:
   void check(ProcessingContext& ctx, int maxInFlight, size_t minSHM);
 
  private:
+  /// Fraction of maxInFlight which needs to be drained before publishing resumes
+  static constexpr float InFlightHysteresis = 0.1f;
+  /// Fraction of minSHM which needs to be free on top of minSHM before publishing resumes
+  static constexpr float SHMHysteresis = 0.1f;
+  /// Initial and maximum back-off when polling for free shared memory
+  static constexpr int MinBackoffMs = 1;
+  static constexpr int MaxBackoffMs = 100;
+
+  /// Drain all the pending metric-feedback messages, waiting at most timeoutMs
+  /// for the first one. @return true if at least one message was received.
+  bool receiveFeedback(fair::mq::Device* device, int timeoutMs);
+  /// @return the currently free shared memory for the device segment
+  uint64_t freeSHM(ProcessingContext& ctx, fair::mq::Device* device);
+
   int64_t mConsumedTimeframes = 0;
   int64_t mSentTimeframes = 0;
+  /// Total time spent waiting, in milliseconds
+  uint64_t mTotalWaitMs = 0;
 };
 } // namespace o2::framework
 
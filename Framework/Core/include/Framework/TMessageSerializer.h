@@ -22,6 +22,7 @@
 #include <gsl/util>
 #include <gsl/span>
 #include <gsl/narrow>
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <cstddef>
@@ -44,6 +45,14 @@ class FairTMessage : public TMessage
   FairTMessage() : TMessage(kMESS_OBJECT) {}
   FairTMessage(void* buf, Int_t len) : TMessage(buf, len) { ResetBit(kIsOwner); }
   FairTMessage(gsl::span<std::byte> buf) : TMessage(buf.data(), buf.size()) { ResetBit(kIsOwner); }
+  // write into a buffer which is not owned by the message and is grown with reallocFunc
+  FairTMessage(void* buf, Int_t len, ReAllocCharFun_t reallocFunc) : TMessage(kMESS_OBJECT, kMinimalSize)
+  {
+    SetBuffer(buf, len, kFALSE, reallocFunc);
+    // reserved space for the message length, followed by the message type
+    WriteUInt(0);
+    WriteUInt(What());
+  }
   // helper function to clean up the object holding the data after it is transported.
   static void free(void* /*data*/, void* hint);
 };
@@ -51,6 +60,7 @@ class FairTMessage : public TMessage
 struct TMessageSerializer {
   using StreamerList = std::vector<TVirtualStreamerInfo*>;
   using CompressionLevel = int;
+  using MessageCreator = std::function<fair::mq::MessagePtr(size_t)>;
   enum class CacheStreamers { yes,
                               no };
 
@@ -63,6 +73,14 @@ struct TMessageSerializer {
                         CacheStreamers streamers = CacheStreamers::no,            //
                         CompressionLevel compressionLevel = -1);
 
+  /// Serialize into a message created by @a creator, e.g. in shared memory, without an
+  /// intermediate buffer. When the object does not fit, a larger message is created;
+  /// the size of the previous message of the same class is used as initial size.
+  template <typename T>
+  static fair::mq::MessagePtr Serialize(MessageCreator const& creator, const T* input, const TClass* cl, //
+                                        CacheStreamers streamers = CacheStreamers::no,                  //
+                                        CompressionLevel compressionLevel = -1);
+
   template <typename T = TObject>
   static void Deserialize(const fair::mq::Message& msg, std::unique_ptr<T>& output);
 
@@ -98,6 +116,9 @@ struct TMessageSerializer {
   // update the cache of streamer infos for serialized classes
   static void updateStreamers(const FairTMessage& message, StreamerList& streamers);
 
+  static fair::mq::MessagePtr serializeToMessage(MessageCreator const& creator, const void* input, const TClass* cl,
+                                                 CacheStreamers streamers, CompressionLevel compressionLevel);
+
   // for now this is a static, maybe it would be better to move the storage somewhere else?
   static StreamerList sStreamers;
   static std::mutex sStreamersLock;
@@ -197,6 +218,25 @@ inline void TMessageSerializer::Serialize(fair::mq::Message& msg, const T* input
   tm.release();
 }
 
+template <typename T>
+inline fair::mq::MessagePtr TMessageSerializer::Serialize(MessageCreator const& creator, const T* input, //
+                                                          const TClass* cl,                             //
+                                                          TMessageSerializer::CacheStreamers streamers, //
+                                                          TMessageSerializer::CompressionLevel compressionLevel)
+{
+  if (cl == nullptr) {
+    if constexpr (std::is_base_of_v<TObject, T>) {
+      cl = input->IsA();
+    } else {
+      cl = TClass::GetClass(typeid(T));
+    }
+  }
+  if (cl == nullptr) {
+    throw runtime_error_f("class is not ROOT-serializable: %s", typeid(T).name());
+  }
+  return serializeToMessage(creator, input, cl, streamers, compressionLevel);
+}
+
 template <typename T>
 inline void TMessageSerializer::Deserialize(const fair::mq::Message& msg, std::unique_ptr<T>& output)
 {
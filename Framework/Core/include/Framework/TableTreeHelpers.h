@@ -123,15 +123,29 @@ class TreeToTable
  public:
   TreeToTable(arrow::MemoryPool* pool = arrow::default_memory_pool());
   void setLabel(const char* label);
+  /// Read and decompress the columns on up to \a nThreads workers of the
+  /// ROOT thread pool in fill(). With \a nThreads > 1 this enables ROOT
+  /// implicit multi-threading for the whole process, with \a nThreads
+  /// threads, unless it is already enabled.
+  void setNThreads(int nThreads);
+  /// Read the baskets of the requested columns through a TTreeCache, set up
+  /// by addAllColumns. Used when reading ahead, where the TFile belongs to
+  /// the reading thread.
+  void setUseTreeCache(bool useTreeCache);
   void addAllColumns(TTree* tree, std::vector<std::string>&& names = {});
   void fill(TTree*);
   std::shared_ptr<arrow::Table> finalize();
 
+  /// Upper limit for the TTreeCache of the tree, in bytes
+  static constexpr Long64_t maxCacheSize = 50 * 1024 * 1024;
+
  private:
   arrow::MemoryPool* mArrowMemoryPool;
   std::vector<std::unique_ptr<BranchToColumn>> mBranchReaders;
   std::string mTableLabel;
   std::shared_ptr<arrow::Table> mTable;
+  int mNThreads = 1;
+  bool mUseTreeCache = false;
 
   void addReader(TBranch* branch, std::string const& name, bool VLA);
 };
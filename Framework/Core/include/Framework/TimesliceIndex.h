@@ -87,6 +87,10 @@ class TimesliceIndex
   [[nodiscard]] inline bool isValid(TimesliceSlot const& slot) const;
   [[nodiscard]] inline bool isDirty(TimesliceSlot const& slot) const;
   inline void markAsDirty(TimesliceSlot slot, bool value);
+  /// @return the dirty slot with the highest index smaller than @a index,
+  /// or an invalid slot if there is none. This allows iterating on the dirty
+  /// slots without checking each one of them.
+  [[nodiscard]] inline TimesliceSlot findDirtyBefore(size_t index) const;
   inline void markAsInvalid(TimesliceSlot slot);
   /// Mark all the cachelines as invalid, e.g. due to an out of band event
   inline void rescan();
@@ -143,8 +147,8 @@ class TimesliceIndex
   std::vector<data_matcher::VariableContext> mPublishedVariables;
 
   /// This keeps track whether or not something was relayed
-  /// since last time we called getReadyToProcess()
-  std::vector<bool> mDirty;
+  /// since last time we called getReadyToProcess(). One bit per slot.
+  std::vector<uint64_t> mDirty;
 
   /// This is the oldest possible timeslice for any given channel
   /// The cardinality of this vector is the number of input channels
@@ -13,6 +13,7 @@
 #include "Framework/AODReaderHelpers.h"
 #include "Framework/ArrowContext.h"
 #include "Framework/DataProcessor.h"
+#include "Framework/Expressions.h"
 #include "Framework/ServiceRegistry.h"
 #include "Framework/ConfigContext.h"
 #include "Framework/CommonDataProcessors.h"
@@ -389,6 +390,14 @@ o2::framework::ServiceSpec ArrowSupport::arrowBackendSpec()
                        auto& monitoring = ctx.services().get<Monitoring>();
                        monitoring.send(Metric{(uint64_t)arrow->bytesDestroyed(), "arrow-bytes-destroyed"}.addTag(Key::Subsystem, monitoring::tags::Value::DPL));
                        monitoring.send(Metric{(uint64_t)arrow->messagesDestroyed(), "arrow-messages-destroyed"}.addTag(Key::Subsystem, monitoring::tags::Value::DPL));
+                       auto expressionCache = expressions::getExpressionCacheStats();
+                       if (expressionCache.hits + expressionCache.misses > 0) {
+                         monitoring.send(Metric{expressionCache.hits, "expression-cache-hits"}.addTag(Key::Subsystem, monitoring::tags::Value::DPL));
+                         monitoring.send(Metric{expressionCache.misses, "expression-cache-misses"}.addTag(Key::Subsystem, monitoring::tags::Value::DPL));
+                         monitoring.send(Metric{(double)expressionCache.hits / (expressionCache.hits + expressionCache.misses), "expression-cache-hit-rate"}.addTag(Key::Subsystem, monitoring::tags::Value::DPL));
+                         monitoring.send(Metric{expressionCache.evictions, "expression-cache-evictions"}.addTag(Key::Subsystem, monitoring::tags::Value::DPL));
+                         monitoring.send(Metric{expressionCache.buildTimeUs / 1000., "expression-build-time-ms"}.addTag(Key::Subsystem, monitoring::tags::Value::DPL));
+                       }
                        monitoring.flushBuffer(); },
     .driverInit = [](ServiceRegistry& registry, boost::program_options::variables_map const& vm) {
                        auto config = new RateLimitConfig{};
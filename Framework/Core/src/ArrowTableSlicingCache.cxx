@@ -0,0 +1,38 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#include "Framework/ArrowTableSlicingCache.h"
+
+#include <arrow/array.h>
+
+namespace o2::framework
+{
+arrow::Status ArrowTableSlicingCache::getCacheFor(std::shared_ptr<arrow::Table> const& table, std::string const& key, std::shared_ptr<SliceInfo const>& info)
+{
+  auto column = table->GetColumnByName(key);
+  if (column == nullptr) {
+    return arrow::Status::KeyError("Column ", key, " not found");
+  }
+  CacheKey cacheKey{key, {}};
+  for (auto const& chunk : column->chunks()) {
+    cacheKey.second.emplace_back(chunk->data()->GetValues<int32_t>(1), chunk->length());
+  }
+  auto entry = mCache.find(cacheKey);
+  if (entry != mCache.end()) {
+    info = entry->second;
+    return arrow::Status::OK();
+  }
+  auto newInfo = std::make_shared<SliceInfo>();
+  ARROW_RETURN_NOT_OK(getSliceInfo(key.c_str(), table, *newInfo));
+  info = mCache.emplace(std::move(cacheKey), std::move(newInfo)).first->second;
+  return arrow::Status::OK();
+}
+} // namespace o2::framework
@@ -11,7 +11,8 @@
 
 #include "Framework/AsyncQueue.h"
 #include "Framework/Logger.h"
-#include <numeric>
+#include <algorithm>
+#include <climits>
 
 namespace o2::framework
 {
@@ -25,86 +26,84 @@ auto AsyncQueueHelpers::create(AsyncQueue& queue, AsyncTaskSpec spec) -> AsyncTa
 
 auto AsyncQueueHelpers::post(AsyncQueue& queue, AsyncTaskId id, std::function<void()> task, TimesliceId timeslice, int64_t debounce) -> void
 {
+  auto& bucket = queue.tasks[timeslice.value];
+  auto scoreOf = [&queue](AsyncTask const& t) {
+    return t.id.value == -1 ? INT_MIN : queue.prototypes[t.id.value].score;
+  };
+
+  // Tasks with the same id and timeslice always become runnable together,
+  // so only the one with the highest debounce value will ever run.
+  if (debounce >= 0 && id.value != -1) {
+    auto same = std::find_if(bucket.begin(), bucket.end(), [&id](AsyncTask const& t) {
+      return t.id.value == id.value && t.debounce >= 0;
+    });
+    if (same != bucket.end()) {
+      if (same->debounce < debounce) {
+        same->task = std::move(task);
+        same->debounce = debounce;
+      }
+      return;
+    }
+  }
+
   AsyncTask taskToPost;
-  taskToPost.task = task;
+  taskToPost.task = std::move(task);
   taskToPost.id = id;
   taskToPost.timeslice = timeslice;
   taskToPost.debounce = debounce;
-  queue.tasks.push_back(taskToPost);
+  // Keep the bucket sorted by score and then debounce, both descending.
+  auto score = scoreOf(taskToPost);
+  auto pos = std::find_if(bucket.begin(), bucket.end(), [&](AsyncTask const& t) {
+    auto other = scoreOf(t);
+    return other < score || (other == score && t.id.value == id.value && t.debounce < debounce);
+  });
+  bucket.insert(pos, std::move(taskToPost));
+  queue.pending++;
 }
 
 auto AsyncQueueHelpers::run(AsyncQueue& queue, TimesliceId oldestPossible) -> void
 {
-  if (queue.tasks.empty()) {
+  if (queue.pending == 0) {
+    return;
+  }
+  LOGP(debug, "Attempting at running {} tasks", queue.pending);
+  // All the buckets up to (and including) the oldest possible timeslice
+  // are runnable.
+  auto end = queue.tasks.upper_bound(oldestPossible.value);
+  if (end == queue.tasks.begin()) {
+    LOGP(debug, "AsyncQueue: not running iteration {} timeslice {} pending {}.", queue.iteration, oldestPossible.value, queue.pending);
     return;
   }
-  LOGP(debug, "Attempting at running {} tasks", queue.tasks.size());
-  std::vector<int> order;
-  order.resize(queue.tasks.size());
-  std::iota(order.begin(), order.end(), 0);
-  // Decide wether or not they can run as a first thing
-  for (auto& task : queue.tasks) {
-    if (task.timeslice.value <= oldestPossible.value) {
-      task.runnable = true;
+  std::vector<AsyncTask> runnable;
+  for (auto it = std::make_reverse_iterator(end); it != queue.tasks.rend(); ++it) {
+    for (auto& task : it->second) {
+      runnable.emplace_back(std::move(task));
     }
   }
+  queue.tasks.erase(queue.tasks.begin(), end);
+  queue.pending -= runnable.size();
 
-  // Sort by runnable, timeslice, then priority and finally debounce
-  std::sort(order.begin(), order.end(), [&queue](int a, int b) {
-    if (queue.tasks[a].runnable && !queue.tasks[b].runnable) {
-      return true;
-    }
-    if (!queue.tasks[a].runnable && queue.tasks[b].runnable) {
-      return false;
-    }
-    if (queue.tasks[a].timeslice.value == queue.tasks[b].timeslice.value) {
-      if (queue.tasks[a].id.value == -1 || queue.tasks[b].id.value == -1) {
-        return false;
+  LOGP(debug, "AsyncQueue: Running {} tasks in iteration {} timeslice {}", runnable.size(), queue.iteration, oldestPossible.value);
+  // Keep only the task with the highest (timeslice, debounce) value for a
+  // given id. Since we go by descending timeslice, it's the first one we meet.
+  std::vector<bool> done(queue.prototypes.size(), false);
+  for (auto& task : runnable) {
+    if (task.id.value != -1 && task.debounce >= 0) {
+      if (done[task.id.value]) {
+        LOGP(debug, "AsyncQueue: Skipping task {}, timeslice {}, debounce {}", task.id.value, task.timeslice.value, task.debounce);
+        continue;
       }
-      if (queue.tasks[a].id.value == queue.tasks[b].id.value) {
-        return queue.tasks[a].debounce > queue.tasks[b].debounce;
-      }
-      return queue.prototypes[queue.tasks[a].id.value].score > queue.prototypes[queue.tasks[b].id.value].score;
-    } else {
-      return queue.tasks[a].timeslice.value > queue.tasks[b].timeslice.value;
-    }
-  });
-  for (auto i : order) {
-    if (queue.tasks[i].runnable) {
-      LOGP(debug, "AsyncQueue: Running task {}, timeslice {}, score {}, debounce {}", queue.tasks[i].id.value, queue.tasks[i].timeslice.value, queue.prototypes[queue.tasks[i].id.value].score, queue.tasks[i].debounce);
-    } else {
-      LOGP(debug, "AsyncQueue: Skipping task {}, timeslice {}, score {}, debounce {}", queue.tasks[i].id.value, queue.tasks[i].timeslice.value, queue.prototypes[queue.tasks[i].id.value].score, queue.tasks[i].debounce);
+      done[task.id.value] = true;
     }
-  }
-  // Keep only the tasks with the highest debounce value for a given id
-  auto newEnd = std::unique(order.begin(), order.end(), [&queue](int a, int b) {
-    return queue.tasks[a].runnable == queue.tasks[b].runnable && queue.tasks[a].id.value == queue.tasks[b].id.value && queue.tasks[a].debounce >= 0 && queue.tasks[b].debounce >= 0;
-  });
-  order.erase(newEnd, order.end());
-
-  if (order.empty() && queue.tasks.size() > 0) {
-    LOGP(debug, "AsyncQueue: not running iteration {} timeslice {} pending {}.", order.size(), queue.iteration, oldestPossible.value, queue.tasks.size());
-    return;
-  } else if (order.empty()) {
-    return;
-  }
-  LOGP(debug, "AsyncQueue: Running {} tasks in iteration {} timeslice {}", order.size(), queue.iteration, oldestPossible.value);
-  bool obsolete = true;
-
-  for (auto i : order) {
-    if (queue.tasks[i].runnable) {
-      // If a task is runable, we can run the task and remove it from the queue
-      LOGP(debug, "Running task {} ({})", queue.prototypes[queue.tasks[i].id.value].name, i);
-      queue.tasks[i].task();
-      LOGP(debug, "Done running {}", i);
+    if (task.id.value == -1) {
+      task.task();
+      continue;
     }
+    auto& spec = queue.prototypes[task.id.value];
+    LOGP(debug, "AsyncQueue: Running task {}, timeslice {}, score {}, debounce {}", spec.name, task.timeslice.value, spec.score, task.debounce);
+    task.task();
   }
-  // Remove all runnable tasks regardless  they actually
-  // ran or they were skipped due to debouncing.
-  queue.tasks.erase(std::remove_if(queue.tasks.begin(), queue.tasks.end(), [&queue](AsyncTask const& task) {
-                      return task.runnable;
-                    }),
-                    queue.tasks.end());
+  queue.iteration++;
 }
 
 } // namespace o2::framework
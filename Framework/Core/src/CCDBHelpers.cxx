@@ -23,6 +23,7 @@
 #include <TError.h>
 #include <TMemFile.h>
 #include <functional>
+#include <limits>
 
 namespace o2::framework
 {
@@ -34,6 +35,19 @@ struct CCDBFetcherHelper {
     size_t cacheHit = 0;
     size_t minSize = -1ULL;
     size_t maxSize = 0;
+    int64_t validFrom = 0;
+    int64_t validUntil = std::numeric_limits<int64_t>::max();
+    int64_t prefetchedFor = -1; // end of validity for which the object of the next interval was prefetched
+  };
+
+  /// object of the next validity interval of a path, loaded ahead of the end of validity of the cached one
+  struct PrefetchedObject {
+    o2::pmr::vector<char> blob;
+    std::map<std::string, std::string> headers;
+    std::map<std::string, std::string> metadata;
+    int64_t validFrom = 0;
+    int64_t validUntil = 0;
+    bool ready = false; // false until the request is done
   };
 
   struct RemapMatcher {
@@ -52,6 +66,8 @@ struct CCDBFetcherHelper {
   std::vector<OutputRoute> routes;
   std::unordered_map<std::string, std::string> remappings;
   size_t queryDownScaleRate = 1;
+  std::unordered_map<std::string, PrefetchedObject> prefetched;
+  int64_t prefetchWindow = 0; // ms before the end of validity of an object from which the next one is prefetched, 0 to disable
   o2::ccdb::CcdbApi& getAPI(const std::string& path)
   {
     // find the first = sign in the string. If present drop everything after it
@@ -168,52 +184,137 @@ auto getOrbitResetTime(o2::pmr::vector<char> const& v) -> Long64_t
   return (*ctp)[0];
 };
 
+auto getValidity(std::map<std::string, std::string> const& headers, std::string const& key, int64_t defaultValue) -> int64_t
+{
+  auto entry = headers.find(key);
+  return entry == headers.end() ? defaultValue : std::strtoll(entry->second.c_str(), nullptr, 10);
+}
+
 auto populateCacheWith(std::shared_ptr<CCDBFetcherHelper> const& helper,
                        int64_t timestamp,
                        TimingInfo& timingInfo,
                        DataTakingContext& dtc,
                        DataAllocator& allocator) -> void
 {
+  // the objects to be checked are requested from each backend at once, the results are then
+  // processed route by route
+  struct RouteQuery {
+    std::string path;
+    std::map<std::string, std::string> metadata;
+    std::map<std::string, std::string> headers;
+    std::string etag;
+    bool load = false;
+  };
   std::string ccdbMetadataPrefix = "ccdb-metadata-";
   bool checkValidityGlo = timingInfo.timeslice % helper->queryDownScaleRate == 0;
-  for (auto& route : helper->routes) {
+  std::vector<RouteQuery> queries(helper->routes.size());
+  std::vector<o2::pmr::vector<char>> buffers;
+  buffers.reserve(helper->routes.size());
+  std::unordered_map<o2::ccdb::CcdbApi const*, std::vector<o2::ccdb::CcdbApi::LoadRequest>> requests;
+  std::vector<std::string> prefetchPaths;
+
+  for (size_t ir = 0; ir < helper->routes.size(); ir++) {
+    auto& route = helper->routes[ir];
+    auto& query = queries[ir];
     LOGP(debug, "Fetching object for route {}", route.matcher);
 
     auto concrete = DataSpecUtils::asConcreteDataMatcher(route.matcher);
     Output output{concrete.origin, concrete.description, concrete.subSpec, route.matcher.lifetime};
-    auto&& v = allocator.makeVector<char>(output);
-    std::map<std::string, std::string> metadata;
-    std::map<std::string, std::string> headers;
-    std::string path = "";
-    std::string etag = "";
+    auto& v = buffers.emplace_back(allocator.makeVector<char>(output));
     bool checkValidity = checkValidityGlo;
     for (auto& meta : route.matcher.metadata) {
       if (meta.name == "ccdb-path") {
-        path = meta.defaultValue.get<std::string>();
+        query.path = meta.defaultValue.get<std::string>();
       } else if (meta.name == "ccdb-run-dependent" && meta.defaultValue.get<bool>() == true) {
-        metadata["runNumber"] = dtc.runNumber;
+        query.metadata["runNumber"] = dtc.runNumber;
       } else if (isPrefix(ccdbMetadataPrefix, meta.name)) {
         std::string key = meta.name.substr(ccdbMetadataPrefix.size());
         auto value = meta.defaultValue.get<std::string>();
         LOGP(debug, "Adding metadata {}: {} to the request", key, value);
-        metadata[key] = value;
+        query.metadata[key] = value;
       } else if (meta.name == "ccdb-query-rate") {
         checkValidity = (timingInfo.timeslice % meta.defaultValue.get<int64_t>() == 0);
       }
     }
+    const auto& path = query.path;
     LOGP(debug, "checkValidity is {} for slice {} of {}", checkValidity, timingInfo.timeslice, path);
 
     const auto url2uuid = helper->mapURL2UUID.find(path);
     if (url2uuid != helper->mapURL2UUID.end()) {
-      etag = url2uuid->second.etag;
+      query.etag = url2uuid->second.etag;
     } else {
       checkValidity = true; // never skip check if the cache is empty
     }
     const auto& api = helper->getAPI(path);
-    if (checkValidity && (!api.isSnapshotMode() || etag.empty())) { // in the snapshot mode the object needs to be fetched only once
+    if (api.isSnapshotMode()) {
+      query.load = checkValidity && query.etag.empty(); // in the snapshot mode the object needs to be fetched only once
+      if (query.load) {
+        requests[&api].push_back({&v, path, query.metadata, timestamp, &query.headers, query.etag});
+      }
+      continue;
+    }
+    // the cached object expired and the object of the next validity interval was prefetched: use it without query
+    auto prefetched = helper->prefetched.find(path);
+    if (prefetched != helper->prefetched.end() && prefetched->second.ready && url2uuid != helper->mapURL2UUID.end() &&
+        (timestamp < url2uuid->second.validFrom || timestamp >= url2uuid->second.validUntil)) {
+      auto& object = prefetched->second;
+      if (object.metadata == query.metadata && object.validFrom <= timestamp && timestamp < object.validUntil) {
+        LOGP(detail, "Using the object of {} prefetched for timestamp {}", path, timestamp);
+        v.assign(object.blob.begin(), object.blob.end());
+        query.headers = std::move(object.headers);
+        query.etag.clear();
+        query.load = true;
+      }
+      helper->prefetched.erase(prefetched);
+      if (query.load) {
+        continue;
+      }
+    }
+    if (checkValidity) {
       LOGP(detail, "Loading {} for timestamp {}", path, timestamp);
-      api.loadFileToMemory(v, path, metadata, timestamp, &headers, etag, helper->createdNotAfter, helper->createdNotBefore);
-      if ((headers.count("Error") != 0) || (etag.empty() && v.empty())) {
+      query.load = true;
+      requests[&api].push_back({&v, path, query.metadata, timestamp, &query.headers, query.etag});
+      // the object of the next validity interval is loaded with the query preceding the end of validity of the cached one
+      // (not with a local snapshot cache, which keeps one object per path)
+      if (helper->prefetchWindow > 0 && !api.hasSnapshotCache() && url2uuid != helper->mapURL2UUID.end()) {
+        auto& info = url2uuid->second;
+        if (timestamp < info.validUntil && timestamp + helper->prefetchWindow >= info.validUntil && info.prefetchedFor != info.validUntil) {
+          info.prefetchedFor = info.validUntil;
+          helper->prefetched.erase(path);
+          auto& object = helper->prefetched[path];
+          object.metadata = query.metadata;
+          requests[&api].push_back({&object.blob, path, query.metadata, info.validUntil, &object.headers, ""});
+          prefetchPaths.push_back(path);
+        }
+      }
+    }
+  }
+
+  for (auto& [api, apiRequests] : requests) {
+    api->loadFilesToMemory(apiRequests, helper->createdNotAfter, helper->createdNotBefore);
+  }
+  for (auto& path : prefetchPaths) {
+    auto& object = helper->prefetched[path];
+    if (object.headers.count("Error") != 0 || object.blob.empty()) {
+      LOGP(detail, "No object of {} could be prefetched for the next validity interval", path);
+      helper->prefetched.erase(path);
+      continue;
+    }
+    object.validFrom = getValidity(object.headers, "Valid-From", 0);
+    object.validUntil = getValidity(object.headers, "Valid-Until", 0);
+    object.ready = true;
+  }
+
+  for (size_t ir = 0; ir < helper->routes.size(); ir++) {
+    auto& route = helper->routes[ir];
+    auto& query = queries[ir];
+    auto& v = buffers[ir];
+    auto& path = query.path;
+    auto& headers = query.headers;
+    auto concrete = DataSpecUtils::asConcreteDataMatcher(route.matcher);
+    Output output{concrete.origin, concrete.description, concrete.subSpec, route.matcher.lifetime};
+    if (query.load) {
+      if ((headers.count("Error") != 0) || (query.etag.empty() && v.empty())) {
         LOGP(fatal, "Unable to find object {}/{}", path, timestamp);
         // FIXME: I should send a dummy message.
         continue;
@@ -222,22 +323,15 @@ auto populateCacheWith(std::shared_ptr<CCDBFetcherHelper> const& helper,
       if (headers.find("default") != headers.end()) {
         LOGP(detail, "******** Default entry used for {} ********", path);
       }
-      if (etag.empty()) {
-        helper->mapURL2UUID[path].etag = headers["ETag"]; // update uuid
-        helper->mapURL2UUID[path].cacheMiss++;
-        helper->mapURL2UUID[path].minSize = std::min(v.size(), helper->mapURL2UUID[path].minSize);
-        helper->mapURL2UUID[path].maxSize = std::max(v.size(), helper->mapURL2UUID[path].maxSize);
-        auto cacheId = allocator.adoptContainer(output, std::move(v), true, header::gSerializationMethodCCDB);
-        helper->mapURL2DPLCache[path] = cacheId;
-        LOGP(debug, "Caching {} for {} (DPL id {})", path, headers["ETag"], cacheId.value);
-        continue;
-      }
-      if (v.size()) { // but should be overridden by fresh object
+      if (query.etag.empty() || v.size()) { // a fresh object overrides the cached one
         // somewhere here pruneFromCache should be called
-        helper->mapURL2UUID[path].etag = headers["ETag"]; // update uuid
-        helper->mapURL2UUID[path].cacheMiss++;
-        helper->mapURL2UUID[path].minSize = std::min(v.size(), helper->mapURL2UUID[path].minSize);
-        helper->mapURL2UUID[path].maxSize = std::max(v.size(), helper->mapURL2UUID[path].maxSize);
+        auto& info = helper->mapURL2UUID[path];
+        info.etag = headers["ETag"]; // update uuid
+        info.validFrom = getValidity(headers, "Valid-From", 0);
+        info.validUntil = getValidity(headers, "Valid-Until", std::numeric_limits<int64_t>::max());
+        info.cacheMiss++;
+        info.minSize = std::min(v.size(), info.minSize);
+        info.maxSize = std::max(v.size(), info.maxSize);
         auto cacheId = allocator.adoptContainer(output, std::move(v), true, header::gSerializationMethodCCDB);
         helper->mapURL2DPLCache[path] = cacheId;
         LOGP(debug, "Caching {} for {} (DPL id {})", path, headers["ETag"], cacheId.value);
@@ -282,6 +376,7 @@ AlgorithmSpec CCDBHelpers::fetchFromCCDB()
       }
       helper->createdNotBefore = std::to_string(options.get<int64_t>("condition-not-before"));
       helper->createdNotAfter = std::to_string(options.get<int64_t>("condition-not-after"));
+      helper->prefetchWindow = options.get<int64_t>("condition-prefetch-window");
 
       for (auto &route : spec.outputs) {
         if (route.matcher.lifetime != Lifetime::Condition) {
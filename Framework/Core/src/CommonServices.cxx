@@ -10,6 +10,7 @@
 // or submit itself to any jurisdiction.
 #include "Framework/CommonServices.h"
 #include "Framework/AsyncQueue.h"
+#include "Framework/ArrowTableSlicingCache.h"
 #include "Framework/DataInspectorService.h"
 #include "Framework/ParallelContext.h"
 #include "Framework/ControlService.h"
@@ -905,6 +906,19 @@ o2::framework::ServiceSpec CommonServices::objectCache()
     .kind = ServiceKind::Serial};
 }
 
+o2::framework::ServiceSpec CommonServices::arrowTableSlicingCacheSpec()
+{
+  return ServiceSpec{
+    .name = "arrow-slicing-cache",
+    .init = simpleServiceInit<ArrowTableSlicingCache, ArrowTableSlicingCache>(),
+    .configure = noConfiguration(),
+    .preProcessing = [](ProcessingContext&, void* service) {
+      // the slices are valid for the tables of one dataframe only
+      reinterpret_cast<ArrowTableSlicingCache*>(service)->clear();
+    },
+    .kind = ServiceKind::Serial};
+}
+
 o2::framework::ServiceSpec CommonServices::dataInspectorServiceSpec()
 {
   return ServiceSpec{
@@ -954,6 +968,7 @@ std::vector<ServiceSpec> CommonServices::defaultServices(int numThreads)
     dataSender(),
     dataProcessingStats(),
     objectCache(),
+    arrowTableSlicingCacheSpec(),
     ccdbSupportSpec(),
     CommonMessageBackends::fairMQBackendSpec(),
     ArrowSupport::arrowBackendSpec(),
@@ -11,6 +11,7 @@
 #include "Framework/DataInputDirector.h"
 #include "Framework/DataDescriptorQueryBuilder.h"
 #include "Framework/Logger.h"
+#include "Framework/TableTreeHelpers.h"
 #include "AnalysisDataModelHelpers.h"
 
 #include "rapidjson/document.h"
@@ -19,6 +20,8 @@
 
 #include "TGrid.h"
 #include "TObjString.h"
+#include "TROOT.h"
+#include "TTree.h"
 
 namespace o2
 {
@@ -34,6 +37,30 @@ FileNameHolder* makeFileNameHolder(std::string fileName)
   return fileNameHolder;
 }
 
+namespace
+{
+void fillTimeFrameKeys(TFile* file, FileNameHolder* fileNameHolder)
+{
+  std::regex TFRegex = std::regex("DF_[0-9]+");
+  TList* keyList = file->GetListOfKeys();
+
+  // extract TF numbers and sort accordingly
+  for (auto key : *keyList) {
+    if (std::regex_match(((TObjString*)key)->GetString().Data(), TFRegex)) {
+      auto folderNumber = std::stoul(std::string(((TObjString*)key)->GetString().Data()).substr(3));
+      fileNameHolder->listOfTimeFrameNumbers.emplace_back(folderNumber);
+    }
+  }
+  std::sort(fileNameHolder->listOfTimeFrameNumbers.begin(), fileNameHolder->listOfTimeFrameNumbers.end());
+
+  for (auto folderNumber : fileNameHolder->listOfTimeFrameNumbers) {
+    auto folderName = "DF_" + std::to_string(folderNumber);
+    fileNameHolder->listOfTimeFrameKeys.emplace_back(folderName);
+  }
+  fileNameHolder->numberOfTimeFrames = fileNameHolder->listOfTimeFrameKeys.size();
+}
+} // namespace
+
 DataInputDescriptor::DataInputDescriptor(bool alienSupport)
 {
   mAlienSupport = alienSupport;
@@ -107,23 +134,7 @@ bool DataInputDescriptor::setFile(int counter)
 
   // get the directory names
   if (mfilenames[counter]->numberOfTimeFrames <= 0) {
-    std::regex TFRegex = std::regex("DF_[0-9]+");
-    TList* keyList = mcurrentFile->GetListOfKeys();
-
-    // extract TF numbers and sort accordingly
-    for (auto key : *keyList) {
-      if (std::regex_match(((TObjString*)key)->GetString().Data(), TFRegex)) {
-        auto folderNumber = std::stoul(std::string(((TObjString*)key)->GetString().Data()).substr(3));
-        mfilenames[counter]->listOfTimeFrameNumbers.emplace_back(folderNumber);
-      }
-    }
-    std::sort(mfilenames[counter]->listOfTimeFrameNumbers.begin(), mfilenames[counter]->listOfTimeFrameNumbers.end());
-
-    for (auto folderNumber : mfilenames[counter]->listOfTimeFrameNumbers) {
-      auto folderName = "DF_" + std::to_string(folderNumber);
-      mfilenames[counter]->listOfTimeFrameKeys.emplace_back(folderName);
-    }
-    mfilenames[counter]->numberOfTimeFrames = mfilenames[counter]->listOfTimeFrameKeys.size();
+    fillTimeFrameKeys(mcurrentFile, mfilenames[counter]);
   }
 
   return true;
@@ -554,6 +565,25 @@ uint64_t DataInputDirector::getTimeFrameNumber(header::DataHeader dh, int counte
   return didesc->getTimeFrameNumber(counter, numTF);
 }
 
+std::string DataInputDirector::getFileName(header::DataHeader dh, int counter)
+{
+  auto didesc = getDataInputDescriptor(dh);
+  // if NOT match then use defaultDataInputDescriptor
+  if (!didesc) {
+    didesc = mdefaultDataInputDescriptor;
+  }
+
+  return didesc->getFileName(counter);
+}
+
+std::string DataInputDirector::getTreeName(header::DataHeader dh)
+{
+  auto didesc = getDataInputDescriptor(dh);
+  // if match then use treename from DataInputDescriptor
+  // if NOT match then use treename from DataHeader
+  return didesc ? didesc->treename : aod::datamodel::getTreeName(dh);
+}
+
 TTree* DataInputDirector::getDataTree(header::DataHeader dh, int counter, int numTF)
 {
   std::string treename;
@@ -629,5 +659,216 @@ void DataInputDirector::printOut()
   }
 }
 
+DataFramePrefetcher::DataFramePrefetcher(std::shared_ptr<DataInputDirector> didir, std::vector<header::DataHeader> headers, int first, int stride,
+                                         int depth, int nThreads, size_t memoryLimit, int columnThreads)
+  : mDirector{std::move(didir)},
+    mHeaders{std::move(headers)},
+    mStride{stride},
+    mDepth{std::max(depth, 1)},
+    mMemoryLimit{memoryLimit},
+    mColumnThreads{columnThreads},
+    mCounter{first}
+{
+  for (auto& dh : mHeaders) {
+    mTreeNames.emplace_back(mDirector->getTreeName(dh));
+  }
+  if (mHeaders.empty()) {
+    mEnd = 0;
+  }
+
+  // the threads open and read files of their own
+  ROOT::EnableThreadSafety();
+  for (auto i = 0; i < std::max(nThreads, 1); ++i) {
+    mThreads.emplace_back(&DataFramePrefetcher::run, this);
+  }
+}
+
+DataFramePrefetcher::~DataFramePrefetcher()
+{
+  stop();
+}
+
+void DataFramePrefetcher::stop()
+{
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mStop = true;
+  }
+  mCondition.notify_all();
+  for (auto& thread : mThreads) {
+    thread.join();
+  }
+  mThreads.clear();
+}
+
+size_t DataFramePrefetcher::getNReadAhead()
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  return mReady.size();
+}
+
+bool DataFramePrefetcher::next(PrefetchedDataFrame& df)
+{
+  std::unique_lock<std::mutex> lock(mMutex);
+  mCondition.wait(lock, [this]() { return mReady.count(mNextHandOut) > 0 || mNextHandOut >= mEnd; });
+  auto ready = mReady.find(mNextHandOut);
+  if (ready == mReady.end()) {
+    return false;
+  }
+  df = std::move(ready->second);
+  mReady.erase(ready);
+  mBytesHeld -= df.bytesUncompressed;
+  ++mNextHandOut;
+  lock.unlock();
+  mCondition.notify_all();
+
+  if (df.error) {
+    std::rethrow_exception(df.error);
+  }
+  return true;
+}
+
+namespace
+{
+TFile* openFile(std::map<std::string, std::unique_ptr<TFile>>& files, std::string const& fileName)
+{
+  auto& file = files[fileName];
+  if (!file) {
+    file.reset(TFile::Open(fileName.c_str()));
+    if (!file) {
+      files.erase(fileName);
+      throw std::runtime_error(fmt::format("Couldn't open file \"{}\"!", fileName));
+    }
+    file->SetReadaheadSize(50 * 1024 * 1024);
+  }
+  return file.get();
+}
+} // namespace
+
+FileNameHolder const& DataFramePrefetcher::getTimeFrameKeys(std::string const& fileName, TFile* file)
+{
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    auto keys = mTimeFrameKeys.find(fileName);
+    if (keys != mTimeFrameKeys.end()) {
+      return keys->second;
+    }
+  }
+  FileNameHolder keys;
+  keys.fileName = fileName;
+  fillTimeFrameKeys(file, &keys);
+
+  std::lock_guard<std::mutex> lock(mMutex);
+  return mTimeFrameKeys.emplace(fileName, std::move(keys)).first->second;
+}
+
+void DataFramePrefetcher::read(PrefetchedDataFrame& df, std::map<std::string, std::unique_ptr<TFile>>& files)
+{
+  // close the files of the previous file counter
+  std::vector<std::string> fileNames;
+  for (auto& dh : mHeaders) {
+    fileNames.emplace_back(mDirector->getFileName(dh, df.counter));
+  }
+  for (auto file = files.begin(); file != files.end();) {
+    if (std::find(fileNames.begin(), fileNames.end(), file->first) == fileNames.end()) {
+      file = files.erase(file);
+    } else {
+      ++file;
+    }
+  }
+
+  for (auto i = 0u; i < mHeaders.size(); ++i) {
+    auto file = openFile(files, fileNames[i]);
+    auto& keys = getTimeFrameKeys(fileNames[i], file);
+    if (df.numTF >= keys.numberOfTimeFrames) {
+      throw std::runtime_error(fmt::format("Can not retrieve tree {}: fileCounter {}, timeFrame {}", mTreeNames[i], df.counter, df.numTF));
+    }
+    auto treename = keys.listOfTimeFrameKeys[df.numTF] + "/" + mTreeNames[i];
+    std::unique_ptr<TTree> tree{(TTree*)file->Get(treename.c_str())};
+    if (!tree) {
+      throw std::runtime_error(fmt::format(R"(Couldn't get TTree "{}" from "{}". Please check https://aliceo2group.github.io/analysis-framework/docs/troubleshooting/treenotfound.html for more information.)", treename, file->GetName()));
+    }
+
+    df.bytesCompressed += tree->GetZipBytes();
+    df.bytesUncompressed += tree->GetTotBytes();
+    TreeToTable t2t;
+    t2t.setLabel(tree->GetName());
+    t2t.setUseTreeCache(true);
+    t2t.setNThreads(mColumnThreads);
+    t2t.addAllColumns(tree.get());
+    t2t.fill(tree.get());
+    df.tables.emplace_back(t2t.finalize());
+  }
+}
+
+void DataFramePrefetcher::run()
+{
+  // the files stay open as long as dataframes are read from them
+  std::map<std::string, std::unique_ptr<TFile>> files;
+  std::unique_lock<std::mutex> lock(mMutex);
+  while (true) {
+    mCondition.wait(lock, [this]() {
+      return mStop || mNextRead >= mEnd ||
+             (!mListing && mNextRead < mNextHandOut + mDepth && (mBytesHeld < mMemoryLimit || mNextRead == mNextHandOut));
+    });
+    if (mStop || mNextRead >= mEnd) {
+      break;
+    }
+
+    // list the dataframes of the next file
+    if (mCurrentKeys == nullptr) {
+      if (mDirector->atEnd(mCounter)) {
+        mEnd = mNextRead;
+        mCondition.notify_all();
+        break;
+      }
+      mListing = true;
+      auto counter = mCounter;
+      lock.unlock();
+      FileNameHolder const* keys = nullptr;
+      PrefetchedDataFrame failed;
+      try {
+        auto fileName = mDirector->getFileName(mHeaders[0], counter);
+        keys = &getTimeFrameKeys(fileName, openFile(files, fileName));
+      } catch (...) {
+        failed.error = std::current_exception();
+      }
+      lock.lock();
+      mListing = false;
+      if (failed.error) {
+        mReady.emplace(mNextRead, std::move(failed));
+        mEnd = ++mNextRead;
+        mCondition.notify_all();
+        break;
+      }
+      mCurrentKeys = keys;
+      mNumTF = 0;
+      mCondition.notify_all();
+      continue;
+    }
+    if (mNumTF >= mCurrentKeys->numberOfTimeFrames) {
+      mCounter += mStride;
+      mCurrentKeys = nullptr;
+      continue;
+    }
+
+    PrefetchedDataFrame df;
+    df.counter = mCounter;
+    df.numTF = mNumTF++;
+    df.timeFrameNumber = mCurrentKeys->listOfTimeFrameNumbers[df.numTF];
+    auto sequence = mNextRead++;
+    lock.unlock();
+    try {
+      read(df, files);
+    } catch (...) {
+      df.error = std::current_exception();
+    }
+    lock.lock();
+    mBytesHeld += df.bytesUncompressed;
+    mReady.emplace(sequence, std::move(df));
+    mCondition.notify_all();
+  }
+}
+
 } // namespace framework
 } // namespace o2
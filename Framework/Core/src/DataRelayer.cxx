@@ -57,6 +57,26 @@ constexpr int INVALID_INPUT = -1;
 // The number should really be tuned at runtime for each processor.
 constexpr int DEFAULT_PIPELINE_LENGTH = 128;
 
+namespace
+{
+/// @return true if the matcher contains a negation, which means that binding
+/// a variable can make it match when it would not match an empty context.
+bool hasNegation(DataDescriptorMatcher const& matcher)
+{
+  if (matcher.getOp() == DataDescriptorMatcher::Op::Not || matcher.getOp() == DataDescriptorMatcher::Op::Xor) {
+    return true;
+  }
+  for (auto* node : {&matcher.getLeft(), &matcher.getRight()}) {
+    if (auto child = std::get_if<std::unique_ptr<DataDescriptorMatcher>>(node)) {
+      if (*child && hasNegation(**child)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+} // namespace
+
 DataRelayer::DataRelayer(const CompletionPolicy& policy,
                          std::vector<InputRoute> const& routes,
                          monitoring::Monitoring& metrics,
@@ -68,8 +88,6 @@ DataRelayer::DataRelayer(const CompletionPolicy& policy,
     mInputMatchers{DataRelayerHelpers::createInputMatchers(routes)},
     mMaxLanes{InputRouteHelpers::maxLanes(routes)}
 {
-  std::scoped_lock<LockableBase(std::recursive_mutex)> lock(mMutex);
-
   if (policy.configureRelayer == nullptr) {
     char* defaultPipelineLengthTxt = getenv("DPL_DEFAULT_PIPELINE_LENGTH");
     int defaultPipelineLength = defaultPipelineLengthTxt ? std::stoi(defaultPipelineLengthTxt) : DEFAULT_PIPELINE_LENGTH;
@@ -80,6 +98,9 @@ DataRelayer::DataRelayer(const CompletionPolicy& policy,
 
   // The queries are all the same, so we only have width 1
   auto numInputTypes = mDistinctRoutesIndex.size();
+  for (size_t i = 0; i < numInputTypes; ++i) {
+    mRouteNeedsFullMatch.push_back(hasNegation(mInputMatchers[mDistinctRoutesIndex[i]]));
+  }
   sQueriesMetricsNames.resize(numInputTypes * 1);
   mMetrics.send({(int)numInputTypes, "data_queries/h", Verbosity::Debug});
   mMetrics.send({(int)1, "data_queries/w", Verbosity::Debug});
@@ -94,9 +115,90 @@ DataRelayer::DataRelayer(const CompletionPolicy& policy,
   }
 }
 
+void DataRelayer::waitForRelease(TimesliceSlot slot, uint32_t mask)
+{
+  auto& slotState = mSlotStates[slot.index];
+  if ((slotState.state.load(std::memory_order_acquire) & mask) == 0) {
+    return;
+  }
+  std::unique_lock<std::mutex> lock(slotState.mutex);
+  slotState.released.wait(lock, [&slotState, mask]() { return (slotState.state.load(std::memory_order_acquire) & mask) == 0; });
+}
+
+void DataRelayer::notifyRelease(TimesliceSlot slot)
+{
+  auto& slotState = mSlotStates[slot.index];
+  // Taking the mutex orders the state change with respect to a waiter
+  // which is about to park, so that the notification is not lost.
+  { std::lock_guard<std::mutex> lock(slotState.mutex); }
+  slotState.released.notify_all();
+}
+
+void DataRelayer::beginWrite(TimesliceSlot slot)
+{
+  auto& state = mSlotStates[slot.index].state;
+  // Writers can share a slot, but they need to wait for a consumer to be done.
+  uint32_t expected = state.load(std::memory_order_relaxed) & ~SLOT_CONSUMING;
+  while (!state.compare_exchange_weak(expected, expected + 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+    if (expected & SLOT_CONSUMING) {
+      waitForRelease(slot, SLOT_CONSUMING);
+    }
+    expected &= ~SLOT_CONSUMING;
+  }
+}
+
+void DataRelayer::endWrite(TimesliceSlot slot)
+{
+  mSlotStates[slot.index].state.fetch_sub(1, std::memory_order_release);
+  notifyRelease(slot);
+}
+
+void DataRelayer::beginConsume(TimesliceSlot slot)
+{
+  auto& state = mSlotStates[slot.index].state;
+  // Only the consumer which sets the bit owns the slot.
+  while (state.fetch_or(SLOT_CONSUMING, std::memory_order_acq_rel) & SLOT_CONSUMING) {
+    waitForRelease(slot, SLOT_CONSUMING);
+  }
+  waitForRelease(slot, ~SLOT_CONSUMING);
+}
+
+void DataRelayer::endConsume(TimesliceSlot slot)
+{
+  mSlotStates[slot.index].state.fetch_and(~SLOT_CONSUMING, std::memory_order_release);
+  notifyRelease(slot);
+}
+
+void DataRelayer::waitForExclusive(TimesliceSlot slot)
+{
+  waitForRelease(slot, ~0u);
+}
+
+bool DataRelayer::isSlotBusy(TimesliceSlot slot) const
+{
+  return mSlotStates[slot.index].state.load(std::memory_order_acquire) != 0;
+}
+
+void DataRelayer::markRouteFilled(TimesliceSlot slot, size_t route)
+{
+  mFilledRoutes[slot.index * mFilledRoutesWords + route / 64] |= uint64_t{1} << (route % 64);
+}
+
+void DataRelayer::clearFilledRoutes(TimesliceSlot slot)
+{
+  auto begin = mFilledRoutes.begin() + slot.index * mFilledRoutesWords;
+  std::fill(begin, begin + mFilledRoutesWords, 0);
+}
+
+bool DataRelayer::hasFilledRoutes(TimesliceSlot slot) const
+{
+  auto begin = mFilledRoutes.begin() + slot.index * mFilledRoutesWords;
+  return std::any_of(begin, begin + mFilledRoutesWords, [](uint64_t word) { return word != 0; });
+}
+
 TimesliceId DataRelayer::getTimesliceForSlot(TimesliceSlot slot)
 {
-  std::scoped_lock<LockableBase(std::recursive_mutex)> lock(mMutex);
+  std::scoped_lock<LockableBase(std::mutex)> lock(mMutex);
   auto& variables = mTimesliceIndex.getVariablesForSlot(slot);
   return VariableContextHelpers::getTimeslice(variables);
 }
@@ -105,7 +207,7 @@ DataRelayer::ActivityStats DataRelayer::processDanglingInputs(std::vector<Expira
                                                               ServiceRegistry& services, bool createNew)
 {
   LOGP(debug, "DataRelayer::processDanglingInputs");
-  std::scoped_lock<LockableBase(std::recursive_mutex)> lock(mMutex);
+  std::scoped_lock<LockableBase(std::mutex)> lock(mMutex);
   auto& deviceProxy = services.get<FairMQDeviceProxy>();
 
   ActivityStats activity;
@@ -150,6 +252,7 @@ DataRelayer::ActivityStats DataRelayer::processDanglingInputs(std::vector<Expira
     if (mTimesliceIndex.isValid(slot) == false) {
       continue;
     }
+    waitForExclusive(slot);
     assert(mDistinctRoutesIndex.empty() == false);
     auto& variables = mTimesliceIndex.getVariablesForSlot(slot);
     auto timestamp = VariableContextHelpers::getTimeslice(variables);
@@ -214,6 +317,7 @@ DataRelayer::ActivityStats DataRelayer::processDanglingInputs(std::vector<Expira
       PartRef newRef;
       expirator.handler(services, newRef, variables);
       part.reset(std::move(newRef));
+      markRouteFilled(slot, expirator.routeIndex.value);
       activity.expiredSlots++;
 
       mTimesliceIndex.markAsDirty(slot, true);
@@ -270,6 +374,7 @@ void sendVariableContextMetrics(VariableContext& context, TimesliceSlot slot,
 
 void DataRelayer::setOldestPossibleInput(TimesliceId proposed, ChannelIndex channel)
 {
+  std::scoped_lock<LockableBase(std::mutex)> lock(mMutex);
   auto newOldest = mTimesliceIndex.setOldestPossibleInput(proposed, channel);
   LOGP(debug, "DataRelayer::setOldestPossibleInput {} from channel {}", newOldest.timeslice.value, newOldest.channel.value);
   for (size_t si = 0; si < mCache.size() / mInputs.size(); ++si) {
@@ -284,6 +389,7 @@ void DataRelayer::setOldestPossibleInput(TimesliceId proposed, ChannelIndex chan
     }
     bool droppingNotCondition = false;
     mPruneOps.push_back(PruneOp{si});
+    waitForExclusive({si});
     for (size_t mi = 0; mi < mInputs.size(); ++mi) {
       auto& input = mInputs[mi];
       auto& element = mCache[si * mInputs.size() + mi];
@@ -309,14 +415,24 @@ TimesliceIndex::OldestOutputInfo DataRelayer::getOldestPossibleOutput() const
 
 void DataRelayer::prunePending(OnDropCallback onDrop)
 {
+  std::scoped_lock<LockableBase(std::mutex)> lock(mMutex);
   for (auto& op : mPruneOps) {
-    this->pruneCache(op.slot, onDrop);
+    this->doPruneCache(op.slot, onDrop);
   }
   mPruneOps.clear();
 }
 
 void DataRelayer::pruneCache(TimesliceSlot slot, OnDropCallback onDrop)
 {
+  std::scoped_lock<LockableBase(std::mutex)> lock(mMutex);
+  doPruneCache(slot, onDrop);
+}
+
+void DataRelayer::doPruneCache(TimesliceSlot slot, OnDropCallback const& onDrop)
+{
+  // Nobody can start writing in the slot while we hold the lock, so we only
+  // need to wait for whoever is already doing it.
+  waitForExclusive(slot);
   // We need to prune the cache from the old stuff, if any. Otherwise we
   // simply store the payload in the cache and we mark relevant bit in the
   // hence the first if.
@@ -357,6 +473,7 @@ void DataRelayer::pruneCache(TimesliceSlot slot, OnDropCallback onDrop)
   };
 
   pruneCache(slot);
+  clearFilledRoutes(slot);
 }
 
 DataRelayer::RelayChoice
@@ -366,12 +483,12 @@ DataRelayer::RelayChoice
                      size_t nPayloads,
                      std::function<void(TimesliceSlot, std::vector<MessageSet>&, TimesliceIndex::OldestOutputInfo)> onDrop)
 {
-  std::scoped_lock<LockableBase(std::recursive_mutex)> lock(mMutex);
+  std::unique_lock<LockableBase(std::mutex)> lock(mMutex);
   DataProcessingHeader const* dph = o2::header::get<DataProcessingHeader*>(rawHeader);
   // STATE HOLDING VARIABLES
-  // This is the class level state of the relaying. If we start supporting
-  // multithreading this will have to be made thread safe before we can invoke
-  // relay concurrently.
+  // Only the slot lookup happens while holding the lock. The messages are
+  // saved in the cache once the lock has been released, using the per slot
+  // state to make sure that nobody consumes the slot while we are writing in it.
   auto const& readonlyCache = mCache;
 
   // IMPLEMENTATION DETAILS
@@ -380,17 +497,44 @@ DataRelayer::RelayChoice
   auto isSlotInLane = [currentLane = dph->startTime, maxLanes = mMaxLanes](TimesliceSlot slot) {
     return (slot.index % maxLanes) == (currentLane % maxLanes);
   };
+  // Binding the variables of a slot can only restrict what a matcher
+  // accepts, so only the routes which match the message on an empty context
+  // can match it for any of the slots. We find them once, so that
+  // the matching of each slot does not need to go through all the routes.
+  mCandidateRoutes.clear();
+  {
+    VariableContext scratch;
+    for (size_t ri = 0, re = mDistinctRoutesIndex.size(); ri < re; ++ri) {
+      auto& matcher = mInputMatchers[mDistinctRoutesIndex[ri]];
+      if (mRouteNeedsFullMatch[ri] || matcher.match(reinterpret_cast<char const*>(rawHeader), scratch)) {
+        mCandidateRoutes.push_back(ri);
+      }
+      scratch.discard();
+    }
+  }
+  // Like matchToContext, but only considering the candidate routes.
+  auto matchCandidates = [&matchers = mInputMatchers,
+                          &distinctRoutes = mDistinctRoutesIndex,
+                          &candidates = mCandidateRoutes,
+                          &rawHeader](VariableContext& context) -> int {
+    for (auto ri : candidates) {
+      if (matchers[distinctRoutes[ri]].match(reinterpret_cast<char const*>(rawHeader), context)) {
+        context.commit();
+        return ri;
+      }
+      context.discard();
+    }
+    return INVALID_INPUT;
+  };
+
   // This returns the identifier for the given input. We use a separate
   // function because while it's trivial now, the actual matchmaking will
   // become more complicated when we will start supporting ranges.
-  auto getInputTimeslice = [&matchers = mInputMatchers,
-                            &distinctRoutes = mDistinctRoutesIndex,
-                            &rawHeader,
-                            &index = mTimesliceIndex](VariableContext& context)
+  auto getInputTimeslice = [&matchCandidates](VariableContext& context)
     -> std::tuple<int, TimesliceId> {
     /// FIXME: for the moment we only use the first context and reset
     /// between one invokation and the other.
-    auto input = matchToContext(rawHeader, matchers, distinctRoutes, context);
+    auto input = matchCandidates(context);
 
     if (input == INVALID_INPUT) {
       return {
@@ -411,17 +555,19 @@ DataRelayer::RelayChoice
     };
   };
 
-  // Actually save the header / payload in the slot
-  auto saveInSlot = [&cachedStateMetrics = mCachedStateMetrics,
-                     &messages,
+  // Actually save the header / payload in the slot. This is invoked
+  // without holding the lock. Writers share a slot, so relays of the same
+  // route (e.g. several subspecs of a wildcard input) serialise on the
+  // mutex of the cache entry.
+  auto saveInSlot = [&messages,
                      &nMessages,
                      &nPayloads,
                      &cache = mCache,
-                     numInputTypes = mDistinctRoutesIndex.size(),
-                     &metrics = mMetrics](TimesliceId timeslice, int input, TimesliceSlot slot) {
+                     &cacheMutexes = mCacheMutexes,
+                     numInputTypes = mDistinctRoutesIndex.size()](TimesliceId timeslice, int input, TimesliceSlot slot) {
     auto cacheIdx = numInputTypes * slot.index + input;
+    std::lock_guard<std::mutex> entryLock(cacheMutexes[cacheIdx]);
     MessageSet& target = cache[cacheIdx];
-    cachedStateMetrics[cacheIdx] = CacheEntryStatus::PENDING;
     // TODO: make sure that multiple parts can only be added within the same call of
     // DataRelayer::relay
     assert(nPayloads > 0);
@@ -503,13 +649,18 @@ DataRelayer::RelayChoice
   if (input != INVALID_INPUT && TimesliceId::isValid(timeslice) && TimesliceSlot::isValid(slot)) {
     O2_SIGNPOST(O2_PROBE_DATARELAYER, timeslice.value, 0, 0, 0);
     if (needsCleaning) {
-      this->pruneCache(slot, onDrop);
+      this->doPruneCache(slot, onDrop);
       mPruneOps.erase(std::remove_if(mPruneOps.begin(), mPruneOps.end(), [slot](const auto& x) { return x.slot == slot; }), mPruneOps.end());
     }
-    saveInSlot(timeslice, input, slot);
+    mCachedStateMetrics[mDistinctRoutesIndex.size() * slot.index + input] = CacheEntryStatus::PENDING;
+    markRouteFilled(slot, input);
     index.publishSlot(slot);
     index.markAsDirty(slot, true);
     mStats.relayedMessages++;
+    beginWrite(slot);
+    lock.unlock();
+    saveInSlot(timeslice, input, slot);
+    endWrite(slot);
     return WillRelay;
   }
 
@@ -580,11 +731,16 @@ DataRelayer::RelayChoice
     case TimesliceIndex::ActionTaken::ReplaceObsolete:
       // At this point the variables match the new input but the
       // cache still holds the old data, so we prune it.
-      this->pruneCache(slot, onDrop);
+      this->doPruneCache(slot, onDrop);
       mPruneOps.erase(std::remove_if(mPruneOps.begin(), mPruneOps.end(), [slot](const auto& x) { return x.slot == slot; }), mPruneOps.end());
-      saveInSlot(timeslice, input, slot);
+      mCachedStateMetrics[mDistinctRoutesIndex.size() * slot.index + input] = CacheEntryStatus::PENDING;
+      markRouteFilled(slot, input);
       index.publishSlot(slot);
       index.markAsDirty(slot, true);
+      beginWrite(slot);
+      lock.unlock();
+      saveInSlot(timeslice, input, slot);
+      endWrite(slot);
       return WillRelay;
   }
   O2_BUILTIN_UNREACHABLE();
@@ -593,7 +749,7 @@ DataRelayer::RelayChoice
 void DataRelayer::getReadyToProcess(std::vector<DataRelayer::RecordAction>& completed)
 {
   LOGP(debug, "DataRelayer::getReadyToProcess");
-  std::scoped_lock<LockableBase(std::recursive_mutex)> lock(mMutex);
+  std::scoped_lock<LockableBase(std::mutex)> lock(mMutex);
 
   // THE STATE
   const auto& cache = mCache;
@@ -645,14 +801,27 @@ void DataRelayer::getReadyToProcess(std::vector<DataRelayer::RecordAction>& comp
   int countProcess = 0;
   int countDiscard = 0;
   int countWait = 0;
-  int notDirty = 0;
-
-  for (int li = cacheLines - 1; li >= 0; --li) {
-    TimesliceSlot slot{(size_t)li};
-    // We only check the cachelines which have been updated by an incoming
-    // message.
-    if (mTimesliceIndex.isDirty(slot) == false) {
-      notDirty++;
+  int checked = 0;
+  int busy = 0;
+  int empty = 0;
+
+  // We only check the cachelines which have been updated by an incoming
+  // message, going from the last one to the first one.
+  for (auto slot = mTimesliceIndex.findDirtyBefore(cacheLines); TimesliceSlot::isValid(slot);
+       slot = mTimesliceIndex.findDirtyBefore(slot.index)) {
+    auto li = slot.index;
+    checked++;
+    // Someone is still moving messages in or out of the slot. We leave it
+    // dirty so that it gets checked again at the next iteration.
+    if (isSlotBusy(slot)) {
+      busy++;
+      continue;
+    }
+    // A slot without data and without an associated timeslice cannot
+    // result in any action, no need to ask the completion policy.
+    if (hasFilledRoutes(slot) == false && mTimesliceIndex.isValid(slot) == false) {
+      empty++;
+      mTimesliceIndex.markAsDirty(slot, false);
       continue;
     }
     auto partial = getPartialRecord(li);
@@ -722,14 +891,14 @@ void DataRelayer::getReadyToProcess(std::vector<DataRelayer::RecordAction>& comp
     }
   }
   mTimesliceIndex.updateOldestPossibleOutput();
-  LOGP(debug, "DataRelayer::getReadyToProcess results notDirty:{}, consume:{}, consumeExisting:{}, process:{}, discard:{}, wait:{}",
-       notDirty, countConsume, countConsumeExisting, countProcess,
+  LOGP(debug, "DataRelayer::getReadyToProcess results notDirty:{}, busy:{}, empty:{}, consume:{}, consumeExisting:{}, process:{}, discard:{}, wait:{}",
+       cacheLines - checked, busy, empty, countConsume, countConsumeExisting, countProcess,
        countDiscard, countWait);
 }
 
 void DataRelayer::updateCacheStatus(TimesliceSlot slot, CacheEntryStatus oldStatus, CacheEntryStatus newStatus)
 {
-  std::scoped_lock<LockableBase(std::recursive_mutex)> lock(mMutex);
+  std::scoped_lock<LockableBase(std::mutex)> lock(mMutex);
   const auto numInputTypes = mDistinctRoutesIndex.size();
 
   auto markInputDone = [&cachedStateMetrics = mCachedStateMetrics,
@@ -747,13 +916,22 @@ void DataRelayer::updateCacheStatus(TimesliceSlot slot, CacheEntryStatus oldStat
 
 std::vector<o2::framework::MessageSet> DataRelayer::consumeAllInputsForTimeslice(TimesliceSlot slot)
 {
-  std::scoped_lock<LockableBase(std::recursive_mutex)> lock(mMutex);
-
   const auto numInputTypes = mDistinctRoutesIndex.size();
   // State of the computation
   std::vector<MessageSet> messages(numInputTypes);
   auto& cache = mCache;
-  auto& index = mTimesliceIndex;
+
+  // Invalidating the slot while holding the lock guarantees that any further
+  // relay will consider it as a new slot and wait for us before pruning it.
+  {
+    std::scoped_lock<LockableBase(std::mutex)> lock(mMutex);
+    mTimesliceIndex.markAsInvalid(slot);
+    clearFilledRoutes(slot);
+    for (size_t ai = 0, ae = numInputTypes; ai != ae; ++ai) {
+      mCachedStateMetrics[slot.index * numInputTypes + ai] = CacheEntryStatus::RUNNING;
+    }
+    beginConsume(slot);
+  }
 
   // Nothing to see here, this is just to make the outer loop more understandable.
   auto jumpToCacheEntryAssociatedWith = [](TimesliceSlot) {
@@ -765,28 +943,24 @@ std::vector<o2::framework::MessageSet> DataRelayer::consumeAllInputsForTimeslice
   // This means we can still handle old messages if there is still space in the
   // cache where to put them.
   auto moveHeaderPayloadToOutput = [&messages,
-                                    &cachedStateMetrics = mCachedStateMetrics,
-                                    &cache, &index, &numInputTypes](TimesliceSlot s, size_t arg) {
+                                    &cache, &numInputTypes](TimesliceSlot s, size_t arg) {
     auto cacheId = s.index * numInputTypes + arg;
-    cachedStateMetrics[cacheId] = CacheEntryStatus::RUNNING;
     // TODO: in the original implementation of the cache, there have been only two messages per entry,
     // check if the 2 above corresponds to the number of messages.
     if (cache[cacheId].size() > 0) {
       messages[arg] = std::move(cache[cacheId]);
     }
-    index.markAsInvalid(s);
   };
 
   // An invalid set of arguments is a set of arguments associated to an invalid
   // timeslice, so I can simply do that. I keep the assertion there because in principle
   // we should have dispatched the timeslice already!
   // FIXME: what happens when we have enough timeslices to hit the invalid one?
-  auto invalidateCacheFor = [&numInputTypes, &index, &cache](TimesliceSlot s) {
+  auto invalidateCacheFor = [&numInputTypes, &cache](TimesliceSlot s) {
     for (size_t ai = s.index * numInputTypes, ae = ai + numInputTypes; ai != ae; ++ai) {
       assert(std::accumulate(cache[ai].messages.begin(), cache[ai].messages.end(), true, [](bool result, auto const& element) { return result && element.get() == nullptr; }));
       cache[ai].clear();
     }
-    index.markAsInvalid(s);
   };
 
   // Outer loop here.
@@ -795,20 +969,25 @@ std::vector<o2::framework::MessageSet> DataRelayer::consumeAllInputsForTimeslice
     moveHeaderPayloadToOutput(slot, ai);
   }
   invalidateCacheFor(slot);
+  endConsume(slot);
 
   return messages;
 }
 
 std::vector<o2::framework::MessageSet> DataRelayer::consumeExistingInputsForTimeslice(TimesliceSlot slot)
 {
-  std::scoped_lock<LockableBase(std::recursive_mutex)> lock(mMutex);
-
   const auto numInputTypes = mDistinctRoutesIndex.size();
   // State of the computation
   std::vector<MessageSet> messages(numInputTypes);
   auto& cache = mCache;
-  auto& index = mTimesliceIndex;
-  auto& metrics = mMetrics;
+
+  {
+    std::scoped_lock<LockableBase(std::mutex)> lock(mMutex);
+    for (size_t ai = 0, ae = numInputTypes; ai != ae; ++ai) {
+      mCachedStateMetrics[slot.index * numInputTypes + ai] = CacheEntryStatus::RUNNING;
+    }
+    beginConsume(slot);
+  }
 
   // Nothing to see here, this is just to make the outer loop more understandable.
   auto jumpToCacheEntryAssociatedWith = [](TimesliceSlot) {
@@ -820,10 +999,8 @@ std::vector<o2::framework::MessageSet> DataRelayer::consumeExistingInputsForTime
   // This means we can still handle old messages if there is still space in the
   // cache where to put them.
   auto copyHeaderPayloadToOutput = [&messages,
-                                    &cachedStateMetrics = mCachedStateMetrics,
-                                    &cache, &index, &numInputTypes, &metrics](TimesliceSlot s, size_t arg) {
+                                    &cache, &numInputTypes](TimesliceSlot s, size_t arg) {
     auto cacheId = s.index * numInputTypes + arg;
-    cachedStateMetrics[cacheId] = CacheEntryStatus::RUNNING;
     // TODO: in the original implementation of the cache, there have been only two messages per entry,
     // check if the 2 above corresponds to the number of messages.
     for (size_t pi = 0; pi < cache[cacheId].size(); pi++) {
@@ -839,22 +1016,33 @@ std::vector<o2::framework::MessageSet> DataRelayer::consumeExistingInputsForTime
   for (size_t ai = 0, ae = numInputTypes; ai != ae; ++ai) {
     copyHeaderPayloadToOutput(slot, ai);
   }
+  endConsume(slot);
 
   return std::move(messages);
 }
 
 void DataRelayer::clear()
 {
-  std::scoped_lock<LockableBase(std::recursive_mutex)> lock(mMutex);
+  std::scoped_lock<LockableBase(std::mutex)> lock(mMutex);
 
+  for (size_t s = 0; s < mTimesliceIndex.size(); ++s) {
+    waitForExclusive(TimesliceSlot{s});
+  }
   for (auto& cache : mCache) {
     cache.clear();
   }
+  std::fill(mFilledRoutes.begin(), mFilledRoutes.end(), 0);
   for (size_t s = 0; s < mTimesliceIndex.size(); ++s) {
     mTimesliceIndex.markAsInvalid(TimesliceSlot{s});
   }
 }
 
+void DataRelayer::rescan()
+{
+  std::scoped_lock<LockableBase(std::mutex)> lock(mMutex);
+  mTimesliceIndex.rescan();
+}
+
 size_t
   DataRelayer::getParallelTimeslices() const
 {
@@ -867,22 +1055,34 @@ size_t
 /// the time pipelining.
 void DataRelayer::setPipelineLength(size_t s)
 {
-  std::scoped_lock<LockableBase(std::recursive_mutex)> lock(mMutex);
+  std::scoped_lock<LockableBase(std::mutex)> lock(mMutex);
 
   mTimesliceIndex.resize(s);
   mVariableContextes.resize(s);
-  publishMetrics();
+  // Resizing is only allowed while nobody is relaying, so we can
+  // simply reset the state of all the slots.
+  mSlotStates = std::make_unique<SlotState[]>(s);
+  mFilledRoutesWords = (mDistinctRoutesIndex.size() + 63) / 64;
+  mFilledRoutes.resize(s * mFilledRoutesWords, 0);
+  doPublishMetrics();
 }
 
 void DataRelayer::publishMetrics()
 {
-  std::scoped_lock<LockableBase(std::recursive_mutex)> lock(mMutex);
+  std::scoped_lock<LockableBase(std::mutex)> lock(mMutex);
+  doPublishMetrics();
+}
 
+void DataRelayer::doPublishMetrics()
+{
   auto numInputTypes = mDistinctRoutesIndex.size();
   // FIXME: many of the DataRelayer function rely on allocated cache, so its
   // maybe misleading to have the allocation in a function primarily for
   // metrics publishing, do better in setPipelineLength?
-  mCache.resize(numInputTypes * mTimesliceIndex.size());
+  if (mCache.size() != numInputTypes * mTimesliceIndex.size()) {
+    mCache.resize(numInputTypes * mTimesliceIndex.size());
+    mCacheMutexes = std::make_unique<std::mutex[]>(mCache.size());
+  }
   mMetrics.send({(int)numInputTypes, "data_relayer/h", Verbosity::Debug});
   mMetrics.send({(int)mTimesliceIndex.size(), "data_relayer/w", Verbosity::Debug});
   sMetricsNames.resize(mCache.size());
@@ -918,31 +1118,31 @@ DataRelayerStats const& DataRelayer::getStats() const
 
 uint32_t DataRelayer::getFirstTFOrbitForSlot(TimesliceSlot slot)
 {
-  std::scoped_lock<LockableBase(std::recursive_mutex)> lock(mMutex);
+  std::scoped_lock<LockableBase(std::mutex)> lock(mMutex);
   return VariableContextHelpers::getFirstTFOrbit(mTimesliceIndex.getVariablesForSlot(slot));
 }
 
 uint32_t DataRelayer::getFirstTFCounterForSlot(TimesliceSlot slot)
 {
-  std::scoped_lock<LockableBase(std::recursive_mutex)> lock(mMutex);
+  std::scoped_lock<LockableBase(std::mutex)> lock(mMutex);
   return VariableContextHelpers::getFirstTFCounter(mTimesliceIndex.getVariablesForSlot(slot));
 }
 
 uint32_t DataRelayer::getRunNumberForSlot(TimesliceSlot slot)
 {
-  std::scoped_lock<LockableBase(std::recursive_mutex)> lock(mMutex);
+  std::scoped_lock<LockableBase(std::mutex)> lock(mMutex);
   return VariableContextHelpers::getRunNumber(mTimesliceIndex.getVariablesForSlot(slot));
 }
 
 uint64_t DataRelayer::getCreationTimeForSlot(TimesliceSlot slot)
 {
-  std::scoped_lock<LockableBase(std::recursive_mutex)> lock(mMutex);
+  std::scoped_lock<LockableBase(std::mutex)> lock(mMutex);
   return VariableContextHelpers::getCreationTime(mTimesliceIndex.getVariablesForSlot(slot));
 }
 
 void DataRelayer::sendContextState()
 {
-  std::scoped_lock<LockableBase(std::recursive_mutex)> lock(mMutex);
+  std::scoped_lock<LockableBase(std::mutex)> lock(mMutex);
   for (size_t ci = 0; ci < mTimesliceIndex.size(); ++ci) {
     auto slot = TimesliceSlot{ci};
     sendVariableContextMetrics(mTimesliceIndex.getPublishedVariablesForSlot(slot), slot,
@@ -19,8 +19,13 @@
 #include <stack>
 #include <iostream>
 #include <unordered_map>
+#include <list>
+#include <string_view>
+#include <cstdlib>
 #include <set>
 #include <algorithm>
+#include <chrono>
+#include <mutex>
 
 using namespace o2::framework;
 
@@ -376,43 +381,160 @@ gandiva::ExpressionPtr makeExpression(gandiva::NodePtr node, gandiva::FieldPtr r
   return gandiva::TreeExprBuilder::MakeExpression(std::move(node), std::move(result));
 }
 
+namespace
+{
+/// Cache of the compiled filters and projectors, keyed by the schema and the expressions, so that
+/// the LLVM code of an expression is generated only once per process, and not for each dataframe
+/// (e.g. for Spawns) or each user of the same expression.
+/// The key uses the string representation of the expressions, as the internal cache of gandiva does.
+/// As the literals are part of it, the number of entries is bounded and the least recently used ones
+/// are evicted. The size can be set with DPL_EXPRESSION_CACHE_SIZE or setExpressionCacheSize.
+class ExpressionCache
+{
+ public:
+  static ExpressionCache& instance()
+  {
+    static ExpressionCache cache;
+    return cache;
+  }
+
+  std::shared_ptr<gandiva::Filter> getFilter(gandiva::SchemaPtr const& schema, gandiva::ConditionPtr const& condition)
+  {
+    return get(mFilters, "filter\n" + schema->ToString() + "\n" + condition->ToString(), [&]() {
+      std::shared_ptr<gandiva::Filter> filter;
+      auto s = gandiva::Filter::Make(schema, condition, &filter);
+      if (!s.ok()) {
+        throw runtime_error_f("Failed to create filter: %s", s.ToString().c_str());
+      }
+      return filter;
+    });
+  }
+
+  std::shared_ptr<gandiva::Projector> getProjector(gandiva::SchemaPtr const& schema, std::vector<gandiva::ExpressionPtr> const& expressions)
+  {
+    std::string key = "projector\n" + schema->ToString();
+    for (auto const& expression : expressions) {
+      key += "\n" + expression->result()->ToString() + " = " + expression->ToString();
+    }
+    return get(mProjectors, key, [&]() {
+      std::shared_ptr<gandiva::Projector> projector;
+      auto s = gandiva::Projector::Make(schema, expressions, &projector);
+      if (!s.ok()) {
+        throw runtime_error_f("Failed to create projector: %s", s.ToString().c_str());
+      }
+      return projector;
+    });
+  }
+
+  ExpressionCacheStats getStats()
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mStats.size = mFilters.entries.size() + mProjectors.entries.size();
+    return mStats;
+  }
+
+  void setMaxSize(size_t maxSize)
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mMaxSize = maxSize;
+    shrink(mFilters, mMaxSize);
+    shrink(mProjectors, mMaxSize);
+  }
+
+ private:
+  ExpressionCache()
+  {
+    if (char const* size = getenv("DPL_EXPRESSION_CACHE_SIZE")) {
+      mMaxSize = std::stoul(size);
+    }
+  }
+
+  /// Entries in the order of use, the most recent first
+  template <typename T>
+  struct LRU {
+    using Entries = std::list<std::pair<std::string, std::shared_ptr<T>>>;
+    Entries entries;
+    std::unordered_map<std::string_view, typename Entries::iterator> index; // views of the keys in the entries
+  };
+
+  template <typename T>
+  void shrink(LRU<T>& cache, size_t maxSize)
+  {
+    while (cache.entries.size() > maxSize) {
+      cache.index.erase(cache.entries.back().first);
+      cache.entries.pop_back();
+      ++mStats.evictions;
+    }
+  }
+
+  template <typename T, typename F>
+  std::shared_ptr<T> get(LRU<T>& cache, std::string const& key, F&& make)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+      auto entry = cache.index.find(key);
+      if (entry != cache.index.end()) {
+        ++mStats.hits;
+        cache.entries.splice(cache.entries.begin(), cache.entries, entry->second);
+        return entry->second->second;
+      }
+    }
+    // The lock is not held while building, so that other expressions are served meanwhile. If several
+    // threads miss the same expression at the same time, each builds it and the first one is kept.
+    auto start = std::chrono::steady_clock::now();
+    auto object = make();
+    auto buildTimeUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    ++mStats.misses;
+    mStats.buildTimeUs += buildTimeUs;
+    auto entry = cache.index.find(key);
+    if (entry != cache.index.end()) {
+      return entry->second->second;
+    }
+    if (mMaxSize == 0) {
+      return object;
+    }
+    cache.entries.emplace_front(key, object);
+    cache.index.emplace(cache.entries.front().first, cache.entries.begin());
+    shrink(cache, mMaxSize);
+    return object;
+  }
+
+  std::mutex mMutex;
+  size_t mMaxSize = 256; // per kind of object
+  LRU<gandiva::Filter> mFilters;
+  LRU<gandiva::Projector> mProjectors;
+  ExpressionCacheStats mStats;
+};
+} // namespace
+
+ExpressionCacheStats getExpressionCacheStats()
+{
+  return ExpressionCache::instance().getStats();
+}
+
+void setExpressionCacheSize(size_t size)
+{
+  ExpressionCache::instance().setMaxSize(size);
+}
+
 std::shared_ptr<gandiva::Filter>
   createFilter(gandiva::SchemaPtr const& Schema, Operations const& opSpecs)
 {
-  std::shared_ptr<gandiva::Filter> filter;
-  auto s = gandiva::Filter::Make(Schema,
-                                 makeCondition(createExpressionTree(opSpecs, Schema)),
-                                 &filter);
-  if (!s.ok()) {
-    throw runtime_error_f("Failed to create filter: %s", s.ToString().c_str());
-  }
-  return filter;
+  return createFilter(Schema, makeCondition(createExpressionTree(opSpecs, Schema)));
 }
 
 std::shared_ptr<gandiva::Filter>
   createFilter(gandiva::SchemaPtr const& Schema, gandiva::ConditionPtr condition)
 {
-  std::shared_ptr<gandiva::Filter> filter;
-  auto s = gandiva::Filter::Make(Schema,
-                                 std::move(condition),
-                                 &filter);
-  if (!s.ok()) {
-    throw runtime_error_f("Failed to create filter: %s", s.ToString().c_str());
-  }
-  return filter;
+  return ExpressionCache::instance().getFilter(Schema, condition);
 }
 
 std::shared_ptr<gandiva::Projector>
   createProjector(gandiva::SchemaPtr const& Schema, Operations const& opSpecs, gandiva::FieldPtr result)
 {
-  std::shared_ptr<gandiva::Projector> projector;
-  auto s = gandiva::Projector::Make(Schema,
-                                    {makeExpression(createExpressionTree(opSpecs, Schema), std::move(result))},
-                                    &projector);
-  if (!s.ok()) {
-    throw runtime_error_f("Failed to create projector: %s", s.ToString().c_str());
-  }
-  return projector;
+  return ExpressionCache::instance().getProjector(Schema, {makeExpression(createExpressionTree(opSpecs, Schema), std::move(result))});
 }
 
 std::shared_ptr<gandiva::Projector>
@@ -436,16 +558,7 @@ std::shared_ptr<gandiva::Projector> createProjectorHelper(size_t nColumns, expre
         fields[ci]));
   }
 
-  std::shared_ptr<gandiva::Projector> projector;
-  auto s = gandiva::Projector::Make(
-    schema,
-    expressions,
-    &projector);
-  if (s.ok()) {
-    return projector;
-  } else {
-    throw o2::framework::runtime_error_f("Failed to create projector: %s", s.ToString().c_str());
-  }
+  return ExpressionCache::instance().getProjector(schema, expressions);
 }
 
 gandiva::Selection createSelection(std::shared_ptr<arrow::Table> const& table, std::shared_ptr<gandiva::Filter> const& gfilter)
@@ -12,6 +12,7 @@
 #include "Framework/HistogramRegistry.h"
 #include <regex>
 #include <TList.h>
+#include <TClass.h>
 
 namespace o2::framework
 {
@@ -117,6 +118,7 @@ HistPtr HistogramRegistry::add(char const* const name, char const* const title,
 // store a copy of an existing histogram (or group of histograms) under a different name
 void HistogramRegistry::addClone(const std::string& source, const std::string& target)
 {
+  flush();
   auto doInsertClone = [&](const auto& sharedPtr) {
     if (!sharedPtr.get()) {
       return;
@@ -268,6 +270,7 @@ void HistogramRegistry::print(bool showAxisDetails)
 // create output structure will be propagated to file-sink
 TList* HistogramRegistry::operator*()
 {
+  flush();
   TList* list = new TList();
   list->SetName(mName.data());
 
@@ -324,6 +327,37 @@ TList* HistogramRegistry::operator*()
   return list;
 }
 
+void HistogramRegistry::setFillBufferSize(uint32_t nEntries)
+{
+  flush();
+  mFillBufferSize = nEntries;
+  mFillBuffers.clear();
+  if (nEntries) {
+    mFillBuffers.resize(MAX_REGISTRY_SIZE);
+  }
+}
+
+void HistogramRegistry::flush()
+{
+  for (auto idx = 0u; idx < mFillBuffers.size(); ++idx) {
+    flushBuffer(idx);
+  }
+}
+
+void HistogramRegistry::flushBuffer(uint32_t idx)
+{
+  auto& buffer = mFillBuffers[idx];
+  if (buffer.nEntries == 0) {
+    return;
+  }
+  std::vector<double const*> columns(buffer.nColumns);
+  for (int i = 0; i < buffer.nColumns; ++i) {
+    columns[i] = buffer.values.data() + i * mFillBufferSize;
+  }
+  std::visit([&](auto&& hist) { HistFiller::fillHistBulk(hist, columns.data(), buffer.nColumns, buffer.nEntries); }, mRegistryValue[idx]);
+  buffer.nEntries = 0;
+}
+
 // helper function to create resp. find the subList defined by path
 TList* HistogramRegistry::getSubList(TList* list, std::deque<std::string>& path)
 {
@@ -392,4 +426,142 @@ void HistogramRegistry::registerName(const std::string& name)
   mRegisteredNames.push_back(name);
 }
 
+namespace
+{
+// bins of x on a uniform axis, with the same arithmetic as TAxis::FindBin so that the same bins are found.
+// The position is computed for all entries and under- and overflows are selected afterwards, which lets
+// the compiler vectorise the loop (with branches as in FindBin it does not, since the division could trap)
+void findUniformBins(TAxis const* axis, double const* x, int* bins, size_t n)
+{
+  const int nBins = axis->GetNbins();
+  const double xMin = axis->GetXmin();
+  const double xMax = axis->GetXmax();
+  for (size_t i = 0; i < n; ++i) {
+    double pos = nBins * (x[i] - xMin) / (xMax - xMin);
+    pos = (pos < nBins) ? pos : nBins;
+    pos = (x[i] < xMax) ? pos : nBins; // overflow, also for NaN
+    pos = (x[i] < xMin) ? -1. : pos;   // underflow
+    bins[i] = 1 + int(pos);
+  }
+}
+
+// TH1::GetStatOverflowsBehaviour is protected
+struct StatOverflows : TH1 {
+  static bool consider(TH1 const* hist) { return (hist->*(&StatOverflows::GetStatOverflowsBehaviour))(); }
+};
+
+template <typename A>
+bool fillBins(TH1* hist, TAxis* const* axes, int nDim, double const* const* x, double const* w, size_t n)
+{
+  auto array = dynamic_cast<A*>(hist);
+  if (!array) {
+    return false;
+  }
+  auto* content = array->GetArray();
+  double* sumw2 = hist->GetSumw2N() ? hist->GetSumw2()->GetArray() : nullptr;
+  const bool statOverflows = StatOverflows::consider(hist);
+
+  // sums of weights needed for the statistics, in the order of TH1::GetStats
+  // w, w2, wx, wx2 (TH1), wy, wy2, wxy (TH2), wz, wz2, wxz, wyz (TH3)
+  double stats[TH1::kNstat]{};
+  hist->GetStats(stats);
+
+  constexpr size_t BlockSize = 256;
+  int axisBins[3][BlockSize];
+  int bins[BlockSize];
+  for (size_t begin = 0; begin < n; begin += BlockSize) {
+    const size_t size = std::min(BlockSize, n - begin);
+    for (int d = 0; d < nDim; ++d) {
+      findUniformBins(axes[d], x[d] + begin, axisBins[d], size);
+    }
+    for (size_t i = 0; i < size; ++i) {
+      bins[i] = axisBins[0][i];
+    }
+    for (int d = 1; d < nDim; ++d) {
+      int stride = 1;
+      for (int k = 0; k < d; ++k) {
+        stride *= axes[k]->GetNbins() + 2;
+      }
+      for (size_t i = 0; i < size; ++i) {
+        bins[i] += stride * axisBins[d][i];
+      }
+    }
+
+    for (size_t i = 0; i < size; ++i) {
+      const double weight = w ? w[begin + i] : 1.;
+      content[bins[i]] += static_cast<std::remove_pointer_t<decltype(content)>>(weight); // as in TH1F::AddBinContent
+      if (sumw2) {
+        sumw2[bins[i]] += weight * weight;
+      }
+    }
+
+    // as in TH1::Fill the entries in under- and overflow bins are not considered for the statistics by default
+    for (size_t i = 0; i < size; ++i) {
+      bool inRange = true;
+      for (int d = 0; d < nDim; ++d) {
+        inRange &= (axisBins[d][i] > 0 && axisBins[d][i] <= axes[d]->GetNbins());
+      }
+      if (!inRange && !statOverflows) {
+        continue;
+      }
+      const double weight = w ? w[begin + i] : 1.;
+      const double xi = x[0][begin + i];
+      stats[0] += weight;
+      stats[1] += weight * weight;
+      stats[2] += weight * xi;
+      stats[3] += weight * xi * xi;
+      if (nDim > 1) {
+        const double yi = x[1][begin + i];
+        stats[4] += weight * yi;
+        stats[5] += weight * yi * yi;
+        stats[6] += weight * xi * yi;
+        if (nDim > 2) {
+          const double zi = x[2][begin + i];
+          stats[7] += weight * zi;
+          stats[8] += weight * zi * zi;
+          stats[9] += weight * xi * zi;
+          stats[10] += weight * yi * zi;
+        }
+      }
+    }
+  }
+  hist->PutStats(stats);
+  hist->SetEntries(hist->GetEntries() + n);
+  return true;
+}
+} // namespace
+
+void HistFiller::fillBinnedBulk(TH1* hist, int nDim, double const* const* x, double const* w, size_t n)
+{
+  TAxis* axes[3] = {hist->GetXaxis(), hist->GetYaxis(), hist->GetZaxis()};
+
+  // the bins are computed here only for plain histograms with uniform axes which cannot be extended,
+  // for which the statistics are not restricted to a range of the axes
+  bool bulkBins = (hist->IsA() == TH1F::Class() || hist->IsA() == TH1D::Class() || hist->IsA() == TH2F::Class() || hist->IsA() == TH2D::Class() || hist->IsA() == TH3F::Class() || hist->IsA() == TH3D::Class()) && !hist->GetBuffer();
+  for (int d = 0; d < nDim; ++d) {
+    bulkBins &= (axes[d]->GetXbins()->GetSize() == 0 && !axes[d]->CanExtend() && !axes[d]->TestBit(TAxis::kAxisRange));
+  }
+
+  if (bulkBins) {
+    // as in TH1::Fill the sum of squares of the weights is stored as soon as a weight is not 1
+    if (w && !hist->GetSumw2N() && !hist->TestBit(TH1::kIsNotW) && std::any_of(w, w + n, [](double weight) { return weight != 1.; })) {
+      hist->Sumw2();
+    }
+    if (fillBins<TArrayF>(hist, axes, nDim, x, w, n) || fillBins<TArrayD>(hist, axes, nDim, x, w, n)) {
+      return;
+    }
+  }
+
+  if (nDim == 1) {
+    hist->FillN(static_cast<int>(n), x[0], w);
+  } else if (nDim == 2) {
+    hist->FillN(static_cast<int>(n), x[0], x[1], w);
+  } else {
+    auto hist3D = static_cast<TH3*>(hist);
+    for (size_t i = 0; i < n; ++i) {
+      w ? hist3D->Fill(x[0][i], x[1][i], x[2][i], w[i]) : hist3D->Fill(x[0][i], x[1][i], x[2][i]);
+    }
+  }
+}
+
 } // namespace o2::framework
@@ -21,6 +21,7 @@
 #include <arrow/util/variant.h>
 #include <arrow/util/config.h>
 
+#include <algorithm>
 #include <string>
 
 namespace o2::framework
@@ -42,6 +43,46 @@ arrow::Status getSlices(
   return arrow::Status::OK();
 }
 
+arrow::Status getSliceInfo(
+  const char* key,
+  std::shared_ptr<arrow::Table> const& input,
+  SliceInfo& info)
+{
+  std::shared_ptr<arrow::NumericArray<arrow::Int32Type>> values;
+  std::shared_ptr<arrow::NumericArray<arrow::Int64Type>> counts;
+  ARROW_RETURN_NOT_OK(getSlices(key, input, values, counts));
+
+  // the groups are in the order of appearance, as for the offsets accumulated by getSliceFor.
+  // The values are stored densely unless they are too sparse for it
+  int64_t maxValue = -1;
+  for (auto slice = 0; slice < values->length(); ++slice) {
+    if (values->IsValid(slice)) {
+      maxValue = std::max(maxValue, (int64_t)values->Value(slice));
+    }
+  }
+  const int64_t denseSize = maxValue < 4 * values->length() + 1024 ? maxValue + 1 : 0;
+  info.offsets.assign(denseSize, -1);
+  info.sizes.assign(denseSize, 0);
+  info.sparse.clear();
+  int64_t offset = 0;
+  for (auto slice = 0; slice < values->length(); ++slice) {
+    const auto count = counts->Value(slice);
+    if (values->IsValid(slice)) {
+      const auto value = values->Value(slice);
+      if (value >= 0 && value < denseSize) {
+        info.offsets[value] = offset;
+        info.sizes[value] = count;
+      } else {
+        info.sparse.push_back({value, offset, count});
+      }
+    }
+    offset += count;
+  }
+  std::sort(info.sparse.begin(), info.sparse.end(), [](auto const& a, auto const& b) { return a[0] < b[0]; });
+  info.nRows = offset;
+  return arrow::Status::OK();
+}
+
 arrow::Status getSliceFor(
   int value,
   char const* key,
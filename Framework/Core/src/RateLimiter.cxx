@@ -13,11 +13,59 @@
 #include "Framework/RawDeviceService.h"
 #include "Framework/ServiceRegistry.h"
 #include "Framework/RunningWorkflowInfo.h"
+#include "Framework/Monitoring.h"
 #include <fairmq/Device.h>
 #include <fairmq/shmem/Monitor.h>
 #include <fairmq/shmem/Common.h>
+#include <algorithm>
+#include <chrono>
+#include <thread>
 
 using namespace o2::framework;
+using o2::monitoring::Monitoring;
+using Metric = o2::monitoring::Metric;
+using Key = o2::monitoring::tags::Key;
+using Value = o2::monitoring::tags::Value;
+
+bool RateLimiter::receiveFeedback(fair::mq::Device* device, int timeoutMs)
+{
+  bool received = false;
+  // Only the first receive is allowed to block, afterwards we simply
+  // drain whatever is already queued so that we always use the latest value.
+  int timeout = timeoutMs;
+  while (true) {
+    auto msg = device->NewMessageFor("metric-feedback", 0, 0);
+    auto count = device->Receive(msg, "metric-feedback", 0, timeout);
+    if (count <= 0) {
+      break;
+    }
+    assert(msg->GetSize() == 8);
+    mConsumedTimeframes = *(int64_t*)msg->GetData();
+    received = true;
+    timeout = 0;
+  }
+  return received;
+}
+
+uint64_t RateLimiter::freeSHM(ProcessingContext& ctx, fair::mq::Device* device)
+{
+  auto& runningWorkflow = ctx.services().get<RunningWorkflowInfo const>();
+  long freeMemory = -1;
+  try {
+    freeMemory = fair::mq::shmem::Monitor::GetFreeMemory(fair::mq::shmem::ShmId{fair::mq::shmem::makeShmIdStr(device->fConfig->GetProperty<uint64_t>("shmid"))}, runningWorkflow.shmSegmentId);
+  } catch (...) {
+  }
+  if (freeMemory == -1) {
+    try {
+      freeMemory = fair::mq::shmem::Monitor::GetFreeMemory(fair::mq::shmem::SessionId{device->fConfig->GetProperty<std::string>("session")}, runningWorkflow.shmSegmentId);
+    } catch (...) {
+    }
+  }
+  if (freeMemory == -1) {
+    throw std::runtime_error("Could not obtain free SHM memory");
+  }
+  return freeMemory;
+}
 
 void RateLimiter::check(ProcessingContext& ctx, int maxInFlight, size_t minSHM)
 {
@@ -25,58 +73,71 @@ void RateLimiter::check(ProcessingContext& ctx, int maxInFlight, size_t minSHM)
     return;
   }
   auto device = ctx.services().get<RawDeviceService>().device();
-  if (maxInFlight && device->fChannels.count("metric-feedback")) {
-    int waitMessage = 0;
-    int recvTimeot = 0;
-    while ((mSentTimeframes - mConsumedTimeframes) >= maxInFlight) {
-      if (recvTimeot == -1 && waitMessage == 0) {
-        LOG(alarm) << "Maximum number of TF in flight reached (" << maxInFlight << ": published " << mSentTimeframes << " - finished " << mConsumedTimeframes << "), waiting";
-        waitMessage = 1;
-      }
-      auto msg = device->NewMessageFor("metric-feedback", 0, 0);
+  bool hasFeedback = maxInFlight && device->fChannels.count("metric-feedback");
+  if (hasFeedback) {
+    receiveFeedback(device, 0);
+  }
 
-      auto count = device->Receive(msg, "metric-feedback", 0, recvTimeot);
-      if (count <= 0) {
-        recvTimeot = -1;
-        continue;
-      }
-      assert(msg->GetSize() == 8);
-      mConsumedTimeframes = *(int64_t*)msg->GetData();
-    }
-    if (waitMessage) {
-      LOG(important) << (mSentTimeframes - mConsumedTimeframes) << " / " << maxInFlight << " TF in flight, continuing to publish";
+  auto tfLimitReached = [&](int64_t margin) {
+    return hasFeedback && (mSentTimeframes - mConsumedTimeframes) + margin >= maxInFlight;
+  };
+  auto shmLimitReached = [&](uint64_t margin, uint64_t& free) {
+    if (!minSHM) {
+      return false;
     }
+    free = freeSHM(ctx, device);
+    return free <= minSHM + margin;
+  };
+
+  uint64_t free = 0;
+  if (!tfLimitReached(0) && !shmLimitReached(0, free)) {
+    mSentTimeframes++;
+    return;
   }
-  if (minSHM) {
-    int waitMessage = 0;
-    auto& runningWorkflow = ctx.services().get<RunningWorkflowInfo const>();
-    while (true) {
-      long freeMemory = -1;
-      try {
-        freeMemory = fair::mq::shmem::Monitor::GetFreeMemory(fair::mq::shmem::ShmId{fair::mq::shmem::makeShmIdStr(device->fConfig->GetProperty<uint64_t>("shmid"))}, runningWorkflow.shmSegmentId);
-      } catch (...) {
-      }
-      if (freeMemory == -1) {
-        try {
-          freeMemory = fair::mq::shmem::Monitor::GetFreeMemory(fair::mq::shmem::SessionId{device->fConfig->GetProperty<std::string>("session")}, runningWorkflow.shmSegmentId);
-        } catch (...) {
-        }
-      }
-      if (freeMemory == -1) {
-        throw std::runtime_error("Could not obtain free SHM memory");
-      }
-      uint64_t freeSHM = freeMemory;
-      if (freeSHM > minSHM) {
-        if (waitMessage) {
-          LOG(important) << "Sufficient SHM memory free (" << freeSHM << " >= " << minSHM << "), continuing to publish";
-        }
-        break;
-      }
-      if (waitMessage == 0) {
-        LOG(alarm) << "Free SHM memory too low: " << freeSHM << " < " << minSHM << ", waiting";
-        waitMessage = 1;
-      }
+
+  // From now on we wait until both limits are satisfied including the hysteresis margin.
+  auto tfMargin = (int64_t)(maxInFlight * InFlightHysteresis);
+  auto shmMargin = (uint64_t)(minSHM * SHMHysteresis);
+  auto start = std::chrono::steady_clock::now();
+  int backoff = MinBackoffMs;
+  bool waitTFMessage = false;
+  bool waitSHMMessage = false;
+  while (true) {
+    bool waitTF = tfLimitReached(tfMargin);
+    bool waitSHM = !waitTF && shmLimitReached(shmMargin, free);
+    if (!waitTF && !waitSHM) {
+      break;
+    }
+    if (waitTF && !waitTFMessage) {
+      LOG(alarm) << "Maximum number of TF in flight reached (" << maxInFlight << ": published " << mSentTimeframes << " - finished " << mConsumedTimeframes << "), waiting";
+      waitTFMessage = true;
     }
+    if (waitSHM && !waitSHMMessage) {
+      LOG(alarm) << "Free SHM memory too low: " << free << " < " << minSHM + shmMargin << ", waiting";
+      waitSHMMessage = true;
+    }
+    // A finished timeframe is likely to free shared memory as well, so
+    // we use the feedback channel as a wake up notification in both cases
+    // and fall back to a plain sleep when there is no such channel.
+    if (hasFeedback && receiveFeedback(device, waitTF ? MaxBackoffMs : backoff)) {
+      backoff = MinBackoffMs;
+      continue;
+    }
+    if (!hasFeedback) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(backoff));
+    }
+    backoff = std::min(backoff * 2, MaxBackoffMs);
+  }
+  auto waitMs = (uint64_t)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+  mTotalWaitMs += waitMs;
+  if (waitTFMessage) {
+    LOG(important) << (mSentTimeframes - mConsumedTimeframes) << " / " << maxInFlight << " TF in flight, continuing to publish";
+  }
+  if (waitSHMMessage) {
+    LOG(important) << "Sufficient SHM memory free (" << free << " > " << minSHM + shmMargin << "), continuing to publish";
   }
+  auto& monitoring = ctx.services().get<Monitoring>();
+  monitoring.send(Metric{waitMs, "rate-limiter-wait-ms"}.addTag(Key::Subsystem, Value::DPL));
+  monitoring.send(Metric{mTotalWaitMs, "rate-limiter-total-wait-ms"}.addTag(Key::Subsystem, Value::DPL));
   mSentTimeframes++;
 }
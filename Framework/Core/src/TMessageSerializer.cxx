@@ -10,7 +10,10 @@
 // or submit itself to any jurisdiction.
 #include <Framework/TMessageSerializer.h>
 #include <algorithm>
+#include <cstring>
 #include <memory>
+#include <unordered_map>
+#include <utility>
 
 using namespace o2::framework;
 
@@ -102,3 +105,66 @@ void TMessageSerializer::updateStreamers(const TObject* object)
   FairTMessage msg(kMESS_OBJECT);
   serialize(msg, object, CacheStreamers::yes, CompressionLevel{0});
 }
+
+namespace
+{
+// The message backing the FairTMessage written on this thread. The reallocation
+// function of TBuffer gets no user data, so that it has to find it here.
+struct MessageBuffer {
+  TMessageSerializer::MessageCreator const* creator = nullptr;
+  fair::mq::MessagePtr message;
+};
+thread_local MessageBuffer* currentMessageBuffer = nullptr;
+
+char* reallocMessage(char* current, size_t newSize, size_t oldSize)
+{
+  auto message = (*currentMessageBuffer->creator)(newSize);
+  if (current != nullptr) {
+    std::memcpy(message->GetData(), current, std::min(oldSize, newSize));
+  }
+  currentMessageBuffer->message = std::move(message);
+  return static_cast<char*>(currentMessageBuffer->message->GetData());
+}
+
+// size of the last message of each class, used as initial size of the next one
+std::unordered_map<TClass const*, size_t> sizeHints;
+std::mutex sizeHintsLock;
+} // namespace
+
+fair::mq::MessagePtr TMessageSerializer::serializeToMessage(MessageCreator const& creator, const void* input, const TClass* cl,
+                                                            CacheStreamers streamers, CompressionLevel compressionLevel)
+{
+  size_t initialSize = 4096;
+  {
+    std::lock_guard<std::mutex> lock{sizeHintsLock};
+    auto hint = sizeHints.find(cl);
+    if (hint != sizeHints.end()) {
+      initialSize = hint->second;
+    }
+  }
+
+  MessageBuffer buffer{&creator, creator(initialSize)};
+  auto previous = std::exchange(currentMessageBuffer, &buffer);
+  auto restore = gsl::finally([previous]() { currentMessageBuffer = previous; });
+
+  FairTMessage tm(buffer.message->GetData(), buffer.message->GetSize(), reallocMessage);
+  if (streamers == CacheStreamers::yes) {
+    tm.EnableSchemaEvolution(true);
+  }
+  if (compressionLevel >= 0) {
+    tm.SetCompressionLevel(compressionLevel);
+  }
+  tm.WriteObjectAny(input, cl);
+  if (streamers == CacheStreamers::yes) {
+    updateStreamers(tm, sStreamers);
+  }
+
+  size_t length = tm.Length();
+  buffer.message->SetUsedSize(length);
+  {
+    // leave some room for objects which grow slowly, e.g. containers
+    std::lock_guard<std::mutex> lock{sizeHintsLock};
+    sizeHints[cl] = length + length / 8 + 64;
+  }
+  return std::move(buffer.message);
+}
@@ -15,7 +15,16 @@
 #include "arrow/type_traits.h"
 #include <arrow/util/key_value_metadata.h>
 #include <TBufferFile.h>
-
+#include <TROOT.h>
+#ifdef R__USE_IMT
+#include <ROOT/TParBranchProcessingRAII.hxx>
+#include <ROOT/TSeq.hxx>
+#include <ROOT/TThreadExecutor.hxx>
+#endif
+
+#include <atomic>
+#include <mutex>
+#include <numeric>
 #include <utility>
 namespace TableTreeHelpers
 {
@@ -214,16 +223,6 @@ std::pair<std::shared_ptr<arrow::ChunkedArray>, std::shared_ptr<arrow::Field>> B
     }
   } else {
     // other types: use serialized read to build arrays directly
-    auto&& result = arrow::AllocateResizableBuffer(mBranch->GetTotBytes(), mPool);
-    if (!result.ok()) {
-      throw runtime_error("Cannot allocate values buffer");
-    }
-    std::shared_ptr<arrow::Buffer> arrowValuesBuffer = std::move(result).ValueUnsafe();
-    auto ptr = arrowValuesBuffer->mutable_data();
-    if (ptr == nullptr) {
-      throw runtime_error("Invalid buffer");
-    }
-
     auto typeSize = TDataType::GetDataType(mType)->Size();
     std::unique_ptr<TBufferFile> offsetBuffer = nullptr;
 
@@ -237,7 +236,7 @@ std::pair<std::shared_ptr<arrow::ChunkedArray>, std::shared_ptr<arrow::Field>> B
     if (mVLA) {
       mSizeBranch = mBranch->GetTree()->GetBranch((std::string{mBranch->GetName()} + TableTreeHelpers::sizeBranchSuffix).c_str());
       offsetBuffer = std::make_unique<TBufferFile>(TBuffer::EMode::kWrite, 4 * 1024 * 1024);
-      result = arrow::AllocateResizableBuffer((totalEntries + 1) * (int64_t)sizeof(int), mPool);
+      auto&& result = arrow::AllocateBuffer((totalEntries + 1) * (int64_t)sizeof(int), mPool);
       if (!result.ok()) {
         throw runtime_error("Cannot allocate offset buffer");
       }
@@ -258,6 +257,20 @@ std::pair<std::shared_ptr<arrow::ChunkedArray>, std::shared_ptr<arrow::Field>> B
       offsets[count] = (int)offset;
       totalSize = offset;
       readEntries = 0;
+    } else {
+      totalSize = totalEntries * mListSize;
+    }
+
+    // the values are swapped from the baskets straight into a buffer of the
+    // final size, so that it is allocated only once
+    auto&& result = arrow::AllocateBuffer((int64_t)totalSize * typeSize, mPool);
+    if (!result.ok()) {
+      throw runtime_error("Cannot allocate values buffer");
+    }
+    std::shared_ptr<arrow::Buffer> arrowValuesBuffer = std::move(result).ValueUnsafe();
+    auto ptr = arrowValuesBuffer->mutable_data();
+    if (ptr == nullptr) {
+      throw runtime_error("Invalid buffer");
     }
 
     while (readEntries < totalEntries) {
@@ -522,14 +535,32 @@ void TreeToTable::addAllColumns(TTree* tree, std::vector<std::string>&& names)
   if (mBranchReaders.empty()) {
     throw runtime_error("No columns will be read");
   }
-  //tree->SetCacheSize(50000000);
+  if (!mUseTreeCache) {
+    return;
+  }
+
+  // read the baskets of the requested columns with a single vectored read,
+  // the cache is sized from their compressed size
+  std::vector<TBranch*> cachedBranches;
+  Long64_t cacheSize = 0;
+  for (auto& reader : mBranchReaders) {
+    cachedBranches.push_back(reader->branch());
+    auto sizeBranch = tree->GetBranch((std::string{reader->branch()->GetName()} + TableTreeHelpers::sizeBranchSuffix).c_str());
+    if (sizeBranch != nullptr) {
+      cachedBranches.push_back(sizeBranch);
+    }
+  }
+  for (auto* branch : cachedBranches) {
+    cacheSize += branch->GetZipBytes();
+  }
+  tree->SetCacheSize(std::min(cacheSize, maxCacheSize));
   // FIXME: see https://github.com/root-project/root/issues/8962 and enable
   // again once fixed.
   //tree->SetClusterPrefetch(true);
-  //for (auto& reader : mBranchReaders) {
-  //  tree->AddBranchToCache(reader->branch());
-  //}
-  //tree->StopCacheLearningPhase();
+  for (auto* branch : cachedBranches) {
+    tree->AddBranchToCache(branch, false);
+  }
+  tree->StopCacheLearningPhase();
 }
 
 void TreeToTable::setLabel(const char* label)
@@ -537,16 +568,74 @@ void TreeToTable::setLabel(const char* label)
   mTableLabel = label;
 }
 
+void TreeToTable::setUseTreeCache(bool useTreeCache)
+{
+  mUseTreeCache = useTreeCache;
+}
+
+void TreeToTable::setNThreads(int nThreads)
+{
+  mNThreads = std::max(nThreads, 1);
+#ifdef R__USE_IMT
+  // the columns are read on the ROOT thread pool, which is created once
+  // with the requested size unless implicit multi-threading is already on
+  if (mNThreads > 1 && !ROOT::IsImplicitMTEnabled()) {
+    ROOT::EnableImplicitMT(mNThreads);
+  }
+#endif
+}
+
 void TreeToTable::fill(TTree*)
 {
-  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
-  std::vector<std::shared_ptr<arrow::Field>> fields;
-  static TBufferFile buffer{TBuffer::EMode::kWrite, 4 * 1024 * 1024};
-  for (auto& reader : mBranchReaders) {
-    buffer.Reset();
-    auto arrayAndField = reader->read(&buffer);
-    columns.push_back(arrayAndField.first);
-    fields.push_back(arrayAndField.second);
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns(mBranchReaders.size());
+  std::vector<std::shared_ptr<arrow::Field>> fields(mBranchReaders.size());
+  thread_local TBufferFile buffer{TBuffer::EMode::kWrite, 4 * 1024 * 1024};
+
+#ifdef R__USE_IMT
+  auto nThreads = std::min<size_t>(mNThreads, mBranchReaders.size());
+#else
+  // the file access is serialised only in ROOT builds with implicit multi-threading
+  size_t nThreads = 1;
+#endif
+  if (nThreads <= 1) {
+    for (auto i = 0u; i < mBranchReaders.size(); ++i) {
+      buffer.Reset();
+      std::tie(columns[i], fields[i]) = mBranchReaders[i]->read(&buffer);
+    }
+  } else {
+#ifdef R__USE_IMT
+    // each task takes the next column, the largest ones first; ROOT
+    // serialises the file access as for its own parallel branch reading
+    std::vector<size_t> order(mBranchReaders.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+      return mBranchReaders[a]->branch()->GetTotBytes() > mBranchReaders[b]->branch()->GetTotBytes();
+    });
+    std::atomic<size_t> next{0};
+    std::exception_ptr error = nullptr;
+    std::mutex errorMutex;
+    auto readColumns = [&](unsigned int) {
+      try {
+        for (auto i = next++; i < order.size(); i = next++) {
+          buffer.Reset();
+          std::tie(columns[order[i]], fields[order[i]]) = mBranchReaders[order[i]]->read(&buffer);
+        }
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(errorMutex);
+        error = std::current_exception();
+        next = order.size();
+      }
+    };
+
+    // the tasks run on the workers of the ROOT thread pool set up by
+    // setNThreads, which outlive the fill together with their buffer
+    ROOT::Internal::TParBranchProcessingRAII parallelBranchProcessing;
+    ROOT::TThreadExecutor executor;
+    executor.Foreach(readColumns, ROOT::TSeqU(nThreads));
+    if (error) {
+      std::rethrow_exception(error);
+    }
+#endif
   }
 
   auto schema = std::make_shared<arrow::Schema>(fields, std::make_shared<arrow::KeyValueMetadata>(std::vector{std::string{"label"}}, std::vector{mTableLabel}));
@@ -555,7 +644,7 @@ void TreeToTable::fill(TTree*)
 
 void TreeToTable::addReader(TBranch* branch, std::string const& name, bool VLA)
 {
-  static TClass* cls;
+  TClass* cls;
   EDataType type;
   branch->GetExpectedType(cls, type);
   auto listSize = -1;
@@ -24,7 +24,11 @@ void TimesliceIndex::resize(size_t s)
 {
   mVariables.resize(s);
   mPublishedVariables.resize(s);
-  mDirty.resize(s, false);
+  mDirty.resize((s + 63) / 64, 0);
+  // Make sure we do not keep stale bits beyond the new size.
+  if (s % 64) {
+    mDirty.back() &= (uint64_t{1} << (s % 64)) - 1;
+  }
 }
 
 void TimesliceIndex::associate(TimesliceId timestamp, TimesliceSlot slot)
@@ -32,7 +36,7 @@ void TimesliceIndex::associate(TimesliceId timestamp, TimesliceSlot slot)
   assert(mVariables.size() > slot.index);
   mVariables[slot.index].put({0, static_cast<uint64_t>(timestamp.value)});
   mVariables[slot.index].commit();
-  mDirty[slot.index] = true;
+  markAsDirty(slot, true);
 }
 
 TimesliceSlot TimesliceIndex::findOldestSlot(TimesliceId timestamp) const
@@ -130,7 +134,7 @@ TimesliceIndex::OldestInputInfo TimesliceIndex::setOldestPossibleInput(Timeslice
 
 bool TimesliceIndex::validateSlot(TimesliceSlot slot, TimesliceId currentOldest)
 {
-  if (mDirty[slot.index] == true) {
+  if (isDirty(slot)) {
     return true;
   }
 
@@ -248,6 +248,7 @@ void WorkflowHelpers::injectServiceDevices(WorkflowSpec& workflow, ConfigContext
                 {"condition-not-after", VariantType::Int64, 3385078236000ll, {"do not fetch from CCDB objects created after the timestamp"}},
                 {"condition-remap", VariantType::String, "", {"remap condition path in CCDB based on the provided string."}},
                 {"condition-tf-per-query", VariantType::Int64, defaultConditionQueryRate(), {"check condition validity per requested number of TFs, fetch only once if <0"}},
+                {"condition-prefetch-window", VariantType::Int64, 10000ll, {"prefetch the next version of a condition with the validity check done in the given time in ms before its end of validity, 0 to disable"}},
                 {"orbit-offset-enumeration", VariantType::Int64, 0ll, {"initial value for the orbit"}},
                 {"orbit-multiplier-enumeration", VariantType::Int64, 0ll, {"multiplier to get the orbit from the counter"}},
                 {"start-value-enumeration", VariantType::Int64, 0ll, {"initial value for the enumeration"}},
@@ -291,6 +292,10 @@ void WorkflowHelpers::injectServiceDevices(WorkflowSpec& workflow, ConfigContext
     {ConfigParamSpec{"aod-file", VariantType::String, {"Input AOD file"}},
      ConfigParamSpec{"aod-reader-json", VariantType::String, {"json configuration file"}},
      ConfigParamSpec{"time-limit", VariantType::Int64, 0ll, {"Maximum run time limit in seconds"}},
+     ConfigParamSpec{"aod-prefetch", VariantType::Int, 0, {"Number of dataframes read ahead on background threads (0: read on demand)"}},
+     ConfigParamSpec{"aod-prefetch-threads", VariantType::Int, 1, {"Number of threads reading ahead the dataframes"}},
+     ConfigParamSpec{"aod-prefetch-memory-limit", VariantType::Int64, 1000ll, {"Maximum size in MB of the dataframes read ahead"}},
+     ConfigParamSpec{"aod-column-threads", VariantType::Int, 1, {"Number of threads reading the columns of a table (> 1 enables ROOT implicit multi-threading with this number of threads for the whole process)"}},
      ConfigParamSpec{"orbit-offset-enumeration", VariantType::Int64, 0ll, {"initial value for the orbit"}},
      ConfigParamSpec{"orbit-multiplier-enumeration", VariantType::Int64, 0ll, {"multiplier to get the orbit from the counter"}},
      ConfigParamSpec{"start-value-enumeration", VariantType::Int64, 0ll, {"initial value for the enumeration"}},
@@ -27,9 +27,11 @@ DECLARE_SOA_COLUMN_FULL(X, x, float, "x");
 DECLARE_SOA_COLUMN_FULL(Y, y, float, "y");
 DECLARE_SOA_COLUMN_FULL(Z, z, float, "z");
 DECLARE_SOA_DYNAMIC_COLUMN(Sum, sum, [](float x, float y) { return x + y; });
+DECLARE_SOA_COLUMN_FULL(GroupId, groupId, int32_t, "fIndexGroups");
 } // namespace test
 
 DECLARE_SOA_TABLE(TestTable, "AOD", "TESTTBL", test::X, test::Y, test::Z, test::Sum<test::X, test::Y>);
+DECLARE_SOA_TABLE(GroupedTable, "AOD", "GRPTBL", test::GroupId, test::X);
 
 #ifdef __APPLE__
 constexpr unsigned int maxrange = 10;
@@ -314,4 +316,59 @@ static void BM_ASoADynamicColumnCall(benchmark::State& state)
 }
 BENCHMARK(BM_ASoADynamicColumnCall)->Range(8, 8 << maxrange);
 
+// 10 rows per group, as the tracks of a collision, sorted by group
+static std::shared_ptr<arrow::Table> makeGroupedTable(int nGroups)
+{
+  TableBuilder builder;
+  auto rowWriter = builder.cursor<GroupedTable>();
+  for (auto i = 0; i < 10 * nGroups; ++i) {
+    rowWriter(0, i / 10, 0.f);
+  }
+  return builder.finalize();
+}
+
+// every group is sliced once, as when grouping tracks per collision with sliceBy
+static void BM_ASoASliceBy(benchmark::State& state)
+{
+  auto table = makeGroupedTable(state.range(0));
+  GroupedTable grouped{table};
+  o2::framework::Preslice<GroupedTable> slices = test::groupId;
+  for (auto _ : state) {
+    slices.setNewDF();
+    auto status = slices.processTable(table);
+    int64_t n = 0;
+    for (auto i = 0; i < state.range(0); ++i) {
+      n += grouped.sliceBy(slices, i).size();
+    }
+    benchmark::DoNotOptimize(n);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ASoASliceBy)->RangeMultiplier(10)->Range(100, 100000);
+
+// the same with the linear search of each group in the value counts, as done before the SliceInfo
+static void BM_ASoASliceByLinear(benchmark::State& state)
+{
+  auto table = makeGroupedTable(state.range(0));
+  for (auto _ : state) {
+    std::shared_ptr<arrow::NumericArray<arrow::Int32Type>> values;
+    std::shared_ptr<arrow::NumericArray<arrow::Int64Type>> counts;
+    auto status = getSlices("fIndexGroups", table, values, counts);
+    int64_t n = 0;
+    for (auto i = 0; i < state.range(0); ++i) {
+      uint64_t offset = 0;
+      for (auto slice = 0; slice < values->length(); ++slice) {
+        if (values->Value(slice) == i) {
+          n += table->Slice(offset, counts->Value(slice))->num_rows();
+          break;
+        }
+        offset += counts->Value(slice);
+      }
+    }
+    benchmark::DoNotOptimize(n);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ASoASliceByLinear)->RangeMultiplier(10)->Range(100, 100000);
+
 BENCHMARK_MAIN();
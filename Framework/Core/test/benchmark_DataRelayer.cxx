@@ -17,7 +17,9 @@
 #include "Framework/DataProcessingHeader.h"
 #include <Monitoring/Monitoring.h>
 #include <fairmq/TransportFactory.h>
+#include <atomic>
 #include <cstring>
+#include <memory>
 #include <vector>
 
 using Monitoring = o2::monitoring::Monitoring;
@@ -344,4 +346,146 @@ static void BM_RelayMultiplePayloads(benchmark::State& state)
 
 BENCHMARK(BM_RelayMultiplePayloads)->Arg(10)->Arg(100)->Arg(1000);
 
+// Per message cost of relaying and checking for completion when many
+// slots are in flight and each timeslice has many inputs. All the slots but
+// one are kept partially filled, so that they are never complete.
+static void BM_RelayManySlotsManyInputs(benchmark::State& state)
+{
+  const size_t nSlots = state.range(0);
+  const size_t nInputs = state.range(1);
+  Monitoring metrics;
+  std::vector<InputRoute> inputs;
+  for (size_t i = 0; i < nInputs; ++i) {
+    InputSpec spec{"clusters", "TPC", "CLUSTERS", static_cast<header::DataHeader::SubSpecificationType>(i)};
+    inputs.emplace_back(InputRoute{spec, i, "Fake" + std::to_string(i), 0});
+  }
+
+  std::vector<InputChannelInfo> infos{nInputs};
+  TimesliceIndex index{1, infos};
+
+  auto policy = CompletionPolicyHelpers::consumeWhenAll();
+  DataRelayer relayer(policy, inputs, metrics, index);
+  relayer.setPipelineLength(nSlots);
+
+  DataHeader dh;
+  dh.dataDescription = "CLUSTERS";
+  dh.dataOrigin = "TPC";
+
+  auto transport = fair::mq::TransportFactory::CreateTransportFactory("zeromq");
+  auto createMessages = [&](size_t timeslice, size_t input) {
+    dh.subSpecification = input;
+    DataProcessingHeader dph{timeslice, 1};
+    Stack stack{dh, dph};
+    std::vector<fair::mq::MessagePtr> messages;
+    messages.emplace_back(transport->CreateMessage(stack.size()));
+    messages.emplace_back(transport->CreateMessage(1000));
+    memcpy(messages[0]->GetData(), stack.data(), stack.size());
+    return messages;
+  };
+
+  // Fill all the slots but one, leaving out the last input.
+  for (size_t ts = 0; ts < nSlots - 1; ++ts) {
+    for (size_t i = 0; i < nInputs - 1; ++i) {
+      auto messages = createMessages(ts, i);
+      relayer.relay(messages[0]->GetData(), messages.data(), messages.size());
+    }
+  }
+  std::vector<RecordAction> ready;
+  relayer.getReadyToProcess(ready);
+  assert(ready.empty());
+
+  std::vector<std::vector<fair::mq::MessagePtr>> inflightMessages;
+  for (size_t i = 0; i < nInputs; ++i) {
+    inflightMessages.emplace_back(createMessages(nSlots, i));
+  }
+  size_t timeslice = nSlots;
+
+  for (auto _ : state) {
+    for (size_t i = 0; i < nInputs; ++i) {
+      relayer.relay(inflightMessages[i][0]->GetData(), inflightMessages[i].data(), inflightMessages[i].size());
+      ready.clear();
+      relayer.getReadyToProcess(ready);
+    }
+    assert(ready.size() == 1);
+    auto result = relayer.consumeAllInputsForTimeslice(ready[0].slot);
+    // Reuse the messages for the next timeslice.
+    timeslice++;
+    for (size_t i = 0; i < nInputs; ++i) {
+      inflightMessages[i] = std::move(result[i].messages);
+      dh.subSpecification = i;
+      DataProcessingHeader dph{timeslice, 1};
+      Stack stack{dh, dph};
+      memcpy(inflightMessages[i][0]->GetData(), stack.data(), stack.size());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * nInputs);
+}
+
+BENCHMARK(BM_RelayManySlotsManyInputs)->Args({4, 4})->Args({64, 50});
+
+// Relay throughput as a function of the number of threads relaying and
+// consuming concurrently on the same relayer. Each thread has its own input
+// route, so that the only contention is on the relayer itself.
+// Notice that messages are created inside the loop, see BM_RelayMessageCreation
+// for the contribution of the message creation alone.
+static void BM_RelayMultipleThreads(benchmark::State& state)
+{
+  static std::unique_ptr<Monitoring> metrics;
+  static std::unique_ptr<TimesliceIndex> index;
+  static std::unique_ptr<DataRelayer> relayer;
+  static std::vector<InputChannelInfo> infos;
+  static std::atomic<size_t> nextTimeslice = 0;
+  const int nThreads = state.threads();
+
+  if (state.thread_index() == 0) {
+    std::vector<InputRoute> inputs;
+    for (int ti = 0; ti < nThreads; ++ti) {
+      InputSpec spec{"clusters", "TPC", "CLUSTERS", static_cast<header::DataHeader::SubSpecificationType>(ti)};
+      inputs.emplace_back(InputRoute{spec, (size_t)ti, "Fake" + std::to_string(ti), 0});
+    }
+    infos.clear();
+    infos.resize(nThreads);
+    metrics = std::make_unique<Monitoring>();
+    index = std::make_unique<TimesliceIndex>(1, infos);
+    auto policy = CompletionPolicyHelpers::consumeWhenAny();
+    relayer = std::make_unique<DataRelayer>(policy, inputs, *metrics, *index);
+    relayer->setPipelineLength(64);
+    nextTimeslice = 0;
+  }
+
+  DataHeader dh;
+  dh.dataDescription = "CLUSTERS";
+  dh.dataOrigin = "TPC";
+  dh.subSpecification = state.thread_index();
+
+  auto transport = fair::mq::TransportFactory::CreateTransportFactory("zeromq");
+  std::vector<RecordAction> ready;
+
+  for (auto _ : state) {
+    DataProcessingHeader dph{nextTimeslice++, 1};
+    Stack stack{dh, dph};
+    std::vector<fair::mq::MessagePtr> inflightMessages;
+    inflightMessages.emplace_back(transport->CreateMessage(stack.size()));
+    inflightMessages.emplace_back(transport->CreateMessage(1000));
+    memcpy(inflightMessages[0]->GetData(), stack.data(), stack.size());
+
+    relayer->relay(inflightMessages[0]->GetData(), inflightMessages.data(), inflightMessages.size());
+    ready.clear();
+    relayer->getReadyToProcess(ready);
+    for (auto& action : ready) {
+      auto result = relayer->consumeAllInputsForTimeslice(action.slot);
+      benchmark::DoNotOptimize(result);
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+
+  if (state.thread_index() == 0) {
+    relayer.reset();
+    index.reset();
+    metrics.reset();
+  }
+}
+
+BENCHMARK(BM_RelayMultipleThreads)->ThreadRange(1, 16)->UseRealTime();
+
 BENCHMARK_MAIN();
@@ -16,6 +16,7 @@
 
 #include <benchmark/benchmark.h>
 #include <boost/format.hpp>
+#include <random>
 
 using namespace o2::framework;
 using namespace arrow;
@@ -62,6 +63,79 @@ static void BM_StandardNameLookup(benchmark::State& state)
     }
   }
 }
+
+/// Number of rows to fill
+const int nRows = 1000000;
+
+namespace test
+{
+DECLARE_SOA_COLUMN_FULL(X, x, float, "x");
+DECLARE_SOA_COLUMN_FULL(Y, y, float, "y");
+DECLARE_SOA_COLUMN_FULL(Z, z, float, "z");
+DECLARE_SOA_COLUMN_FULL(W, w, float, "w");
+} // namespace test
+
+using TestTable = o2::soa::Table<o2::soa::Index<>, test::X, test::Y, test::Z, test::W>;
+
+TestTable makeTable()
+{
+  TableBuilder builder;
+  auto rowWriter = builder.persist<float, float, float, float>({"x", "y", "z", "w"});
+  std::default_random_engine e1(1234567891);
+  std::normal_distribution<float> gauss(0.f, 1.f);
+  for (auto i = 0; i < nRows; ++i) {
+    rowWriter(0, gauss(e1), gauss(e1), gauss(e1), 1.f + 0.1f * gauss(e1));
+  }
+  return TestTable{builder.finalize()};
+}
+
+HistogramRegistry makeRegistry()
+{
+  return {"registry", {{"th1", "th1", {HistType::kTH1F, {{100, -5, 5}}}},
+                       {"th2", "th2", {HistType::kTH2F, {{100, -5, 5}, {100, -5, 5}}}},
+                       {"sparse", "sparse", {HistType::kTHnSparseF, {{100, -5, 5}, {100, -5, 5}, {100, -5, 5}}}}}};
+}
+
+/// Fill the rows of a table one by one into a TH1F (0), TH2F (1) or THnSparseF (2), with a fill buffer of range(1) entries (0 fills directly)
+static void BM_HistogramRegistryFillRows(benchmark::State& state)
+{
+  static auto table = makeTable();
+  auto registry = makeRegistry();
+  registry.setFillBufferSize(state.range(1));
+  for (auto _ : state) {
+    for (auto& row : table) {
+      if (state.range(0) == 0) {
+        registry.fill(HIST("th1"), row.x());
+      } else if (state.range(0) == 1) {
+        registry.fill(HIST("th2"), row.x(), row.y(), row.w());
+      } else {
+        registry.fill(HIST("sparse"), row.x(), row.y(), row.z());
+      }
+    }
+    registry.flush();
+  }
+  state.SetItemsProcessed(state.iterations() * nRows);
+}
+
+/// Fill the columns of a filtered table at once into a TH1F (0), TH2F (1) or THnSparseF (2)
+static void BM_HistogramRegistryFillTable(benchmark::State& state)
+{
+  static auto table = makeTable();
+  auto registry = makeRegistry();
+  for (auto _ : state) {
+    if (state.range(0) == 0) {
+      registry.fill<test::X>(HIST("th1"), table, test::w > 0.f);
+    } else if (state.range(0) == 1) {
+      registry.fill<test::X, test::Y, test::W>(HIST("th2"), table, test::w > 0.f);
+    } else {
+      registry.fill<test::X, test::Y, test::Z>(HIST("sparse"), table, test::w > 0.f);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * nRows);
+}
+
+BENCHMARK(BM_HistogramRegistryFillRows)->Args({0, 0})->Args({0, 1024})->Args({1, 0})->Args({1, 1024})->Args({2, 0})->Args({2, 1024})->ArgNames({"hist", "buffer"})->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_HistogramRegistryFillTable)->Arg(0)->Arg(1)->Arg(2)->ArgNames({"hist"})->Unit(benchmark::kMillisecond);
 BENCHMARK(BM_HashedNameLookup)->Arg(4)->Arg(8)->Arg(16)->Arg(64)->Arg(128)->Arg(256)->Arg(512);
 BENCHMARK(BM_StandardNameLookup)->Arg(4)->Arg(8)->Arg(16)->Arg(64)->Arg(128)->Arg(256)->Arg(512);
 
@@ -0,0 +1,114 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#include <benchmark/benchmark.h>
+
+#include "Framework/TMessageSerializer.h"
+#include <fairmq/ProgOptions.h>
+#include <fairmq/TransportFactory.h>
+#include <TH2F.h>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+using namespace o2::framework;
+
+// count the heap allocations made while serializing
+static std::atomic<size_t> allocations{0};
+
+void* operator new(size_t size)
+{
+  allocations++;
+  if (void* ptr = std::malloc(size)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+  std::free(ptr);
+}
+
+/// Transport of range(0): zeromq (0) or shared memory (1)
+std::shared_ptr<fair::mq::TransportFactory> getTransport(int type)
+{
+  static auto zeromq = fair::mq::TransportFactory::CreateTransportFactory("zeromq");
+  static auto shmem = []() {
+    fair::mq::ProgOptions config;
+    config.SetProperty<std::string>("session", "benchmark_TMessageSerializer");
+    config.SetProperty<size_t>("shm-segment-size", 1024 * 1024 * 1024);
+    return fair::mq::TransportFactory::CreateTransportFactory("shmem", "benchmark_TMessageSerializer", &config);
+  }();
+  return type == 0 ? zeromq : shmem;
+}
+
+/// A histogram of range(1) x range(1) bins, as shipped by QC devices
+std::unique_ptr<TH2F> makeHistogram(int nBins)
+{
+  auto histogram = std::make_unique<TH2F>("histogram", "histogram", nBins, 0, 1, nBins, 0, 1);
+  histogram->SetDirectory(nullptr);
+  for (auto i = 0; i < 100000; ++i) {
+    histogram->Fill((i % 997) / 997., (i % 991) / 991.);
+  }
+  return histogram;
+}
+
+/// Serialize into a TMessage which is adopted by the message
+static void BM_SerializeTMessage(benchmark::State& state)
+{
+  auto transport = getTransport(state.range(0));
+  auto histogram = makeHistogram(state.range(1));
+  size_t bytes = 0;
+  size_t heapAllocations = 0;
+  for (auto _ : state) {
+    auto before = allocations.load();
+    auto message = transport->CreateMessage();
+    TMessageSerializer::Serialize(*message, histogram.get(), histogram->IsA());
+    heapAllocations += allocations.load() - before;
+    bytes += message->GetSize();
+  }
+  state.SetBytesProcessed(bytes);
+  state.counters["heap allocations"] = benchmark::Counter(heapAllocations, benchmark::Counter::kAvgIterations);
+}
+
+/// Serialize directly into the memory of the message
+static void BM_SerializeToMessage(benchmark::State& state)
+{
+  auto transport = getTransport(state.range(0));
+  auto histogram = makeHistogram(state.range(1));
+  size_t messages = 0;
+  auto creator = [&transport, &messages](size_t size) {
+    messages++;
+    return transport->CreateMessage(size);
+  };
+  size_t bytes = 0;
+  size_t heapAllocations = 0;
+  for (auto _ : state) {
+    auto before = allocations.load();
+    auto message = TMessageSerializer::Serialize(creator, histogram.get(), histogram->IsA());
+    heapAllocations += allocations.load() - before;
+    bytes += message->GetSize();
+  }
+  state.SetBytesProcessed(bytes);
+  state.counters["heap allocations"] = benchmark::Counter(heapAllocations, benchmark::Counter::kAvgIterations);
+  state.counters["messages"] = benchmark::Counter(messages, benchmark::Counter::kAvgIterations);
+}
+
+BENCHMARK(BM_SerializeTMessage)->Args({0, 100})->Args({0, 1000})->Args({1, 100})->Args({1, 1000})->ArgNames({"shmem", "bins"});
+BENCHMARK(BM_SerializeToMessage)->Args({0, 100})->Args({0, 1000})->Args({1, 100})->Args({1, 1000})->ArgNames({"shmem", "bins"});
+
+BENCHMARK_MAIN();
@@ -11,9 +11,14 @@
 
 #include "Framework/CommonDataProcessors.h"
 #include "Framework/TableTreeHelpers.h"
+#include "Framework/DataInputDirector.h"
 #include "Framework/Logger.h"
+#include "Headers/DataHeader.h"
 #include <benchmark/benchmark.h>
+#include <chrono>
 #include <random>
+#include <set>
+#include <thread>
 #include <vector>
 
 #include <TFile.h>
@@ -91,6 +96,137 @@ static void BM_TreeToTable(benchmark::State& state)
   state.SetBytesProcessed(state.iterations() * state.range(0) * 24);
 }
 
+/// Convert a wide table of range(0) rows with 32 float columns and 8 variable size
+/// array columns, reading the columns on range(1) threads
+static void BM_TreeToTableColumns(benchmark::State& state)
+{
+  static std::set<int64_t> written;
+  auto fileName = fmt::format("tree2table_columns_{}.root", state.range(0));
+  if (written.insert(state.range(0)).second) {
+    std::default_random_engine e1(1234567891);
+    std::normal_distribution<float> rf(5., 2.);
+    std::uniform_int_distribution<int> rn(0, 8);
+
+    TFile fout(fileName.c_str(), "RECREATE");
+    TTree tree("tree2table", "tree2table");
+    float values[32];
+    int sizes[8];
+    float arrays[8][8];
+    for (auto i = 0; i < 32; ++i) {
+      tree.Branch(fmt::format("f{}", i).c_str(), &values[i], fmt::format("f{}/F", i).c_str());
+    }
+    for (auto i = 0; i < 8; ++i) {
+      tree.Branch(fmt::format("a{}_size", i).c_str(), &sizes[i], fmt::format("a{}_size/I", i).c_str());
+      tree.Branch(fmt::format("a{}", i).c_str(), arrays[i], fmt::format("a{}[a{}_size]/F", i, i).c_str());
+    }
+    for (auto entry = 0; entry < state.range(0); ++entry) {
+      for (auto& value : values) {
+        value = rf(e1);
+      }
+      for (auto i = 0; i < 8; ++i) {
+        sizes[i] = rn(e1);
+        for (auto j = 0; j < sizes[i]; ++j) {
+          arrays[i][j] = rf(e1);
+        }
+      }
+      tree.Fill();
+    }
+    tree.Write();
+    fout.Close();
+  }
+
+  for (auto _ : state) {
+    TFile f(fileName.c_str(), "READ");
+    auto tr = (TTree*)f.Get("tree2table");
+    TreeToTable tr2ta;
+    tr2ta.setNThreads(state.range(1));
+    tr2ta.addAllColumns(tr);
+    tr2ta.fill(tr);
+    benchmark::DoNotOptimize(tr2ta.finalize());
+    delete tr;
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+/// Local AO2D sample: files with dataframes DF_<n> holding the trees of two tables
+const int nFiles = 4;
+const int nDataFrames = 8;
+const int nRowsPerDataFrame = 200000;
+
+std::vector<std::string> makeAO2DSample()
+{
+  std::default_random_engine e1(1234567891);
+  std::normal_distribution<float> rf(5., 2.);
+  std::vector<std::string> fileNames;
+  for (auto i = 0; i < nFiles; ++i) {
+    fileNames.emplace_back(fmt::format("AO2D_sample_{}.root", i));
+    TFile fout(fileNames.back().c_str(), "RECREATE");
+    for (auto j = 0; j < nDataFrames; ++j) {
+      auto folder = fmt::format("DF_{}", i * nDataFrames + j);
+      fout.mkdir(folder.c_str());
+      for (auto treename : {"O2track", "O2collision"}) {
+        TableBuilder builder;
+        auto rowWriter = builder.persist<float, float, float, int>({"x", "y", "z", "i"});
+        for (auto k = 0; k < nRowsPerDataFrame; ++k) {
+          rowWriter(0, rf(e1), rf(e1), rf(e1), k);
+        }
+        auto table = builder.finalize();
+        TableToTree ta2tr(table, &fout, (folder + "/" + treename).c_str());
+        ta2tr.addAllBranches();
+        ta2tr.process();
+      }
+    }
+    fout.Close();
+  }
+  return fileNames;
+}
+
+/// Read all dataframes of the sample, while each of them is processed for range(0) ms,
+/// reading range(1) dataframes ahead on range(2) threads (0: read on demand as the reader does)
+static void BM_ReadDataFrames(benchmark::State& state)
+{
+  static auto fileNames = makeAO2DSample();
+  std::vector<o2::header::DataHeader> headers{{o2::header::DataDescription{"TRACK"}, o2::header::DataOrigin{"AOD"}, 0},
+                                              {o2::header::DataDescription{"COLLISION"}, o2::header::DataOrigin{"AOD"}, 0}};
+  auto process = [&state](std::shared_ptr<arrow::Table> const& table) {
+    benchmark::DoNotOptimize(table->num_rows());
+    std::this_thread::sleep_for(std::chrono::milliseconds(state.range(0)));
+  };
+
+  int nRead = 0;
+  for (auto _ : state) {
+    auto didir = std::make_shared<DataInputDirector>(fileNames);
+    if (state.range(1) == 0) {
+      for (auto counter = 0; !didir->atEnd(counter); ++counter) {
+        for (auto numTF = 0; numTF < nDataFrames; ++numTF) {
+          for (auto& dh : headers) {
+            auto tree = didir->getDataTree(dh, counter, numTF);
+            TreeToTable t2t;
+            t2t.addAllColumns(tree);
+            t2t.fill(tree);
+            delete tree;
+            process(t2t.finalize());
+          }
+          ++nRead;
+        }
+      }
+      didir->closeInputFiles();
+    } else {
+      DataFramePrefetcher prefetcher(didir, headers, 0, 1, state.range(1), state.range(2), 1000 * 1024 * 1024);
+      PrefetchedDataFrame df;
+      while (prefetcher.next(df)) {
+        for (auto& table : df.tables) {
+          process(table);
+        }
+        ++nRead;
+      }
+    }
+  }
+  state.SetItemsProcessed(nRead);
+}
+
 BENCHMARK(BM_TreeToTable)->Range(8, 8 << maxrange);
+BENCHMARK(BM_TreeToTableColumns)->Args({100000, 1})->Args({100000, 4})->Args({1000000, 1})->Args({1000000, 2})->Args({1000000, 4})->Args({1000000, 8})->ArgNames({"rows", "threads"})->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_ReadDataFrames)->Args({0, 0, 0})->Args({0, 4, 2})->Args({5, 0, 0})->Args({5, 2, 1})->Args({5, 4, 2})->ArgNames({"processMS", "prefetch", "threads"})->Unit(benchmark::kMillisecond)->UseRealTime();
 
 BENCHMARK_MAIN();
@@ -950,6 +950,38 @@ BOOST_AUTO_TEST_CASE(TestSliceBy)
   }
 }
 
+BOOST_AUTO_TEST_CASE(TestSliceByCache)
+{
+  TableBuilder w;
+  auto writer_w = w.cursor<References>();
+  for (auto i = 0; i < 5 * 20; ++i) {
+    writer_w(0, i / 5);
+  }
+  auto refs = w.finalize();
+  References r{refs};
+
+  // the slices are computed once for the two Preslices and for another arrow::Table of the same data
+  o2::framework::ArrowTableSlicingCache cache;
+  o2::framework::Preslice<References> slices1 = test::originId;
+  o2::framework::Preslice<References> slices2 = test::originId;
+  slices1.setNewDF(&cache);
+  slices2.setNewDF(&cache);
+  BOOST_REQUIRE(slices1.processTable(refs).ok());
+  BOOST_REQUIRE(slices2.processTable(arrow::Table::Make(refs->schema(), refs->columns())).ok());
+  BOOST_CHECK_EQUAL(cache.size(), 1);
+  BOOST_CHECK_EQUAL(slices1.sliceInfo, slices2.sliceInfo);
+
+  for (auto i = 0; i < 21; ++i) {
+    auto cachedSlice = r.sliceBy(slices2, i);
+    BOOST_CHECK_EQUAL(cachedSlice.size(), i < 20 ? 5 : 0);
+    for (auto& ri : cachedSlice) {
+      BOOST_CHECK_EQUAL(ri.originId(), i);
+    }
+  }
+  cache.clear();
+  BOOST_CHECK_EQUAL(cache.size(), 0);
+}
+
 BOOST_AUTO_TEST_CASE(TestIndexUnboundExceptions)
 {
   TableBuilder b;
@@ -88,13 +88,14 @@ BOOST_AUTO_TEST_CASE(TestOldestTimesliceWithBounce)
     queue, taskId2, [&count]() { count += 30; }, TimesliceId{1}, 20);
   AsyncQueueHelpers::run(queue, TimesliceId{0});
   BOOST_CHECK_EQUAL(count, 0);
-  BOOST_CHECK_EQUAL(queue.tasks.size(), 3);
+  // The two debounced tasks for the same timeslice are collapsed when posted
+  BOOST_CHECK_EQUAL(queue.pending, 2);
   AsyncQueueHelpers::run(queue, TimesliceId{1});
   BOOST_CHECK_EQUAL(count, 30);
-  BOOST_CHECK_EQUAL(queue.tasks.size(), 1);
+  BOOST_CHECK_EQUAL(queue.pending, 1);
   AsyncQueueHelpers::run(queue, TimesliceId{2});
   BOOST_CHECK_EQUAL(count, 40);
-  BOOST_CHECK_EQUAL(queue.tasks.size(), 0);
+  BOOST_CHECK_EQUAL(queue.pending, 0);
 }
 
 // test bouncing disabled with negative value
@@ -114,13 +115,13 @@ BOOST_AUTO_TEST_CASE(TestOldestTimesliceWithNegativeBounce)
     queue, taskId2, [&count]() { count += 30; }, TimesliceId{1}, -20);
   AsyncQueueHelpers::run(queue, TimesliceId{0});
   BOOST_CHECK_EQUAL(count, 0);
-  BOOST_CHECK_EQUAL(queue.tasks.size(), 3);
+  BOOST_CHECK_EQUAL(queue.pending, 3);
   AsyncQueueHelpers::run(queue, TimesliceId{1});
   BOOST_CHECK_EQUAL(count, 50);
-  BOOST_CHECK_EQUAL(queue.tasks.size(), 1);
+  BOOST_CHECK_EQUAL(queue.pending, 1);
   AsyncQueueHelpers::run(queue, TimesliceId{2});
   BOOST_CHECK_EQUAL(count, 60);
-  BOOST_CHECK_EQUAL(queue.tasks.size(), 0);
+  BOOST_CHECK_EQUAL(queue.pending, 0);
 }
 
 // Make sure we execute tasks only up to the timeslice provided to run.
@@ -133,17 +134,39 @@ BOOST_AUTO_TEST_CASE(TestOldestTimeslicePerTimeslice)
   auto count = 0;
   AsyncQueueHelpers::post(
     queue, taskId1, [&count]() { count += 10; }, TimesliceId{1});
-  BOOST_CHECK_EQUAL(queue.tasks.size(), 1);
+  BOOST_CHECK_EQUAL(queue.pending, 1);
   AsyncQueueHelpers::run(queue, TimesliceId{0});
-  BOOST_CHECK_EQUAL(queue.tasks.size(), 1);
+  BOOST_CHECK_EQUAL(queue.pending, 1);
   BOOST_CHECK_EQUAL(count, 0);
   AsyncQueueHelpers::post(
     queue, taskId1, [&count]() { count += 20; }, TimesliceId{2});
-  BOOST_CHECK_EQUAL(queue.tasks.size(), 2);
+  BOOST_CHECK_EQUAL(queue.pending, 2);
   AsyncQueueHelpers::run(queue, TimesliceId{1});
-  BOOST_CHECK_EQUAL(queue.tasks.size(), 1);
+  BOOST_CHECK_EQUAL(queue.pending, 1);
   BOOST_CHECK_EQUAL(count, 10);
   AsyncQueueHelpers::run(queue, TimesliceId{2});
-  BOOST_CHECK_EQUAL(queue.tasks.size(), 0);
+  BOOST_CHECK_EQUAL(queue.pending, 0);
   BOOST_CHECK_EQUAL(count, 30);
 }
+
+// Debounced tasks with the same id are collapsed across timeslices
+// only when they become runnable together.
+BOOST_AUTO_TEST_CASE(TestDebouncingAcrossTimeslices)
+{
+  using namespace o2::framework;
+  AsyncQueue queue;
+  auto taskId = AsyncQueueHelpers::create(queue, {.name = "test", .score = 10});
+  auto count = 0;
+  AsyncQueueHelpers::post(
+    queue, taskId, [&count]() { count += 1; }, TimesliceId{0}, 10);
+  AsyncQueueHelpers::post(
+    queue, taskId, [&count]() { count += 2; }, TimesliceId{2}, 20);
+  AsyncQueueHelpers::post(
+    queue, taskId, [&count]() { count += 4; }, TimesliceId{3}, 30);
+  BOOST_CHECK_EQUAL(queue.pending, 3);
+  AsyncQueueHelpers::run(queue, TimesliceId{1});
+  BOOST_CHECK_EQUAL(count, 1);
+  AsyncQueueHelpers::run(queue, TimesliceId{3});
+  BOOST_CHECK_EQUAL(count, 5);
+  BOOST_CHECK_EQUAL(queue.pending, 0);
+}
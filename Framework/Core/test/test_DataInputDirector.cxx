@@ -17,6 +17,17 @@
 
 #include "Headers/DataHeader.h"
 #include "Framework/DataInputDirector.h"
+#include "Framework/TableBuilder.h"
+#include "Framework/TableTreeHelpers.h"
+#include <TFile.h>
+#include <arrow/array.h>
+#include <arrow/table.h>
+#include <fmt/format.h>
+#include <chrono>
+#include <memory>
+#include <set>
+#include <thread>
+#include <vector>
 
 BOOST_AUTO_TEST_CASE(TestDatainputDirector)
 {
@@ -108,3 +119,157 @@ BOOST_AUTO_TEST_CASE(TestDatainputDirector)
   BOOST_CHECK(didesc);
   BOOST_CHECK_EQUAL(didesc->getNumberInputfiles(), 3);
 }
+
+using namespace o2::framework;
+
+namespace
+{
+const int nRows = 100;
+const std::vector<o2::header::DataHeader> prefetchedHeaders{{o2::header::DataDescription{"TRACK"}, o2::header::DataOrigin{"AOD"}, 0},
+                                                            {o2::header::DataDescription{"COLLISION"}, o2::header::DataOrigin{"AOD"}, 0}};
+
+// Files with nDataFrames dataframes DF_<n> holding the trees O2track and
+// O2collision. The column "df" holds the number n of the dataframe, so that
+// the order in which the dataframes are handed out can be checked. The
+// collision tree of the dataframes in missingCollisions is not written.
+std::vector<std::string> makeDataFrames(std::string const& prefix, int nFiles, int nDataFrames, std::set<int> const& missingCollisions = {})
+{
+  std::vector<std::string> fileNames;
+  for (auto i = 0; i < nFiles; ++i) {
+    fileNames.emplace_back(fmt::format("{}_{}.root", prefix, i));
+    TFile fout(fileNames.back().c_str(), "RECREATE");
+    for (auto j = 0; j < nDataFrames; ++j) {
+      auto n = i * nDataFrames + j;
+      auto folder = fmt::format("DF_{}", n);
+      fout.mkdir(folder.c_str());
+      for (std::string treename : {"O2track", "O2collision"}) {
+        if (treename == "O2collision" && missingCollisions.count(n)) {
+          continue;
+        }
+        TableBuilder builder;
+        auto rowWriter = builder.persist<int, float>({"df", "x"});
+        for (auto k = 0; k < nRows; ++k) {
+          rowWriter(0, n, k);
+        }
+        auto table = builder.finalize();
+        TableToTree ta2tr(table, &fout, (folder + "/" + treename).c_str());
+        ta2tr.addAllBranches();
+        ta2tr.process();
+      }
+    }
+    fout.Close();
+  }
+  return fileNames;
+}
+
+void checkDataFrame(PrefetchedDataFrame const& df, int counter, int numTF, int n)
+{
+  BOOST_CHECK_EQUAL(df.counter, counter);
+  BOOST_CHECK_EQUAL(df.numTF, numTF);
+  BOOST_CHECK_EQUAL(df.timeFrameNumber, static_cast<uint64_t>(n));
+  BOOST_REQUIRE_EQUAL(df.tables.size(), prefetchedHeaders.size());
+  for (auto& table : df.tables) {
+    BOOST_REQUIRE_EQUAL(table->num_rows(), nRows);
+    auto column = std::static_pointer_cast<arrow::Int32Array>(table->GetColumnByName("df")->chunk(0));
+    BOOST_CHECK_EQUAL(column->Value(0), n);
+  }
+}
+
+// wait until the prefetcher holds nReadAhead dataframes, then check that it does not read more
+bool settlesAt(DataFramePrefetcher& prefetcher, size_t nReadAhead)
+{
+  for (auto i = 0; i < 1000 && prefetcher.getNReadAhead() < nReadAhead; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  return prefetcher.getNReadAhead() == nReadAhead;
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(TestDataFramePrefetcherOrder)
+{
+  const int nFiles = 3, nDataFrames = 4;
+  auto fileNames = makeDataFrames("prefetch_order", nFiles, nDataFrames);
+
+  // the dataframes are handed out in reading order, whichever thread read them
+  for (auto nThreads : {1, 4}) {
+    DataFramePrefetcher prefetcher(std::make_shared<DataInputDirector>(fileNames), prefetchedHeaders, 0, 1, 6, nThreads, 1000 * 1024 * 1024, 2);
+    PrefetchedDataFrame df;
+    for (auto counter = 0; counter < nFiles; ++counter) {
+      for (auto numTF = 0; numTF < nDataFrames; ++numTF) {
+        BOOST_REQUIRE(prefetcher.next(df));
+        checkDataFrame(df, counter, numTF, counter * nDataFrames + numTF);
+      }
+    }
+    BOOST_CHECK(!prefetcher.next(df));
+    BOOST_CHECK(!prefetcher.next(df));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(TestDataFramePrefetcherStride)
+{
+  const int nFiles = 4, nDataFrames = 2;
+  auto fileNames = makeDataFrames("prefetch_stride", nFiles, nDataFrames);
+
+  // each parallel reader reads the files first, first + stride, ... until the end of the input
+  for (auto [first, stride] : std::vector<std::pair<int, int>>{{0, 2}, {1, 2}, {2, 3}, {1, 4}, {4, 2}}) {
+    DataFramePrefetcher prefetcher(std::make_shared<DataInputDirector>(fileNames), prefetchedHeaders, first, stride, 3, 2, 1000 * 1024 * 1024);
+    PrefetchedDataFrame df;
+    for (auto counter = first; counter < nFiles; counter += stride) {
+      for (auto numTF = 0; numTF < nDataFrames; ++numTF) {
+        BOOST_REQUIRE(prefetcher.next(df));
+        checkDataFrame(df, counter, numTF, counter * nDataFrames + numTF);
+      }
+    }
+    BOOST_CHECK(!prefetcher.next(df));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(TestDataFramePrefetcherError)
+{
+  const int nFiles = 2, nDataFrames = 3;
+  auto fileNames = makeDataFrames("prefetch_error", nFiles, nDataFrames, {4});
+
+  // the error of a dataframe is rethrown when it is handed out, after the ones before it
+  DataFramePrefetcher prefetcher(std::make_shared<DataInputDirector>(fileNames), prefetchedHeaders, 0, 1, 4, 3, 1000 * 1024 * 1024);
+  PrefetchedDataFrame df;
+  for (auto n = 0; n < 4; ++n) {
+    BOOST_REQUIRE(prefetcher.next(df));
+    checkDataFrame(df, n / nDataFrames, n % nDataFrames, n);
+  }
+  BOOST_CHECK_THROW(prefetcher.next(df), std::runtime_error);
+  BOOST_REQUIRE(prefetcher.next(df));
+  checkDataFrame(df, 1, 2, 5);
+  BOOST_CHECK(!prefetcher.next(df));
+
+  // a file which cannot be opened ends the input with an error
+  DataFramePrefetcher missing(std::make_shared<DataInputDirector>(std::vector<std::string>{"prefetch_missing.root"}), prefetchedHeaders, 0, 1, 4, 1, 1000 * 1024 * 1024);
+  BOOST_CHECK_THROW(missing.next(df), std::runtime_error);
+  BOOST_CHECK(!missing.next(df));
+}
+
+BOOST_AUTO_TEST_CASE(TestDataFramePrefetcherBackPressure)
+{
+  const int nFiles = 1, nDataFrames = 6;
+  auto fileNames = makeDataFrames("prefetch_memory", nFiles, nDataFrames);
+  PrefetchedDataFrame df;
+
+  // no more than depth dataframes are read ahead
+  DataFramePrefetcher deep(std::make_shared<DataInputDirector>(fileNames), prefetchedHeaders, 0, 1, 3, 4, 1000 * 1024 * 1024);
+  BOOST_CHECK(settlesAt(deep, 3));
+  BOOST_REQUIRE(deep.next(df));
+  BOOST_CHECK(settlesAt(deep, 3));
+
+  // above the memory limit only the dataframe to be handed out next is read. The
+  // dataframes being read are not counted, so a single thread is used to see the bound
+  DataFramePrefetcher limited(std::make_shared<DataInputDirector>(fileNames), prefetchedHeaders, 0, 1, 4, 1, 1);
+  BOOST_CHECK(settlesAt(limited, 1));
+  for (auto n = 0; n < nDataFrames; ++n) {
+    BOOST_REQUIRE(limited.next(df));
+    checkDataFrame(df, 0, n, n);
+    if (n + 1 < nDataFrames) {
+      BOOST_CHECK(settlesAt(limited, 1));
+    }
+  }
+  BOOST_CHECK(!limited.next(df));
+}
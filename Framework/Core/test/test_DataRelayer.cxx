@@ -25,6 +25,8 @@
 #include <Monitoring/Monitoring.h>
 #include <fairmq/TransportFactory.h>
 #include <array>
+#include <atomic>
+#include <thread>
 #include <vector>
 
 using Monitoring = o2::monitoring::Monitoring;
@@ -751,3 +753,74 @@ BOOST_AUTO_TEST_CASE(SplitPayloadSequence)
     }
   }
 }
+
+// Several threads relaying into the same route of the same slot, as for
+// the subspecs of a wildcard input, must not lose or corrupt any part.
+BOOST_AUTO_TEST_CASE(ConcurrentRelaySameRoute)
+{
+  Monitoring metrics;
+  InputSpec spec{"clusters", ConcreteDataTypeMatcher{"TPC", "CLUSTERS"}};
+
+  std::vector<InputRoute> inputs = {
+    InputRoute{spec, 0, "Fake", 0},
+  };
+
+  std::vector<InputChannelInfo> infos{1};
+  TimesliceIndex index{1, infos};
+
+  auto policy = CompletionPolicyHelpers::consumeWhenAny();
+  DataRelayer relayer(policy, inputs, metrics, index);
+  relayer.setPipelineLength(4);
+
+  const size_t nThreads = 8;
+  const size_t nRelaysPerThread = 500;
+  const size_t nPayloads = 2;
+  std::atomic<size_t> nRelayed = 0;
+
+  auto relayParts = [&relayer, &nRelayed, nRelaysPerThread, nPayloads](size_t threadId) {
+    auto transport = fair::mq::TransportFactory::CreateTransportFactory("zeromq");
+    auto channelAlloc = o2::pmr::getTransportAllocator(transport.get());
+    DataHeader dh{"CLUSTERS", "TPC", static_cast<DataHeader::SubSpecificationType>(threadId)};
+    dh.splitPayloadIndex = nPayloads;
+    dh.splitPayloadParts = nPayloads;
+    for (size_t ri = 0; ri < nRelaysPerThread; ++ri) {
+      std::vector<fair::mq::MessagePtr> messages;
+      messages.emplace_back(o2::pmr::getMessage(Stack{channelAlloc, dh, DataProcessingHeader{0, 1}}));
+      for (size_t pi = 0; pi < nPayloads; ++pi) {
+        messages.emplace_back(transport->CreateMessage(sizeof(size_t)));
+        *(reinterpret_cast<size_t*>(messages.back()->GetData())) = (threadId * nRelaysPerThread + ri) * nPayloads + pi;
+      }
+      if (relayer.relay(messages[0]->GetData(), messages.data(), messages.size(), nPayloads) == DataRelayer::WillRelay) {
+        nRelayed++;
+      }
+    }
+  };
+  std::vector<std::thread> threads;
+  for (size_t ti = 0; ti < nThreads; ++ti) {
+    threads.emplace_back(relayParts, ti);
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  BOOST_REQUIRE_EQUAL(nRelayed, nThreads * nRelaysPerThread);
+
+  std::vector<RecordAction> ready;
+  relayer.getReadyToProcess(ready);
+  BOOST_REQUIRE_EQUAL(ready.size(), 1);
+  auto messageSet = relayer.consumeAllInputsForTimeslice(ready[0].slot);
+  BOOST_REQUIRE_EQUAL(messageSet.size(), 1);
+  BOOST_REQUIRE_EQUAL(messageSet[0].size(), nThreads * nRelaysPerThread);
+  // every relay is stored as a whole, with its payloads in order
+  std::vector<bool> seen(nThreads * nRelaysPerThread, false);
+  for (size_t part = 0; part < messageSet[0].size(); ++part) {
+    BOOST_REQUIRE(messageSet[0].header(part));
+    BOOST_REQUIRE_EQUAL(messageSet[0].getNumberOfPayloads(part), nPayloads);
+    auto first = *(reinterpret_cast<size_t const*>(messageSet[0].payload(part, 0)->GetData()));
+    BOOST_REQUIRE_EQUAL(first % nPayloads, 0);
+    for (size_t pi = 1; pi < nPayloads; ++pi) {
+      BOOST_CHECK_EQUAL(*(reinterpret_cast<size_t const*>(messageSet[0].payload(part, pi)->GetData())), first + pi);
+    }
+    BOOST_CHECK(!seen[first / nPayloads]);
+    seen[first / nPayloads] = true;
+  }
+}
@@ -252,3 +252,52 @@ BOOST_AUTO_TEST_CASE(TestConditionalExpressions)
   BOOST_REQUIRE_EQUAL(gandiva_tree2->ToString(),
                       "bool greater_than((float) fSigned1Pt, (const float) 0 raw(0)) && if (bool less_than(float absf((float) fEta), (const float) 1 raw(3f800000)) && if (bool less_than((float) fPt, (const float) 1 raw(3f800000))) { bool greater_than((float) fPhi, (const float) 1.5708 raw(3fc90fdb)) } else { bool less_than((float) fPhi, (const float) 1.5708 raw(3fc90fdb)) }) { bool greater_than(float absf((float) fX), (const float) 1 raw(3f800000)) } else { bool greater_than(float absf((float) fY), (const float) 1 raw(3f800000)) }");
 }
+
+BOOST_AUTO_TEST_CASE(TestExpressionCache)
+{
+  auto fields = o2::soa::createFieldsFromColumns(o2::aod::Tracks::persistent_columns_t{});
+  auto schema = std::make_shared<arrow::Schema>(fields);
+  auto stats = getExpressionCacheStats();
+
+  // the same expression on the same schema is compiled once
+  Filter f1 = o2::aod::track::signed1Pt > 1.0f;
+  Filter f2 = o2::aod::track::signed1Pt > 1.0f;
+  auto filter1 = createFilter(schema, createOperations(f1));
+  auto filter2 = createFilter(schema, createOperations(f2));
+  BOOST_CHECK_EQUAL(filter1, filter2);
+  BOOST_CHECK_EQUAL(getExpressionCacheStats().misses, stats.misses + 1);
+  BOOST_CHECK_EQUAL(getExpressionCacheStats().hits, stats.hits + 1);
+
+  // a different literal is a different filter
+  Filter f3 = o2::aod::track::signed1Pt > 1.00001f;
+  auto filter3 = createFilter(schema, createOperations(f3));
+  BOOST_CHECK_NE(filter1, filter3);
+  BOOST_CHECK_EQUAL(getExpressionCacheStats().misses, stats.misses + 2);
+
+  // and so is the same expression on a different schema
+  auto schema2 = std::make_shared<arrow::Schema>(std::vector{o2::aod::track::Signed1Pt::asArrowField()});
+  auto filter4 = createFilter(schema2, createOperations(f1));
+  BOOST_CHECK_NE(filter1, filter4);
+
+  auto projector1 = createProjectors(o2::framework::pack<o2::aod::track::Pt>{}, fields, schema);
+  auto projector2 = createProjectors(o2::framework::pack<o2::aod::track::Pt>{}, fields, schema);
+  BOOST_CHECK_EQUAL(projector1, projector2);
+  BOOST_CHECK(getExpressionCacheStats().buildTimeUs > 0);
+
+  // the least recently used entries are evicted when the cache is full
+  setExpressionCacheSize(0);
+  BOOST_CHECK_EQUAL(getExpressionCacheStats().size, 0);
+  setExpressionCacheSize(2);
+  stats = getExpressionCacheStats();
+  createFilter(schema, createOperations(f1));
+  createFilter(schema, createOperations(f3));
+  createFilter(schema, createOperations(f1));
+  Filter f5 = o2::aod::track::signed1Pt > 2.0f;
+  createFilter(schema, createOperations(f5)); // evicts f3
+  createFilter(schema, createOperations(f1));
+  BOOST_CHECK_EQUAL(getExpressionCacheStats().hits, stats.hits + 2);
+  createFilter(schema, createOperations(f3));
+  BOOST_CHECK_EQUAL(getExpressionCacheStats().misses, stats.misses + 4);
+  BOOST_CHECK_EQUAL(getExpressionCacheStats().evictions, stats.evictions + 2);
+  setExpressionCacheSize(256);
+}
@@ -14,6 +14,7 @@
 
 #include "Framework/HistogramRegistry.h"
 #include <boost/test/unit_test.hpp>
+#include <cmath>
 #include <iostream>
 
 using namespace o2;
@@ -109,6 +110,64 @@ BOOST_AUTO_TEST_CASE(HistogramRegistryExpressionFill)
   BOOST_CHECK_EQUAL(registry.get<TH2>(HIST("xy"))->GetEntries(), 2);
 }
 
+BOOST_AUTO_TEST_CASE(HistogramRegistryBufferedFill)
+{
+  std::vector<HistogramSpec> specs{
+    {"h1", "h1", {HistType::kTH1F, {{100, -1.0, 1.0}}}},
+    {"h1var", "h1var", {HistType::kTH1D, {{std::vector<double>{-1.0, -0.5, 0.0, 0.1, 0.2, 1.0}}}}},
+    {"h2", "h2", {HistType::kTH2D, {{20, -1.0, 1.0}, {30, -1.0, 1.0}}}},
+    {"h3", "h3", {HistType::kTH3F, {{10, -1.0, 1.0}, {10, -1.0, 1.0}, {10, -1.0, 1.0}}}},
+    {"sparse", "sparse", {HistType::kTHnSparseF, {{10, -1.0, 1.0}, {10, -1.0, 1.0}, {10, -1.0, 1.0}}}},
+    {"profile", "profile", {HistType::kTProfile, {{10, -1.0, 1.0}}}}};
+  HistogramRegistry direct{"direct", specs};
+  HistogramRegistry buffered{"buffered", specs};
+  buffered.setFillBufferSize(16);
+
+  // values in and outside of the axis ranges, on the bin edges and NaN
+  auto value = [](int i) { return (i % 101 == 0) ? std::nan("") : ((i % 7 == 0) ? -1.0 + 0.1 * (i % 23) : std::sin(1.7 * i) * 1.2); };
+  for (auto* registry : {&direct, &buffered}) {
+    for (int i = 0; i < 1000; ++i) {
+      const double x = value(i), y = value(i + 1), z = value(i + 2), w = 0.5 + (i % 3);
+      registry->fill(HIST("h1"), x);
+      registry->fill(HIST("h1var"), x, w);
+      registry->fill(HIST("h2"), x, y, (i < 500) ? 1. : w);
+      registry->fill(HIST("h3"), x, y, z);
+      registry->fill(HIST("sparse"), x, y, z, w);
+      registry->fill(HIST("profile"), x, y);
+    }
+  }
+
+  auto compare = [](auto hist, auto reference) {
+    BOOST_CHECK_EQUAL(hist->GetEntries(), reference->GetEntries());
+    BOOST_CHECK_EQUAL(hist->GetSumw2N(), reference->GetSumw2N());
+    for (int bin = 0; bin < reference->GetNcells(); ++bin) {
+      BOOST_CHECK_EQUAL(hist->GetBinContent(bin), reference->GetBinContent(bin));
+      BOOST_CHECK_EQUAL(hist->GetBinError(bin), reference->GetBinError(bin));
+    }
+    double stats[TH1::kNstat]{}, referenceStats[TH1::kNstat]{};
+    hist->GetStats(stats);
+    reference->GetStats(referenceStats);
+    for (int i = 0; i < TH1::kNstat; ++i) {
+      BOOST_CHECK_CLOSE(stats[i], referenceStats[i], 1e-9);
+    }
+  };
+  compare(buffered.get<TH1>(HIST("h1")), direct.get<TH1>(HIST("h1")));
+  compare(buffered.get<TH1>(HIST("h1var")), direct.get<TH1>(HIST("h1var")));
+  compare(buffered.get<TH2>(HIST("h2")), direct.get<TH2>(HIST("h2")));
+  compare(buffered.get<TH3>(HIST("h3")), direct.get<TH3>(HIST("h3")));
+  compare(buffered.get<TProfile>(HIST("profile")), direct.get<TProfile>(HIST("profile")));
+
+  auto sparse = buffered.get<THnSparse>(HIST("sparse"));
+  auto sparseReference = direct.get<THnSparse>(HIST("sparse"));
+  BOOST_CHECK_EQUAL(sparse->GetEntries(), sparseReference->GetEntries());
+  BOOST_REQUIRE_EQUAL(sparse->GetNbins(), sparseReference->GetNbins());
+  int coordinates[3];
+  for (Long64_t bin = 0; bin < sparse->GetNbins(); ++bin) {
+    const double content = sparse->GetBinContent(bin, coordinates);
+    BOOST_CHECK_EQUAL(content, sparseReference->GetBinContent(coordinates));
+  }
+}
+
 BOOST_AUTO_TEST_CASE(HistogramRegistryStepTHn)
 {
   HistogramRegistry registry{"registry"};
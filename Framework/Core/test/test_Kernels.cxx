@@ -106,3 +106,36 @@ BOOST_AUTO_TEST_CASE(TestSlicingException)
     BOOST_FAIL("Slicing should have failed due to unsorted index");
   }
 }
+
+BOOST_AUTO_TEST_CASE(TestSliceInfo)
+{
+  TableBuilder builder;
+  auto rowWriter = builder.persist<int32_t, int32_t>({"x", "y"});
+
+  rowWriter(0, -1, 1);
+  rowWriter(0, 1, 4);
+  rowWriter(0, 1, 5);
+  rowWriter(0, 2, 7);
+  rowWriter(0, -2, 2);
+  rowWriter(0, 4, 8);
+  rowWriter(0, 5, 9);
+  rowWriter(0, 5, 10);
+  rowWriter(0, 100000, 11);
+  auto table = builder.finalize();
+
+  SliceInfo info;
+  auto status = getSliceInfo("x", table, info);
+  BOOST_REQUIRE(status.ok());
+  BOOST_REQUIRE_EQUAL(info.nRows, 9);
+  // the same slices as the linear search of getSliceFor, including absent values
+  for (auto value : {-3, -2, -1, 0, 1, 2, 3, 4, 5, 6, 99999, 100000, 100001}) {
+    std::shared_ptr<arrow::Table> output;
+    uint64_t offset = 0;
+    BOOST_REQUIRE(getSliceFor(value, "x", table, output, offset).ok());
+    auto [start, size] = info.getSliceFor(value);
+    BOOST_CHECK_EQUAL(start, offset);
+    BOOST_CHECK_EQUAL(size, output->num_rows());
+  }
+  // a value much larger than the number of groups is not stored densely
+  BOOST_CHECK_LT(info.offsets.size(), 100000);
+}
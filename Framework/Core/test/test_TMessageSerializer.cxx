@@ -15,6 +15,8 @@
 
 #include "Framework/TMessageSerializer.h"
 #include "TestClasses.h"
+#include <fairmq/TransportFactory.h>
+#include <fmt/format.h>
 #include <boost/test/unit_test.hpp>
 
 using namespace o2::framework;
@@ -108,3 +110,45 @@ BOOST_AUTO_TEST_CASE(TestTMessageSerializer_InvalidBuffer)
                           return strcmp(err.what, "class is not ROOT-serializable") != 0;
                         });
 }
+
+BOOST_AUTO_TEST_CASE(TestTMessageSerializer_ToMessage)
+{
+  using namespace o2::framework;
+  auto transport = fair::mq::TransportFactory::CreateTransportFactory("zeromq");
+  int created = 0;
+  auto creator = [&transport, &created](size_t size) {
+    created++;
+    return transport->CreateMessage(size);
+  };
+
+  // larger than the initial message, which has to grow
+  TObjArray array;
+  array.SetOwner();
+  for (int i = 0; i < 1000; i++) {
+    array.Add(new TNamed(fmt::format("name{}", i).c_str(), "title"));
+  }
+
+  for (int pass = 0; pass < 2; pass++) {
+    created = 0;
+    auto msg = TMessageSerializer::Serialize(creator, &array, nullptr);
+    // the size of the first message of the class is used for the next one
+    if (pass == 0) {
+      BOOST_CHECK_GT(created, 1);
+    } else {
+      BOOST_CHECK_EQUAL(created, 1);
+    }
+
+    FairTMessage reference;
+    TMessageSerializer::serialize(reference, &array);
+    // the message holds exactly what was written, while the buffer of the reference has some room left
+    BOOST_REQUIRE_EQUAL(msg->GetSize(), reference.Length());
+    BOOST_CHECK(memcmp(static_cast<char*>(msg->GetData()) + sizeof(UInt_t), reference.Buffer() + sizeof(UInt_t), reference.Length() - sizeof(UInt_t)) == 0);
+
+    auto out = TMessageSerializer::deserialize(as_span(*msg));
+    TObjArray* outarr = dynamic_cast<TObjArray*>(out.get());
+    BOOST_REQUIRE(outarr != nullptr);
+    outarr->SetOwner();
+    BOOST_REQUIRE_EQUAL(outarr->GetEntries(), 1000);
+    BOOST_CHECK_EQUAL(std::string(outarr->At(999)->GetName()), "name999");
+  }
+}
@@ -50,6 +50,32 @@ BOOST_AUTO_TEST_CASE(TestBasics)
   BOOST_CHECK(index.isValid(slot) == false);
 }
 
+BOOST_AUTO_TEST_CASE(TestFindDirty)
+{
+  using namespace o2::framework;
+  std::vector<InputChannelInfo> infos{1};
+  TimesliceIndex index{1, infos};
+  index.resize(130);
+  BOOST_CHECK(TimesliceSlot::isValid(index.findDirtyBefore(130)) == false);
+  index.markAsDirty({0}, true);
+  index.markAsDirty({64}, true);
+  index.markAsDirty({129}, true);
+  BOOST_CHECK_EQUAL(index.findDirtyBefore(130).index, 129);
+  BOOST_CHECK_EQUAL(index.findDirtyBefore(129).index, 64);
+  BOOST_CHECK_EQUAL(index.findDirtyBefore(64).index, 0);
+  BOOST_CHECK(TimesliceSlot::isValid(index.findDirtyBefore(0)) == false);
+  index.markAsDirty({64}, false);
+  BOOST_CHECK_EQUAL(index.findDirtyBefore(129).index, 0);
+  index.rescan();
+  BOOST_CHECK_EQUAL(index.findDirtyBefore(1000).index, 129);
+  BOOST_CHECK_EQUAL(index.findDirtyBefore(64).index, 63);
+  // Shrinking should not leave dirty slots around
+  index.resize(10);
+  BOOST_CHECK_EQUAL(index.findDirtyBefore(1000).index, 9);
+  index.resize(100);
+  BOOST_CHECK_EQUAL(index.findDirtyBefore(1000).index, 9);
+}
+
 BOOST_AUTO_TEST_CASE(TestLRUReplacement)
 {
   using namespace o2::framework;
@@ -21,6 +21,7 @@
 #include "Framework/TableBuilder.h"
 
 #include <TTree.h>
+#include <TTreeCache.h>
 #include <TRandom.h>
 #include <arrow/table.h>
 
@@ -239,3 +240,91 @@ BOOST_AUTO_TEST_CASE(VariableLists)
     ++i;
   }
 }
+
+BOOST_AUTO_TEST_CASE(ParallelColumns)
+{
+  TableBuilder b;
+  auto writer = b.cursor<o2::aod::Vectors>();
+  std::vector<int> iv;
+  std::vector<float> fv;
+  std::vector<double> dv;
+  std::vector<uint8_t> ui;
+  for (auto i = 0; i < 10000; ++i) {
+    iv.assign(i % 7, i);
+    fv.assign(i % 5, i * 0.5f);
+    dv.assign(i % 3, i * 0.25);
+    ui.assign(i % 2, i % 256);
+    writer(0, iv, fv, dv, ui);
+  }
+  auto table = b.finalize();
+
+  auto* f = TFile::Open("parallel_columns.root", "RECREATE");
+  TableToTree ta2tr(table, f, "lists");
+  ta2tr.addAllBranches();
+  ta2tr.process();
+  f->Close();
+
+  // the columns read on several threads are the same as read on one
+  std::vector<std::shared_ptr<arrow::Table>> tables;
+  for (auto nThreads : {1, 4}) {
+    auto* f2 = TFile::Open("parallel_columns.root", "READ");
+    auto* treeptr = static_cast<TTree*>(f2->Get("lists"));
+    TreeToTable tr2ta;
+    tr2ta.setNThreads(nThreads);
+    tr2ta.addAllColumns(treeptr);
+    tr2ta.fill(treeptr);
+    tables.emplace_back(tr2ta.finalize());
+    f2->Close();
+  }
+  BOOST_REQUIRE_EQUAL(tables[1]->Validate().ok(), true);
+  BOOST_REQUIRE_EQUAL(tables[1]->num_rows(), 10000);
+  BOOST_CHECK(tables[0]->Equals(*tables[1]));
+}
+
+BOOST_AUTO_TEST_CASE(ParallelColumnsTreeCache)
+{
+  // enough rows for many baskets per branch, which the concurrent reads get from the TTreeCache
+  TableBuilder b;
+  auto writer = b.cursor<o2::aod::Vectors>();
+  std::vector<int> iv;
+  std::vector<float> fv;
+  std::vector<double> dv;
+  std::vector<uint8_t> ui;
+  for (auto i = 0; i < 200000; ++i) {
+    iv.assign(i % 7, i);
+    fv.assign(i % 5, i * 0.5f);
+    dv.assign(i % 3, i * 0.25);
+    ui.assign(i % 2, i % 256);
+    writer(0, iv, fv, dv, ui);
+  }
+  auto table = b.finalize();
+
+  auto* f = TFile::Open("parallel_columns_cache.root", "RECREATE");
+  TableToTree ta2tr(table, f, "lists");
+  ta2tr.addAllBranches();
+  ta2tr.process();
+  f->Close();
+
+  std::shared_ptr<arrow::Table> reference;
+  for (auto nThreads : {1, 4, 4, 4}) {
+    auto* f2 = TFile::Open("parallel_columns_cache.root", "READ");
+    auto* treeptr = static_cast<TTree*>(f2->Get("lists"));
+    TreeToTable tr2ta;
+    tr2ta.setUseTreeCache(true);
+    tr2ta.setNThreads(nThreads);
+    tr2ta.addAllColumns(treeptr);
+    tr2ta.fill(treeptr);
+    auto* cache = dynamic_cast<TTreeCache*>(f2->GetCacheRead(treeptr));
+    BOOST_REQUIRE(cache != nullptr);
+    BOOST_CHECK_GT(cache->GetEfficiencyRel(), 0.9);
+    auto result = tr2ta.finalize();
+    BOOST_REQUIRE_EQUAL(result->Validate().ok(), true);
+    BOOST_REQUIRE_EQUAL(result->num_rows(), 200000);
+    if (reference) {
+      BOOST_CHECK(reference->Equals(*result));
+    } else {
+      reference = result;
+    }
+    f2->Close();
+  }
+}
@@ -51,9 +51,15 @@ class IntegratingMerger : public framework::Task
   /// \brief IntegratingMerger process callback.
   void run(framework::ProcessingContext& ctx) override;
 
+  /// \brief Merges an input object into the merged object, or makes it the merged object if there is none yet.
+  void merge(ObjectStore&& other);
+  /// \brief Drops the merged object, as done after publishing when the merged object timespan is over.
+  void clear();
+  /// \brief Returns the merged object, std::monostate if nothing was received since the start or the last reset.
+  const ObjectStore& getMergedObject() const { return mMergedObject; }
+
  private:
   void publish(framework::DataAllocator& allocator);
-  void clear();
 
  private:
   header::DataHeader::SubSpecificationType mSubSpec;
@@ -19,6 +19,8 @@
 
 #include "Mergers/MergeInterface.h"
 
+#include <memory>
+
 class TObject;
 
 namespace o2::mergers::algorithm
@@ -28,6 +30,23 @@ namespace o2::mergers::algorithm
 void merge(TObject* const target, TObject* const other);
 void deleteTCollections(TObject* obj);
 
+/// \brief Creates what changed in an object since its previous state, to be sent to Mergers expecting differences.
+///
+/// Histograms are turned into SparseHistogramDelta with only the changed bins, TCollections are walked recursively.
+/// If previous is nullptr (e.g. in the first cycle), or an object was not present in the previous collection,
+/// a full copy is returned.
+/// Throws if a delta cannot be created for an object, e.g. one which is not a histogram.
+std::unique_ptr<TObject> makeSparseDelta(const TObject* current, const TObject* previous);
+
+/// \brief Tells if the object is a SparseHistogramDelta or a TCollection which contains one at any depth.
+bool containsSparseDeltas(const TObject* obj);
+
+/// \brief Creates a copy of the object where each SparseHistogramDelta is replaced with the histogram it describes.
+///
+/// Used when a Merger has no object to add the deltas to, e.g. after it was reset. TCollections with deltas
+/// are copied into owning TObjArrays, other objects are cloned.
+std::unique_ptr<TObject> expandSparseDeltas(const TObject* obj);
+
 } // namespace o2::mergers::algorithm
 
 #endif //ALICEO2_MERGERS_H
@@ -29,6 +29,7 @@ namespace o2::mergers
 enum class InputObjectsTimespan {
   FullHistory,   // Mergers expect objects with all data accumulated so far each time.
   LastDifference // Mergers expect objects' differences (what has changed since the previous were sent).
+                 // Differences of histograms can be sent as SparseHistogramDelta, see algorithm::makeSparseDelta.
 };
 
 enum class MergedObjectTimespan {
@@ -0,0 +1,76 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#ifndef O2_SPARSEHISTOGRAMDELTA_H
+#define O2_SPARSEHISTOGRAMDELTA_H
+
+/// \file SparseHistogramDelta.h
+/// \brief Definition of SparseHistogramDelta, the bins of a histogram which changed since the last cycle.
+
+#include <TNamed.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+class TH1;
+
+namespace o2::mergers
+{
+
+/// \brief The bins of a histogram which changed since the previous cycle.
+///
+/// Producers of large histograms with few bins updated in each cycle can send a SparseHistogramDelta instead
+/// of the whole difference, when Mergers expect InputObjectsTimespan::LastDifference. It carries the global index
+/// of each changed bin with the increments of its content and of its sum of squared weights, together with the
+/// increments of the statistics and of the number of entries. Mergers add it to the histogram with the same name.
+/// The delta also carries the class and the binning of the histogram, so that Mergers which have no histogram to add
+/// it to, e.g. after a reset, can create an empty one with createTarget().
+/// Profiles and histograms with labels are not supported.
+class SparseHistogramDelta : public TNamed
+{
+ public:
+  SparseHistogramDelta() = default;
+  /// \brief Creates the delta between the current and the previous state of a histogram with the same binning.
+  SparseHistogramDelta(const TH1* current, const TH1* previous);
+  ~SparseHistogramDelta() override = default;
+
+  /// \brief Adds the changed bins, statistics and entries to the target histogram.
+  void addTo(TH1* target) const;
+
+  /// \brief Creates an empty histogram with the class, name, title and binning of the one the delta was made of.
+  std::unique_ptr<TH1> createTarget() const;
+
+  /// \brief Number of changed bins
+  size_t size() const { return mBins.size(); }
+
+  /// \brief Tells if a delta can be created for a histogram of this kind.
+  static bool isSupported(const TH1* histogram);
+
+ private:
+  Int_t mNcells = 0;
+  std::vector<Int_t> mBins;
+  std::vector<Double_t> mContents;
+  std::vector<Double_t> mSumw2; // empty if the histogram does not store the sum of squared weights
+  std::vector<Double_t> mStats;
+  Double_t mEntries = 0;
+  std::string mHistogramClass;
+  std::vector<Int_t> mAxisNbins;
+  std::vector<Double_t> mAxisLimits;    // the lower and upper edge of each axis
+  std::vector<Bool_t> mAxisVariable;    // true for the axes with variable bins
+  std::vector<Double_t> mVariableEdges; // the bin edges of the axes with variable bins, one axis after another
+  std::vector<std::string> mAxisTitles;
+
+  ClassDefOverride(SparseHistogramDelta, 2);
+};
+
+} // namespace o2::mergers
+
+#endif //O2_SPARSEHISTOGRAMDELTA_H
@@ -60,23 +60,7 @@ void IntegratingMerger::run(framework::ProcessingContext& ctx)
 
   for (const DataRef& ref : InputRecordWalker(ctx.inputs())) {
     if (ref.header != timerHeader) {
-      auto other = object_store_helpers::extractObjectFrom(ref);
-      if (std::holds_alternative<std::monostate>(mMergedObject)) {
-        LOG(debug) << "Received the first input object in the run or after the last moving window reset";
-        mMergedObject = std::move(object_store_helpers::extractObjectFrom(ref));
-      } else if (std::holds_alternative<TObjectPtr>(mMergedObject)) {
-        // We expect that if the first object was TObject, then all should.
-        auto targetAsTObject = std::get<TObjectPtr>(mMergedObject);
-        auto otherAsTObject = std::get<TObjectPtr>(other);
-        algorithm::merge(targetAsTObject.get(), otherAsTObject.get());
-      } else if (std::holds_alternative<MergeInterfacePtr>(mMergedObject)) {
-        // We expect that if the first object inherited MergeInterface, then all should.
-        auto otherAsMergeInterface = std::get<MergeInterfacePtr>(other);
-        std::get<MergeInterfacePtr>(mMergedObject)->merge(otherAsMergeInterface.get());
-      } else {
-        throw std::runtime_error("mMergedObject' variant has no value.");
-      }
-      mDeltasMerged++;
+      merge(object_store_helpers::extractObjectFrom(ref));
     }
   }
 
@@ -91,6 +75,31 @@ void IntegratingMerger::run(framework::ProcessingContext& ctx)
   }
 }
 
+void IntegratingMerger::merge(ObjectStore&& other)
+{
+  if (std::holds_alternative<std::monostate>(mMergedObject)) {
+    LOG(debug) << "Received the first input object in the run or after the last moving window reset";
+    if (std::holds_alternative<TObjectPtr>(other) && algorithm::containsSparseDeltas(std::get<TObjectPtr>(other).get())) {
+      // There is nothing to add the sparse deltas to, so we create the histograms they describe.
+      mMergedObject = TObjectPtr(algorithm::expandSparseDeltas(std::get<TObjectPtr>(other).get()).release(), algorithm::deleteTCollections);
+    } else {
+      mMergedObject = std::move(other);
+    }
+  } else if (std::holds_alternative<TObjectPtr>(mMergedObject)) {
+    // We expect that if the first object was TObject, then all should.
+    auto targetAsTObject = std::get<TObjectPtr>(mMergedObject);
+    auto otherAsTObject = std::get<TObjectPtr>(other);
+    algorithm::merge(targetAsTObject.get(), otherAsTObject.get());
+  } else if (std::holds_alternative<MergeInterfacePtr>(mMergedObject)) {
+    // We expect that if the first object inherited MergeInterface, then all should.
+    auto otherAsMergeInterface = std::get<MergeInterfacePtr>(other);
+    std::get<MergeInterfacePtr>(mMergedObject)->merge(otherAsMergeInterface.get());
+  } else {
+    throw std::runtime_error("mMergedObject' variant has no value.");
+  }
+  mDeltasMerged++;
+}
+
 // I am not calling it reset(), because it does not have to be performed during the FairMQs reset.
 void IntegratingMerger::clear()
 {
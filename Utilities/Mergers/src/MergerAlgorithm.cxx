@@ -17,6 +17,7 @@
 #include "Mergers/MergerAlgorithm.h"
 
 #include "Mergers/MergeInterface.h"
+#include "Mergers/SparseHistogramDelta.h"
 #include "Framework/Logger.h"
 
 #include <TH1.h>
@@ -29,6 +30,9 @@
 #include <TGraph.h>
 #include <TEfficiency.h>
 
+#include <string_view>
+#include <unordered_map>
+
 namespace o2::mergers::algorithm
 {
 
@@ -42,6 +46,18 @@ size_t estimateTreeSize(TTree* tree)
   return totalSize;
 }
 
+std::unordered_map<std::string_view, TObject*> indexByName(const TCollection* collection)
+{
+  std::unordered_map<std::string_view, TObject*> index;
+  index.reserve(collection->GetSize());
+  auto iterator = collection->MakeIterator();
+  while (auto object = iterator->Next()) {
+    index.emplace(object->GetName(), object);
+  }
+  delete iterator;
+  return index;
+}
+
 void merge(TObject* const target, TObject* const other)
 {
   if (target == nullptr) {
@@ -69,18 +85,31 @@ void merge(TObject* const target, TObject* const other)
                                "' is a TCollection, while the other object '" + other->GetName() + "' is not.");
     }
 
+    // TCollection::FindObject is a linear search, which would make merging large collections quadratic.
+    // Instead, we index the target objects by name once. As FindObject, we match the first object with a given name.
+    auto targetObjects = indexByName(targetCollection);
     auto otherIterator = otherCollection->MakeIterator();
     while (auto otherObject = otherIterator->Next()) {
-      TObject* targetObject = targetCollection->FindObject(otherObject->GetName());
-      if (targetObject) {
+      auto targetObject = targetObjects.find(otherObject->GetName());
+      if (targetObject != targetObjects.end()) {
         // That might be another collection or a concrete object to be merged, we walk on the collection recursively.
-        merge(targetObject, otherObject);
+        merge(targetObject->second, otherObject);
       } else {
         // We prefer to clone instead of passing the pointer in order to simplify deleting the `other`.
-        targetCollection->Add(otherObject->Clone());
+        // Sparse deltas are turned into histograms, so that the following ones can be added to them.
+        auto clone = expandSparseDeltas(otherObject).release();
+        targetCollection->Add(clone);
+        targetObjects.emplace(clone->GetName(), clone);
       }
     }
     delete otherIterator;
+  } else if (auto delta = dynamic_cast<SparseHistogramDelta*>(other)) {
+    auto targetTH1 = dynamic_cast<TH1*>(target);
+    if (targetTH1 == nullptr) {
+      throw std::runtime_error(std::string("The other object '") + other->GetName() + "' is a sparse histogram delta, while the target object '" +
+                               target->GetName() + "' of type '" + target->ClassName() + "' is not a histogram.");
+    }
+    delta->addTo(targetTH1);
   } else {
     Long64_t errorCode = 0;
     TObjArray otherCollection;
@@ -127,6 +156,88 @@ void merge(TObject* const target, TObject* const other)
   }
 }
 
+std::unique_ptr<TObject> makeSparseDelta(const TObject* current, const TObject* previous)
+{
+  if (current == nullptr) {
+    throw std::runtime_error("The object to make a delta of is nullptr");
+  }
+  if (previous == nullptr) {
+    return std::unique_ptr<TObject>(current->Clone());
+  }
+
+  if (auto currentCollection = dynamic_cast<const TCollection*>(current)) {
+    auto previousCollection = dynamic_cast<const TCollection*>(previous);
+    if (previousCollection == nullptr) {
+      throw std::runtime_error(std::string("The current object '") + current->GetName() + "' is a TCollection, while the previous one is not.");
+    }
+    auto previousObjects = indexByName(previousCollection);
+    auto deltas = std::make_unique<TObjArray>();
+    deltas->SetOwner(true);
+    deltas->SetName(current->GetName());
+    auto currentIterator = currentCollection->MakeIterator();
+    while (auto currentObject = currentIterator->Next()) {
+      auto previousObject = previousObjects.find(currentObject->GetName());
+      deltas->Add(makeSparseDelta(currentObject, previousObject != previousObjects.end() ? previousObject->second : nullptr).release());
+    }
+    delete currentIterator;
+    return deltas;
+  } else if (auto currentTH1 = dynamic_cast<const TH1*>(current)) {
+    auto previousTH1 = dynamic_cast<const TH1*>(previous);
+    if (previousTH1 == nullptr) {
+      throw std::runtime_error(std::string("The current object '") + current->GetName() + "' is a histogram, while the previous one is not.");
+    }
+    return std::make_unique<SparseHistogramDelta>(currentTH1, previousTH1);
+  } else {
+    throw std::runtime_error(std::string("Cannot create a sparse delta of the object '") + current->GetName() + "' with type '" + current->ClassName() + "'");
+  }
+}
+
+bool containsSparseDeltas(const TObject* obj)
+{
+  if (obj->InheritsFrom(SparseHistogramDelta::Class())) {
+    return true;
+  }
+  if (auto collection = dynamic_cast<const TCollection*>(obj)) {
+    auto iterator = collection->MakeIterator();
+    bool found = false;
+    while (auto element = iterator->Next()) {
+      if ((found = containsSparseDeltas(element))) {
+        break;
+      }
+    }
+    delete iterator;
+    return found;
+  }
+  return false;
+}
+
+std::unique_ptr<TObject> expandSparseDeltas(const TObject* obj)
+{
+  if (obj == nullptr) {
+    throw std::runtime_error("The object to expand the sparse deltas of is nullptr");
+  }
+  if (!containsSparseDeltas(obj)) {
+    return std::unique_ptr<TObject>(obj->Clone());
+  }
+
+  if (auto delta = dynamic_cast<const SparseHistogramDelta*>(obj)) {
+    auto histogram = delta->createTarget();
+    delta->addTo(histogram.get());
+    return histogram;
+  } else {
+    auto collection = dynamic_cast<const TCollection*>(obj);
+    auto expanded = std::make_unique<TObjArray>();
+    expanded->SetOwner(true);
+    expanded->SetName(collection->GetName());
+    auto iterator = collection->MakeIterator();
+    while (auto element = iterator->Next()) {
+      expanded->Add(expandSparseDeltas(element).release());
+    }
+    delete iterator;
+    return expanded;
+  }
+}
+
 void deleteTCollections(TObject* obj)
 {
   if (auto c = dynamic_cast<TCollection*>(obj)) {
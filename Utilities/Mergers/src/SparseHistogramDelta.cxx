@@ -0,0 +1,172 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file SparseHistogramDelta.cxx
+/// \brief Implementation of SparseHistogramDelta
+
+#include "Mergers/SparseHistogramDelta.h"
+
+#include <TH1.h>
+#include <TAxis.h>
+#include <TClass.h>
+#include <TProfile.h>
+#include <TProfile2D.h>
+#include <TProfile3D.h>
+
+#include <stdexcept>
+#include <string>
+
+namespace o2::mergers
+{
+
+SparseHistogramDelta::SparseHistogramDelta(const TH1* current, const TH1* previous)
+  : TNamed(current->GetName(), current->GetTitle()),
+    mNcells(current->GetNcells()),
+    mStats(TH1::kNstat, 0)
+{
+  if (!isSupported(current) || (previous != nullptr && !isSupported(previous))) {
+    throw std::runtime_error(std::string("Cannot create a sparse delta of the histogram '") + current->GetName() + "' of type '" + current->ClassName() + "'");
+  }
+  if (previous != nullptr && previous->GetNcells() != mNcells) {
+    throw std::runtime_error(std::string("The previous state of the histogram '") + current->GetName() + "' has a different binning");
+  }
+
+  const Double_t* currentSumw2 = current->GetSumw2N() ? current->GetSumw2()->GetArray() : nullptr;
+  const Double_t* previousSumw2 = previous != nullptr && previous->GetSumw2N() ? previous->GetSumw2()->GetArray() : nullptr;
+  for (Int_t bin = 0; bin < mNcells; bin++) {
+    const Double_t previousContent = previous != nullptr ? previous->GetBinContent(bin) : 0;
+    const Double_t content = current->GetBinContent(bin) - previousContent;
+    // without the sum of squared weights, the errors are given by the contents
+    const Double_t sumw2 = currentSumw2 != nullptr ? currentSumw2[bin] - (previousSumw2 != nullptr ? previousSumw2[bin] : previousContent) : 0;
+    if (content != 0 || sumw2 != 0) {
+      mBins.push_back(bin);
+      mContents.push_back(content);
+      if (currentSumw2 != nullptr) {
+        mSumw2.push_back(sumw2);
+      }
+    }
+  }
+
+  current->GetStats(mStats.data());
+  mEntries = current->GetEntries();
+  if (previous != nullptr) {
+    std::vector<Double_t> previousStats(TH1::kNstat, 0);
+    previous->GetStats(previousStats.data());
+    for (size_t i = 0; i < mStats.size(); i++) {
+      mStats[i] -= previousStats[i];
+    }
+    mEntries -= previous->GetEntries();
+  }
+
+  mHistogramClass = current->ClassName();
+  const TAxis* axes[] = {current->GetXaxis(), current->GetYaxis(), current->GetZaxis()};
+  for (Int_t i = 0; i < current->GetDimension(); i++) {
+    const TAxis* axis = axes[i];
+    mAxisNbins.push_back(axis->GetNbins());
+    mAxisLimits.push_back(axis->GetXmin());
+    mAxisLimits.push_back(axis->GetXmax());
+    mAxisVariable.push_back(axis->IsVariableBinSize());
+    if (axis->IsVariableBinSize()) {
+      mVariableEdges.insert(mVariableEdges.end(), axis->GetXbins()->GetArray(), axis->GetXbins()->GetArray() + axis->GetXbins()->GetSize());
+    }
+    mAxisTitles.emplace_back(axis->GetTitle());
+  }
+}
+
+std::unique_ptr<TH1> SparseHistogramDelta::createTarget() const
+{
+  auto histogramClass = TClass::GetClass(mHistogramClass.c_str());
+  if (histogramClass == nullptr || !histogramClass->InheritsFrom(TH1::Class()) || mAxisNbins.empty() || mAxisNbins.size() > 3) {
+    throw std::runtime_error(std::string("The sparse delta of '") + GetName() + "' does not describe a histogram which could be created, its class is '" + mHistogramClass + "'");
+  }
+  std::unique_ptr<TH1> target(static_cast<TH1*>(histogramClass->DynamicCast(TH1::Class(), histogramClass->New())));
+  target->SetDirectory(nullptr);
+  target->SetNameTitle(GetName(), GetTitle());
+
+  // The axes are created with fixed bins first, as SetBins() does not allow mixing fixed and variable ones.
+  const auto& n = mAxisNbins;
+  const auto& l = mAxisLimits;
+  if (n.size() == 1) {
+    target->SetBins(n[0], l[0], l[1]);
+  } else if (n.size() == 2) {
+    target->SetBins(n[0], l[0], l[1], n[1], l[2], l[3]);
+  } else if (n.size() == 3) {
+    target->SetBins(n[0], l[0], l[1], n[1], l[2], l[3], n[2], l[4], l[5]);
+  }
+  const Double_t* edges = mVariableEdges.data();
+  TAxis* axes[] = {target->GetXaxis(), target->GetYaxis(), target->GetZaxis()};
+  for (size_t i = 0; i < n.size(); i++) {
+    if (mAxisVariable[i]) {
+      axes[i]->Set(n[i], edges);
+      edges += n[i] + 1;
+    }
+    axes[i]->SetTitle(mAxisTitles[i].c_str());
+  }
+
+  if (target->GetNcells() != mNcells) {
+    throw std::runtime_error(std::string("The histogram created for the sparse delta of '") + GetName() + "' has " + std::to_string(target->GetNcells()) +
+                             " bins, while the delta has " + std::to_string(mNcells));
+  }
+  return target;
+}
+
+void SparseHistogramDelta::addTo(TH1* target) const
+{
+  if (!isSupported(target)) {
+    throw std::runtime_error(std::string("Cannot add a sparse delta to the histogram '") + target->GetName() + "' of type '" + target->ClassName() + "'");
+  }
+  if (target->GetNcells() != mNcells) {
+    throw std::runtime_error(std::string("The sparse delta of '") + GetName() + "' has " + std::to_string(mNcells) +
+                             " bins, while the target histogram has " + std::to_string(target->GetNcells()));
+  }
+
+  // The statistics are taken before touching the bins, so that they are not recomputed from the updated contents.
+  Double_t stats[TH1::kNstat] = {0};
+  target->GetStats(stats);
+  const Double_t entries = target->GetEntries();
+
+  if (!mSumw2.empty() && target->GetSumw2N() == 0) {
+    target->Sumw2();
+  }
+  Double_t* targetSumw2 = target->GetSumw2N() ? target->GetSumw2()->GetArray() : nullptr;
+  for (size_t i = 0; i < mBins.size(); i++) {
+    target->AddBinContent(mBins[i], mContents[i]);
+    if (targetSumw2 != nullptr) {
+      targetSumw2[mBins[i]] += mSumw2.empty() ? mContents[i] : mSumw2[i];
+    }
+  }
+
+  for (size_t i = 0; i < mStats.size() && i < static_cast<size_t>(TH1::kNstat); i++) {
+    stats[i] += mStats[i];
+  }
+  target->PutStats(stats);
+  target->SetEntries(entries + mEntries);
+}
+
+bool SparseHistogramDelta::isSupported(const TH1* histogram)
+{
+  // Profiles keep the bin entries besides the contents, averages are not additive, while labels and extendable axes
+  // may change the meaning of a bin index between cycles.
+  if (histogram->InheritsFrom(TProfile::Class()) || histogram->InheritsFrom(TProfile2D::Class()) || histogram->InheritsFrom(TProfile3D::Class())) {
+    return false;
+  }
+  if (histogram->TestBit(TH1::kIsAverage)) {
+    return false;
+  }
+  for (const TAxis* axis : {histogram->GetXaxis(), histogram->GetYaxis(), histogram->GetZaxis()}) {
+    if (axis->GetLabels() != nullptr || axis->CanExtend()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace o2::mergers
@@ -10,6 +10,8 @@
 // or submit itself to any jurisdiction.
 #include <benchmark/benchmark.h>
 
+#include "Mergers/MergerAlgorithm.h"
+
 #include <TObjArray.h>
 #include <TH1.h>
 #include <TH2.h>
@@ -30,6 +32,7 @@ const size_t collectionSize = 100;
 
 #define DIFF_OBJECTS 0
 #define FULL_OBJECTS 1
+#define SPARSE_DELTAS 2
 
 static void BM_MergingTH1I(benchmark::State& state)
 {
@@ -248,6 +251,45 @@ static void BM_MergingTTree(benchmark::State& state)
   delete merged;
 }
 
+// Merges a collection of differences into a collection of histograms with the merger algorithm, either as whole
+// histograms or as sparse deltas with only the changed bins.
+static void BM_MergingCollectionTH1I(benchmark::State& state)
+{
+  const size_t bins = 62500; // makes 250kB
+
+  TCollection* previous = new TObjArray();
+  previous->SetOwner(true);
+  TCollection* current = new TObjArray();
+  current->SetOwner(true);
+  TCollection* merged = new TObjArray();
+  merged->SetOwner(true);
+  TF1* uni = new TF1("uni", "1", 0, 1000000);
+  for (size_t i = 0; i < collectionSize; i++) {
+    auto name = "test" + std::to_string(i);
+    previous->Add(new TH1I(name.c_str(), "test", bins, 0, 1000000));
+    TH1I* h = new TH1I(name.c_str(), "test", bins, 0, 1000000);
+    h->FillRandom("uni", entriesInDiff);
+    current->Add(h);
+    merged->Add(new TH1I(name.c_str(), "test", bins, 0, 1000000));
+  }
+  auto deltas = o2::mergers::algorithm::makeSparseDelta(current, previous);
+  TObject* other = state.range(0) == SPARSE_DELTAS ? deltas.get() : current;
+
+  for (auto _ : state) {
+    auto start = std::chrono::high_resolution_clock::now();
+    o2::mergers::algorithm::merge(merged, other);
+    auto end = std::chrono::high_resolution_clock::now();
+
+    auto elapsed_seconds = std::chrono::duration_cast<std::chrono::duration<double>>(end - start);
+    state.SetIterationTime(elapsed_seconds.count());
+  }
+
+  delete previous;
+  delete current;
+  delete merged;
+  delete uni;
+}
+
 BENCHMARK(BM_MergingTH1I)->Arg(DIFF_OBJECTS)->UseManualTime();
 BENCHMARK(BM_MergingTH1I)->Arg(FULL_OBJECTS)->UseManualTime();
 BENCHMARK(BM_MergingTH2I)->Arg(DIFF_OBJECTS)->UseManualTime();
@@ -258,5 +300,7 @@ BENCHMARK(BM_MergingTHnSparse)->Arg(DIFF_OBJECTS)->UseManualTime();
 BENCHMARK(BM_MergingTHnSparse)->Arg(FULL_OBJECTS)->UseManualTime();
 BENCHMARK(BM_MergingTTree)->Arg(DIFF_OBJECTS)->UseManualTime();
 BENCHMARK(BM_MergingTTree)->Arg(FULL_OBJECTS)->UseManualTime();
+BENCHMARK(BM_MergingCollectionTH1I)->Arg(DIFF_OBJECTS)->UseManualTime();
+BENCHMARK(BM_MergingCollectionTH1I)->Arg(SPARSE_DELTAS)->UseManualTime();
 
 BENCHMARK_MAIN();
\ No newline at end of file
@@ -10,6 +10,8 @@
 // or submit itself to any jurisdiction.
 #include <benchmark/benchmark.h>
 
+#include "Mergers/MergerAlgorithm.h"
+
 #include <TObjArray.h>
 #include <TH1.h>
 #include <TH2.h>
@@ -449,6 +451,35 @@ static void BM_mergingBoostRegular2DCollections(benchmark::State& state)
   delete uni;
 }
 
+// Merges two collections with the same names of small histograms with the merger algorithm, which matches
+// the objects by name.
+static void BM_mergingNamedCollections(benchmark::State& state)
+{
+  const size_t collectionSize = state.range(0);
+  const size_t bins = 10;
+
+  auto target = std::make_unique<TObjArray>();
+  target->SetOwner(true);
+  auto other = std::make_unique<TObjArray>();
+  other->SetOwner(true);
+  for (size_t i = 0; i < collectionSize; i++) {
+    auto name = "test" + std::to_string(i);
+    target->Add(new TH1I(name.c_str(), "test", bins, 0, 1000000));
+    TH1I* h = new TH1I(name.c_str(), "test", bins, 0, 1000000);
+    h->Fill(i);
+    other->Add(h);
+  }
+
+  for (auto _ : state) {
+    auto start = std::chrono::high_resolution_clock::now();
+    o2::mergers::algorithm::merge(target.get(), other.get());
+    auto end = std::chrono::high_resolution_clock::now();
+
+    auto elapsed_seconds = std::chrono::duration_cast<std::chrono::duration<double>>(end - start);
+    state.SetIterationTime(elapsed_seconds.count());
+  }
+}
+
 // one by one comparison
 BENCHMARK(BM_mergingCollectionsTH1I)->Arg(1)->UseManualTime();
 BENCHMARK(BM_mergingCollectionsTH1I)->Arg(1)->UseManualTime();
@@ -470,5 +501,6 @@ BENCHMARK(BM_mergingPODCollections)->BENCHMARK_RANGE_COLLECTIONS->UseManualTime(
 BENCHMARK(BM_mergingBoostRegular1DCollections)->BENCHMARK_RANGE_COLLECTIONS->UseManualTime();
 BENCHMARK(BM_mergingBoostRegular2DCollections)->BENCHMARK_RANGE_COLLECTIONS->UseManualTime();
 BENCHMARK(BM_mergingCollectionsTTree)->BENCHMARK_RANGE_COLLECTIONS->UseManualTime();
+BENCHMARK(BM_mergingNamedCollections)->BENCHMARK_RANGE_COLLECTIONS->UseManualTime();
 
 BENCHMARK_MAIN();
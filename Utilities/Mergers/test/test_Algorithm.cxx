@@ -23,6 +23,7 @@
 #include "Mergers/MergerAlgorithm.h"
 #include "Mergers/CustomMergeableTObject.h"
 #include "Mergers/CustomMergeableObject.h"
+#include "Mergers/SparseHistogramDelta.h"
 
 #include <TObjArray.h>
 #include <TObjString.h>
@@ -301,6 +302,156 @@ BOOST_AUTO_TEST_CASE(MergerCollection)
   delete target;
 }
 
+BOOST_AUTO_TEST_CASE(MergerLargeCollection)
+{
+  const size_t collectionSize = 500;
+
+  TObjArray* target = new TObjArray();
+  target->SetOwner(true);
+  TList* other = new TList();
+  other->SetOwner(true);
+  for (size_t i = 0; i < collectionSize; i++) {
+    auto name = "histo " + std::to_string(i);
+    auto* targetTH1I = new TH1I(name.c_str(), name.c_str(), bins, min, max);
+    targetTH1I->Fill(i % bins);
+    target->Add(targetTH1I);
+    // the other collection is in the reverse order and contains a few more histograms
+    auto otherName = "histo " + std::to_string(collectionSize + 9 - i);
+    auto* otherTH1I = new TH1I(otherName.c_str(), otherName.c_str(), bins, min, max);
+    otherTH1I->Fill((collectionSize + 9 - i) % bins);
+    other->Add(otherTH1I);
+  }
+  // a repeated name is merged into the object which was added from the other collection
+  auto* repeated = new TH1I("histo 509", "histo 509", bins, min, max);
+  repeated->Fill(9);
+  other->Add(repeated);
+
+  BOOST_CHECK_NO_THROW(algorithm::merge(target, other));
+  delete other;
+
+  BOOST_REQUIRE_EQUAL(target->GetEntries(), collectionSize + 10);
+  for (size_t i = 0; i < collectionSize + 10; i++) {
+    auto name = "histo " + std::to_string(i);
+    auto* result = dynamic_cast<TH1I*>(target->FindObject(name.c_str()));
+    BOOST_REQUIRE(result != nullptr);
+    const double expected = (i < collectionSize ? 1 : 0) + (i >= 10 ? 1 : 0) + (i == collectionSize + 9 ? 1 : 0);
+    BOOST_CHECK_EQUAL(result->GetBinContent(result->FindBin(i % bins)), expected);
+    BOOST_CHECK_EQUAL(result->GetEntries(), expected);
+  }
+
+  delete target;
+}
+
+BOOST_AUTO_TEST_CASE(SparseDelta)
+{
+  TH1F* previous = new TH1F("histo 1d", "histo 1d", bins, min, max);
+  previous->Sumw2();
+  previous->Fill(1);
+  previous->Fill(5, 2);
+
+  TH1F* current = dynamic_cast<TH1F*>(previous->Clone());
+  current->Fill(5);
+  current->Fill(8, 3);
+  current->Fill(-1); // underflow
+
+  SparseHistogramDelta delta(current, previous);
+  BOOST_CHECK_EQUAL(delta.size(), 3);
+  BOOST_CHECK_EQUAL(std::string(delta.GetName()), "histo 1d");
+
+  // Merging the delta into the previous state should give the current one.
+  BOOST_CHECK_NO_THROW(algorithm::merge(previous, &delta));
+  for (Int_t bin = 0; bin < current->GetNcells(); bin++) {
+    BOOST_CHECK_CLOSE(previous->GetBinContent(bin), current->GetBinContent(bin), 0.001);
+    BOOST_CHECK_CLOSE(previous->GetBinError(bin), current->GetBinError(bin), 0.001);
+  }
+  BOOST_CHECK_EQUAL(previous->GetEntries(), current->GetEntries());
+  BOOST_CHECK_CLOSE(previous->GetMean(), current->GetMean(), 0.001);
+  BOOST_CHECK_CLOSE(previous->GetStdDev(), current->GetStdDev(), 0.001);
+
+  // The binning has to match
+  TH1F* otherBinning = new TH1F("histo 1d", "histo 1d", bins * 2, min, max);
+  BOOST_CHECK_THROW(algorithm::merge(otherBinning, &delta), std::runtime_error);
+  BOOST_CHECK_THROW((SparseHistogramDelta{current, otherBinning}), std::runtime_error);
+
+  // Profiles are not supported
+  TProfile* profile = new TProfile("profile", "profile", bins, min, max);
+  BOOST_CHECK_THROW((SparseHistogramDelta{profile, nullptr}), std::runtime_error);
+
+  delete profile;
+  delete otherBinning;
+  delete current;
+  delete previous;
+}
+
+BOOST_AUTO_TEST_CASE(SparseDeltaCollection)
+{
+  // What a producer would keep, the state of its objects from the previous cycle.
+  TObjArray* previous = new TObjArray();
+  previous->SetOwner(true);
+  previous->Add(new TH1I("histo 1d", "histo 1d", bins, min, max));
+  previous->Add(new TH2I("histo 2d", "histo 2d", bins, min, max, bins, min, max));
+
+  TObjArray* current = dynamic_cast<TObjArray*>(previous->Clone());
+  current->SetOwner(true);
+  dynamic_cast<TH1I*>(current->FindObject("histo 1d"))->Fill(2);
+  dynamic_cast<TH2I*>(current->FindObject("histo 2d"))->Fill(5, 5);
+  auto* newTH1I = new TH1I("new histo", "new histo", bins, min, max);
+  newTH1I->Fill(3);
+  current->Add(newTH1I);
+
+  // The first cycle sends the full objects
+  auto first = algorithm::makeSparseDelta(previous, nullptr);
+  BOOST_REQUIRE(first != nullptr);
+  BOOST_CHECK(first->InheritsFrom(TObjArray::Class()));
+  BOOST_CHECK(dynamic_cast<TObjArray*>(first.get())->FindObject("histo 1d")->InheritsFrom(TH1I::Class()));
+
+  auto deltas = algorithm::makeSparseDelta(current, previous);
+  auto* deltasArray = dynamic_cast<TObjArray*>(deltas.get());
+  BOOST_REQUIRE(deltasArray != nullptr);
+  BOOST_REQUIRE_EQUAL(deltasArray->GetEntries(), 3);
+  BOOST_CHECK(deltasArray->FindObject("histo 1d")->InheritsFrom(SparseHistogramDelta::Class()));
+  BOOST_CHECK(deltasArray->FindObject("histo 2d")->InheritsFrom(SparseHistogramDelta::Class()));
+  // a histogram which was not there in the previous cycle is sent as a whole
+  BOOST_CHECK(deltasArray->FindObject("new histo")->InheritsFrom(TH1I::Class()));
+
+  BOOST_CHECK_NO_THROW(algorithm::merge(first.get(), deltas.get()));
+  auto* merged = dynamic_cast<TObjArray*>(first.get());
+  BOOST_REQUIRE_EQUAL(merged->GetEntries(), 3);
+  auto* resultTH1I = dynamic_cast<TH1I*>(merged->FindObject("histo 1d"));
+  BOOST_CHECK_EQUAL(resultTH1I->GetBinContent(resultTH1I->FindBin(2)), 1);
+  BOOST_CHECK_EQUAL(resultTH1I->GetEntries(), 1);
+  auto* resultTH2I = dynamic_cast<TH2I*>(merged->FindObject("histo 2d"));
+  BOOST_CHECK_EQUAL(resultTH2I->GetBinContent(resultTH2I->FindBin(5, 5)), 1);
+  auto* resultNew = dynamic_cast<TH1I*>(merged->FindObject("new histo"));
+  BOOST_REQUIRE(resultNew != nullptr);
+  BOOST_CHECK_EQUAL(resultNew->GetBinContent(resultNew->FindBin(3)), 1);
+
+  // A delta with no histogram to be added to creates the histogram
+  TObjArray* empty = new TObjArray();
+  empty->SetOwner(true);
+  BOOST_CHECK_NO_THROW(algorithm::merge(empty, deltas.get()));
+  BOOST_REQUIRE_EQUAL(empty->GetEntries(), 3);
+  auto* createdTH2I = dynamic_cast<TH2I*>(empty->FindObject("histo 2d"));
+  BOOST_REQUIRE(createdTH2I != nullptr);
+  BOOST_CHECK_EQUAL(createdTH2I->GetNbinsX(), bins);
+  BOOST_CHECK_EQUAL(createdTH2I->GetBinContent(createdTH2I->FindBin(5, 5)), 1);
+  BOOST_CHECK_EQUAL(createdTH2I->GetEntries(), 1);
+
+  // Only histograms are supported
+  TObjArray* withString = dynamic_cast<TObjArray*>(current->Clone());
+  withString->SetOwner(true);
+  withString->Add(new TObjString("string"));
+  TObjArray* previousWithString = dynamic_cast<TObjArray*>(withString->Clone());
+  previousWithString->SetOwner(true);
+  BOOST_CHECK_THROW(algorithm::makeSparseDelta(withString, previousWithString), std::runtime_error);
+
+  delete previousWithString;
+  delete withString;
+  delete empty;
+  delete current;
+  delete previous;
+}
+
 BOOST_AUTO_TEST_CASE(Deleting)
 {
   TObjArray* main = new TObjArray();
@@ -0,0 +1,137 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file test_IntegratingMerger.cxx
+/// \brief A unit test of IntegratingMerger receiving sparse histogram deltas
+
+#define BOOST_TEST_MODULE Test Utilities MergerIntegratingMerger
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+
+#include "Mergers/IntegratingMerger.h"
+#include "Mergers/MergerAlgorithm.h"
+
+#include <TObjArray.h>
+#include <TH1.h>
+#include <TH2.h>
+
+#include <memory>
+
+using namespace o2::mergers;
+
+namespace
+{
+TObjectPtr makeInput(const TObject* current, const TObject* previous)
+{
+  return TObjectPtr(algorithm::makeSparseDelta(current, previous).release(), algorithm::deleteTCollections);
+}
+
+template <typename T>
+T* getMerged(const IntegratingMerger& merger)
+{
+  BOOST_REQUIRE(std::holds_alternative<TObjectPtr>(merger.getMergedObject()));
+  return dynamic_cast<T*>(std::get<TObjectPtr>(merger.getMergedObject()).get());
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(ResetFollowedByDeltas)
+{
+  TH1::AddDirectory(false);
+
+  // Intermediate layers reset the merged object after each publication.
+  MergerConfig config;
+  config.inputObjectTimespan = {InputObjectsTimespan::LastDifference};
+  config.mergedObjectTimespan = {MergedObjectTimespan::NCycles, 1};
+  IntegratingMerger merger(config, 0);
+
+  const Double_t edges[] = {0, 1, 2, 5, 10};
+  std::unique_ptr<TH2F> previous(new TH2F("histo", "histo", 4, edges, 10, 0, 10));
+  previous->Sumw2();
+  previous->GetXaxis()->SetTitle("x");
+  previous->Fill(1.5, 3);
+
+  // The first cycle of the producer sends the full histogram
+  merger.merge(makeInput(previous.get(), nullptr));
+  BOOST_CHECK(getMerged<TH2F>(merger) != nullptr);
+  merger.clear();
+  BOOST_CHECK(std::holds_alternative<std::monostate>(merger.getMergedObject()));
+
+  // The following cycles send only deltas, the first one after the reset creates the histogram.
+  std::unique_ptr<TH2F> current(dynamic_cast<TH2F*>(previous->Clone()));
+  current->Fill(7, 2, 2.);
+  merger.merge(makeInput(current.get(), previous.get()));
+  auto* merged = getMerged<TH2F>(merger);
+  BOOST_REQUIRE(merged != nullptr);
+  BOOST_CHECK_EQUAL(std::string(merged->GetName()), "histo");
+  BOOST_CHECK_EQUAL(std::string(merged->GetXaxis()->GetTitle()), "x");
+  BOOST_CHECK(merged->GetXaxis()->IsVariableBinSize());
+  BOOST_CHECK(!merged->GetYaxis()->IsVariableBinSize());
+  BOOST_CHECK_EQUAL(merged->GetNcells(), current->GetNcells());
+  BOOST_CHECK_EQUAL(merged->GetBinContent(merged->FindBin(1.5, 3)), 0);
+  BOOST_CHECK_EQUAL(merged->GetBinContent(merged->FindBin(7, 2)), 2);
+  BOOST_CHECK_CLOSE(merged->GetBinError(merged->FindBin(7, 2)), 2, 0.001);
+  BOOST_CHECK_EQUAL(merged->GetEntries(), 1);
+
+  // The next deltas and full objects are added to it.
+  std::unique_ptr<TH2F> next(dynamic_cast<TH2F*>(current->Clone()));
+  next->Fill(7, 2);
+  BOOST_CHECK_NO_THROW(merger.merge(makeInput(next.get(), current.get())));
+  std::unique_ptr<TH2F> full(new TH2F("histo", "histo", 4, edges, 10, 0, 10));
+  full->Fill(0.5, 0.5);
+  BOOST_CHECK_NO_THROW(merger.merge(TObjectPtr(full->Clone(), algorithm::deleteTCollections)));
+  merged = getMerged<TH2F>(merger);
+  BOOST_CHECK_EQUAL(merged->GetBinContent(merged->FindBin(7, 2)), 3);
+  BOOST_CHECK_EQUAL(merged->GetBinContent(merged->FindBin(0.5, 0.5)), 1);
+  BOOST_CHECK_EQUAL(merged->GetEntries(), 3);
+}
+
+BOOST_AUTO_TEST_CASE(ResetFollowedByDeltaCollections)
+{
+  TH1::AddDirectory(false);
+
+  MergerConfig config;
+  config.inputObjectTimespan = {InputObjectsTimespan::LastDifference};
+  config.mergedObjectTimespan = {MergedObjectTimespan::LastDifference};
+  IntegratingMerger merger(config, 0);
+
+  std::unique_ptr<TObjArray> previous(new TObjArray());
+  previous->SetOwner(true);
+  previous->Add(new TH1I("histo 1d", "histo 1d", 10, 0, 10));
+  previous->Add(new TH2I("histo 2d", "histo 2d", 10, 0, 10, 10, 0, 10));
+
+  merger.merge(makeInput(previous.get(), nullptr));
+  merger.clear();
+
+  std::unique_ptr<TObjArray> current(dynamic_cast<TObjArray*>(previous->Clone()));
+  current->SetOwner(true);
+  dynamic_cast<TH1I*>(current->FindObject("histo 1d"))->Fill(2);
+  merger.merge(makeInput(current.get(), previous.get()));
+
+  // The merged collection contains histograms, not deltas, so it can be published and merged further.
+  auto* merged = getMerged<TObjArray>(merger);
+  BOOST_REQUIRE(merged != nullptr);
+  BOOST_REQUIRE_EQUAL(merged->GetEntries(), 2);
+  auto* mergedTH1I = dynamic_cast<TH1I*>(merged->FindObject("histo 1d"));
+  BOOST_REQUIRE(mergedTH1I != nullptr);
+  BOOST_CHECK_EQUAL(mergedTH1I->GetBinContent(mergedTH1I->FindBin(2)), 1);
+  BOOST_CHECK(dynamic_cast<TH2I*>(merged->FindObject("histo 2d")) != nullptr);
+  BOOST_CHECK(!algorithm::containsSparseDeltas(merged));
+
+  std::unique_ptr<TObjArray> next(dynamic_cast<TObjArray*>(current->Clone()));
+  next->SetOwner(true);
+  dynamic_cast<TH1I*>(next->FindObject("histo 1d"))->Fill(2);
+  BOOST_CHECK_NO_THROW(merger.merge(makeInput(next.get(), current.get())));
+  mergedTH1I = dynamic_cast<TH1I*>(getMerged<TObjArray>(merger)->FindObject("histo 1d"));
+  BOOST_CHECK_EQUAL(mergedTH1I->GetBinContent(mergedTH1I->FindBin(2)), 2);
+  BOOST_CHECK_EQUAL(mergedTH1I->GetEntries(), 2);
+}
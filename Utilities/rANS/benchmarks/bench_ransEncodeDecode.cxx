@@ -0,0 +1,97 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   bench_ransEncodeDecode.cxx
+/// @since  2022-03-14
+/// @brief  throughput of the two-way literal coders vs. the N-way interleaved coders
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "rANS/rans.h"
+
+namespace
+{
+// normal distributed 16 Bit source, similar in spread to TPC cluster charges/pads
+struct SourceMessage {
+  SourceMessage(size_t size)
+  {
+    std::mt19937 rng{0};
+    std::normal_distribution<double> dist{32768., 1024.};
+    data.resize(size);
+    std::generate(data.begin(), data.end(), [&]() { return static_cast<uint16_t>(std::clamp(dist(rng), 0., 65535.)); });
+    frequencyTable = o2::rans::renorm(o2::rans::makeFrequencyTableFromSamples(data.begin(), data.end()), 20);
+  }
+
+  std::vector<uint16_t> data;
+  o2::rans::RenormedFrequencyTable frequencyTable;
+};
+
+const SourceMessage& getSource()
+{
+  static SourceMessage source{1 << 24};
+  return source;
+}
+} // namespace
+
+template <typename encoder_T>
+static void BM_Encode(benchmark::State& state)
+{
+  const auto& source = getSource();
+  const size_t size = state.range(0);
+  const encoder_T encoder{source.frequencyTable};
+  std::vector<uint32_t> stream(size + 1024);
+  std::vector<uint16_t> literals;
+
+  for (auto _ : state) {
+    literals.clear();
+    benchmark::DoNotOptimize(encoder.process(source.data.begin(), source.data.begin() + size, stream.begin(), literals));
+  }
+  state.SetBytesProcessed(int64_t(state.iterations()) * size * sizeof(uint16_t));
+}
+
+template <typename encoder_T, typename decoder_T>
+static void BM_Decode(benchmark::State& state)
+{
+  const auto& source = getSource();
+  const size_t size = state.range(0);
+  const encoder_T encoder{source.frequencyTable};
+  const decoder_T decoder{source.frequencyTable};
+  std::vector<uint32_t> stream(size + 1024);
+  std::vector<uint16_t> literals;
+  const auto streamEnd = encoder.process(source.data.begin(), source.data.begin() + size, stream.begin(), literals);
+  std::vector<uint16_t> decoded(size);
+
+  for (auto _ : state) {
+    auto literalsCopy = literals;
+    decoder.process(streamEnd, decoded.begin(), size, literalsCopy);
+    benchmark::ClobberMemory();
+  }
+  if (!std::equal(decoded.begin(), decoded.end(), source.data.begin())) {
+    state.SkipWithError("decoded message does not match source");
+  }
+  state.SetBytesProcessed(int64_t(state.iterations()) * size * sizeof(uint16_t));
+}
+
+BENCHMARK_TEMPLATE(BM_Encode, o2::rans::LiteralEncoder64<uint16_t>)->RangeMultiplier(16)->Range(1 << 12, 1 << 24);
+BENCHMARK_TEMPLATE(BM_Encode, o2::rans::InterleavedEncoder64<uint16_t, 8>)->RangeMultiplier(16)->Range(1 << 12, 1 << 24);
+BENCHMARK_TEMPLATE(BM_Encode, o2::rans::InterleavedEncoder64<uint16_t, 16>)->RangeMultiplier(16)->Range(1 << 12, 1 << 24);
+BENCHMARK_TEMPLATE(BM_Encode, o2::rans::InterleavedEncoder64<uint16_t, 32>)->RangeMultiplier(16)->Range(1 << 12, 1 << 24);
+
+BENCHMARK_TEMPLATE(BM_Decode, o2::rans::LiteralEncoder64<uint16_t>, o2::rans::LiteralDecoder64<uint16_t>)->RangeMultiplier(16)->Range(1 << 12, 1 << 24);
+BENCHMARK_TEMPLATE(BM_Decode, o2::rans::InterleavedEncoder64<uint16_t, 8>, o2::rans::InterleavedDecoder64<uint16_t, 8>)->RangeMultiplier(16)->Range(1 << 12, 1 << 24);
+BENCHMARK_TEMPLATE(BM_Decode, o2::rans::InterleavedEncoder64<uint16_t, 16>, o2::rans::InterleavedDecoder64<uint16_t, 16>)->RangeMultiplier(16)->Range(1 << 12, 1 << 24);
+BENCHMARK_TEMPLATE(BM_Decode, o2::rans::InterleavedEncoder64<uint16_t, 32>, o2::rans::InterleavedDecoder64<uint16_t, 32>)->RangeMultiplier(16)->Range(1 << 12, 1 << 24);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,155 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   InterleavedDecoder.h
+/// @since  2022-03-14
+/// @brief  Decoder for streams produced by the InterleavedEncoder
+
+#ifndef RANS_INTERLEAVEDDECODER_H
+#define RANS_INTERLEAVEDDECODER_H
+
+#include <array>
+#include <iomanip>
+#include <vector>
+
+#include <fairlogger/Logger.h>
+
+#include "rANS/internal/DecoderBase.h"
+#include "rANS/internal/DecoderSymbol.h"
+#include "rANS/internal/InterleavedKernels.h"
+#include "rANS/internal/helper.h"
+#include "rANS/internal/ReverseSymbolLookupTable.h"
+#include "rANS/internal/SymbolTable.h"
+
+namespace o2
+{
+namespace rans
+{
+
+template <typename coder_T, typename stream_T, typename source_T, size_t nStreams_V>
+class InterleavedDecoder : public internal::DecoderBase<coder_T, stream_T, source_T>
+{
+  static_assert(nStreams_V > 0 && nStreams_V <= 64, "number of interleaved streams must be in [1, 64]");
+
+ public:
+  using decoderSymbolTable_t = typename internal::DecoderBase<coder_T, stream_T, source_T>::decoderSymbolTable_t;
+  using reverseSymbolLookupTable_t = typename internal::DecoderBase<coder_T, stream_T, source_T>::reverseSymbolLookupTable_t;
+
+  static constexpr size_t NStreams = nStreams_V;
+
+  using internal::DecoderBase<coder_T, stream_T, source_T>::DecoderBase;
+
+  template <typename stream_IT, typename source_IT, std::enable_if_t<internal::isCompatibleIter_v<stream_T, stream_IT>, bool> = true>
+  void process(stream_IT inputEnd, source_IT outputBegin, size_t messageLength, std::vector<source_T>& literals) const
+  {
+    decode(this->mSymbolTable, this->mReverseLUT, inputEnd, outputBegin, messageLength, literals);
+  };
+
+  /// decode with the tables of another decoder of the same coder setup, e.g. an externally provided LiteralDecoder
+  template <typename stream_IT, typename source_IT, std::enable_if_t<internal::isCompatibleIter_v<stream_T, stream_IT>, bool> = true>
+  static void decode(const decoderSymbolTable_t& symbolTable, const reverseSymbolLookupTable_t& reverseLUT,
+                     stream_IT inputEnd, source_IT outputBegin, size_t messageLength, std::vector<source_T>& literals);
+};
+
+template <typename coder_T, typename stream_T, typename source_T, size_t nStreams_V>
+template <typename stream_IT, typename source_IT, std::enable_if_t<internal::isCompatibleIter_v<stream_T, stream_IT>, bool>>
+void InterleavedDecoder<coder_T, stream_T, source_T, nStreams_V>::decode(const decoderSymbolTable_t& symbolTable, const reverseSymbolLookupTable_t& reverseLUT,
+                                                                      stream_IT inputEnd, source_IT outputBegin, size_t messageLength, std::vector<source_T>& literals)
+{
+  using namespace internal;
+  using namespace internal::interleaved;
+  LOG(trace) << "start decoding";
+  RANSTimer t;
+  t.start();
+
+  if (messageLength == 0) {
+    LOG(warning) << "Empty message passed to decoder, skipping decode process";
+    return;
+  }
+
+  const size_t precision = symbolTable.getPrecision();
+  const coder_T mask = (static_cast<coder_T>(1) << precision) - 1;
+  constexpr size_t StreamBits = interleaved::StreamBits<coder_T>;
+
+  std::array<coder_T, nStreams_V> states{};
+  std::array<const DecoderSymbol*, nStreams_V> symbols{};
+  const DecoderSymbol* const escapeSymbol = &symbolTable.getEscapeSymbol();
+
+  // make Iter point to the last last element
+  stream_IT inputIter = inputEnd;
+  --inputIter;
+  source_IT it = outputBegin;
+
+  for (auto& state : states) {
+    for (size_t i = 0; i < sizeof(coder_T) / sizeof(stream_T); ++i) {
+      state |= static_cast<coder_T>(*inputIter) << (i * StreamBits);
+      --inputIter;
+    }
+  }
+
+  auto lookupSymbol = [&](size_t lane) {
+    const auto streamSymbol = reverseLUT[states[lane] & mask];
+    symbols[lane] = &symbolTable[streamSymbol];
+    source_T symbol = streamSymbol;
+    if (symbols[lane] == escapeSymbol) {
+      symbol = literals.back();
+      literals.pop_back();
+    }
+    *it++ = symbol;
+  };
+
+  // same as for the encoder, 64 Bit states on random access streams read unconditionally and only advance
+  // conditionally. The stream iterator never points before the beginning of the stream range.
+  auto renorm = [&](uint64_t renormMask, size_t nLanes) {
+    for (size_t lane = 0; lane < nLanes; ++lane) {
+      const bool consume = (renormMask >> lane) & 0x1;
+      coder_T& state = states[lane];
+      if constexpr (needs64Bit<coder_T>() && isRandomAccessIter_v<stream_IT>) {
+        const coder_T renormed = (state << StreamBits) | *inputIter;
+        state = consume ? renormed : state;
+        inputIter -= consume;
+      } else if (consume) {
+        do {
+          state = (state << StreamBits) | *inputIter;
+          --inputIter;
+        } while (state < LowerBound<coder_T>);
+      }
+    }
+  };
+
+  const size_t nFull = messageLength - messageLength % nStreams_V;
+  for (size_t i = 0; i < nFull; i += nStreams_V) {
+    for (size_t lane = 0; lane < nStreams_V; ++lane) {
+      lookupSymbol(lane);
+    }
+    decoderUpdate<nStreams_V>(states.data(), symbols.data(), precision);
+    renorm(decoderRenormMask<nStreams_V>(states.data()), nStreams_V);
+  }
+
+  // trailing symbols, if message length is not a multiple of the number of streams
+  for (size_t lane = 0; lane < messageLength % nStreams_V; ++lane) {
+    lookupSymbol(lane);
+    decoderUpdate<1>(&states[lane], &symbols[lane], precision);
+    renorm(decoderRenormMask<1>(&states[lane]) << lane, lane + 1);
+  }
+
+  t.stop();
+  LOG(debug1) << "InterleavedDecoder::" << __func__ << " { DecodedSymbols: " << messageLength << ","
+              << " nStreams: " << nStreams_V << ","
+              << " inclusiveTimeMS: " << t.getDurationMS() << ","
+              << " BandwidthMiBPS: " << std::fixed << std::setprecision(2) << (messageLength * sizeof(source_T) * 1.0) / (t.getDurationS() * 1.0 * (1 << 20)) << "}";
+  LOG(trace) << "done decoding";
+}
+
+} // namespace rans
+} // namespace o2
+
+#endif /* RANS_INTERLEAVEDDECODER_H */
@@ -0,0 +1,149 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   InterleavedEncoder.h
+/// @since  2022-03-14
+/// @brief  Encoder with N interleaved rANS states and literal support
+
+#ifndef RANS_INTERLEAVEDENCODER_H
+#define RANS_INTERLEAVEDENCODER_H
+
+#include <array>
+#include <iomanip>
+#include <vector>
+
+#include <fairlogger/Logger.h>
+
+#include "rANS/internal/EncoderBase.h"
+#include "rANS/internal/EncoderSymbol.h"
+#include "rANS/internal/InterleavedKernels.h"
+#include "rANS/internal/helper.h"
+#include "rANS/internal/SymbolTable.h"
+
+namespace o2
+{
+namespace rans
+{
+
+/// Symbol i of the message is coded by state i % nStreams_V, states are updated lane-parallel
+/// (see internal/InterleavedKernels.h). Escape symbols are stored in the literals vector as for the
+/// LiteralEncoder, with nStreams_V == 2 the produced stream is identical to the one of LiteralEncoder.
+template <typename coder_T, typename stream_T, typename source_T, size_t nStreams_V>
+class InterleavedEncoder : public internal::EncoderBase<coder_T, stream_T, source_T>
+{
+  static_assert(nStreams_V > 0 && nStreams_V <= 64, "number of interleaved streams must be in [1, 64]");
+
+ public:
+  using encoderSymbolTable_t = typename internal::EncoderBase<coder_T, stream_T, source_T>::encoderSymbolTable_t;
+
+  static constexpr size_t NStreams = nStreams_V;
+
+  // inherit constructors;
+  using internal::EncoderBase<coder_T, stream_T, source_T>::EncoderBase;
+
+  template <typename stream_IT, typename source_IT, std::enable_if_t<internal::isCompatibleIter_v<source_T, source_IT>, bool> = true>
+  stream_IT process(source_IT inputBegin, source_IT inputEnd, stream_IT outputBegin, std::vector<source_T>& literals) const
+  {
+    return encode(this->mSymbolTable, inputBegin, inputEnd, outputBegin, literals);
+  };
+
+  /// encode with the symbol table of another encoder of the same coder setup, e.g. an externally provided LiteralEncoder
+  template <typename stream_IT, typename source_IT, std::enable_if_t<internal::isCompatibleIter_v<source_T, source_IT>, bool> = true>
+  static stream_IT encode(const encoderSymbolTable_t& symbolTable, source_IT inputBegin, source_IT inputEnd, stream_IT outputBegin, std::vector<source_T>& literals);
+};
+
+template <typename coder_T, typename stream_T, typename source_T, size_t nStreams_V>
+template <typename stream_IT, typename source_IT, std::enable_if_t<internal::isCompatibleIter_v<source_T, source_IT>, bool>>
+stream_IT InterleavedEncoder<coder_T, stream_T, source_T, nStreams_V>::encode(const encoderSymbolTable_t& symbolTable, source_IT inputBegin, source_IT inputEnd, stream_IT outputBegin, std::vector<source_T>& literals)
+{
+  using namespace internal;
+  using namespace internal::interleaved;
+  LOG(trace) << "start encoding";
+  RANSTimer t;
+  t.start();
+
+  if (inputBegin == inputEnd) {
+    LOG(warning) << "passed empty message to encoder, skip encoding";
+    return outputBegin;
+  }
+
+  const size_t precision = symbolTable.getPrecision();
+  constexpr size_t StreamBits = interleaved::StreamBits<coder_T>;
+
+  std::array<coder_T, nStreams_V> states;
+  states.fill(LowerBound<coder_T>);
+  const EncoderSymbol<coder_T>* const escapeSymbol = &symbolTable.getEscapeSymbol();
+
+  stream_IT outputIter = outputBegin;
+  source_IT inputIT = inputEnd;
+  const size_t inputBufferSize = std::distance(inputBegin, inputEnd);
+
+  // Which lanes renormalize is close to random, so for 64 Bit states on random access streams we always store the
+  // low word and only advance the stream conditionally instead of branching. The store never leaves the final
+  // stream range as it is followed by at least the flushed states.
+  auto putSymbol = [&](size_t lane) {
+    const source_T symbol = *(--inputIT);
+    const EncoderSymbol<coder_T>* encoderSymbol = &symbolTable[symbol];
+    if (encoderSymbol == escapeSymbol) {
+      literals.push_back(symbol);
+    }
+    coder_T& state = states[lane];
+    const bool emit = encoderRenormMask<1>(&state, &encoderSymbol, precision);
+    if constexpr (needs64Bit<coder_T>() && isRandomAccessIter_v<stream_IT>) {
+      outputIter[1] = static_cast<stream_T>(state);
+      outputIter += emit;
+      state = emit ? state >> StreamBits : state;
+    } else if (emit) {
+      const coder_T bound = (LowerBound<coder_T> >> precision) << StreamBits;
+      do {
+        ++outputIter;
+        *outputIter = static_cast<stream_T>(state);
+        state >>= StreamBits;
+      } while (state >= bound * encoderSymbol->getFrequency());
+    }
+    encoderUpdate<1>(&state, &encoderSymbol);
+  };
+
+  // the trailing message % nStreams_V symbols go to the first lanes
+  for (size_t lane = inputBufferSize % nStreams_V; lane-- > 0;) {
+    putSymbol(lane);
+  }
+
+  while (inputIT != inputBegin) { // NB: working in reverse!
+    for (size_t lane = nStreams_V; lane-- > 0;) {
+      putSymbol(lane);
+    }
+  }
+
+  for (size_t lane = nStreams_V; lane-- > 0;) {
+    const coder_T state = states[lane];
+    for (size_t i = sizeof(coder_T) / sizeof(stream_T); i-- > 0;) {
+      ++outputIter;
+      *outputIter = static_cast<stream_T>(state >> (i * StreamBits));
+    }
+  }
+  // first iterator past the range so that sizes, distances and iterators work correctly.
+  ++outputIter;
+
+  t.stop();
+  LOG(debug1) << "InterleavedEncoder::" << __func__ << " {ProcessedBytes: " << inputBufferSize * sizeof(source_T) << ","
+              << " nStreams: " << nStreams_V << ","
+              << " inclusiveTimeMS: " << t.getDurationMS() << ","
+              << " BandwidthMiBPS: " << std::fixed << std::setprecision(2) << (inputBufferSize * sizeof(source_T) * 1.0) / (t.getDurationS() * 1.0 * (1 << 20)) << "}";
+  LOG(trace) << "done encoding";
+
+  return outputIter;
+}
+
+} // namespace rans
+} // namespace o2
+
+#endif /* RANS_INTERLEAVEDENCODER_H */
@@ -60,6 +60,8 @@ class DecoderBase
   inline size_t getSymbolTablePrecision() const noexcept { return mSymbolTable.getPrecision(); }
   inline int getMinSymbol() const noexcept { return mSymbolTable.getMinSymbol(); }
   inline int getMaxSymbol() const noexcept { return mSymbolTable.getMaxSymbol(); }
+  inline const decoderSymbolTable_t& getSymbolTable() const noexcept { return mSymbolTable; }
+  inline const reverseSymbolLookupTable_t& getReverseLUT() const noexcept { return mReverseLUT; }
 
  protected:
   decoderSymbolTable_t mSymbolTable{};
@@ -58,6 +58,7 @@ class EncoderBase
   inline size_t getAlphabetRangeBits() const noexcept { return mSymbolTable.getAlphabetRangeBits(); };
   inline symbol_t getMinSymbol() const noexcept { return mSymbolTable.getMinSymbol(); };
   inline symbol_t getMaxSymbol() const noexcept { return mSymbolTable.getMaxSymbol(); };
+  inline const encoderSymbolTable_t& getSymbolTable() const noexcept { return mSymbolTable; };
 
  protected:
   encoderSymbolTable_t mSymbolTable{};
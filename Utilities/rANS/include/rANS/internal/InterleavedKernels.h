@@ -0,0 +1,190 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   InterleavedKernels.h
+/// @since  2022-03-14
+/// @brief  lane-parallel state update and renormalization kernels for the interleaved rANS coders
+
+#ifndef RANS_INTERNAL_INTERLEAVEDKERNELS_H
+#define RANS_INTERNAL_INTERLEAVEDKERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#if defined(__AVX2__) || defined(__SSE4_1__)
+#include <immintrin.h>
+#endif
+
+#include "rANS/internal/EncoderSymbol.h"
+#include "rANS/internal/DecoderSymbol.h"
+#include "rANS/internal/helper.h"
+
+namespace o2
+{
+namespace rans
+{
+namespace internal
+{
+namespace interleaved
+{
+
+// All kernels operate on nLanes_V independent rANS states and the symbols looked up for them.
+// Explicit SIMD paths are provided for decoding in the 64 Bit state / 32 Bit stream setup used for
+// CTF data and compute exactly the same values as the scalar loops, so streams do not depend on
+// the instruction set the coder was compiled for. Renormalization only computes a bitmask of lanes
+// which have to consume stream words, the stream access itself stays sequential to keep the lane
+// order defined.
+// Encoding is bound by the symbol table lookups, gathering the symbol parameters of several lanes
+// into vector registers was measured to be slower than updating one lane right after its lookup,
+// so the encoder kernels are used lane by lane and have no SIMD paths.
+
+template <typename state_T>
+inline constexpr state_T LowerBound = needs64Bit<state_T>() ? (1u << 31) : (1u << 23);
+
+template <typename state_T>
+inline constexpr size_t StreamBits = needs64Bit<state_T>() ? 32 : 8;
+
+__extension__ using uint128_t = unsigned __int128;
+
+template <typename state_T>
+inline state_T mulHi(state_T a, state_T b) noexcept
+{
+  if constexpr (needs64Bit<state_T>()) {
+    return static_cast<state_T>((static_cast<uint128_t>(a) * b) >> 64);
+  } else {
+    return static_cast<state_T>((static_cast<uint64_t>(a) * b) >> 32);
+  }
+}
+
+#if defined(__AVX2__)
+// low 64 Bit of a 64x32 Bit product, b holds 32 Bit values in 64 Bit lanes
+inline __m256i mulLo64x32(__m256i a, __m256i b) noexcept
+{
+  const __m256i lo = _mm256_mul_epu32(a, b);
+  const __m256i hi = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), b);
+  return _mm256_add_epi64(lo, _mm256_slli_epi64(hi, 32));
+}
+#elif defined(__SSE4_1__)
+inline __m128i mulLo64x32(__m128i a, __m128i b) noexcept
+{
+  const __m128i lo = _mm_mul_epu32(a, b);
+  const __m128i hi = _mm_mul_epu32(_mm_srli_epi64(a, 32), b);
+  return _mm_add_epi64(lo, _mm_slli_epi64(hi, 32));
+}
+#endif
+
+// x = C(s,x) for all lanes, see EncoderSymbol for the meaning of the parameters
+template <size_t nLanes_V, typename state_T>
+inline void encoderUpdate(state_T* __restrict__ states, const EncoderSymbol<state_T>* const* symbols) noexcept
+{
+  for (size_t i = 0; i < nLanes_V; ++i) {
+    const state_T quotient = mulHi(states[i], symbols[i]->getReciprocalFrequency()) >> symbols[i]->getReciprocalShift();
+    states[i] = states[i] + symbols[i]->getBias() + quotient * symbols[i]->getFrequencyComplement();
+  }
+}
+
+// bitmask of lanes with x >= ((L >> precision) << STREAM_BITS) * frequency, i.e. lanes that have to emit stream words
+// before the next symbol can be encoded.
+template <size_t nLanes_V, typename state_T>
+inline uint64_t encoderRenormMask(const state_T* states, const EncoderSymbol<state_T>* const* symbols, size_t precision) noexcept
+{
+  static_assert(nLanes_V <= 64);
+  const state_T bound = (LowerBound<state_T> >> precision) << StreamBits<state_T>;
+  uint64_t mask = 0;
+  for (size_t i = 0; i < nLanes_V; ++i) {
+    mask |= static_cast<uint64_t>(states[i] >= bound * symbols[i]->getFrequency()) << i;
+  }
+  return mask;
+}
+
+// s, x = D(x) for all lanes
+template <size_t nLanes_V, typename state_T>
+inline void decoderUpdate(state_T* __restrict__ states, const DecoderSymbol* const* symbols, size_t precision) noexcept
+{
+  if constexpr (std::is_same_v<state_T, uint64_t>) {
+#if defined(__AVX2__)
+    if constexpr (nLanes_V % 4 == 0) {
+      const __m128i p = _mm_cvtsi64_si128(precision);
+      const __m256i mask = _mm256_set1_epi64x((1ull << precision) - 1);
+      for (size_t i = 0; i < nLanes_V; i += 4) {
+        const auto* s = symbols + i;
+        const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(states + i));
+        const __m256i frequency = _mm256_set_epi64x(s[3]->getFrequency(), s[2]->getFrequency(), s[1]->getFrequency(), s[0]->getFrequency());
+        const __m256i cumulative = _mm256_set_epi64x(s[3]->getCumulative(), s[2]->getCumulative(), s[1]->getCumulative(), s[0]->getCumulative());
+        const __m256i scaled = mulLo64x32(_mm256_srl_epi64(x, p), frequency);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(states + i), _mm256_sub_epi64(_mm256_add_epi64(scaled, _mm256_and_si256(x, mask)), cumulative));
+      }
+      return;
+    }
+#elif defined(__SSE4_1__)
+    if constexpr (nLanes_V % 2 == 0) {
+      const __m128i p = _mm_cvtsi64_si128(precision);
+      const __m128i mask = _mm_set1_epi64x((1ull << precision) - 1);
+      for (size_t i = 0; i < nLanes_V; i += 2) {
+        const auto* s = symbols + i;
+        const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(states + i));
+        const __m128i scaled = mulLo64x32(_mm_srl_epi64(x, p), _mm_set_epi64x(s[1]->getFrequency(), s[0]->getFrequency()));
+        const __m128i cumulative = _mm_set_epi64x(s[1]->getCumulative(), s[0]->getCumulative());
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(states + i), _mm_sub_epi64(_mm_add_epi64(scaled, _mm_and_si128(x, mask)), cumulative));
+      }
+      return;
+    }
+#endif
+  }
+  const state_T mask = (static_cast<state_T>(1) << precision) - 1;
+  for (size_t i = 0; i < nLanes_V; ++i) {
+    states[i] = symbols[i]->getFrequency() * (states[i] >> precision) + (states[i] & mask) - symbols[i]->getCumulative();
+  }
+}
+
+// bitmask of lanes with x < L, i.e. lanes that have to consume stream words
+template <size_t nLanes_V, typename state_T>
+inline uint64_t decoderRenormMask(const state_T* states) noexcept
+{
+  static_assert(nLanes_V <= 64);
+  if constexpr (std::is_same_v<state_T, uint64_t>) {
+    // decoded states are < 2^63, so x < L <=> sign(x - L)
+#if defined(__AVX2__)
+    if constexpr (nLanes_V % 4 == 0) {
+      const __m256i bound = _mm256_set1_epi64x(LowerBound<uint64_t>);
+      uint64_t mask = 0;
+      for (size_t i = 0; i < nLanes_V; i += 4) {
+        const __m256i diff = _mm256_sub_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(states + i)), bound);
+        mask |= static_cast<uint64_t>(_mm256_movemask_pd(_mm256_castsi256_pd(diff))) << i;
+      }
+      return mask;
+    }
+#elif defined(__SSE4_1__)
+    if constexpr (nLanes_V % 2 == 0) {
+      const __m128i bound = _mm_set1_epi64x(LowerBound<uint64_t>);
+      uint64_t mask = 0;
+      for (size_t i = 0; i < nLanes_V; i += 2) {
+        const __m128i diff = _mm_sub_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(states + i)), bound);
+        mask |= static_cast<uint64_t>(_mm_movemask_pd(_mm_castsi128_pd(diff))) << i;
+      }
+      return mask;
+    }
+#endif
+  }
+  uint64_t mask = 0;
+  for (size_t i = 0; i < nLanes_V; ++i) {
+    mask |= static_cast<uint64_t>(states[i] < LowerBound<state_T>) << i;
+  }
+  return mask;
+}
+
+} // namespace interleaved
+} // namespace internal
+} // namespace rans
+} // namespace o2
+
+#endif /* RANS_INTERNAL_INTERLEAVEDKERNELS_H */
@@ -158,6 +158,8 @@ template <typename T, typename IT>
 inline constexpr bool isCompatibleIter_v = std::is_convertible_v<typename std::iterator_traits<IT>::value_type, T>;
 template <typename IT>
 inline constexpr bool isIntegralIter_v = std::is_integral_v<typename std::iterator_traits<IT>::value_type>;
+template <typename IT>
+inline constexpr bool isRandomAccessIter_v = std::is_base_of_v<std::random_access_iterator_tag, typename std::iterator_traits<IT>::iterator_category>;
 
 } // namespace internal
 } // namespace rans
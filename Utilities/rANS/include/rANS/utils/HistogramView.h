@@ -139,7 +139,7 @@ HistogramView<HistA_IT> rightTail(const HistogramView<HistA_IT>& histA, const Hi
 
   const ptrdiff_t rightOffset = utils::rightOffset(histA, histB);
 
-  if (rightOffset > 0) {
+  if (rightOffset >= 0) {
     // case 1 no right tail
     return {histA.end(), histA.end(), 0};
   } else if (histA.getMax() < histB.getMin()) {
@@ -148,7 +148,7 @@ HistogramView<HistA_IT> rightTail(const HistogramView<HistA_IT>& histA, const Hi
   } else {
     // case 3 0 < -rightOffset <= histA.size()
     auto newBegin = internal::advanceIter(histA.end(), rightOffset);
-    return {newBegin, histA.end(), *newBegin};
+    return {newBegin, histA.end(), histB.getMax() + 1};
   }
 };
 
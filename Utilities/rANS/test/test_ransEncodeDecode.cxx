@@ -20,6 +20,8 @@
 
 #include <vector>
 #include <cstring>
+#include <array>
+#include <random>
 
 #include <boost/test/unit_test.hpp>
 #include <boost/mpl/vector.hpp>
@@ -185,4 +187,127 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(test_encodeDecode, testCase_T, testCase_t)
   testCase.encode();
   testCase.decode();
   testCase.check();
-};
\ No newline at end of file
+};
+
+template <typename coder_T, typename stream_T, typename source_T>
+using InterleavedEncoder8 = o2::rans::InterleavedEncoder<coder_T, stream_T, source_T, 8>;
+template <typename coder_T, typename stream_T, typename source_T>
+using InterleavedDecoder8 = o2::rans::InterleavedDecoder<coder_T, stream_T, source_T, 8>;
+template <typename coder_T, typename stream_T, typename source_T>
+using InterleavedEncoder32 = o2::rans::InterleavedEncoder<coder_T, stream_T, source_T, 32>;
+template <typename coder_T, typename stream_T, typename source_T>
+using InterleavedDecoder32 = o2::rans::InterleavedDecoder<coder_T, stream_T, source_T, 32>;
+
+template <template <typename, typename, typename> class encoder_T,
+          template <typename, typename, typename> class decoder_T,
+          typename coder_T, class dictString_T, class testString_T>
+struct EncodeDecodeInterleaved : public EncodeDecodeBase<encoder_T, decoder_T, coder_T, dictString_T, testString_T> {
+  void encode() override
+  {
+    BOOST_CHECK_NO_THROW(this->encoder.process(std::begin(this->source.data), std::end(this->source.data), std::back_inserter(this->encodeBuffer), literals));
+  };
+  void decode() override
+  {
+    BOOST_CHECK_NO_THROW(this->decoder.process(this->encodeBuffer.end(), std::back_inserter(this->decodeBuffer), this->source.data.size(), literals));
+    BOOST_CHECK(literals.empty());
+  };
+
+  std::vector<typename Params<coder_T>::source_t> literals;
+};
+
+using interleavedTestCase_t = boost::mpl::vector<EncodeDecodeInterleaved<InterleavedEncoder8, InterleavedDecoder8, uint32_t, EmptyTestString, EmptyTestString>,
+                                                 EncodeDecodeInterleaved<InterleavedEncoder8, InterleavedDecoder8, uint64_t, EmptyTestString, EmptyTestString>,
+                                                 EncodeDecodeInterleaved<InterleavedEncoder8, InterleavedDecoder8, uint32_t, FullTestString, FullTestString>,
+                                                 EncodeDecodeInterleaved<InterleavedEncoder8, InterleavedDecoder8, uint64_t, FullTestString, FullTestString>,
+                                                 EncodeDecodeInterleaved<InterleavedEncoder8, InterleavedDecoder8, uint64_t, EmptyTestString, FullTestString>,
+                                                 EncodeDecodeInterleaved<InterleavedEncoder32, InterleavedDecoder32, uint32_t, FullTestString, FullTestString>,
+                                                 EncodeDecodeInterleaved<InterleavedEncoder32, InterleavedDecoder32, uint64_t, FullTestString, FullTestString>,
+                                                 EncodeDecodeInterleaved<InterleavedEncoder32, InterleavedDecoder32, uint64_t, EmptyTestString, FullTestString>>;
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(test_encodeDecodeInterleaved, testCase_T, interleavedTestCase_t)
+{
+  testCase_T testCase;
+  testCase.encode();
+  testCase.decode();
+  testCase.check();
+};
+
+BOOST_AUTO_TEST_CASE(test_interleavedMatchesLiteralEncoder)
+{
+  // with two streams the interleaved coder has to reproduce the stream of the LiteralEncoder
+  FullTestString source;
+  const std::string& s = source.data;
+  for (size_t length : {s.size(), s.size() - 1}) {
+    o2::rans::RenormedFrequencyTable frequencyTable = o2::rans::renorm(o2::rans::makeFrequencyTableFromSamples(s.begin(), s.begin() + length), 16);
+    o2::rans::LiteralEncoder64<char> literalEncoder{frequencyTable};
+    o2::rans::InterleavedEncoder64<char, 2> interleavedEncoder{frequencyTable};
+    std::vector<uint32_t> literalStream, interleavedStream;
+    std::vector<char> literals;
+    literalEncoder.process(s.begin(), s.begin() + length, std::back_inserter(literalStream), literals);
+    interleavedEncoder.process(s.begin(), s.begin() + length, std::back_inserter(interleavedStream), literals);
+    BOOST_CHECK_EQUAL_COLLECTIONS(literalStream.begin(), literalStream.end(), interleavedStream.begin(), interleavedStream.end());
+
+    // random access streams take the branchless renormalization path
+    std::vector<uint32_t> buffer(length + 16);
+    const auto bufferEnd = interleavedEncoder.process(s.begin(), s.begin() + length, buffer.begin(), literals);
+    BOOST_CHECK_EQUAL_COLLECTIONS(literalStream.begin(), literalStream.end(), buffer.begin() + 1, bufferEnd);
+
+    o2::rans::InterleavedDecoder64<char, 2> interleavedDecoder{frequencyTable};
+    std::string decoded(length, 0);
+    interleavedDecoder.process(bufferEnd, decoded.begin(), length, literals);
+    BOOST_CHECK_EQUAL(decoded, s.substr(0, length));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_interleavedKernels)
+{
+  // vectorized decoder kernels have to agree with the single lane (scalar) code path
+  using namespace o2::rans::internal;
+  constexpr size_t NLanes = 16;
+  constexpr size_t Precision = 16;
+  std::mt19937_64 rng{42};
+  std::vector<EncoderSymbol<uint64_t>> encoderSymbols;
+  std::vector<DecoderSymbol> decoderSymbols;
+  std::array<uint64_t, NLanes> states;
+  for (size_t iteration = 0; iteration < 1000; ++iteration) {
+    encoderSymbols.clear();
+    decoderSymbols.clear();
+    for (size_t i = 0; i < NLanes; ++i) {
+      const uint32_t frequency = 1 + rng() % (pow2(Precision) - 1);
+      const uint32_t cumulative = rng() % (pow2(Precision) - frequency + 1);
+      encoderSymbols.emplace_back(frequency, cumulative, Precision);
+      decoderSymbols.emplace_back(frequency, cumulative, Precision);
+      states[i] = (1ull << 31) + rng() % ((1ull << 63) - (1ull << 31));
+    }
+    std::array<const EncoderSymbol<uint64_t>*, NLanes> encoderSymbolPtrs;
+    std::array<const DecoderSymbol*, NLanes> decoderSymbolPtrs;
+    for (size_t i = 0; i < NLanes; ++i) {
+      encoderSymbolPtrs[i] = &encoderSymbols[i];
+      decoderSymbolPtrs[i] = &decoderSymbols[i];
+    }
+
+    // keep the encoded states in the valid range
+    auto encoded = states;
+    for (auto& state : encoded) {
+      state >>= Precision;
+    }
+    interleaved::encoderUpdate<NLanes>(encoded.data(), encoderSymbolPtrs.data());
+
+    auto scalarStates = encoded;
+    for (size_t i = 0; i < NLanes; ++i) {
+      interleaved::decoderUpdate<1>(&scalarStates[i], &decoderSymbolPtrs[i], Precision);
+    }
+    auto vectorStates = encoded;
+    interleaved::decoderUpdate<NLanes>(vectorStates.data(), decoderSymbolPtrs.data(), Precision);
+    BOOST_CHECK_EQUAL_COLLECTIONS(scalarStates.begin(), scalarStates.end(), vectorStates.begin(), vectorStates.end());
+    for (size_t i = 0; i < NLanes; ++i) {
+      BOOST_CHECK_EQUAL(vectorStates[i], states[i] >> Precision); // D(C(x)) == x
+    }
+
+    uint64_t scalarMask = 0;
+    for (size_t i = 0; i < NLanes; ++i) {
+      scalarMask |= interleaved::decoderRenormMask<1>(&vectorStates[i]) << i;
+    }
+    BOOST_CHECK_EQUAL(interleaved::decoderRenormMask<NLanes>(vectorStates.data()), scalarMask);
+  }
+}
@@ -476,6 +476,20 @@ BOOST_AUTO_TEST_CASE(tails_rightTail)
   BOOST_CHECK((v.rend().base() == a.end() - 5));
 };
 
+BOOST_AUTO_TEST_CASE(tails_sameMax)
+{
+  std::vector<int32_t> a{-3, -2, -1, 0, 1, 2};
+  std::vector<int32_t> b{-1, 0, 1, 2};
+  o2::rans::utils::HistogramView av{a.begin(), a.end(), -3};
+  o2::rans::utils::HistogramView bv{b.begin(), b.end(), -1};
+
+  auto v = o2::rans::utils::rightTail(av, bv);
+  BOOST_CHECK_EQUAL(v.size(), 0);
+  BOOST_CHECK_EQUAL(v.getOffset(), 0);
+  BOOST_CHECK((v.begin() == a.end()));
+  BOOST_CHECK((v.end() == a.end()));
+};
+
 BOOST_AUTO_TEST_CASE(tails_bothTail)
 {
   std::vector<int32_t> a{-3, -2, -1, 0, 1, 2, 3, 4, 5};